@@ -0,0 +1,5 @@
+
+int main(int argc, char **argv) {
+	(void)argc; (void)argv;
+	return 0;
+}
@@ -0,0 +1,6 @@
+
+#include <sys/socket.h>
+int main ()
+{
+  return sendmmsg (0, 0, 0, 0);
+}
@@ -0,0 +1,8 @@
+#include <sys/socket.h>
+
+int main(int argc, char **argv) {
+	void *p;
+	(void)argc; (void)argv;
+	p=(void*)(sendmmsg);
+	return 0;
+}
@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BUCKET_SCHEDULER_H
+#define BUCKET_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+#include <map>
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup scheduler
+ * \brief a two-level bucket event scheduler
+ *
+ * The near future is covered by a window of fixed-width time buckets,
+ * each of which holds its events in a sorted vector. Since new events
+ * are almost always inserted with a uid larger than the uid of the
+ * events already present in their bucket, insertion usually amounts to
+ * a push_back and removal of the next event to an index increment, so
+ * that both are O(1) amortized for the dense near-future events which
+ * dominate typical simulations. Bucket storage is recycled across
+ * windows: once warmed up, the scheduler does not allocate memory.
+ *
+ * Events which fall beyond the end of the window are kept in an ordered
+ * overflow map. When every bucket of the window has been drained, the
+ * window is moved to the earliest overflow event and its bucket width
+ * is recomputed from the spread of the next overflow events, which
+ * makes the scheduler adapt to the event density of the simulation.
+ */
+class BucketScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  BucketScheduler ();
+  virtual ~BucketScheduler ();
+
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+private:
+  /**
+   * A bucket of events sorted by key. The events before m_head
+   * have already been removed.
+   */
+  struct Bucket
+  {
+    std::vector<Scheduler::Event> events;
+    uint32_t head;
+  };
+  typedef std::map<Scheduler::EventKey, EventImpl*> EventMap;
+  typedef std::map<Scheduler::EventKey, EventImpl*>::iterator EventMapI;
+  typedef std::map<Scheduler::EventKey, EventImpl*>::const_iterator EventMapCI;
+
+  void SetBuckets (uint32_t nBuckets);
+  uint32_t GetBuckets (void) const;
+  /**
+   * \param ts the timestamp of an event
+   * \returns the index of the bucket which holds this timestamp, or
+   *          m_nBuckets if it falls beyond the end of the window.
+   */
+  inline uint32_t GetBucketIndex (uint64_t ts) const;
+  /**
+   * Move the index of the current bucket to the first non-empty bucket,
+   * refilling the window from the overflow map if needed.
+   */
+  void Advance (void);
+  /**
+   * Move the window to the earliest overflow event and move every
+   * overflow event which falls in the new window to its bucket.
+   */
+  void Refill (void);
+  static void BucketInsert (Bucket *bucket, const Event &ev);
+
+  std::vector<Bucket> m_buckets;
+  // number of buckets in the window, a power of two
+  uint32_t m_nBuckets;
+  // log2 of the duration of a bucket
+  uint32_t m_shift;
+  // timestamp of the start of the first bucket of the window
+  uint64_t m_windowStart;
+  // all buckets before this one are empty
+  uint32_t m_current;
+  // number of events stored in the buckets of the window
+  uint32_t m_windowSize;
+  // events which fall beyond the end of the window
+  EventMap m_overflow;
+};
+
+} // namespace ns3
+
+#endif /* BUCKET_SCHEDULER_H */
@@ -0,0 +1,147 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CACHED_PROPAGATION_LOSS_MODEL_H
+#define CACHED_PROPAGATION_LOSS_MODEL_H
+
+#include "propagation-loss-model.h"
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Memoize the received power computed by another loss model for
+ * each pair of nodes until one of them moves.
+ *
+ * The model set with the Model attribute, and the models chained after
+ * it with SetNext, are evaluated once for each (transmitter, receiver)
+ * pair and transmit power: the result is kept in a flat open addressing
+ * hash table until either endpoint reports a course change through the
+ * CourseChange trace of its MobilityModel. Nodes with a non-zero velocity
+ * move without reporting it, so the paths which involve them are never
+ * cached.
+ *
+ * The wrapped models must thus be deterministic functions of the
+ * positions, like LogDistancePropagationLossModel,
+ * OkumuraHataPropagationLossModel or the buildings-aware models of
+ * static scenarios. Random models, like NakagamiPropagationLossModel,
+ * must not be wrapped but chained after the cache with SetNext, so that
+ * they are still evaluated for every packet:
+ *
+ * \code
+ * Ptr<CachedPropagationLossModel> cache = CreateObject<CachedPropagationLossModel> ();
+ * cache->SetModel (CreateObject<LogDistancePropagationLossModel> ());
+ * cache->SetNext (CreateObject<NakagamiPropagationLossModel> ());
+ * \endcode
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  CachedPropagationLossModel ();
+  virtual ~CachedPropagationLossModel ();
+
+  /**
+   * \param model the loss model, or chain of loss models, to cache.
+   *
+   * Changing the model flushes the cache.
+   */
+  void SetModel (Ptr<PropagationLossModel> model);
+  /**
+   * \returns the cached loss model.
+   */
+  Ptr<PropagationLossModel> GetModel (void) const;
+
+  /**
+   * \returns the number of CalcRxPower calls served from the cache.
+   */
+  uint64_t GetHits (void) const;
+  /**
+   * \returns the number of CalcRxPower calls which evaluated the model.
+   */
+  uint64_t GetMisses (void) const;
+
+private:
+  CachedPropagationLossModel (const CachedPropagationLossModel &o);
+  CachedPropagationLossModel & operator = (const CachedPropagationLossModel &o);
+
+  virtual void DoDispose (void);
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  /// A mobility model seen by the cache.
+  struct Node
+  {
+    Ptr<MobilityModel> mobility;
+    // incremented on every course change, which invalidates the
+    // paths computed before.
+    uint32_t version;
+    bool moving;
+  };
+  /// The cached result for a path.
+  struct Path
+  {
+    // (index of a << 32) | index of b, or EMPTY_KEY
+    uint64_t key;
+    uint32_t versionA;
+    uint32_t versionB;
+    double txPowerDbm;
+    double rxPowerDbm;
+  };
+  /// A slot of the mobility model to node index table.
+  struct NodeSlot
+  {
+    MobilityModel *mobility;
+    uint32_t index;
+  };
+
+  /**
+   * \returns the index in m_nodes of this mobility model, which is added
+   *          to the cache if it was never seen before.
+   */
+  uint32_t GetNodeIndex (Ptr<MobilityModel> mobility) const;
+  /**
+   * \returns the slot of the path table which holds this key, or the
+   *          empty slot where it should be inserted.
+   */
+  Path *FindPath (uint64_t key) const;
+  void GrowNodeSlots (void) const;
+  void GrowPaths (void) const;
+  void Flush (void);
+  static void CourseChanged (CachedPropagationLossModel const *model, uint32_t index,
+                             Ptr<const MobilityModel> mobility);
+
+  Ptr<PropagationLossModel> m_model;
+  // The cache is filled by DoCalcRxPower, which is const.
+  mutable std::vector<Node> m_nodes;
+  mutable std::vector<NodeSlot> m_nodeSlots; //!< power of two sized
+  mutable std::vector<Path> m_paths; //!< power of two sized
+  mutable uint32_t m_nPaths;
+  mutable uint64_t m_hits;
+  mutable uint64_t m_misses;
+};
+
+} // namespace ns3
+
+#endif /* CACHED_PROPAGATION_LOSS_MODEL_H */
@@ -0,0 +1,150 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2011 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Nicola Baldo  <nbaldo@cttc.es>
+ */
+
+
+#ifndef EPC_TFT_CLASSIFIER_H
+#define EPC_TFT_CLASSIFIER_H
+
+
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/epc-tft.h"
+
+#include <map>
+#include <vector>
+
+
+namespace ns3 {
+
+class EpcTft;
+class Packet;
+
+/**
+ * \brief classifies IP packets accoding to Traffic Flow Templates (TFTs)
+ * 
+ * The TFTs are evaluated in decreasing order of identifier, so that the
+ * default bearer, which is expected to be added first, is evaluated
+ * last, and a packet is classified to the first TFT having a
+ * PacketFilter that matches it. Instead of evaluating each
+ * PacketFilter in turn, the classifier compiles the PacketFilters of
+ * all the TFTs into a bit vector classifier the first time it
+ * classifies a packet after a TFT was added or deleted: the values of
+ * each field of a packet (remote and local address, remote and local
+ * port, type of service and direction) are split into the intervals
+ * over which the set of matching PacketFilters does not change, and
+ * each interval is associated with the bit vector of these
+ * PacketFilters, ordered by decreasing TFT identifier. A packet is
+ * then classified with a binary search per field, followed by the
+ * bitwise AND of the bit vectors: the first bit set is the matching
+ * PacketFilter.
+ *
+ * \note this implementation works with IPv4 only.
+ */
+class EpcTftClassifier : public SimpleRefCount<EpcTftClassifier>
+{
+public:
+  
+  EpcTftClassifier ();
+  
+  /** 
+   * add a TFT to the Classifier
+   * 
+   * \param tft the TFT to be added. Its PacketFilters are not expected
+   * to change afterwards.
+   * 
+   */
+  void Add (Ptr<EpcTft> tft, uint32_t id);
+
+  /** 
+   * delete an existing TFT from the classifier
+   * 
+   * \param id the identifier of the TFT to be deleted
+   */
+  void Delete (uint32_t id);
+  
+
+  /** 
+   * classify an IP packet
+   * 
+   * \param p the IP packet. It is assumed that the outmost header is an IPv4 header.
+   * 
+   * \return the identifier (>0) of the first TFT that matches with the IP packet; 0 if no TFT matched.
+   */
+  uint32_t Classify (Ptr<Packet> p, EpcTft::Direction direction);
+  
+protected:
+  
+  std::map <uint32_t, Ptr<EpcTft> > m_tftMap;
+
+private:
+
+  /**
+   * A field of the packets, split into the intervals over which the set
+   * of matching PacketFilters does not change
+   */
+  struct Field
+  {
+    std::vector<uint32_t> starts; ///< the lowest value of each interval, in increasing order, starting with 0
+    std::vector<uint64_t> bits; ///< the PacketFilters matching each interval, m_nWords words per interval
+  };
+
+  /**
+   * compile the PacketFilters of the TFTs
+   */
+  void Compile ();
+
+  /** 
+   * \param field the field to be compiled
+   * \param ranges the range of values of the field matched by each PacketFilter
+   */
+  void CompileField (Field &field, const std::vector<std::pair<uint32_t, uint32_t> > &ranges) const;
+
+  /** 
+   * \param field a compiled field
+   * \param value a value of the field
+   * 
+   * \return the bit vector of the PacketFilters matching the value
+   */
+  const uint64_t * Lookup (const Field &field, uint32_t value) const;
+
+  bool m_compiled; ///< whether the compiled classifier is up to date with m_tftMap
+  uint32_t m_nWords; ///< the number of words of a bit vector
+  std::vector<EpcTft::PacketFilter> m_filters; ///< the PacketFilters, by decreasing TFT identifier
+  std::vector<uint32_t> m_filterTftIds; ///< the identifier of the TFT of each PacketFilter
+  Field m_remoteAddress;
+  Field m_localAddress;
+  Field m_remotePort;
+  Field m_localPort;
+  std::vector<uint64_t> m_typeOfService; ///< the bit vectors of the 256 types of service
+  std::vector<uint64_t> m_direction; ///< the bit vectors of the UPLINK and DOWNLINK directions
+  /**
+   * the PacketFilters whose address masks are not prefixes, whose
+   * address fields match every address and which are checked with
+   * EpcTft::PacketFilter::Matches instead
+   */
+  std::vector<uint64_t> m_inexact;
+  
+};
+
+
+
+} // namespace ns3
+  
+#endif /* TFT_CLASSIFIER_H */ 
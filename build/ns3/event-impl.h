@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2005,2006 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+#ifndef EVENT_IMPL_H
+#define EVENT_IMPL_H
+
+#include <stdint.h>
+#include <cstddef>
+#include "simple-ref-count.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup events
+ * \brief a simulation event
+ *
+ * Each subclass of this base class represents a simulation event. The
+ * EventImpl::Invoke method will be invoked by the simulation engine
+ * when the time associated to this event expires. This class is
+ * obviously (there are Ref and Unref methods) reference-counted and
+ * most subclasses are usually created by one of the many Simulator::Schedule
+ * methods.
+ *
+ * Events are created and destroyed at a very high rate so the memory
+ * of all subclasses is recycled through per-thread size-class free
+ * lists instead of being returned to the system allocator.
+ */
+class EventImpl : public SimpleRefCount<EventImpl>
+{
+public:
+  EventImpl ();
+  virtual ~EventImpl () = 0;
+  /**
+   * Called by the simulation engine to notify the event that it has expired.
+   */
+  void Invoke (void);
+  /**
+   * Marks the event as 'canceled'. The event will not be removed from
+   * the event list but the simulation engine will check its canceled status
+   * before calling Invoke.
+   */
+  void Cancel (void);
+  /**
+   * \returns true if the event has been canceled.
+   *
+   * Invoked by the simulation engine before calling Invoke.
+   */
+  bool IsCancelled (void);
+
+  /**
+   * \param size the size of the object to allocate
+   * \returns a block taken from the free list of the size class
+   *          of this object, if any.
+   */
+  static void * operator new (size_t size);
+  /**
+   * \param p the object to release
+   * \param size the size of the object
+   *
+   * The block is kept in the free list of its size class unless
+   * that free list is already full.
+   */
+  static void operator delete (void *p, size_t size);
+  /**
+   * \returns the number of events allocated by the calling thread
+   *          from a free list.
+   */
+  static uint64_t GetPoolHits (void);
+  /**
+   * \returns the number of events allocated by the calling thread
+   *          from the system allocator.
+   */
+  static uint64_t GetPoolMisses (void);
+
+protected:
+  virtual void Notify (void) = 0;
+
+private:
+  bool m_cancel;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_IMPL_H */
@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FF_MAC_SCHEDULER_KERNEL_H
+#define FF_MAC_SCHEDULER_KERNEL_H
+
+#include <stdint.h>
+#include <vector>
+#include <ns3/ptr.h>
+#include <ns3/ff-mac-common.h>
+
+namespace ns3 {
+
+class LteAmc;
+
+/**
+ * \ingroup lte
+ * \brief The per-RBG metric evaluation shared by the frequency domain
+ * FF MAC schedulers
+ *
+ * The PF, FD-MT and TTA schedulers give each free RBG to the UE with
+ * the highest achievable rate on that RBG, divided by a per-UE
+ * normalization (the average throughput of the UE, its wideband rate,
+ * or 1). At each TTI, the scheduler adds the UEs which can be
+ * scheduled, each of which gets a compact slot, along with the subband
+ * CQIs they reported; the kernel then selects the UE of every RBG in a
+ * single pass over dense per-slot arrays. The arrays are kept from one
+ * TTI to the next, so that they are not allocated again, and the rate
+ * of each CQI is computed once per TTI instead of once per UE and RBG.
+ *
+ * The rates and metrics are computed exactly as the schedulers did, so
+ * that the allocations are the same: ties go to the UE added first.
+ */
+class FfMacSchedulerKernel
+{
+public:
+  FfMacSchedulerKernel ();
+
+  /**
+   * Forget the UEs of the previous TTI.
+   *
+   * \param rbgNum the number of RBGs of the TTI
+   * \param rbgSize the number of RBs of each RBG
+   * \param amc the AMC module of the scheduler
+   */
+  void Start (int rbgNum, int rbgSize, Ptr<LteAmc> amc);
+  /**
+   * \param rnti the RNTI of a UE which can be scheduled in this TTI
+   * \param normalization the value which the achievable rates of the UE
+   *        are divided by
+   * \return the slot of the UE
+   */
+  uint32_t AddUe (uint16_t rnti, double normalization);
+  /**
+   * Set the achievable rates of a UE on each RBG from its subband CQIs.
+   *
+   * \param slot the slot of the UE
+   * \param sbMeasResult the last subband CQIs of the UE, or 0 if none
+   *        was received
+   * \param nLayer the number of layers of the UE
+   */
+  void SetSbCqi (uint32_t slot, const SbMeasResult_s *sbMeasResult, int nLayer);
+  /**
+   * \param cqi a CQI
+   * \return the achievable rate, in bytes per second, of one layer of an
+   *         RBG with this CQI
+   */
+  double GetRate (uint8_t cqi) const;
+  /**
+   * Select the UE of each RBG.
+   */
+  void Select (void);
+  /**
+   * \param rbg an RBG
+   * \return the slot of the UE with the highest positive metric on the
+   *         RBG, or -1 if no UE can use it
+   */
+  int32_t GetSelectedSlot (int rbg) const;
+  /**
+   * \param slot the slot of a UE
+   * \return its RNTI
+   */
+  uint16_t GetRnti (uint32_t slot) const;
+
+private:
+  int m_rbgNum;
+  uint32_t m_nUes;
+  double m_cqiRates[16]; //!< the rate of one layer of an RBG, indexed by CQI
+  double m_mcs0Rate;     //!< the rate of a layer without CQI
+  // the per-slot arrays
+  std::vector<uint16_t> m_rntis;
+  std::vector<double> m_normalizations;
+  std::vector<double> m_rates; //!< the rates of slot s start at s * m_rbgNum
+  // the per-RBG arrays
+  std::vector<double> m_bestMetrics;
+  std::vector<int32_t> m_bestSlots;
+};
+
+} // namespace ns3
+
+#endif /* FF_MAC_SCHEDULER_KERNEL_H */
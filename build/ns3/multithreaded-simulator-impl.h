@@ -0,0 +1,191 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MULTITHREADED_SIMULATOR_IMPL_H
+#define NS3_MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/simulator-impl.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <list>
+#include <vector>
+
+namespace ns3 {
+
+class MultithreadedBarrier;
+
+/**
+ * \ingroup simulator
+ * \ingroup mpi
+ *
+ * \brief Conservative parallel simulator implementation using one
+ * thread per partition on a shared-memory machine.
+ *
+ * Nodes are assigned to partitions by their system id, exactly like
+ * with DistributedSimulatorImpl, and every event runs in the partition
+ * of its context: each partition owns an event list, a current time and
+ * a thread. Events scheduled for a context which belongs to another
+ * partition are posted to a mailbox of the destination partition: each
+ * (source, destination) pair has its own mailbox and mailboxes are only
+ * read between two barriers, so posting an event does not require any
+ * lock.
+ *
+ * Partitions advance in time windows whose length is the lookahead,
+ * that is, the smallest delay of the point-to-point channels which
+ * connect nodes of different partitions, computed like
+ * DistributedSimulatorImpl::CalculateLookAhead does. The LookAhead
+ * attribute overrides this value.
+ *
+ * Reference counts are not atomic: the design relies on handing
+ * objects over to another partition only through the events posted to
+ * it, which the destination reads after the next barrier. The sending
+ * partition must not touch, not even through a Ptr copy, the objects
+ * of the destination partition, and must not keep any reference to
+ * the objects it hands over. PointToPointChannel does so for links
+ * between partitions: it posts a copy of the packet and a plain
+ * pointer to the receiving device, like PointToPointRemoteChannel
+ * does under MPI. No other channel may connect nodes of different
+ * partitions. Code which must use the objects of several partitions,
+ * like the TxRxPointToPoint trace of such a channel, does so from an
+ * event posted with ScheduleSerial.
+ *
+ * Simulator::Stop called during Run stops every partition at the
+ * same time: after the end of the current window, or after the
+ * requested delay if it ends later. Events of another partition can
+ * only be cancelled or removed outside of Run.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  static TypeId GetTypeId (void);
+
+  MultithreadedSimulatorImpl ();
+  ~MultithreadedSimulatorImpl ();
+
+  // virtual from SimulatorImpl
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (Time const &time);
+  virtual EventId Schedule (Time const &time, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &ev);
+  virtual void Cancel (const EventId &ev);
+  virtual bool IsExpired (const EventId &ev) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+
+  /**
+   * \returns the number of partitions, that is, of threads used by Run.
+   */
+  uint32_t GetPartitionCount (void) const;
+
+  /**
+   * \returns the length of the synchronization windows of the last
+   * call to Run.
+   */
+  Time GetLookAhead (void) const;
+
+  /**
+   * \brief Run an event of the calling partition while every
+   * partition is stopped.
+   *
+   * The event runs at the end of the current window, with the time and
+   * the context of the call, in timestamp order with the other events
+   * posted this way. It can thus use the objects of every partition
+   * but it must not schedule events. Outside of Run, the event runs
+   * immediately.
+   *
+   * \param event the event to run.
+   */
+  static void ScheduleSerial (EventImpl *event);
+
+private:
+  /// An event posted by another partition.
+  struct Message
+  {
+    uint64_t ts;
+    uint32_t context;
+    EventImpl *impl;
+  };
+  typedef std::vector<Message> Mailbox;
+  struct Partition
+  {
+    Ptr<Scheduler> events;
+    uint64_t currentTs;
+    uint32_t currentUid;
+    uint32_t currentContext;
+    uint32_t uid;
+    int unscheduledEvents;
+    // indexed by source partition
+    std::vector<Mailbox> inbox;
+    // the timestamp of the next event, published before each window.
+    uint64_t nextTs;
+    // the last timestamp of the current window.
+    uint64_t windowEnd;
+    // the last timestamp to run after a call to Stop, and its value
+    // published before each window.
+    uint64_t stopRequest;
+    uint64_t stopTs;
+    // the events posted with ScheduleSerial during the current window.
+    std::vector<Message> serial;
+    // the packet uid counter of the partition between two calls to Run.
+    uint32_t packetUid;
+  };
+  typedef std::list<EventId> DestroyEvents;
+
+  virtual void DoDispose (void);
+  void AddPartitions (uint32_t n);
+  Partition *GetCurrentPartition (void) const;
+  uint32_t GetCurrentPartitionId (void) const;
+  uint32_t GetPartitionId (uint32_t context) const;
+  void CheckOwner (const EventId &id, const char *method) const;
+  void CalculateLookAhead (void);
+  void CalculatePartitions (void);
+  EventId Insert (Partition *partition, uint64_t ts, uint32_t context, EventImpl *event);
+  void ProcessOneEvent (Partition *partition);
+  void RunPartition (uint32_t id);
+  void RunSerialEvents (void);
+  static void RunThread (MultithreadedSimulatorImpl *impl, uint32_t id);
+
+  std::vector<Partition *> m_partitions;
+  // partition of each node id, cached by Run and Destroy.
+  std::vector<uint32_t> m_nodePartitions;
+  ObjectFactory m_schedulerFactory;
+  DestroyEvents m_destroyEvents;
+  MultithreadedBarrier *m_barrier;
+  Time m_lookAheadAttribute;
+  uint64_t m_lookAhead;
+  uint64_t m_stopTs;
+  bool m_running;
+  bool m_runningSerial;
+  bool m_stopSnapshot;
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,184 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2011 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Giuseppe Piro  <g.piro@poliba.it>
+ *         Marco Miozzo <mmiozzo@cttc.es>
+ */
+
+
+#ifndef TRACE_FADING_LOSS_MODEL_H
+#define TRACE_FADING_LOSS_MODEL_H
+
+
+#include <ns3/object.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <map>
+#include <vector>
+#include "ns3/random-variable-stream.h"
+#include <ns3/nstime.h>
+
+namespace ns3 {
+
+
+class MobilityModel;
+
+
+/**
+ * \ingroup lte
+ *
+ * \brief fading loss model based on precalculated fading traces
+ *
+ * The trace is read either from a text file, as generated by
+ * fading_trace_generator.m, or from a binary file written by
+ * ConvertTrace (). A binary trace is mapped in memory rather than read,
+ * so that its pages are shared by all the processes which use it, and
+ * the samples of a trace are shared by all the models which load it.
+ */
+class TraceFadingLossModel : public SpectrumPropagationLossModel
+{
+public:
+  TraceFadingLossModel ();
+  virtual ~TraceFadingLossModel ();
+
+  static TypeId GetTypeId ();
+  
+  virtual void DoInitialize (void);
+
+  /**
+   * \brief The couple of mobility mnode that form a fading channel realization
+   */
+  typedef std::pair<Ptr<const MobilityModel>, Ptr<const MobilityModel> > ChannelRealizationId_t;
+
+ /**
+  * Assign a fixed random variable stream number to the random variables
+  * used by this model.  Return the number of streams (possibly zero) that
+  * have been assigned.
+  *
+  * \param stream first stream index to use
+  * \return the number of stream indices assigned by this model
+  */
+  int64_t AssignStreams (int64_t stream);
+
+  /**
+   * \brief Write a text fading trace in the binary format
+   *
+   * The binary format is an 8 byte "NS3FADE1" magic, followed by the
+   * number of RBs and the number of samples per RB as 32 bit integers,
+   * and by the samples of each RB in turn as doubles, all in the byte
+   * order of the host.
+   *
+   * \param textFileName the name of the text trace to read
+   * \param binaryFileName the name of the binary trace to write
+   * \param rbNum the number of RBs of the trace
+   * \param samplesNum the number of samples per RB of the trace
+   */
+  static void ConvertTrace (std::string textFileName, std::string binaryFileName,
+                            uint32_t rbNum, uint32_t samplesNum);
+
+private:
+  /// The samples of a trace, shared by the models which load it.
+  class Samples;
+
+  /// The state of the fading channel realization of a (tx, rx) pair.
+  struct Link
+  {
+    Ptr<UniformRandomVariable> startVariable;
+    int windowOffset;
+  };
+  /// A slot of the mobility model to node index table.
+  struct NodeSlot
+  {
+    const MobilityModel *mobility;
+    uint32_t index;
+  };
+  /// A slot of the (tx, rx) node index pair to link index table.
+  struct LinkSlot
+  {
+    // (index of a << 32) | index of b, or EMPTY_KEY
+    uint64_t key;
+    uint32_t index;
+  };
+
+  /**
+   * \param txPsd set of values vs frequency representing the
+   *              transmission power. See SpectrumChannel for details.
+   * \param a sender mobility
+   * \param b receiver mobility
+   * \return set of values vs frequency representing the received
+   *         power in the same units used for the txPsd parameter.
+   */
+  Ptr<SpectrumValue> DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                   Ptr<const MobilityModel> a,
+                                                   Ptr<const MobilityModel> b) const;
+                                                   
+  /**
+  * \brief Get the value for a particular sub channel and a given speed
+  * \param subChannel the sub channel for which a value is requested
+  * \param speed the relative speed of the two devices
+  * \return the loss for a particular sub channel
+  */
+  double GetValue (int subChannel, double speed);
+  
+  void SetTraceFileName (std::string fileName);
+  void SetTraceLength (Time t);
+  
+  void LoadTrace ();
+
+  /**
+   * \returns the index in m_links of the channel realization from a to
+   *          b, which is created if it was never seen before.
+   */
+  uint32_t GetLinkIndex (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) const;
+  /**
+   * \returns the index of this mobility model, which is given the next
+   *          index if it was never seen before.
+   */
+  uint32_t GetNodeIndex (Ptr<const MobilityModel> mobility) const;
+  void GrowNodeSlots (void) const;
+  void GrowLinkSlots (void) const;
+
+  // The links are created by DoCalcRxPowerSpectralDensity, which is const.
+  mutable std::vector<Ptr<const MobilityModel> > m_nodes;
+  mutable std::vector<NodeSlot> m_nodeSlots; //!< power of two sized
+  mutable std::vector<Link> m_links; //!< in creation order
+  mutable std::vector<LinkSlot> m_linkSlots; //!< power of two sized
+
+  std::string m_traceFile;
+
+  Ptr<Samples> m_samples;
+  /// the samples of RB i start at m_fadingTrace + i * m_samplesNum
+  const double *m_fadingTrace;
+
+  
+  Time m_traceLength;
+  uint32_t m_samplesNum;
+  Time m_windowSize;
+  uint8_t m_rbNum;
+  mutable Time m_lastWindowUpdate;
+  uint8_t m_timeGranularity;
+  mutable uint64_t m_currentStream;
+  mutable uint64_t m_lastStream;
+  uint64_t m_streamSetSize;
+  mutable bool m_streamsAssigned;
+  
+};
+
+
+
+} // namespace ns3
+
+#endif /* TRACE_FADING_LOSS_MODEL_H */
@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2006,2007 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage, <mathieu.lacage@sophia.inria.fr>
+ */
+#ifndef YANS_WIFI_CHANNEL_H
+#define YANS_WIFI_CHANNEL_H
+
+#include <vector>
+#include <map>
+#include <set>
+#include <stdint.h>
+#include "ns3/packet.h"
+#include "ns3/vector.h"
+#include "wifi-channel.h"
+#include "wifi-mode.h"
+#include "wifi-preamble.h"
+#include "wifi-tx-vector.h"
+
+namespace ns3 {
+
+class NetDevice;
+class PropagationLossModel;
+class PropagationDelayModel;
+class YansWifiPhy;
+class MobilityModel;
+
+/**
+ * \brief A Yans wifi channel
+ * \ingroup wifi
+ *
+ * This wifi channel implements the propagation model described in
+ * "Yet Another Network Simulator", (http://cutebugs.net/files/wns2-yans.pdf).
+ *
+ * This class is expected to be used in tandem with the ns3::YansWifiPhy
+ * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
+ * By default, no propagation models are set so, it is the caller's responsability
+ * to set them before using the channel.
+ *
+ * By default, every transmission is delivered to every other phy of the
+ * channel. The MaxRange and RxSensitivity attributes make the channel skip
+ * the phys which are too far from the sender or which would receive the
+ * signal below a given power. When MaxRange is set, the SpatialIndex
+ * attribute additionally keeps the phys in a uniform grid of MaxRange-wide
+ * cells, updated when their mobility model reports a course change, so that
+ * Send only visits the phys of the cells around the sender instead of the
+ * whole phy list. The receptions which are not culled are exactly those
+ * of the full loop, scheduled in the same order, but skipped receivers do
+ * not draw from the random variables of random propagation models.
+ */
+class YansWifiChannel : public WifiChannel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  YansWifiChannel ();
+  virtual ~YansWifiChannel ();
+
+  // inherited from Channel.
+  virtual uint32_t GetNDevices (void) const;
+  virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
+
+  /**
+   * Adds the given YansWifiPhy to the PHY list
+   *
+   * \param phy the YansWifiPhy to be added to the PHY list
+   */
+  void Add (Ptr<YansWifiPhy> phy);
+
+  /**
+   * \param loss the new propagation loss model.
+   */
+  void SetPropagationLossModel (Ptr<PropagationLossModel> loss);
+  /**
+   * \param delay the new propagation delay model.
+   */
+  void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
+
+  /**
+   * \param sender the device from which the packet is originating.
+   * \param packet the packet to send
+   * \param txPowerDbm the tx power associated to the packet
+   * \param txVector the TXVECTOR associated to the packet
+   * \param preamble the preamble associated to the packet
+   *
+   * This method should not be invoked by normal users. It is
+   * currently invoked only from WifiPhy::Send. YansWifiChannel
+   * delivers packets only between PHYs with the same m_channelNumber,
+   * e.g. PHYs that are operating on the same channel.
+   */
+  void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
+             WifiTxVector txVector, WifiPreamble preamble) const;
+
+ /**
+  * Assign a fixed random variable stream number to the random variables
+  * used by this model.  Return the number of streams (possibly zero) that
+  * have been assigned.
+  *
+  * \param stream first stream index to use
+  * \return the number of stream indices assigned by this model
+  */
+  int64_t AssignStreams (int64_t stream);
+
+private:
+  //YansWifiChannel& operator = (const YansWifiChannel &);
+  //YansWifiChannel (const YansWifiChannel &);
+
+  /**
+   * A vector of pointers to YansWifiPhy.
+   */
+  typedef std::vector<Ptr<YansWifiPhy> > PhyList;
+  /**
+   * This method is scheduled by Send for each associated YansWifiPhy.
+   * The method then calls the corresponding YansWifiPhy that the first
+   * bit of the packet has arrived.
+   *
+   * \param i index of the corresponding YansWifiPhy in the PHY list
+   * \param packet the packet being sent, shared by all the receivers
+   * \param rxPowerDbm the received power of the packet
+   * \param txVector the TXVECTOR of the packet
+   * \param preamble the type of preamble being used to send the packet
+   */
+  void Receive (uint32_t i, Ptr<const Packet> packet, double rxPowerDbm,
+                WifiTxVector txVector, WifiPreamble preamble) const;
+  /**
+   * Schedule the reception of a packet by the phy at index j of the PHY list,
+   * unless the phy is culled by the MaxRange or RxSensitivity attributes.
+   */
+  void SendTo (uint32_t j, Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility,
+               Ptr<const Packet> packet, double txPowerDbm,
+               WifiTxVector txVector, WifiPreamble preamble) const;
+
+  /// The coordinates of a cell of the spatial index.
+  typedef std::pair<int64_t, int64_t> Cell;
+  struct GridEntry
+  {
+    Ptr<MobilityModel> mobility;
+    Cell cell;
+    bool moving;
+  };
+  virtual void DoDispose (void);
+  Cell GetCell (const Vector &position) const;
+  /**
+   * Add to the spatial index the phys added to the channel since the last
+   * call, or rebuild it if MaxRange changed.
+   */
+  void UpdateGrid (void) const;
+  void ClearGrid (void) const;
+  /**
+   * Move the phy at index i of the PHY list to the cell of its current
+   * position, or to the list of moving phys if it has a non-zero velocity.
+   */
+  void PlacePhy (uint32_t i) const;
+  static void CourseChanged (YansWifiChannel const *channel, uint32_t i,
+                             Ptr<const MobilityModel> mobility);
+
+
+  PhyList m_phyList; //!< List of YansWifiPhys connected to this YansWifiChannel
+  Ptr<PropagationLossModel> m_loss; //!< Propagation loss model
+  Ptr<PropagationDelayModel> m_delay; //!< Propagation delay model
+  double m_maxRange; //!< Receivers further than this are culled, 0 if disabled
+  double m_rxSensitivityDbm; //!< Receivers below this power are culled
+  bool m_spatialIndex; //!< Whether the spatial index is used when m_maxRange is set
+
+  // The spatial index. It is built lazily by Send since phys usually
+  // get their mobility model after they have been added to the channel.
+  mutable std::vector<GridEntry> m_gridEntries; //!< indexed like m_phyList
+  mutable std::map<Cell, std::vector<uint32_t> > m_cells;
+  mutable std::set<uint32_t> m_moving; //!< phys which cannot be kept in a cell
+  mutable double m_cellSize; //!< the value of m_maxRange the grid was built for
+};
+
+} // namespace ns3
+
+
+#endif /* YANS_WIFI_CHANNEL_H */
@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Network topology
+//
+//       n0 ----------- n1
+//            10 Gbps
+//             10 us
+//
+// - nFlows BulkSendApplication flows from n0 to n1, each of which keeps
+//   its send buffer full (4 MB by default), so that the TCP send and
+//   receive buffers hold many application writes and segments.
+// - Prints the goodput of the flows and the wall clock time it took to
+//   simulate them.
+
+#include <iostream>
+#include <iomanip>
+#include "ns3/core-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/network-module.h"
+#include "ns3/packet-sink.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpBulkSendBenchmark");
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nFlows = 4;
+  uint32_t sendSize = 512;
+  uint32_t sndBufSize = 4 << 20;
+  double duration = 1.0;
+  std::string dataRate = "10Gbps";
+  std::string delay = "10us";
+
+  CommandLine cmd;
+  cmd.AddValue ("nFlows", "Number of TCP flows", nFlows);
+  cmd.AddValue ("sendSize", "Size of the application writes", sendSize);
+  cmd.AddValue ("sndBufSize", "TCP send buffer size", sndBufSize);
+  cmd.AddValue ("duration", "Simulated time, in seconds", duration);
+  cmd.AddValue ("dataRate", "Data rate of the link", dataRate);
+  cmd.AddValue ("delay", "Delay of the link", delay);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (sndBufSize));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (65535));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue (dataRate));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue (delay));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer i = ipv4.Assign (devices);
+
+  ApplicationContainer sinkApps;
+  for (uint32_t flow = 0; flow < nFlows; flow++)
+    {
+      uint16_t port = 5000 + flow;
+      BulkSendHelper source ("ns3::TcpSocketFactory",
+                             InetSocketAddress (i.GetAddress (1), port));
+      source.SetAttribute ("SendSize", UintegerValue (sendSize));
+      ApplicationContainer sourceApps = source.Install (nodes.Get (0));
+      sourceApps.Start (Seconds (0.0));
+      sourceApps.Stop (Seconds (duration));
+
+      PacketSinkHelper sink ("ns3::TcpSocketFactory",
+                             InetSocketAddress (Ipv4Address::GetAny (), port));
+      sinkApps.Add (sink.Install (nodes.Get (1)));
+    }
+  sinkApps.Start (Seconds (0.0));
+  sinkApps.Stop (Seconds (duration));
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+  int64_t ms = clock.End ();
+
+  uint64_t totalRx = 0;
+  for (uint32_t flow = 0; flow < nFlows; flow++)
+    {
+      totalRx += DynamicCast<PacketSink> (sinkApps.Get (flow))->GetTotalRx ();
+    }
+  Simulator::Destroy ();
+
+  std::cout << std::fixed << std::setprecision (3)
+            << nFlows << " flows, goodput " << totalRx * 8 / duration / 1e9 << " Gbps, "
+            << ms << " ms wall clock, "
+            << (ms > 0 ? totalRx * 8 / 1e6 / ms : 0) << " simulated Gbps per wall clock second"
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,284 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "bucket-scheduler.h"
+#include "event-impl.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("BucketScheduler");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (BucketScheduler)
+  ;
+
+TypeId
+BucketScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BucketScheduler")
+    .SetParent<Scheduler> ()
+    .AddConstructor<BucketScheduler> ()
+    .AddAttribute ("Buckets",
+                   "The number of buckets of the near-future window (rounded up to a power of two).",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&BucketScheduler::SetBuckets,
+                                         &BucketScheduler::GetBuckets),
+                   MakeUintegerChecker<uint32_t> (1, 1 << 24))
+  ;
+  return tid;
+}
+
+BucketScheduler::BucketScheduler ()
+  : m_nBuckets (0),
+    m_shift (0),
+    m_windowStart (0),
+    m_current (0),
+    m_windowSize (0)
+{
+  NS_LOG_FUNCTION (this);
+  SetBuckets (1024);
+}
+BucketScheduler::~BucketScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+BucketScheduler::SetBuckets (uint32_t nBuckets)
+{
+  NS_LOG_FUNCTION (this << nBuckets);
+  NS_ASSERT_MSG (m_windowSize == 0 && m_overflow.empty (),
+                 "Cannot resize a non-empty BucketScheduler");
+  uint32_t n = 1;
+  while (n < nBuckets)
+    {
+      n <<= 1;
+    }
+  Bucket empty;
+  empty.head = 0;
+  m_buckets.assign (n, empty);
+  m_nBuckets = n;
+  m_current = 0;
+}
+
+uint32_t
+BucketScheduler::GetBuckets (void) const
+{
+  return m_nBuckets;
+}
+
+uint32_t
+BucketScheduler::GetBucketIndex (uint64_t ts) const
+{
+  if (ts < m_windowStart)
+    {
+      return 0;
+    }
+  uint64_t index = (ts - m_windowStart) >> m_shift;
+  if (index >= m_nBuckets)
+    {
+      return m_nBuckets;
+    }
+  return index;
+}
+
+void
+BucketScheduler::BucketInsert (Bucket *bucket, const Event &ev)
+{
+  // Most events are inserted with the largest uid of their bucket
+  // so this loop rarely iterates.
+  std::vector<Scheduler::Event> &events = bucket->events;
+  events.push_back (ev);
+  uint32_t i = events.size () - 1;
+  while (i > bucket->head && ev.key < events[i - 1].key)
+    {
+      events[i] = events[i - 1];
+      i--;
+    }
+  events[i] = ev;
+}
+
+void
+BucketScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  if (m_windowSize == 0 && ev.key.m_ts < m_windowStart)
+    {
+      // the window is empty so it can be moved backward
+      // without violating the ordering with the overflow events.
+      m_windowStart = ev.key.m_ts;
+      m_current = 0;
+    }
+  uint32_t index = GetBucketIndex (ev.key.m_ts);
+  if (index == m_nBuckets)
+    {
+      std::pair<EventMapI,bool> result;
+      result = m_overflow.insert (std::make_pair (ev.key, ev.impl));
+      NS_ASSERT (result.second);
+      return;
+    }
+  if (m_windowSize == 0)
+    {
+      m_current = index;
+    }
+  else if (index < m_current)
+    {
+      // An event earlier than the current bucket: all previous
+      // buckets are empty so keeping it sorted in the current bucket
+      // preserves the ordering.
+      index = m_current;
+    }
+  BucketInsert (&m_buckets[index], ev);
+  m_windowSize++;
+}
+
+bool
+BucketScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_windowSize == 0 && m_overflow.empty ();
+}
+
+Scheduler::Event
+BucketScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (m_windowSize == 0)
+    {
+      EventMapCI i = m_overflow.begin ();
+      NS_ASSERT (i != m_overflow.end ());
+      Event ev;
+      ev.impl = i->second;
+      ev.key = i->first;
+      return ev;
+    }
+  const Bucket &bucket = m_buckets[m_current];
+  NS_ASSERT (bucket.head < bucket.events.size ());
+  return bucket.events[bucket.head];
+}
+
+Scheduler::Event
+BucketScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_windowSize == 0)
+    {
+      Refill ();
+    }
+  Bucket &bucket = m_buckets[m_current];
+  NS_ASSERT (bucket.head < bucket.events.size ());
+  Event ev = bucket.events[bucket.head];
+  bucket.head++;
+  m_windowSize--;
+  Advance ();
+  NS_LOG_DEBUG (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  return ev;
+}
+
+void
+BucketScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint32_t index = GetBucketIndex (ev.key.m_ts);
+  if (index == m_nBuckets)
+    {
+      EventMapI i = m_overflow.find (ev.key);
+      NS_ASSERT (i != m_overflow.end () && i->second == ev.impl);
+      m_overflow.erase (i);
+      return;
+    }
+  if (index < m_current)
+    {
+      index = m_current;
+    }
+  Bucket &bucket = m_buckets[index];
+  std::vector<Scheduler::Event>::iterator i;
+  i = std::lower_bound (bucket.events.begin () + bucket.head, bucket.events.end (), ev);
+  NS_ASSERT (i != bucket.events.end () && i->impl == ev.impl);
+  bucket.events.erase (i);
+  m_windowSize--;
+  Advance ();
+}
+
+void
+BucketScheduler::Advance (void)
+{
+  NS_LOG_FUNCTION (this);
+  Bucket *bucket = &m_buckets[m_current];
+  while (bucket->head == bucket->events.size ())
+    {
+      // recycle the bucket storage: clear does not release memory.
+      bucket->events.clear ();
+      bucket->head = 0;
+      if (m_windowSize == 0)
+        {
+          return;
+        }
+      m_current++;
+      NS_ASSERT (m_current < m_nBuckets);
+      bucket = &m_buckets[m_current];
+    }
+}
+
+void
+BucketScheduler::Refill (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_windowSize == 0);
+  NS_ASSERT (!m_overflow.empty ());
+
+  // Pick the smallest bucket width which makes the window span the
+  // next m_nBuckets overflow events, that is, about one event per bucket.
+  EventMapCI first = m_overflow.begin ();
+  EventMapCI last = first;
+  uint32_t n = 1;
+  for (EventMapCI i = first; i != m_overflow.end () && n <= m_nBuckets; ++i, ++n)
+    {
+      last = i;
+    }
+  uint64_t span = last->first.m_ts - first->first.m_ts;
+  m_shift = 0;
+  while ((span >> m_shift) >= m_nBuckets)
+    {
+      m_shift++;
+    }
+  m_windowStart = first->first.m_ts;
+  m_current = 0;
+  NS_LOG_DEBUG ("window start=" << m_windowStart << ", shift=" << m_shift);
+
+  EventMapI i = m_overflow.begin ();
+  while (i != m_overflow.end ())
+    {
+      uint32_t index = GetBucketIndex (i->first.m_ts);
+      if (index == m_nBuckets)
+        {
+          break;
+        }
+      Scheduler::Event ev;
+      ev.impl = i->second;
+      ev.key = i->first;
+      // overflow events are sorted so this is a plain push_back.
+      BucketInsert (&m_buckets[index], ev);
+      m_windowSize++;
+      m_overflow.erase (i++);
+    }
+  Advance ();
+}
+
+} // namespace ns3
@@ -27,6 +27,8 @@
 #include "log.h"
 
 #include <sstream>
+#include <map>
+#include <vector>
 
 NS_LOG_COMPONENT_DEFINE ("Config");
 
@@ -148,76 +150,80 @@ public:
   ArrayMatcher (std::string element);
   bool Matches (uint32_t i) const;
 private:
+  void Parse (std::string element);
   bool StringToUint32 (std::string str, uint32_t *value) const;
   std::string m_element;
+  bool m_all; //!< true if one of the alternatives is "*"
+  std::vector<std::pair<uint32_t, uint32_t> > m_ranges; //!< the [min, max] ranges of the other alternatives
 };
 
 
 ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
+  : m_element (element),
+    m_all (false)
 {
   NS_LOG_FUNCTION (this << element);
+  Parse (element);
 }
-bool
-ArrayMatcher::Matches (uint32_t i) const
+void
+ArrayMatcher::Parse (std::string element)
 {
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches *");
-      return true;
+      m_all = true;
+      return;
     }
   std::string::size_type tmp;
-  tmp = m_element.find ("|");
+  tmp = element.find ("|");
   if (tmp != std::string::npos)
     {
-      std::string left = m_element.substr (0, tmp-0);
-      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-      return false;
+      std::string left = element.substr (0, tmp-0);
+      std::string right = element.substr (tmp+1, element.size () - (tmp + 1));
+      Parse (left);
+      Parse (right);
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1 &&
       dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
       if (StringToUint32 (lowerBound, &min) && 
-          StringToUint32 (upperBound, &max) &&
-          i >= min && i <= max)
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-          return true;
-        }
-      else
+          StringToUint32 (upperBound, &max))
         {
-          NS_LOG_DEBUG ("Array "<<i<<" does not "<<m_element);
-          return false;
+          m_ranges.push_back (std::make_pair (min, max));
         }
+      return;
     }
   uint32_t value;
-  if (StringToUint32 (m_element, &value) &&
-      i == value)
+  if (StringToUint32 (element, &value))
+    {
+      m_ranges.push_back (std::make_pair (value, value));
+    }
+}
+bool
+ArrayMatcher::Matches (uint32_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  if (m_all)
     {
       NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
       return true;
     }
+  for (uint32_t j = 0; j < m_ranges.size (); j++)
+    {
+      if (i >= m_ranges[j].first && i <= m_ranges[j].second)
+        {
+          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
+          return true;
+        }
+    }
   NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
   return false;
 }
@@ -232,53 +238,156 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
   return !iss.bad () && !iss.fail ();
 }
 
-
-class Resolver
+/**
+ * One element of a configuration path, parsed once so that resolving the
+ * path over many objects does not have to split and parse strings again.
+ */
+class PathSegment
 {
 public:
-  Resolver (std::string path);
-  virtual ~Resolver ();
+  PathSegment (std::string item);
 
-  void Resolve (Ptr<Object> root);
+  /**
+   * An attribute which may lead to more objects: a pointer or a container.
+   */
+  struct Attribute
+  {
+    std::string name;
+    bool container;
+  };
+  /**
+   * \param tid the TypeId of an object
+   * \returns the pointer and container attributes of tid which this
+   * segment names.  The result for the last TypeId is cached, since the
+   * objects matched by a wildcard usually all have the same type.
+   */
+  const std::vector<Attribute> & GetAttributes (TypeId tid) const;
+
+  std::string m_item;
+  bool m_names; //!< the path left starts with "/Names"
+  bool m_getObject; //!< the item is "$tid", a call to GetObject
+  bool m_tidFound; //!< the TypeId of a GetObject item has been looked up
+  TypeId m_tid; //!< the TypeId of a GetObject item
+  ArrayMatcher m_matcher; //!< the matcher of the item, if it follows a container
 private:
-  void Canonicalize (void);
-  void DoResolve (std::string path, Ptr<Object> root);
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
-  void DoResolveOne (Ptr<Object> object);
-  std::string GetResolvedPath (void) const;
-  virtual void DoOne (Ptr<Object> object, std::string path) = 0;
-  std::vector<std::string> m_workStack;
-  std::string m_path;
+  mutable bool m_cached;
+  mutable TypeId m_cachedTid;
+  mutable std::vector<Attribute> m_attributes;
 };
 
-Resolver::Resolver (std::string path)
-  : m_path (path)
+PathSegment::PathSegment (std::string item)
+  : m_item (item),
+    m_names (item.compare (0, 5, "Names") == 0),
+    m_getObject (item.find ("$") == 0),
+    m_tidFound (false),
+    m_matcher (item),
+    m_cached (false)
 {
-  NS_LOG_FUNCTION (this << path);
-  Canonicalize ();
+  NS_LOG_FUNCTION (this << item);
+  if (m_getObject)
+    {
+      // A TypeId which does not exist is reported when the path is
+      // resolved, as it used to be.
+      m_tidFound = TypeId::LookupByNameFailSafe (item.substr (1, item.size () - 1), &m_tid);
+    }
 }
-Resolver::~Resolver ()
+
+const std::vector<PathSegment::Attribute> &
+PathSegment::GetAttributes (TypeId tid) const
 {
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (this << tid);
+  if (m_cached && m_cachedTid == tid)
+    {
+      return m_attributes;
+    }
+  m_attributes.clear ();
+  for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+    {
+      struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+      if (info.name != m_item && m_item != "*")
+        {
+          continue;
+        }
+      Attribute attribute;
+      attribute.name = info.name;
+      if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+        {
+          attribute.container = false;
+          m_attributes.push_back (attribute);
+        }
+      else if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+        {
+          attribute.container = true;
+          m_attributes.push_back (attribute);
+        }
+      // this could be anything else and we don't know what to do with it.
+      // So, we just ignore it.
+    }
+  m_cached = true;
+  m_cachedTid = tid;
+  return m_attributes;
 }
-void
-Resolver::Canonicalize (void)
+
+/**
+ * \param path a configuration path
+ * \returns the segments of the path
+ */
+static std::vector<PathSegment>
+ParseSegments (std::string path)
 {
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (path);
 
   // ensure that we start and end with a '/'
-  std::string::size_type tmp = m_path.find ("/");
+  std::string::size_type tmp = path.find ("/");
   if (tmp != 0)
     {
       // no slash at start
-      m_path = "/" + m_path;
+      path = "/" + path;
     }
-  tmp = m_path.find_last_of ("/");
-  if (tmp != (m_path.size () - 1))
+  tmp = path.find_last_of ("/");
+  if (tmp != (path.size () - 1))
     {
       // no slash at end
-      m_path = m_path + "/";
+      path = path + "/";
+    }
+
+  std::vector<PathSegment> segments;
+  std::string::size_type start = 1;
+  std::string::size_type next;
+  while ((next = path.find ("/", start)) != std::string::npos)
+    {
+      segments.push_back (PathSegment (path.substr (start, next - start)));
+      start = next + 1;
     }
+  return segments;
+}
+
+
+class Resolver
+{
+public:
+  Resolver (const std::vector<PathSegment> &segments);
+  virtual ~Resolver ();
+
+  void Resolve (Ptr<Object> root);
+private:
+  void DoResolve (uint32_t segment, Ptr<Object> root);
+  void DoArrayResolve (uint32_t segment, const ObjectPtrContainerValue &vector);
+  void DoResolveOne (Ptr<Object> object);
+  std::string GetResolvedPath (void) const;
+  virtual void DoOne (Ptr<Object> object, std::string path) = 0;
+  std::vector<std::string> m_workStack;
+  const std::vector<PathSegment> &m_segments;
+};
+
+Resolver::Resolver (const std::vector<PathSegment> &segments)
+  : m_segments (segments)
+{
+  NS_LOG_FUNCTION (this << &segments);
+}
+Resolver::~Resolver ()
+{
+  NS_LOG_FUNCTION (this);
 }
 
 void 
@@ -286,7 +395,7 @@ Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -312,13 +421,11 @@ Resolver::DoResolveOne (Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (uint32_t segment, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << segment << root);
 
-  if (next == std::string::npos)
+  if (segment == m_segments.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name 
@@ -334,8 +441,8 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const PathSegment &current = m_segments[segment];
+  const std::string &item = current.m_item;
 
   //
   // If root is zero, we're beginning to see if we can use the object name 
@@ -346,11 +453,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      if (current.m_names)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (segment + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -367,7 +473,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (segment + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -383,13 +489,12 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       return;
     }
-  std::string::size_type dollarPos = item.find ("$");
-  if (dollarPos == 0)
+  if (current.m_getObject)
     {
       // This is a call to GetObject
       std::string tidString = item.substr (1, item.size () - 1);
       NS_LOG_DEBUG ("GetObject="<<tidString<<" on path="<<GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
+      TypeId tid = current.m_tidFound ? current.m_tid : TypeId::LookupByName (tidString);
       Ptr<Object> object = root->GetObject<Object> (tid);
       if (object == 0)
         {
@@ -397,25 +502,18 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (segment + 1, object);
       m_workStack.pop_back ();
     }
   else 
     {
       // this is a normal attribute.
-      TypeId tid = root->GetInstanceTypeId ();
+      const std::vector<PathSegment::Attribute> &attributes = current.GetAttributes (root->GetInstanceTypeId ());
       bool foundMatch = false;
-      for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+      for (uint32_t i = 0; i < attributes.size (); i++)
         {
-          struct TypeId::AttributeInformation info;
-          info = tid.GetAttribute(i);
-          if (info.name != item && item != "*")
-            {
-              continue;
-            }
-          // attempt to cast to a pointer checker.
-          const PointerChecker *ptr = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-          if (ptr != 0)
+          const PathSegment::Attribute &info = attributes[i];
+          if (!info.container)
             {
               NS_LOG_DEBUG ("GetAttribute(ptr)="<<info.name<<" on path="<<GetResolvedPath ());
               PointerValue ptr;
@@ -430,24 +528,19 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
                 }
               foundMatch = true;
               m_workStack.push_back (info.name);
-              DoResolve (pathLeft, object);
+              DoResolve (segment + 1, object);
               m_workStack.pop_back ();
             }
-          // attempt to cast to an object vector.
-          const ObjectPtrContainerChecker *vectorChecker = 
-            dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-          if (vectorChecker != 0)
+          else
             {
-              NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
+              NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath ());
               foundMatch = true;
               ObjectPtrContainerValue vector;
               root->GetAttribute (info.name, vector);
               m_workStack.push_back (info.name);
-              DoArrayResolve (pathLeft, vector);
+              DoArrayResolve (segment + 1, vector);
               m_workStack.pop_back ();
             }
-          // this could be anything else and we don't know what to do with it.
-          // So, we just ignore it.
         }
       if (!foundMatch)
         {
@@ -458,20 +551,15 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
 }
 
 void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (uint32_t segment, const ObjectPtrContainerValue &container)
 {
-  NS_LOG_FUNCTION(this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION(this << segment << &container);
+  if (segment == m_segments.size ())
     {
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
 
-  ArrayMatcher matcher = ArrayMatcher (item);
+  const ArrayMatcher &matcher = m_segments[segment].m_matcher;
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
@@ -480,7 +568,7 @@ Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &conta
           std::ostringstream oss;
           oss << (*it).first;
           m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
+          DoResolve (segment + 1, (*it).second);
           m_workStack.pop_back ();
         }
     }
@@ -505,8 +593,11 @@ public:
 
 private:
   void ParsePath (std::string path, std::string *root, std::string *leaf) const;
+  const std::vector<PathSegment> & GetSegments (std::string path);
   typedef std::vector<Ptr<Object> > Roots;
   Roots m_roots;
+  typedef std::map<std::string, std::vector<PathSegment> > Paths;
+  Paths m_paths; //!< the paths already parsed, as a trace source is often connected on each of many objects
 };
 
 void 
@@ -570,6 +661,23 @@ ConfigImpl::Disconnect (std::string path, const CallbackBase &cb)
   container.Disconnect (leaf, cb);
 }
 
+const std::vector<PathSegment> &
+ConfigImpl::GetSegments (std::string path)
+{
+  NS_LOG_FUNCTION (this << path);
+  Paths::const_iterator i = m_paths.find (path);
+  if (i != m_paths.end ())
+    {
+      return i->second;
+    }
+  // Keep the cache bounded when many distinct paths are used.
+  if (m_paths.size () >= 1024)
+    {
+      m_paths.clear ();
+    }
+  return m_paths.insert (std::make_pair (path, ParseSegments (path))).first->second;
+}
+
 Config::MatchContainer 
 ConfigImpl::LookupMatches (std::string path)
 {
@@ -577,8 +685,8 @@ ConfigImpl::LookupMatches (std::string path)
   class LookupMatchesResolver : public Resolver 
   {
   public:
-    LookupMatchesResolver (std::string path)
-      : Resolver (path)
+    LookupMatchesResolver (const std::vector<PathSegment> &segments)
+      : Resolver (segments)
     {}
     virtual void DoOne (Ptr<Object> object, std::string path) {
       m_objects.push_back (object);
@@ -586,7 +694,7 @@ ConfigImpl::LookupMatches (std::string path)
     }
     std::vector<Ptr<Object> > m_objects;
     std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
+  } resolver = LookupMatchesResolver (GetSegments (path));
   for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
     {
       resolver.Resolve (*i);
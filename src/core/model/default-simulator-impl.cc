@@ -100,6 +100,8 @@ DefaultSimulatorImpl::Destroy ()
           ev->Invoke ();
         }
     }
+  NS_LOG_INFO ("event pool: hits=" << EventImpl::GetPoolHits () <<
+               ", misses=" << EventImpl::GetPoolMisses ());
 }
 
 void
@@ -20,11 +20,131 @@
 
 #include "event-impl.h"
 #include "log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "system-thread.h"
+#endif
+#include <new>
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
 namespace ns3 {
 
+namespace {
+
+/**
+ * The free lists are indexed by size class: the size of
+ * the blocks of class i is (i + 1) * POOL_GRANULARITY.
+ */
+const size_t POOL_GRANULARITY = 16;
+const size_t POOL_CLASSES = 16;
+/**
+ * Maximum number of blocks kept in each free list. This bounds the
+ * memory retained by a thread which frees events created by another
+ * one, as in the realtime simulator.
+ */
+const uint32_t POOL_MAX_BLOCKS = 4096;
+
+struct FreeBlock
+{
+  FreeBlock *next;
+};
+
+/**
+ * Events can be created and destroyed from several threads
+ * (see RealtimeSimulatorImpl::ScheduleWithContext) so each thread
+ * owns its free lists, which avoids any locking.
+ */
+__thread FreeBlock *g_freeLists[POOL_CLASSES];
+__thread uint32_t g_freeListSizes[POOL_CLASSES];
+__thread uint64_t g_poolHits;
+__thread uint64_t g_poolMisses;
+/**
+ * Whether the free lists of the calling thread are freed when it exits.
+ */
+__thread bool g_freeAtExit;
+
+/**
+ * Free the blocks of the calling thread, which is exiting: the blocks
+ * it frees from now on are not kept.
+ */
+void
+FreePools (void)
+{
+  for (size_t i = 0; i < POOL_CLASSES; i++)
+    {
+      while (g_freeLists[i] != 0)
+        {
+          FreeBlock *block = g_freeLists[i];
+          g_freeLists[i] = block->next;
+          ::operator delete (block);
+        }
+      g_freeListSizes[i] = POOL_MAX_BLOCKS;
+    }
+}
+
+} // anonymous namespace
+
+void *
+EventImpl::operator new (size_t size)
+{
+  size_t sizeClass = (size - 1) / POOL_GRANULARITY;
+  if (sizeClass < POOL_CLASSES)
+    {
+      FreeBlock *block = g_freeLists[sizeClass];
+      if (block != 0)
+        {
+          g_freeLists[sizeClass] = block->next;
+          g_freeListSizes[sizeClass]--;
+          g_poolHits++;
+          return block;
+        }
+      g_poolMisses++;
+      return ::operator new ((sizeClass + 1) * POOL_GRANULARITY);
+    }
+  g_poolMisses++;
+  return ::operator new (size);
+}
+
+void
+EventImpl::operator delete (void *p, size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  size_t sizeClass = (size - 1) / POOL_GRANULARITY;
+  if (sizeClass < POOL_CLASSES
+      && g_freeListSizes[sizeClass] < POOL_MAX_BLOCKS)
+    {
+#ifdef HAVE_PTHREAD_H
+      if (!g_freeAtExit)
+        {
+          g_freeAtExit = true;
+          SystemThread::AtExit (&FreePools);
+        }
+#endif
+      FreeBlock *block = static_cast<FreeBlock *> (p);
+      block->next = g_freeLists[sizeClass];
+      g_freeLists[sizeClass] = block;
+      g_freeListSizes[sizeClass]++;
+      return;
+    }
+  ::operator delete (p);
+}
+
+uint64_t
+EventImpl::GetPoolHits (void)
+{
+  return g_poolHits;
+}
+
+uint64_t
+EventImpl::GetPoolMisses (void)
+{
+  return g_poolMisses;
+}
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
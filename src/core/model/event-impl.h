@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 namespace ns3 {
@@ -35,6 +36,10 @@ namespace ns3 {
  * obviously (there are Ref and Unref methods) reference-counted and
  * most subclasses are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * Events are created and destroyed at a very high rate so the memory
+ * of all subclasses is recycled through per-thread size-class free
+ * lists instead of being returned to the system allocator.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -58,6 +63,31 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * \param size the size of the object to allocate
+   * \returns a block taken from the free list of the size class
+   *          of this object, if any.
+   */
+  static void * operator new (size_t size);
+  /**
+   * \param p the object to release
+   * \param size the size of the object
+   *
+   * The block is kept in the free list of its size class unless
+   * that free list is already full.
+   */
+  static void operator delete (void *p, size_t size);
+  /**
+   * \returns the number of events allocated by the calling thread
+   *          from a free list.
+   */
+  static uint64_t GetPoolHits (void);
+  /**
+   * \returns the number of events allocated by the calling thread
+   *          from the system allocator.
+   */
+  static uint64_t GetPoolMisses (void);
+
 protected:
   virtual void Notify (void) = 0;
 
@@ -22,6 +22,7 @@
 #include "system-thread.h"
 #include "log.h"
 #include <cstring>
+#include <vector>
 
 NS_LOG_COMPONENT_DEFINE ("SystemThread");
 
@@ -93,6 +94,51 @@ SystemThread::Equals (SystemThread::ThreadId id)
   return (pthread_equal (pthread_self (), id) != 0);
 }
 
+namespace {
+
+typedef std::vector<void (*) (void)> AtExitFunctions;
+
+pthread_key_t g_atExitKey;
+pthread_once_t g_atExitOnce = PTHREAD_ONCE_INIT;
+
+void
+RunAtExitFunctions (void *arg)
+{
+  AtExitFunctions *functions = static_cast<AtExitFunctions *> (arg);
+  for (AtExitFunctions::reverse_iterator i = functions->rbegin (); i != functions->rend (); ++i)
+    {
+      (*i)();
+    }
+  delete functions;
+}
+
+void
+CreateAtExitKey (void)
+{
+  int rc = pthread_key_create (&g_atExitKey, &RunAtExitFunctions);
+  if (rc)
+    {
+      NS_FATAL_ERROR ("pthread_key_create failed: " << rc << "=\"" <<
+                      strerror (rc) << "\".");
+    }
+}
+
+} // anonymous namespace
+
+void
+SystemThread::AtExit (void (*f) (void))
+{
+  NS_LOG_FUNCTION (f);
+  pthread_once (&g_atExitOnce, &CreateAtExitKey);
+  AtExitFunctions *functions = static_cast<AtExitFunctions *> (pthread_getspecific (g_atExitKey));
+  if (functions == 0)
+    {
+      functions = new AtExitFunctions ();
+      pthread_setspecific (g_atExitKey, functions);
+    }
+  functions->push_back (f);
+}
+
 #endif /* HAVE_PTHREAD_H */
 
 } // namespace ns3
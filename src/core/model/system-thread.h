@@ -142,6 +142,17 @@ public:
    */
   static bool Equals(ThreadId id);
 
+  /**
+   * @brief Register a function which the calling thread runs when it
+   * exits, e.g. to free its thread-local caches.
+   *
+   * The functions run in the reverse order of their registration. The
+   * main thread does not run them when the program exits.
+   *
+   * @param f The function to run.
+   */
+  static void AtExit (void (*f) (void));
+
 private:
 #ifdef HAVE_PTHREAD_H
   static void *DoRun (void *arg);
@@ -21,7 +21,7 @@
 #ifndef TRACED_CALLBACK_H
 #define TRACED_CALLBACK_H
 
-#include <list>
+#include <vector>
 #include "callback.h"
 
 namespace ns3 {
@@ -89,7 +89,13 @@ public:
   void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const;
 
 private:
-  typedef std::list<Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> > CallbackList;
+  /**
+   * The sinks are kept in a vector: a trace source is fired far more often
+   * than it is connected, and most of them have no sink at all.  The
+   * invocation operators walk it by index, so that a sink may connect
+   * other sinks while it is called.
+   */
+  typedef std::vector<Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> > CallbackList;
   CallbackList m_callbackList;
 };
 
@@ -169,10 +175,13 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (void) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)();
+      return;
+    }
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      m_callbackList[i] ();
     }
 }
 template<typename T1, typename T2, 
@@ -182,10 +191,13 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)(a1);
+      m_callbackList[i] (a1);
     }
 }
 template<typename T1, typename T2, 
@@ -195,10 +207,13 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)(a1, a2);
+      m_callbackList[i] (a1, a2);
     }
 }
 template<typename T1, typename T2, 
@@ -208,10 +223,13 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)(a1, a2, a3);
+      m_callbackList[i] (a1, a2, a3);
     }
 }
 template<typename T1, typename T2, 
@@ -221,10 +239,13 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)(a1, a2, a3, a4);
+      return;
+    }
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      m_callbackList[i] (a1, a2, a3, a4);
     }
 }
 template<typename T1, typename T2, 
@@ -234,10 +255,13 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)(a1, a2, a3, a4, a5);
+      return;
+    }
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      m_callbackList[i] (a1, a2, a3, a4, a5);
     }
 }
 template<typename T1, typename T2, 
@@ -247,10 +271,13 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6);
+      m_callbackList[i] (a1, a2, a3, a4, a5, a6);
     }
 }
 template<typename T1, typename T2, 
@@ -260,10 +287,13 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7);
+      m_callbackList[i] (a1, a2, a3, a4, a5, a6, a7);
     }
 }
 template<typename T1, typename T2, 
@@ -273,10 +303,13 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7, a8);
+      m_callbackList[i] (a1, a2, a3, a4, a5, a6, a7, a8);
     }
 }
 
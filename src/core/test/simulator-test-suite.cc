@@ -19,10 +19,15 @@
  */
 #include "ns3/test.h"
 #include "ns3/simulator.h"
+#include "ns3/event-impl.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/bucket-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/uinteger.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -168,6 +173,132 @@ SimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_destroy, true, "Event should have run");
 }
 
+class SimulatorOrderTestCase : public TestCase
+{
+public:
+  SimulatorOrderTestCase (ObjectFactory schedulerFactory);
+private:
+  virtual void DoRun (void);
+  void Check (uint64_t expected);
+  void ScheduleRandom (void);
+
+  ObjectFactory m_schedulerFactory;
+  Ptr<UniformRandomVariable> m_rng;
+  std::vector<EventId> m_pending;
+  uint64_t m_lastTs;
+  uint32_t m_count;
+  bool m_ordered;
+};
+
+SimulatorOrderTestCase::SimulatorOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that events run in order with cancellations and mixed delays with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+SimulatorOrderTestCase::ScheduleRandom (void)
+{
+  // mostly short delays with many ties, some long timers.
+  uint64_t delay;
+  double u = m_rng->GetValue (0, 1);
+  if (u < 0.8)
+    {
+      delay = m_rng->GetInteger (0, 100);
+    }
+  else if (u < 0.95)
+    {
+      delay = m_rng->GetInteger (0, 100000);
+    }
+  else
+    {
+      delay = m_rng->GetInteger (0, 100000000);
+    }
+  uint64_t ts = Simulator::Now ().GetNanoSeconds () + delay;
+  m_pending.push_back (Simulator::Schedule (NanoSeconds (delay), &SimulatorOrderTestCase::Check, this, ts));
+}
+
+void
+SimulatorOrderTestCase::Check (uint64_t expected)
+{
+  uint64_t now = Simulator::Now ().GetNanoSeconds ();
+  if (now != expected || now < m_lastTs)
+    {
+      m_ordered = false;
+    }
+  m_lastTs = now;
+  m_count++;
+  if (m_count > 20000)
+    {
+      return;
+    }
+  ScheduleRandom ();
+  if (m_rng->GetValue (0, 1) < 0.3)
+    {
+      ScheduleRandom ();
+    }
+  if (m_rng->GetValue (0, 1) < 0.2)
+    {
+      uint32_t i = m_rng->GetInteger (0, m_pending.size () - 1);
+      Simulator::Cancel (m_pending[i]);
+      m_pending[i] = m_pending.back ();
+      m_pending.pop_back ();
+    }
+}
+
+void
+SimulatorOrderTestCase::DoRun (void)
+{
+  Simulator::SetScheduler (m_schedulerFactory);
+  m_rng = CreateObject<UniformRandomVariable> ();
+  m_rng->SetStream (1);
+  m_lastTs = 0;
+  m_count = 0;
+  m_ordered = true;
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      ScheduleRandom ();
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_pending.clear ();
+  NS_TEST_EXPECT_MSG_EQ (m_ordered, true, "Events did not run in timestamp order");
+  NS_TEST_EXPECT_MSG_GT (m_count, 20000, "Some events did not run");
+}
+
+class SimulatorEventPoolTestCase : public TestCase
+{
+public:
+  SimulatorEventPoolTestCase ();
+private:
+  virtual void DoRun (void);
+  void Nop (void) {}
+};
+
+SimulatorEventPoolTestCase::SimulatorEventPoolTestCase ()
+  : TestCase ("Check that the memory of expired events is recycled")
+{
+}
+
+void
+SimulatorEventPoolTestCase::DoRun (void)
+{
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      Simulator::Schedule (NanoSeconds (i), &SimulatorEventPoolTestCase::Nop, this);
+    }
+  Simulator::Run ();
+  uint64_t hits = EventImpl::GetPoolHits ();
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      Simulator::Schedule (NanoSeconds (i), &SimulatorEventPoolTestCase::Nop, this);
+    }
+  NS_TEST_EXPECT_MSG_EQ (EventImpl::GetPoolHits () - hits, 100U, "Events were not allocated from the pool");
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
 class SimulatorTemplateTestCase : public TestCase
 {
 public:
@@ -475,5 +606,19 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (BucketScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (BucketScheduler::GetTypeId ());
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (BucketScheduler::GetTypeId ());
+    factory.Set ("Buckets", UintegerValue (4));
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
+
+    AddTestCase (new SimulatorEventPoolTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -225,6 +225,59 @@ ThreadedSimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_a, m_d, "Bad scheduling");
 }
 
+namespace {
+std::list<int> g_atExitCalls;
+
+void
+AtExitFirst (void)
+{
+  g_atExitCalls.push_back (1);
+}
+
+void
+AtExitSecond (void)
+{
+  g_atExitCalls.push_back (2);
+}
+
+void
+RegisterAtExit (void)
+{
+  SystemThread::AtExit (&AtExitFirst);
+  SystemThread::AtExit (&AtExitSecond);
+  // nothing runs before the thread exits
+  g_atExitCalls.push_back (0);
+}
+} // anonymous namespace
+
+class ThreadAtExitTestCase : public TestCase
+{
+public:
+  ThreadAtExitTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+ThreadAtExitTestCase::ThreadAtExitTestCase ()
+  : TestCase ("Check that a thread runs its exit functions")
+{
+}
+
+void
+ThreadAtExitTestCase::DoRun (void)
+{
+  g_atExitCalls.clear ();
+  Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&RegisterAtExit));
+  thread->Start ();
+  thread->Join ();
+
+  NS_TEST_ASSERT_MSG_EQ (g_atExitCalls.size (), 3U, "Exit functions not run");
+  std::list<int>::const_iterator i = g_atExitCalls.begin ();
+  NS_TEST_EXPECT_MSG_EQ (*i++, 0, "Exit function run before the thread exits");
+  NS_TEST_EXPECT_MSG_EQ (*i++, 2, "Exit functions not run in reverse order");
+  NS_TEST_EXPECT_MSG_EQ (*i++, 1, "Exit functions not run in reverse order");
+}
+
 class ThreadedSimulatorTestSuite : public TestSuite
 {
 public:
@@ -262,5 +315,6 @@ public:
               }
           }
       }
+    AddTestCase (new ThreadAtExitTestCase (), TestCase::QUICK);
   }
 } g_threadedSimulatorTestSuite;
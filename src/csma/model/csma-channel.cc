@@ -222,6 +222,9 @@ CsmaChannel::TransmitEnd ()
 
   NS_LOG_LOGIC ("Receive");
 
+  // All the devices share a single copy of the packet, which they copy
+  // again only if they accept it.
+  Ptr<const Packet> packet = m_currentPkt->Copy ();
   std::vector<CsmaDeviceRec>::iterator it;
   uint32_t devId = 0;
   for (it = m_deviceList.begin (); it < m_deviceList.end (); it++)
@@ -232,7 +235,7 @@ CsmaChannel::TransmitEnd ()
           Simulator::ScheduleWithContext (it->devicePtr->GetNode ()->GetId (),
                                           m_delay,
                                           &CsmaNetDevice::Receive, it->devicePtr,
-                                          m_currentPkt->Copy (), m_deviceList[m_currentSrc].devicePtr);
+                                          packet, m_deviceList[m_currentSrc].devicePtr);
         }
       devId++;
     }
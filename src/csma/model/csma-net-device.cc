@@ -651,10 +651,10 @@ CsmaNetDevice::SetReceiveErrorModel (Ptr<ErrorModel> em)
 }
 
 void
-CsmaNetDevice::Receive (Ptr<Packet> packet, Ptr<CsmaNetDevice> senderDevice)
+CsmaNetDevice::Receive (Ptr<const Packet> received, Ptr<CsmaNetDevice> senderDevice)
 {
-  NS_LOG_FUNCTION (packet << senderDevice);
-  NS_LOG_LOGIC ("UID is " << packet->GetUid ());
+  NS_LOG_FUNCTION (received << senderDevice);
+  NS_LOG_LOGIC ("UID is " << received->GetUid ());
 
   //
   // We never forward up packets that we sent.  Real devices don't do this since
@@ -669,17 +669,23 @@ CsmaNetDevice::Receive (Ptr<Packet> packet, Ptr<CsmaNetDevice> senderDevice)
   // Hit the trace hook.  This trace will fire on all packets received from the
   // channel except those originated by this device.
   //
-  m_phyRxEndTrace (packet);
+  m_phyRxEndTrace (received);
 
   // 
   // Only receive if the send side of net device is enabled
   //
   if (IsReceiveEnabled () == false)
     {
-      m_phyRxDropTrace (packet);
+      m_phyRxDropTrace (received);
       return;
     }
 
+  //
+  // The received packet is shared by all the devices of the channel so we
+  // make our own copy before removing the headers.
+  //
+  Ptr<Packet> packet = received->Copy ();
+
   if (m_receiveErrorModel && m_receiveErrorModel->IsCorrupt (packet) )
     {
       NS_LOG_LOGIC ("Dropping pkt due to error model ");
@@ -689,9 +695,14 @@ CsmaNetDevice::Receive (Ptr<Packet> packet, Ptr<CsmaNetDevice> senderDevice)
 
   //
   // Trace sinks will expect complete packets, not packets without some of the
-  // headers.
+  // headers. Unless the error model had a chance to modify our copy, the
+  // shared packet is such a packet.
   //
-  Ptr<Packet> originalPacket = packet->Copy ();
+  Ptr<const Packet> originalPacket = received;
+  if (m_receiveErrorModel)
+    {
+      originalPacket = packet->Copy ();
+    }
 
   EthernetTrailer trailer;
   packet->RemoveTrailer (trailer);
@@ -157,10 +157,11 @@ public:
    * arrived at the device.
    *
    * \see CsmaChannel
-   * \param p a reference to the received packet
+   * \param p a reference to the received packet, which is shared by all the
+   *        devices of the channel: the device copies it only if it accepts it
    * \param sender the CsmaNetDevice that transmitted the packet in the first place
    */
-  void Receive (Ptr<Packet> p, Ptr<CsmaNetDevice> sender);
+  void Receive (Ptr<const Packet> p, Ptr<CsmaNetDevice> sender);
 
   /**
    * Is the send side of the network device enabled?
@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+//        node 0                          node 1
+//  +----------------+              +----------------+
+//  |    ns-3 UDP    |              |    ns-3 UDP    |
+//  +----------------+              +----------------+
+//  |    10.1.1.1    |              |    10.1.1.2    |
+//  +----------------+  socketpair  +----------------+
+//  |  fd-net-device |--------------|  fd-net-device |
+//  +----------------+              +----------------+
+//
+// This example measures the packet rate that two FdNetDevices connected
+// by a socket pair sustain in real time, with their frames read and
+// written one by one (batchSize=1) or in batches.  Node 0 sends
+// nPackets small UDP packets in bursts of burstSize packets, once a
+// first packet has resolved the MAC address of node 1, and node 1
+// counts those it receives.  The later the last packet is received,
+// the more the devices lagged behind the real time.
+//
+// Steps to run the experiment:
+//
+// $ ./waf --run="realtime-fd2fd-udp-batch --batchSize=1"
+// $ ./waf --run="realtime-fd2fd-udp-batch --batchSize=32"
+//
+
+#include <sys/socket.h>
+#include <errno.h>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/fd-net-device-module.h"
+#include "ns3/applications-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("RealtimeFdNetDeviceUdpBatchExample");
+
+static Time g_lastRx;
+
+static void
+MacRx (Ptr<const Packet> packet)
+{
+  g_lastRx = Simulator::Now ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t batchSize = 32;
+  uint32_t nPackets = 10000;
+  uint32_t burstSize = 100;
+  uint32_t packetSize = 64; // bytes
+  double burstInterval = 0.001; // s
+
+  CommandLine cmd;
+  cmd.AddValue ("batchSize", "BatchSize attribute of the devices", batchSize);
+  cmd.AddValue ("nPackets", "Number of packets to send", nPackets);
+  cmd.AddValue ("burstSize", "Number of packets sent at once", burstSize);
+  cmd.AddValue ("packetSize", "Size of the UDP payloads, in bytes", packetSize);
+  cmd.AddValue ("burstInterval", "Time between the bursts, in seconds", burstInterval);
+  cmd.Parse (argc, argv);
+
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::RealtimeSimulatorImpl"));
+  GlobalValue::Bind ("ChecksumEnabled", BooleanValue (true));
+
+  NS_LOG_INFO ("Create Node");
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  NS_LOG_INFO ("Create Device");
+  FdNetDeviceHelper fd;
+  fd.SetAttribute ("BatchSize", UintegerValue (batchSize));
+  NetDeviceContainer devices = fd.Install (nodes);
+
+  int sv[2];
+  if (socketpair (AF_UNIX, SOCK_DGRAM, 0, sv) < 0)
+    {
+      NS_FATAL_ERROR ("Error creating pipe=" << strerror (errno));
+    }
+  // room for the bursts in the socket buffers
+  int bufferSize = 4 * 1024 * 1024;
+  for (int i = 0; i < 2; i++)
+    {
+      setsockopt (sv[i], SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof (bufferSize));
+      setsockopt (sv[i], SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof (bufferSize));
+    }
+
+  Ptr<FdNetDevice> clientDevice = devices.Get (0)->GetObject<FdNetDevice> ();
+  clientDevice->SetFileDescriptor (sv[0]);
+  Ptr<FdNetDevice> serverDevice = devices.Get (1)->GetObject<FdNetDevice> ();
+  serverDevice->SetFileDescriptor (sv[1]);
+
+  NS_LOG_INFO ("Add Internet Stack");
+  InternetStackHelper internetStackHelper;
+  internetStackHelper.SetIpv4StackInstall (true);
+  internetStackHelper.Install (nodes);
+
+  NS_LOG_INFO ("Create IPv4 Interface");
+  Ipv4AddressHelper addresses;
+  addresses.SetBase ("10.0.0.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = addresses.Assign (devices);
+
+  // server
+  uint16_t port = 9;
+  UdpServerHelper server (port);
+  ApplicationContainer serverApp = server.Install (nodes.Get (1));
+  serverApp.Start (Seconds (0.0));
+
+  // client: one packet for ARP, then the bursts, which are sent by
+  // burstSize clients at the same time
+  uint32_t nBursts = (nPackets + burstSize - 1) / burstSize;
+  UdpClientHelper client (interfaces.GetAddress (1), port);
+  client.SetAttribute ("MaxPackets", UintegerValue (1));
+  client.Install (nodes.Get (0)).Start (Seconds (0.5));
+  client.SetAttribute ("MaxPackets", UintegerValue (nBursts));
+  client.SetAttribute ("Interval", TimeValue (Seconds (burstInterval)));
+  client.SetAttribute ("PacketSize", UintegerValue (packetSize));
+  for (uint32_t i = 0; i < burstSize; i++)
+    {
+      client.Install (nodes.Get (0)).Start (Seconds (1.0));
+    }
+
+  serverDevice->TraceConnectWithoutContext ("MacRx", MakeCallback (&MacRx));
+
+  double stopTime = 2.0 + nBursts * burstInterval;
+  Simulator::Stop (Seconds (stopTime));
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t ms = clock.End ();
+
+  Ptr<UdpServer> udpServer = serverApp.Get (0)->GetObject<UdpServer> ();
+  std::cout << "batchSize " << batchSize << ": " << 1 + nBursts * burstSize << " packets sent from 1 s to "
+            << 1.0 + (nBursts - 1) * burstInterval << " s, " << udpServer->GetReceived ()
+            << " received, the last at " << g_lastRx.GetSeconds () << " s ("
+            << ms << " ms of wall clock time)" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
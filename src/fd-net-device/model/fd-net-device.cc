@@ -39,14 +39,109 @@
 #include <unistd.h>
 #include <arpa/inet.h>
 #include <net/ethernet.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <poll.h>
+#include <errno.h>
+#include <algorithm>
+#include <vector>
 
 NS_LOG_COMPONENT_DEFINE ("FdNetDevice");
 
 namespace ns3 {
 
+namespace {
+
+/**
+ * Order the memory accesses of the read thread and of the simulator
+ * thread around the indices of the ring they share.
+ */
+inline void
+FullBarrier (void)
+{
+  __sync_synchronize ();
+}
+
+bool
+IsSocket (int fd)
+{
+  struct stat st;
+  return fstat (fd, &st) == 0 && S_ISSOCK (st.st_mode);
+}
+
+} // anonymous namespace
+
+/**
+ * The frames are read by the read thread into the slots head, head + 1,
+ * ... of the ring, which only it advances, and forwarded by the simulator
+ * thread from the slots tail, tail + 1, ..., which only it advances: the
+ * indices are free running, and the buffer of a slot is owned by one
+ * thread at a time.
+ */
+struct FdNetDeviceFdReader::Ring
+{
+  Ring (uint32_t batchSize, uint32_t queueSize, uint32_t bufferSize, Callback<void> notify);
+
+  uint32_t m_batchSize;
+  uint32_t m_bufferSize;
+  uint32_t m_mask;                //!< number of slots - 1, a power of two - 1
+  std::vector<uint8_t> m_buffers; //!< m_bufferSize bytes per slot
+  std::vector<ssize_t> m_lens;    //!< the length of the frame of each slot
+  Callback<void> m_notify;
+  int m_isSocket;                 //!< -1 until the first read
+  volatile uint32_t m_head;       //!< written by the read thread only
+  volatile uint32_t m_tail;       //!< written by the simulator thread only
+  volatile uint32_t m_drainPending;
+#ifdef HAVE_RECVMMSG
+  std::vector<struct mmsghdr> m_msgs;
+  std::vector<struct iovec> m_iovs;
+#endif
+};
+
+FdNetDeviceFdReader::Ring::Ring (uint32_t batchSize, uint32_t queueSize, uint32_t bufferSize,
+                                 Callback<void> notify)
+  : m_batchSize (batchSize),
+    m_bufferSize (bufferSize),
+    m_notify (notify),
+    m_isSocket (-1),
+    m_head (0),
+    m_tail (0),
+    m_drainPending (0)
+{
+  uint32_t size = 1;
+  while (size < queueSize || size < batchSize)
+    {
+      size *= 2;
+    }
+  m_mask = size - 1;
+  m_buffers.resize (size * bufferSize);
+  m_lens.resize (size);
+#ifdef HAVE_RECVMMSG
+  m_msgs.resize (batchSize);
+  m_iovs.resize (batchSize);
+#endif
+}
+
 FdNetDeviceFdReader::FdNetDeviceFdReader ()
-  : m_bufferSize (65536) // Defaults to maximum TCP window size
+  : m_bufferSize (65536), // Defaults to maximum TCP window size
+    m_ring (0)
+{
+}
+
+FdNetDeviceFdReader::~FdNetDeviceFdReader ()
 {
+  // the read thread uses the ring until it is joined
+  Stop ();
+  delete m_ring;
+}
+
+void
+FdNetDeviceFdReader::EnableBatching (uint32_t batchSize, uint32_t queueSize, Callback<void> notify)
+{
+  NS_LOG_FUNCTION (this << batchSize << queueSize);
+  NS_ASSERT_MSG (m_ring == 0, "batching already enabled");
+  m_ring = new Ring (batchSize, queueSize, m_bufferSize, notify);
 }
 
 void
@@ -59,6 +154,11 @@ FdReader::Data FdNetDeviceFdReader::DoRead (void)
 {
   NS_LOG_FUNCTION (this);
 
+  if (m_ring != 0)
+    {
+      return DoReadBatch ();
+    }
+
   uint8_t *buf = (uint8_t *)malloc (m_bufferSize);
   NS_ABORT_MSG_IF (buf == 0, "malloc() failed");
 
@@ -74,6 +174,158 @@ FdReader::Data FdNetDeviceFdReader::DoRead (void)
   return FdReader::Data (buf, len);
 }
 
+FdReader::Data
+FdNetDeviceFdReader::DoReadBatch (void)
+{
+  Ring &ring = *m_ring;
+  if (ring.m_isSocket == -1)
+    {
+      ring.m_isSocket = IsSocket (m_fd);
+    }
+
+  uint32_t head = ring.m_head;
+  uint32_t tail = ring.m_tail;
+  FullBarrier ();
+  uint32_t n = std::min (ring.m_mask + 1 - (head - tail), ring.m_batchSize);
+  if (n == 0)
+    {
+      // The ring is full: leave the frames in the file descriptor until
+      // the simulator catches up.
+      struct timespec time = { 0, 1000000L }; // 1 ms
+      nanosleep (&time, NULL);
+      return FdReader::Data (0, -1);
+    }
+
+  uint32_t nRead = 0;
+#ifdef HAVE_RECVMMSG
+  if (ring.m_isSocket)
+    {
+      for (uint32_t i = 0; i < n; i++)
+        {
+          uint32_t slot = (head + i) & ring.m_mask;
+          ring.m_iovs[i].iov_base = &ring.m_buffers[slot * ring.m_bufferSize];
+          ring.m_iovs[i].iov_len = ring.m_bufferSize;
+          memset (&ring.m_msgs[i], 0, sizeof (struct mmsghdr));
+          ring.m_msgs[i].msg_hdr.msg_iov = &ring.m_iovs[i];
+          ring.m_msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+      NS_LOG_LOGIC ("Calling recvmmsg on fd " << m_fd << " for " << n << " frames");
+      // only wait for the first frame
+      int r = recvmmsg (m_fd, &ring.m_msgs[0], n, MSG_WAITFORONE, NULL);
+      if (r <= 0)
+        {
+          return FdReader::Data (0, r < 0 && errno == EINTR ? -1 : 0);
+        }
+      for (int i = 0; i < r; i++)
+        {
+          ring.m_lens[(head + i) & ring.m_mask] = ring.m_msgs[i].msg_len;
+        }
+      nRead = r;
+    }
+  else
+#endif
+    {
+      // read the frames which are already there, one by one
+      struct pollfd pfd;
+      pfd.fd = m_fd;
+      pfd.events = POLLIN;
+      do
+        {
+          uint32_t slot = (head + nRead) & ring.m_mask;
+          NS_LOG_LOGIC ("Calling read on fd " << m_fd);
+          ssize_t len = read (m_fd, &ring.m_buffers[slot * ring.m_bufferSize], ring.m_bufferSize);
+          if (len <= 0)
+            {
+              break;
+            }
+          ring.m_lens[slot] = len;
+          nRead++;
+        }
+      while (nRead < n && poll (&pfd, 1, 0) == 1 && (pfd.revents & POLLIN));
+      if (nRead == 0)
+        {
+          return FdReader::Data (0, 0);
+        }
+    }
+
+  // publish the frames, then make sure that a drain will see them
+  FullBarrier ();
+  ring.m_head = head + nRead;
+  FullBarrier ();
+  if (__sync_bool_compare_and_swap (&ring.m_drainPending, 0, 1))
+    {
+      ring.m_notify ();
+    }
+  return FdReader::Data (0, -1);
+}
+
+uint32_t
+FdNetDeviceFdReader::Drain (Callback<void, const uint8_t *, ssize_t> forward)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_ring != 0);
+  Ring &ring = *m_ring;
+  // the frames published from now on schedule another drain
+  ring.m_drainPending = 0;
+  FullBarrier ();
+  uint32_t head = ring.m_head;
+  FullBarrier ();
+  uint32_t tail = ring.m_tail;
+  uint32_t n = head - tail;
+  for (; tail != head; tail++)
+    {
+      uint32_t slot = tail & ring.m_mask;
+      if (ring.m_lens[slot] > 0)
+        {
+          forward (&ring.m_buffers[slot * ring.m_bufferSize], ring.m_lens[slot]);
+        }
+    }
+  // give the slots back to the read thread
+  FullBarrier ();
+  ring.m_tail = tail;
+  return n;
+}
+
+/**
+ * The frames sent during an event, which are written together once it
+ * is over.  Each frame is copied after room for a PI header.
+ */
+struct FdNetDevice::TxBatch
+{
+  TxBatch (int fd, uint32_t batchSize, uint32_t frameSize);
+
+  uint32_t m_frameSize;
+  uint32_t m_nFrames;
+  std::vector<uint8_t> m_buffers; //!< m_frameSize bytes per frame
+  std::vector<ssize_t> m_lens;
+  std::vector<Ptr<Packet> > m_packets;
+  bool m_isSocket;
+#ifdef HAVE_SENDMMSG
+  std::vector<struct mmsghdr> m_msgs;
+  std::vector<struct iovec> m_iovs;
+#endif
+};
+
+FdNetDevice::TxBatch::TxBatch (int fd, uint32_t batchSize, uint32_t frameSize)
+  : m_frameSize (frameSize),
+    m_nFrames (0),
+    m_buffers (batchSize * frameSize),
+    m_lens (batchSize),
+    m_packets (batchSize),
+    m_isSocket (IsSocket (fd))
+{
+#ifdef HAVE_SENDMMSG
+  m_msgs.resize (batchSize);
+  m_iovs.resize (batchSize);
+  for (uint32_t i = 0; i < batchSize; i++)
+    {
+      memset (&m_msgs[i], 0, sizeof (struct mmsghdr));
+      m_msgs[i].msg_hdr.msg_iov = &m_iovs[i];
+      m_msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+#endif
+}
+
 NS_OBJECT_ENSURE_REGISTERED (FdNetDevice)
   ;
 
@@ -112,6 +364,15 @@ FdNetDevice::GetTypeId (void)
                    UintegerValue (1000),
                    MakeUintegerAccessor (&FdNetDevice::m_maxPendingReads),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("BatchSize", "Maximum number of frames read or written per "
+                   "system call.  Above 1, the frames are read into a ring of "
+                   "RxQueueSize preallocated buffers, which a single event "
+                   "drains of all the frames read meanwhile, and the frames "
+                   "sent during an event are written together after it "
+                   "(with recvmmsg and sendmmsg on sockets, where available).",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&FdNetDevice::m_batchSize),
+                   MakeUintegerChecker<uint32_t> (1))
     //
     // Trace sources at the "top" of the net device, where packets transition
     // to/from higher layers.  These points do not really correspond to the
@@ -157,6 +418,8 @@ FdNetDevice::FdNetDevice ()
     m_isBroadcast (true),
     m_isMulticast (false),
     m_pendingReadCount (0),
+    m_batchSize (1),
+    m_txBatch (0),
     m_startEvent (),
     m_stopEvent ()
 {
@@ -171,6 +434,7 @@ FdNetDevice::FdNetDevice (FdNetDevice const &)
 FdNetDevice::~FdNetDevice ()
 {
   NS_LOG_FUNCTION (this);
+  delete m_txBatch;
 }
 
 void
@@ -232,6 +496,13 @@ FdNetDevice::StartDevice (void)
 
   m_fdReader = Create<FdNetDeviceFdReader> ();
   m_fdReader->SetBufferSize(m_mtu);
+  if (m_batchSize > 1)
+    {
+      m_fdReader->EnableBatching (m_batchSize, m_maxPendingReads,
+                                  MakeCallback (&FdNetDevice::ScheduleDrainRxRing, this));
+      delete m_txBatch;
+      m_txBatch = new TxBatch (m_fd, m_batchSize, m_mtu + 4);
+    }
   m_fdReader->Start (m_fd, MakeCallback (&FdNetDevice::ReceiveCallback, this));
 
   NotifyLinkUp ();
@@ -242,6 +513,14 @@ FdNetDevice::StopDevice (void)
 {
   NS_LOG_FUNCTION (this);
 
+  if (m_txBatch != 0)
+    {
+      Simulator::Cancel (m_txFlushEvent);
+      FlushTxBatch ();
+      delete m_txBatch;
+      m_txBatch = 0;
+    }
+
   if (m_fdReader != 0)
     {
       m_fdReader->Stop ();
@@ -285,17 +564,36 @@ FdNetDevice::ReceiveCallback (uint8_t *buf, ssize_t len)
    }
 }
 
-/// \todo Consider having a instance member m_packetBuffer and using memmove
-///  instead of memcpy to add the PI header.
-///  It might be faster in this case to use memmove and avoid the extra mallocs.
-static void
-AddPIHeader (uint8_t *&buf, ssize_t &len)
+void
+FdNetDevice::ScheduleDrainRxRing (void)
 {
-  // Synthesize PI header for our friend the kernel
-  uint8_t *buf2 = (uint8_t*)malloc (len + 4);
-  memcpy (buf2 + 4, buf, len);
-  len += 4;
+  // This runs in the read thread
+  Simulator::ScheduleWithContext (m_nodeId, Time (0), MakeEvent (&FdNetDevice::DrainRxRing, this));
+}
+
+void
+FdNetDevice::DrainRxRing (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fdReader == 0)
+    {
+      // the device was stopped
+      return;
+    }
+  uint32_t n = m_fdReader->Drain (MakeCallback (&FdNetDevice::ReceiveFrame, this));
+  NS_LOG_LOGIC ("Drained " << n << " frames");
+}
 
+/**
+ * Synthesize the PI header of a frame for our friend the kernel.
+ *
+ * \param pi the 4 bytes of the PI header
+ * \param buf the frame
+ * \param len the length of the frame plus 4
+ */
+static void
+WritePIHeader (uint8_t *pi, const uint8_t *buf, ssize_t len)
+{
   // PI = 16 bits flags (0) + 16 bits proto
   // NOTE: be careful to interpret buffer data explicitly as
   //  little-endian to be insensible to native byte ordering.
@@ -314,26 +612,26 @@ AddPIHeader (uint8_t *&buf, ssize_t &len)
           proto = buf[12] | (buf[13] << 8);
         }
     }
-  buf2[0] = (uint8_t)flags;
-  buf2[1] = (uint8_t)(flags >> 8);
-  buf2[2] = (uint8_t)proto;
-  buf2[3] = (uint8_t)(proto >> 8);
-
-  // swap buffer
-  free (buf);
-  buf = buf2;
+  pi[0] = (uint8_t)flags;
+  pi[1] = (uint8_t)(flags >> 8);
+  pi[2] = (uint8_t)proto;
+  pi[3] = (uint8_t)(proto >> 8);
 }
 
+/// \todo Consider having a instance member m_packetBuffer and using memmove
+///  instead of memcpy to add the PI header.
+///  It might be faster in this case to use memmove and avoid the extra mallocs.
 static void
-RemovePIHeader (uint8_t *&buf, ssize_t &len)
+AddPIHeader (uint8_t *&buf, ssize_t &len)
 {
-  // strip PI header if present, shrink buffer
-  if (len >= 4)
-    {
-      len -= 4;
-      memmove (buf, buf + 4, len);
-      buf = (uint8_t*)realloc (buf, len);
-    }
+  uint8_t *buf2 = (uint8_t*)malloc (len + 4);
+  memcpy (buf2 + 4, buf, len);
+  len += 4;
+  WritePIHeader (buf2, buf, len);
+
+  // swap buffer
+  free (buf);
+  buf = buf2;
 }
 
 void
@@ -349,18 +647,26 @@ FdNetDevice::ForwardUp (uint8_t *buf, ssize_t len)
       }
     }
 
+  ReceiveFrame (buf, len);
+  free (buf);
+}
+
+void
+FdNetDevice::ReceiveFrame (const uint8_t *buf, ssize_t len)
+{
+  NS_LOG_FUNCTION (this << buf << len);
+
   // We need to remove the PI header and ignore it
-  if (m_encapMode == DIXPI)
+  if (m_encapMode == DIXPI && len >= 4)
     {
-      RemovePIHeader (buf, len);
+      buf += 4;
+      len -= 4;
     }
 
   //
-  // Create a packet out of the buffer we received and free that buffer.
+  // Create a packet out of the buffer we received.
   //
-  Ptr<Packet> packet = Create<Packet> (reinterpret_cast<const uint8_t *> (buf), len);
-  free (buf);
-  buf = 0;
+  Ptr<Packet> packet = Create<Packet> (buf, len);
 
   //
   // Trace sinks will expect complete packets, not packets without some of the
@@ -527,6 +833,42 @@ FdNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address& de
 
   NS_ASSERT_MSG (packet->GetSize () <= m_mtu, "FdNetDevice::SendFrom(): Packet too big " << packet->GetSize ());
 
+  if (m_txBatch != 0)
+    {
+      // copy the frame into the batch, which is written after this event
+      TxBatch &batch = *m_txBatch;
+      if (packet->GetSize () > m_mtu)
+        {
+          m_macTxDropTrace (packet);
+          return false;
+        }
+      uint32_t i = batch.m_nFrames++;
+      uint8_t *frame = &batch.m_buffers[i * batch.m_frameSize];
+      ssize_t len = (ssize_t) packet->GetSize ();
+      if (m_encapMode == DIXPI)
+        {
+          packet->CopyData (frame + 4, len);
+          len += 4;
+          WritePIHeader (frame, frame + 4, len);
+        }
+      else
+        {
+          packet->CopyData (frame, len);
+        }
+      batch.m_lens[i] = len;
+      batch.m_packets[i] = packet;
+      if (batch.m_nFrames == batch.m_lens.size ())
+        {
+          Simulator::Cancel (m_txFlushEvent);
+          FlushTxBatch ();
+        }
+      else if (!m_txFlushEvent.IsRunning ())
+        {
+          m_txFlushEvent = Simulator::ScheduleNow (&FdNetDevice::FlushTxBatch, this);
+        }
+      return true;
+    }
+
   ssize_t len =  (ssize_t) packet->GetSize ();
   uint8_t *buffer = (uint8_t*)malloc (len);
   packet->CopyData (buffer, len);
@@ -549,6 +891,66 @@ FdNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address& de
   return true;
 }
 
+void
+FdNetDevice::FlushTxBatch (void)
+{
+  NS_LOG_FUNCTION (this);
+  TxBatch &batch = *m_txBatch;
+  uint32_t n = batch.m_nFrames;
+  uint32_t sent = 0;
+#ifdef HAVE_SENDMMSG
+  if (batch.m_isSocket)
+    {
+      for (uint32_t i = 0; i < n; i++)
+        {
+          uint8_t *frame = &batch.m_buffers[i * batch.m_frameSize];
+          batch.m_iovs[i].iov_base = frame;
+          batch.m_iovs[i].iov_len = batch.m_lens[i];
+        }
+      while (sent < n)
+        {
+          NS_LOG_LOGIC ("calling sendmmsg for " << n - sent << " frames");
+          // The simulator thread must not block here, since it might be
+          // the one that drains the peer of this socket.
+          int r = sendmmsg (m_fd, &batch.m_msgs[sent], n - sent, MSG_DONTWAIT);
+          if (r < 0 && errno == EINTR)
+            {
+              continue;
+            }
+          if (r <= 0)
+            {
+              // the first frame could not be written, go on with the next one
+              m_macTxDropTrace (batch.m_packets[sent]);
+              sent++;
+              continue;
+            }
+          for (uint32_t i = sent; i < sent + r; i++)
+            {
+              if ((ssize_t) batch.m_msgs[i].msg_len != batch.m_lens[i])
+                {
+                  m_macTxDropTrace (batch.m_packets[i]);
+                }
+            }
+          sent += r;
+        }
+    }
+#endif
+  for (; sent < n; sent++)
+    {
+      NS_LOG_LOGIC ("calling write");
+      ssize_t written = write (m_fd, &batch.m_buffers[sent * batch.m_frameSize], batch.m_lens[sent]);
+      if (written == -1 || written != batch.m_lens[sent])
+        {
+          m_macTxDropTrace (batch.m_packets[sent]);
+        }
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      batch.m_packets[i] = 0;
+    }
+  batch.m_nFrames = 0;
+}
+
 void
 FdNetDevice::SetFileDescriptor (int fd)
 {
@@ -48,16 +48,51 @@ public:
    */
   FdNetDeviceFdReader ();
 
+  virtual ~FdNetDeviceFdReader ();
+
   /**
    * Set size of the read buffer.
    *
    */
   void SetBufferSize (uint32_t bufferSize);
 
+  /**
+   * Read frames in batches into a ring of preallocated buffers, instead
+   * of reading each frame into its own buffer and passing it to the read
+   * callback.  Must be called before Start ().
+   *
+   * The read thread reads up to batchSize frames per system call (with
+   * recvmmsg on sockets, where available) and calls notify when the ring
+   * receives frames while no Drain () is pending.  When the ring is full,
+   * the frames are left to the file descriptor until the simulator
+   * drains it.
+   *
+   * \param batchSize the maximum number of frames read at once
+   * \param queueSize the minimum number of frames the ring can hold
+   * \param notify the callback to invoke, from the read thread, to
+   *        schedule a Drain ()
+   */
+  void EnableBatching (uint32_t batchSize, uint32_t queueSize, Callback<void> notify);
+
+  /**
+   * Pass the frames of the ring to the callback, in the order they were
+   * read, and release their buffers.  The callback must not keep the
+   * buffers.  Called by the simulator thread, after notify.
+   *
+   * \param forward the callback to invoke for each frame
+   * \returns the number of frames drained
+   */
+  uint32_t Drain (Callback<void, const uint8_t *, ssize_t> forward);
+
 private:
+  /// The ring between the read thread and the simulator thread.
+  struct Ring;
+
   FdReader::Data DoRead (void);
+  FdReader::Data DoReadBatch (void);
   
   uint32_t m_bufferSize;
+  Ring *m_ring;
 };
 
 class Node;
@@ -205,10 +240,39 @@ private:
   /**
    * \internal
    *
-   * Forward the frame to the appropriate callback for processing
+   * Forward the frame to the appropriate callback for processing, and
+   * free its buffer
    */
   void ForwardUp (uint8_t *buf, ssize_t len);
 
+  /**
+   * \internal
+   *
+   * Forward the frame to the appropriate callback for processing
+   */
+  void ReceiveFrame (const uint8_t *buf, ssize_t len);
+
+  /**
+   * \internal
+   *
+   * Schedule a DrainRxRing, from the read thread (batched mode)
+   */
+  void ScheduleDrainRxRing (void);
+
+  /**
+   * \internal
+   *
+   * Forward the frames read by the read thread (batched mode)
+   */
+  void DrainRxRing (void);
+
+  /**
+   * \internal
+   *
+   * Write the frames queued by SendFrom (batched mode)
+   */
+  void FlushTxBatch (void);
+
   /**
    * Start Sending a Packet Down the Wire.
    * @param p packet to send
@@ -329,6 +393,32 @@ private:
    */
   SystemMutex m_pendingReadMutex;
 
+  /**
+   * \internal
+   *
+   * Maximum number of frames read or written per system call.  With 1,
+   * each frame is read into its own buffer and forwarded by its own event,
+   * and written by its own write ().
+   */
+  uint32_t m_batchSize;
+
+  /// The frames queued for writing.
+  struct TxBatch;
+
+  /**
+   * \internal
+   *
+   * The frames queued for writing, in batched mode.
+   */
+  TxBatch *m_txBatch;
+
+  /**
+   * \internal
+   *
+   * The event writing the queued frames, in batched mode.
+   */
+  EventId m_txFlushEvent;
+
   /**
    * \internal
    *
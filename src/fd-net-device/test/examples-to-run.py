@@ -16,6 +16,7 @@ cpp_examples = [
     ("fd2fd-onoff", "False", "True"),
     ("fd-tap-ping", "False", "True"),
     ("realtime-fd2fd-onoff", "False", "True"),
+    ("realtime-fd2fd-udp-batch", "False", "True"),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
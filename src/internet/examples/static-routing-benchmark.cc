@@ -0,0 +1,202 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measure the forwarding lookups of Ipv4StaticRouting and
+ * Ipv6StaticRouting on a node which, like a PGW or an LMA, holds one
+ * host route per mobile plus a few hundred aggregate prefixes and a
+ * default route. The route count of each run is given by --routes, a
+ * comma separated list.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv6-static-routing.h"
+#include "ns3/ipv6-route.h"
+
+using namespace ns3;
+
+static std::vector<Ptr<SimpleNetDevice> >
+AddDevices (Ptr<Node> node, uint32_t n)
+{
+  std::vector<Ptr<SimpleNetDevice> > devices;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      devices.push_back (device);
+    }
+  return devices;
+}
+
+static void
+RunIpv4 (uint32_t nRoutes, uint32_t nLookups, Ptr<UniformRandomVariable> random)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol> ();
+  Ptr<Ipv4StaticRouting> routing = CreateObject<Ipv4StaticRouting> ();
+  ipv4->SetRoutingProtocol (routing);
+  node->AggregateObject (ipv4);
+  std::vector<Ptr<SimpleNetDevice> > devices = AddDevices (node, 4);
+  for (uint32_t i = 0; i < devices.size (); i++)
+    {
+      uint32_t interface = ipv4->AddInterface (devices[i]);
+      ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address (0xc0a80001 + (i << 8)),
+                                                         Ipv4Mask ("255.255.255.0")));
+      ipv4->SetUp (interface);
+    }
+
+  // mobiles are numbered from 10.0.0.0, and the aggregates cover them /16 by /16
+  SystemWallClockMs time;
+  time.Start ();
+  routing->SetDefaultRoute (Ipv4Address ("192.168.0.254"), 1);
+  for (uint32_t i = 0; i < 256; i++)
+    {
+      routing->AddNetworkRouteTo (Ipv4Address (0x0a000000 | (i << 16)), Ipv4Mask ("255.255.0.0"),
+                                  Ipv4Address ("192.168.1.254"), 2);
+    }
+  for (uint32_t i = 0; i < nRoutes; i++)
+    {
+      routing->AddHostRouteTo (Ipv4Address (0x0a000000 + i), Ipv4Address ("192.168.2.254"), 3);
+    }
+  double insert = time.End ();
+
+  std::vector<Ipv4Header> headers (1024);
+  for (uint32_t i = 0; i < headers.size (); i++)
+    {
+      headers[i].SetDestination (Ipv4Address (0x0a000000 + random->GetInteger (0, 2 * nRoutes)));
+    }
+  Ptr<Packet> packet = Create<Packet> ();
+  Socket::SocketErrno error;
+  uint32_t found = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < nLookups; i++)
+    {
+      found += routing->RouteOutput (packet, headers[i % headers.size ()], 0, error) != 0;
+    }
+  double lookup = time.End ();
+  NS_ABORT_MSG_IF (found != nLookups, "missing route");
+
+  std::cout << std::setw (6) << "IPv4"
+            << std::setw (10) << nRoutes
+            << std::setw (16) << insert * 1e6 / nRoutes
+            << std::setw (16) << lookup * 1e6 / nLookups
+            << std::endl;
+  node->Dispose ();
+}
+
+static void
+RunIpv6 (uint32_t nRoutes, uint32_t nLookups, Ptr<UniformRandomVariable> random)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<Ipv6L3Protocol> ipv6 = CreateObject<Ipv6L3Protocol> ();
+  Ptr<Ipv6StaticRouting> routing = CreateObject<Ipv6StaticRouting> ();
+  ipv6->SetRoutingProtocol (routing);
+  node->AggregateObject (ipv6);
+  std::vector<Ptr<SimpleNetDevice> > devices = AddDevices (node, 4);
+  for (uint32_t i = 0; i < devices.size (); i++)
+    {
+      ipv6->SetUp (ipv6->AddInterface (devices[i]));
+    }
+
+  // mobiles get a /64 each out of 2001:db8::/32, covered by /48 aggregates
+  SystemWallClockMs time;
+  time.Start ();
+  routing->SetDefaultRoute (Ipv6Address ("2001:db8:ffff::1"), 1);
+  for (uint32_t i = 0; i < 256; i++)
+    {
+      uint8_t network[16] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+      network[5] = i;
+      routing->AddNetworkRouteTo (Ipv6Address (network), Ipv6Prefix (48), Ipv6Address ("2001:db8:ffff::2"), 2);
+    }
+  for (uint32_t i = 0; i < nRoutes; i++)
+    {
+      uint8_t network[16] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+      network[5] = (i >> 16) & 0xff;
+      network[6] = (i >> 8) & 0xff;
+      network[7] = i & 0xff;
+      routing->AddNetworkRouteTo (Ipv6Address (network), Ipv6Prefix (64), Ipv6Address ("2001:db8:ffff::3"), 3);
+    }
+  double insert = time.End ();
+
+  std::vector<Ipv6Header> headers (1024);
+  for (uint32_t i = 0; i < headers.size (); i++)
+    {
+      uint32_t mobile = random->GetInteger (0, 2 * nRoutes);
+      uint8_t address[16] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+      address[5] = (mobile >> 16) & 0xff;
+      address[6] = (mobile >> 8) & 0xff;
+      address[7] = mobile & 0xff;
+      headers[i].SetDestinationAddress (Ipv6Address (address));
+    }
+  Ptr<Packet> packet = Create<Packet> ();
+  Socket::SocketErrno error;
+  uint32_t found = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < nLookups; i++)
+    {
+      found += routing->RouteOutput (packet, headers[i % headers.size ()], 0, error) != 0;
+    }
+  double lookup = time.End ();
+  NS_ABORT_MSG_IF (found != nLookups, "missing route");
+
+  std::cout << std::setw (6) << "IPv6"
+            << std::setw (10) << nRoutes
+            << std::setw (16) << insert * 1e6 / nRoutes
+            << std::setw (16) << lookup * 1e6 / nLookups
+            << std::endl;
+  node->Dispose ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string routes = "10000,30000,100000";
+  uint32_t lookups = 1000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("routes", "comma separated list of host route counts", routes);
+  cmd.AddValue ("lookups", "number of lookups timed for each route count", lookups);
+  cmd.Parse (argc, argv);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+
+  std::cout << std::setw (6) << "proto"
+            << std::setw (10) << "routes"
+            << std::setw (16) << "insert (ns)"
+            << std::setw (16) << "lookup (ns)" << std::endl;
+  std::istringstream iss (routes);
+  std::string token;
+  while (std::getline (iss, token, ','))
+    {
+      uint32_t nRoutes = 0;
+      std::istringstream (token) >> nRoutes;
+      RunIpv4 (nRoutes, lookups, random);
+      RunIpv6 (nRoutes, lookups, random);
+    }
+  return 0;
+}
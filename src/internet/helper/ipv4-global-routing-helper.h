@@ -68,6 +68,8 @@ public:
    * All this function does is call the functions
    * BuildGlobalRoutingDatabase () and  InitializeRoutes ().
    *
+   * The shortest path trees of the nodes are computed in parallel by the
+   * number of threads given by the "GlobalRoutingSpfThreads" global value.
    */
   static void PopulateRoutingTables (void);
   /**
@@ -81,6 +83,9 @@ public:
    * Users must first call PopulateRoutingTables() and then may subsequently
    * call RecomputeRoutingTables() at any later time in the simulation.
    *
+   * If the "GlobalRoutingIncrementalSpf" global value is true, only the
+   * routes of the nodes whose shortest path tree may have changed are
+   * removed and added again.
    */
   static void RecomputeRoutingTables (void);
 private:
@@ -35,6 +35,13 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/mpi-interface.h"
+#include "ns3/global-value.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
 #include "global-router-interface.h"
 #include "global-route-manager-impl.h"
 #include "candidate-queue.h"
@@ -44,6 +51,18 @@ NS_LOG_COMPONENT_DEFINE ("GlobalRouteManagerImpl");
 
 namespace ns3 {
 
+static GlobalValue g_spfThreads ("GlobalRoutingSpfThreads",
+                                 "The number of threads among which the SPF calculations "
+                                 "of the routers are split when the routes are computed",
+                                 UintegerValue (1),
+                                 MakeUintegerChecker<uint32_t> (1));
+
+static GlobalValue g_incrementalSpf ("GlobalRoutingIncrementalSpf",
+                                     "If true, only the routers whose routes may have changed "
+                                     "are computed again when the routing tables are recomputed",
+                                     BooleanValue (false),
+                                     MakeBooleanChecker ());
+
 /**
  * \brief Stream insertion operator.
  *
@@ -470,7 +489,31 @@ GlobalRouteManagerLSDB::Insert (Ipv4Address addr, GlobalRoutingLSA* lsa)
     } 
   else
     {
-      m_database.insert (LSDBPair_t (addr, lsa));
+      if (!m_database.insert (LSDBPair_t (addr, lsa)).second)
+        {
+          return;
+        }
+//
+// GetLSAByLinkData () returns the first LSA of the map with a matching
+// TransitNetwork link record, that is, the one with the lowest address.
+//
+      for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+          if (lr->GetLinkType () != GlobalRoutingLinkRecord::TransitNetwork)
+            {
+              continue;
+            }
+          std::map<Ipv4Address, Ipv4Address>::iterator i = m_linkDataIndex.find (lr->GetLinkData ());
+          if (i == m_linkDataIndex.end ())
+            {
+              m_linkDataIndex.insert (std::make_pair (lr->GetLinkData (), addr));
+            }
+          else if (addr < i->second)
+            {
+              i->second = addr;
+            }
+        }
     }
 }
 
@@ -495,13 +538,10 @@ GlobalRouteManagerLSDB::GetLSA (Ipv4Address addr) const
 //
 // Look up an LSA by its address.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  LSDBMap_t::const_iterator i = m_database.find (addr);
+  if (i != m_database.end ())
     {
-      if (i->first == addr)
-        {
-          return i->second;
-        }
+      return i->second;
     }
   return 0;
 }
@@ -511,24 +551,226 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 {
   NS_LOG_FUNCTION (this << addr);
 //
-// Look up an LSA by its address.
+// Look up an LSA by the link data of its TransitNetwork link records.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  std::map<Ipv4Address, Ipv4Address>::const_iterator i = m_linkDataIndex.find (addr);
+  if (i != m_linkDataIndex.end ())
     {
-      GlobalRoutingLSA* temp = i->second;
-// Iterate among temp's Link Records
-      for (uint32_t j = 0; j < temp->GetNLinkRecords (); j++)
+      return GetLSA (i->second);
+    }
+  return 0;
+}
+
+GlobalRouteManagerLSDB*
+GlobalRouteManagerLSDB::Copy () const
+{
+  NS_LOG_FUNCTION (this);
+  GlobalRouteManagerLSDB *lsdb = new GlobalRouteManagerLSDB ();
+  for (LSDBMap_t::const_iterator i = m_database.begin (); i != m_database.end (); i++)
+    {
+      lsdb->Insert (i->first, new GlobalRoutingLSA (*i->second));
+    }
+  for (uint32_t j = 0; j < m_extdatabase.size (); j++)
+    {
+      GlobalRoutingLSA *lsa = new GlobalRoutingLSA (*m_extdatabase[j]);
+      lsdb->Insert (lsa->GetLinkStateId (), lsa);
+    }
+  return lsdb;
+}
+
+//
+// Compare the contents of two LSAs, ignoring their SPF status.
+//
+static bool
+IsSameLSA (GlobalRoutingLSA *a, GlobalRoutingLSA *b)
+{
+  if (a->GetLSType () != b->GetLSType ()
+      || a->GetLinkStateId () != b->GetLinkStateId ()
+      || a->GetAdvertisingRouter () != b->GetAdvertisingRouter ()
+      || a->GetNetworkLSANetworkMask () != b->GetNetworkLSANetworkMask ()
+      || a->GetNLinkRecords () != b->GetNLinkRecords ()
+      || a->GetNAttachedRouters () != b->GetNAttachedRouters ())
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < a->GetNLinkRecords (); i++)
+    {
+      GlobalRoutingLinkRecord *la = a->GetLinkRecord (i);
+      GlobalRoutingLinkRecord *lb = b->GetLinkRecord (i);
+      if (la->GetLinkType () != lb->GetLinkType ()
+          || la->GetLinkId () != lb->GetLinkId ()
+          || la->GetLinkData () != lb->GetLinkData ()
+          || la->GetMetric () != lb->GetMetric ())
+        {
+          return false;
+        }
+    }
+  for (uint32_t i = 0; i < a->GetNAttachedRouters (); i++)
+    {
+      if (a->GetAttachedRouter (i) != b->GetAttachedRouter (i))
         {
-          GlobalRoutingLinkRecord *lr = temp->GetLinkRecord (j);
-          if ( lr->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork &&
-               lr->GetLinkData () == addr)
+          return false;
+        }
+    }
+  return true;
+}
+
+//
+// Add the link data of the TransitNetwork link records of an LSA, which
+// GetLSAByLinkData () looks up, to a set.
+//
+static void
+AddTransitLinkData (GlobalRoutingLSA *lsa, std::set<Ipv4Address> &linkData)
+{
+  for (uint32_t i = 0; i < lsa->GetNLinkRecords (); i++)
+    {
+      GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (i);
+      if (lr->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork)
+        {
+          linkData.insert (lr->GetLinkData ());
+        }
+    }
+}
+
+bool
+GlobalRouteManagerLSDB::GetChangedRouters (const GlobalRouteManagerLSDB& old,
+                                           std::set<Ipv4Address>& routers) const
+{
+  NS_LOG_FUNCTION (this << &old);
+//
+// Every SPF calculation processes all of the External LSAs.
+//
+  if (m_extdatabase.size () != old.m_extdatabase.size ())
+    {
+      return true;
+    }
+  for (uint32_t j = 0; j < m_extdatabase.size (); j++)
+    {
+      if (!IsSameLSA (m_extdatabase[j], old.m_extdatabase[j]))
+        {
+          return true;
+        }
+    }
+//
+// Walk both maps in order to find the LSAs which have been added, removed
+// or modified, and the link data which GetLSAByLinkData () may not resolve
+// to the same LSA any more.
+//
+  std::set<Ipv4Address> changedIds;
+  std::set<Ipv4Address> changedLinkData;
+  LSDBMap_t::const_iterator i = m_database.begin ();
+  LSDBMap_t::const_iterator j = old.m_database.begin ();
+  while (i != m_database.end () || j != old.m_database.end ())
+    {
+      if (j == old.m_database.end () || (i != m_database.end () && i->first < j->first))
+        {
+          NS_LOG_LOGIC ("Added LSA " << i->first);
+          changedIds.insert (i->first);
+          AddTransitLinkData (i->second, changedLinkData);
+          if (i->second->GetLSType () == GlobalRoutingLSA::RouterLSA)
+            {
+              routers.insert (i->first);
+            }
+          i++;
+        }
+      else if (i == m_database.end () || j->first < i->first)
+        {
+          NS_LOG_LOGIC ("Removed LSA " << j->first);
+          changedIds.insert (j->first);
+          AddTransitLinkData (j->second, changedLinkData);
+          j++;
+        }
+      else
+        {
+          if (!IsSameLSA (i->second, j->second))
             {
-              return temp;
+              NS_LOG_LOGIC ("Modified LSA " << i->first);
+              changedIds.insert (i->first);
+              AddTransitLinkData (i->second, changedLinkData);
+              AddTransitLinkData (j->second, changedLinkData);
             }
+          i++;
+          j++;
         }
     }
-  return 0;
+  if (changedIds.empty ())
+    {
+      return false;
+    }
+//
+// The SPF calculation of a router reads the LSAs which SPFNext () looks up
+// from the LSAs already in the tree, starting from its own.  Record, for
+// each LSA of the old database, which LSAs look it up, and mark the LSAs
+// whose processing reads something which has changed.
+//
+  std::map<Ipv4Address, std::vector<Ipv4Address> > readers;
+  std::set<Ipv4Address> dirty;
+  std::vector<Ipv4Address> pending;
+  for (j = old.m_database.begin (); j != old.m_database.end (); j++)
+    {
+      GlobalRoutingLSA *lsa = j->second;
+      bool changed = changedIds.find (j->first) != changedIds.end ();
+      if (lsa->GetLSType () == GlobalRoutingLSA::RouterLSA)
+        {
+          for (uint32_t k = 0; k < lsa->GetNLinkRecords (); k++)
+            {
+              GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (k);
+              if (lr->GetLinkType () == GlobalRoutingLinkRecord::PointToPoint
+                  || lr->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork)
+                {
+                  readers[lr->GetLinkId ()].push_back (j->first);
+                  changed = changed || changedIds.find (lr->GetLinkId ()) != changedIds.end ();
+                }
+            }
+        }
+      else if (lsa->GetLSType () == GlobalRoutingLSA::NetworkLSA)
+        {
+          for (uint32_t k = 0; k < lsa->GetNAttachedRouters (); k++)
+            {
+              Ipv4Address attached = lsa->GetAttachedRouter (k);
+              GlobalRoutingLSA *w = old.GetLSAByLinkData (attached);
+              if (w)
+                {
+                  readers[w->GetLinkStateId ()].push_back (j->first);
+                }
+              changed = changed || changedLinkData.find (attached) != changedLinkData.end ();
+            }
+        }
+      if (changed && dirty.insert (j->first).second)
+        {
+          pending.push_back (j->first);
+        }
+    }
+//
+// Then propagate the marks backwards: an LSA which looks up a marked LSA
+// is marked too.  The marked router LSAs are the routers to recompute.
+//
+  while (!pending.empty ())
+    {
+      Ipv4Address id = pending.back ();
+      pending.pop_back ();
+      std::map<Ipv4Address, std::vector<Ipv4Address> >::const_iterator r = readers.find (id);
+      if (r == readers.end ())
+        {
+          continue;
+        }
+      for (uint32_t k = 0; k < r->second.size (); k++)
+        {
+          if (dirty.insert (r->second[k]).second)
+            {
+              pending.push_back (r->second[k]);
+            }
+        }
+    }
+  for (std::set<Ipv4Address>::const_iterator d = dirty.begin (); d != dirty.end (); d++)
+    {
+      if (old.GetLSA (*d)->GetLSType () == GlobalRoutingLSA::RouterLSA)
+        {
+          routers.insert (*d);
+        }
+    }
+  NS_LOG_LOGIC (changedIds.size () << " changed LSAs, " << routers.size () << " routers to recompute");
+  return false;
 }
 
 // ---------------------------------------------------------------------------
@@ -539,7 +781,8 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 
 GlobalRouteManagerImpl::GlobalRouteManagerImpl () 
   :
-    m_spfroot (0)
+    m_spfroot (0),
+    m_lsdbInUse (false)
 {
   NS_LOG_FUNCTION (this);
   m_lsdb = new GlobalRouteManagerLSDB ();
@@ -563,6 +806,7 @@ GlobalRouteManagerImpl::DebugUseLsdb (GlobalRouteManagerLSDB* lsdb)
       delete m_lsdb;
     }
   m_lsdb = lsdb;
+  m_lsdbInUse = false;
 }
 
 void
@@ -572,25 +816,7 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes ()
   NodeList::Iterator listEnd = NodeList::End ();
   for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
     {
-      Ptr<Node> node = *i;
-      Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-      if (router == 0)
-        {
-          continue;
-        }
-      Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-      uint32_t j = 0;
-      uint32_t nRoutes = gr->GetNRoutes ();
-      NS_LOG_LOGIC ("Deleting " << gr->GetNRoutes ()<< " routes from node " << node->GetId ());
-      // Each time we delete route 0, the route index shifts downward
-      // We can delete all routes if we delete the route numbered 0
-      // nRoutes times
-      for (j = 0; j < nRoutes; j++)
-        {
-          NS_LOG_LOGIC ("Deleting global route " << j << " from node " << node->GetId ());
-          gr->RemoveRoute (0);
-        }
-      NS_LOG_LOGIC ("Deleted " << j << " global routes from node "<< node->GetId ());
+      DeleteRoutes (*i);
     }
   if (m_lsdb)
     {
@@ -598,6 +824,31 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes ()
       delete m_lsdb;
       m_lsdb = new GlobalRouteManagerLSDB ();
     }
+  m_lsdbInUse = false;
+}
+
+void
+GlobalRouteManagerImpl::DeleteRoutes (Ptr<Node> node)
+{
+  NS_LOG_FUNCTION (this << node);
+  Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
+  if (router == 0)
+    {
+      return;
+    }
+  Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
+  uint32_t j = 0;
+  uint32_t nRoutes = gr->GetNRoutes ();
+  NS_LOG_LOGIC ("Deleting " << gr->GetNRoutes ()<< " routes from node " << node->GetId ());
+  // Each time we delete route 0, the route index shifts downward
+  // We can delete all routes if we delete the route numbered 0
+  // nRoutes times
+  for (j = 0; j < nRoutes; j++)
+    {
+      NS_LOG_LOGIC ("Deleting global route " << j << " from node " << node->GetId ());
+      gr->RemoveRoute (0);
+    }
+  NS_LOG_LOGIC ("Deleted " << j << " global routes from node "<< node->GetId ());
 }
 
 //
@@ -712,8 +963,10 @@ GlobalRouteManagerImpl::InitializeRoutes ()
         node->GetObject<GlobalRouter> ();
 
       uint32_t systemId = MpiInterface::GetSystemId ();
-      // Ignore nodes that are not assigned to our systemId (distributed sim)
-      if (node->GetSystemId () != systemId) 
+      // Ignore nodes that are not assigned to our systemId (distributed sim).
+      // Without MPI, all the nodes belong to this process, whatever their
+      // systemId (see MultithreadedSimulatorImpl).
+      if (MpiInterface::IsEnabled () && node->GetSystemId () != systemId) 
         {
           continue;
         }
@@ -724,12 +977,138 @@ GlobalRouteManagerImpl::InitializeRoutes ()
 //
       if (rtr && rtr->GetNumLSAs () )
         {
-          SPFCalculate (rtr->GetRouterId ());
+          m_spfRoots.push_back (SPFRoot_t (rtr->GetRouterId (), node));
+        }
+    }
+  SPFCalculateRoots ();
+  m_lsdbInUse = true;
+  NS_LOG_INFO ("Finished SPF calculation");
+}
+
+void
+GlobalRouteManagerImpl::RecomputeRoutingTables ()
+{
+  NS_LOG_FUNCTION (this);
+  BooleanValue incremental;
+  g_incrementalSpf.GetValue (incremental);
+  if (!incremental.Get () || !m_lsdbInUse)
+    {
+      DeleteGlobalRoutes ();
+      BuildGlobalRoutingDatabase ();
+      InitializeRoutes ();
+      return;
+    }
+//
+// Build the new database next to the one from which the current routes
+// were computed, and find the routers whose SPF calculation reads an LSA
+// which has changed.
+//
+  GlobalRouteManagerLSDB *old = m_lsdb;
+  m_lsdb = new GlobalRouteManagerLSDB ();
+  BuildGlobalRoutingDatabase ();
+  std::set<Ipv4Address> routers;
+  bool all = m_lsdb->GetChangedRouters (*old, routers);
+  delete old;
+//
+// Only the routes of these routers are deleted and computed again; the
+// other routers would get the same routes, in the same order.
+//
+  uint32_t systemId = MpiInterface::GetSystemId ();
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<Node> node = *i;
+      Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter> ();
+      if (rtr == 0
+          || (!all && routers.find (rtr->GetRouterId ()) == routers.end ()))
+        {
+          continue;
+        }
+      DeleteRoutes (node);
+      if ((!MpiInterface::IsEnabled () || node->GetSystemId () == systemId)
+          && rtr->GetNumLSAs ())
+        {
+          m_spfRoots.push_back (SPFRoot_t (rtr->GetRouterId (), node));
         }
     }
+  NS_LOG_INFO ("About to recompute the routes of " << m_spfRoots.size () << " routers");
+  SPFCalculateRoots ();
   NS_LOG_INFO ("Finished SPF calculation");
 }
 
+void
+GlobalRouteManagerImpl::SPFCalculateRoots (void)
+{
+  NS_LOG_FUNCTION (this);
+  UintegerValue spfThreads;
+  g_spfThreads.GetValue (spfThreads);
+  uint32_t nThreads = std::min<uint32_t> (spfThreads.Get (), m_spfRoots.size ());
+#ifdef HAVE_PTHREAD_H
+  if (nThreads > 1)
+    {
+//
+// Each worker gets its own copy of the LSDB, since the SPF calculation
+// marks the LSAs, and every nThreads-th root.  The nodes and their
+// routing protocols are only touched by the worker which owns their root.
+//
+      NS_LOG_INFO ("Splitting " << m_spfRoots.size () << " SPF calculations among " << nThreads << " threads");
+      std::vector<GlobalRouteManagerImpl *> workers;
+      std::vector<Ptr<SystemThread> > threads;
+      for (uint32_t i = 0; i < nThreads; i++)
+        {
+          GlobalRouteManagerImpl *worker = new GlobalRouteManagerImpl ();
+          delete worker->m_lsdb;
+          worker->m_lsdb = m_lsdb->Copy ();
+          for (uint32_t j = i; j < m_spfRoots.size (); j += nThreads)
+            {
+              worker->m_spfRoots.push_back (m_spfRoots[j]);
+            }
+          workers.push_back (worker);
+        }
+      m_spfRoots.clear ();
+      for (uint32_t i = 0; i < nThreads; i++)
+        {
+          threads.push_back (Create<SystemThread> (MakeCallback (&GlobalRouteManagerImpl::DoSPFCalculateRoots,
+                                                                 workers[i])));
+          threads[i]->Start ();
+        }
+      for (uint32_t i = 0; i < nThreads; i++)
+        {
+          threads[i]->Join ();
+          delete workers[i];
+        }
+      return;
+    }
+#endif /* HAVE_PTHREAD_H */
+  DoSPFCalculateRoots ();
+}
+
+void
+GlobalRouteManagerImpl::DoSPFCalculateRoots (void)
+{
+  for (uint32_t i = 0; i < m_spfRoots.size (); i++)
+    {
+      SPFCalculate (m_spfRoots[i].first, m_spfRoots[i].second);
+    }
+  m_spfRoots.clear ();
+}
+
+Ptr<Node>
+GlobalRouteManagerImpl::FindRouterNode (Ipv4Address routerId) const
+{
+  NS_LOG_FUNCTION (this << routerId);
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter> ();
+      if (rtr != 0 && rtr->GetRouterId () == routerId)
+        {
+          return *i;
+        }
+    }
+  return 0;
+}
+
 //
 // This method is derived from quagga ospf_spf_next ().  See RFC2328 Section 
 // 16.1 (2) for further details.
@@ -1320,11 +1699,7 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
               if (lr->GetLinkId () == myRouterId)
                 {
                   // Next hop is stored in the LinkID field of lr
-                  Ptr<GlobalRouter> router = rlsa->GetNode ()->GetObject<GlobalRouter> ();
-                  NS_ASSERT (router);
-                  Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-                  NS_ASSERT (gr);
-                  gr->AddNetworkRouteTo (Ipv4Address ("0.0.0.0"), Ipv4Mask ("0.0.0.0"), lr->GetLinkData (), 
+                  m_spfrootRouting->AddNetworkRouteTo (Ipv4Address ("0.0.0.0"), Ipv4Mask ("0.0.0.0"), lr->GetLinkData (), 
                                          FindOutgoingInterfaceId (transitLink->GetLinkData ()));
                   NS_LOG_LOGIC ("Inserting default route for node " << myRouterId << " to next hop " << 
                                 lr->GetLinkData () << " via interface " << 
@@ -1337,14 +1712,36 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
   return false;
 }
 
-// quagga ospf_spf_calculate
 void
 GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 {
   NS_LOG_FUNCTION (this << root);
+  SPFCalculate (root, FindRouterNode (root));
+}
+
+// quagga ospf_spf_calculate
+void
+GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root, Ptr<Node> node)
+{
+  NS_LOG_FUNCTION (this << root << node);
 
   SPFVertex *v;
 //
+// Look up once the objects of the node for which we are building the
+// routing table.  This is the node with the router ID of the root; if
+// there is none, the tree is computed but no route is added.
+//
+  m_spfrootNode = node;
+  if (node != 0)
+    {
+      m_spfrootIpv4 = node->GetObject<Ipv4> ();
+      NS_ASSERT_MSG (m_spfrootIpv4,
+                     "GlobalRouteManagerImpl::SPFCalculate (): "
+                     "GetObject for <Ipv4> interface failed");
+      m_spfrootRouting = node->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      NS_ASSERT (m_spfrootRouting);
+    }
+//
 // Initialize the Link State Database.
 //
   m_lsdb->Initialize ();
@@ -1377,10 +1774,14 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 // reached.  Instead, short-circuit this computation and just install
 // a default route in the CheckForStubNode() method.
 //
-  if (NodeList::GetNNodes () > 0 && CheckForStubNode (root))
+  if (m_spfrootNode != 0 && CheckForStubNode (root))
     {
       NS_LOG_LOGIC ("SPFCalculate truncated for stub node " << root);
       delete m_spfroot;
+      m_spfroot = 0;
+      m_spfrootNode = 0;
+      m_spfrootIpv4 = 0;
+      m_spfrootRouting = 0;
       return;
     }
 
@@ -1502,6 +1903,9 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 //
   delete m_spfroot;
   m_spfroot = 0;
+  m_spfrootNode = 0;
+  m_spfrootIpv4 = 0;
+  m_spfrootRouting = 0;
 }
 
 void
@@ -1556,62 +1960,31 @@ GlobalRouteManagerImpl::SPFAddASExternal (GlobalRoutingLSA *extlsa, SPFVertex *v
   NS_LOG_LOGIC ("External is on remote host: " 
                 << extlsa->GetAdvertisingRouter () << "; installing");
 
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
+  NS_LOG_LOGIC ("Vertex ID = " << m_spfroot->GetVertexId ());
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// The node that has the router ID corresponding to the root vertex, which
+// SPFCalculate () has looked up, is the one we're going to write the routing
+// information to.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  if (m_spfrootNode == 0)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to QI for that interface.  If there's no GlobalRouter interface, the node
-// in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to QI
-// for that interface.  If the node is acting as an IP version 4 router, it
-// should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "QI for <Ipv4> interface failed");
+      NS_LOG_LOGIC ("Can't find root node " << m_spfroot->GetVertexId ());
+      return;
+    }
+  Ptr<Node> node = m_spfrootNode;
+  NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
 //
 // Get the Global Router Link State Advertisement from the vertex we're
 // adding the routes to.  The LSA will have a number of attached Global Router
 // Link Records corresponding to links off of that vertex / node.  We're going
 // to be interested in the records corresponding to point-to-point links.
 //
-          NS_ASSERT_MSG (v->GetLSA (), 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask ();
-          Ipv4Address tempip = extlsa->GetLinkStateId ();
-          tempip = tempip.CombineMask (tempmask);
+  NS_ASSERT_MSG (v->GetLSA (), 
+                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask ();
+  Ipv4Address tempip = extlsa->GetLinkStateId ();
+  tempip = tempip.CombineMask (tempmask);
 
 //
 // Here's why we did all of that work.  We're going to add a host route to the
@@ -1626,39 +1999,30 @@ GlobalRouteManagerImpl::SPFAddASExternal (GlobalRoutingLSA *extlsa, SPFVertex *v
 // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
 // which the packets should be send for forwarding.
 //
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all next-hop-IPs and out-going-interfaces for reaching
-          // the stub network gateway 'v' from the root node
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-              if (outIf >= 0)
-                {
-                  gr->AddASExternalRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add external network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative");
-                }
-            }
-          return;
-        } // if
-    } // for
+  Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+  // walk through all next-hop-IPs and out-going-interfaces for reaching
+  // the stub network gateway 'v' from the root node
+  for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+    {
+      SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
+      if (outIf >= 0)
+        {
+          gr->AddASExternalRouteTo (tempip, tempmask, nextHop, outIf);
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
+                        " add external network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
+        }
+      else
+        {
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
+                        " NOT able to add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative");
+        }
+    }
 }
 
 
@@ -1725,64 +2089,31 @@ GlobalRouteManagerImpl::SPFIntraAddStub (GlobalRoutingLinkRecord *l, SPFVertex*
 // going to use this ID to discover which node it is that we're actually going
 // to update.
 //
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
+  NS_LOG_LOGIC ("Vertex ID = " << m_spfroot->GetVertexId ());
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// The node that has the router ID corresponding to the root vertex, which
+// SPFCalculate () has looked up, is the one we're going to write the routing
+// information to.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  if (m_spfrootNode == 0)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to QI for that interface.  If there's no GlobalRouter interface, the node
-// in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to QI
-// for that interface.  If the node is acting as an IP version 4 router, it
-// should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "QI for <Ipv4> interface failed");
+      NS_LOG_LOGIC ("Can't find root node " << m_spfroot->GetVertexId ());
+      return;
+    }
+  Ptr<Node> node = m_spfrootNode;
+  NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
 //
 // Get the Global Router Link State Advertisement from the vertex we're
 // adding the routes to.  The LSA will have a number of attached Global Router
 // Link Records corresponding to links off of that vertex / node.  We're going
 // to be interested in the records corresponding to point-to-point links.
 //
-          NS_ASSERT_MSG (v->GetLSA (), 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask (l->GetLinkData ().Get ());
-          Ipv4Address tempip = l->GetLinkId ();
-          tempip = tempip.CombineMask (tempmask);
+  NS_ASSERT_MSG (v->GetLSA (), 
+                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask (l->GetLinkData ().Get ());
+  Ipv4Address tempip = l->GetLinkId ();
+  tempip = tempip.CombineMask (tempmask);
 //
 // Here's why we did all of that work.  We're going to add a host route to the
 // host address found in the m_linkData field of the point-to-point link
@@ -1796,40 +2127,30 @@ GlobalRouteManagerImpl::SPFIntraAddStub (GlobalRoutingLinkRecord *l, SPFVertex*
 // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
 // which the packets should be send for forwarding.
 //
-
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all next-hop-IPs and out-going-interfaces for reaching
-          // the stub network gateway 'v' from the root node
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-              if (outIf >= 0)
-                {
-                  gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative");
-                }
-            }
-          return;
-        } // if
-    } // for
+  Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+  // walk through all next-hop-IPs and out-going-interfaces for reaching
+  // the stub network gateway 'v' from the root node
+  for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+    {
+      SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
+      if (outIf >= 0)
+        {
+          gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
+                        " add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
+        }
+      else
+        {
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
+                        " NOT able to add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative");
+        }
+    }
 }
 
 //
@@ -1851,63 +2172,31 @@ GlobalRouteManagerImpl::FindOutgoingInterfaceId (Ipv4Address a, Ipv4Mask amask)
 // node in order to iterate the interfaces and find the one corresponding to
 // the address in question.
 //
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
 //
-// Walk the list of nodes in the system looking for the one corresponding to
-// the node at the root of the SPF tree.  This is the node for which we are
-// building the routing table.
+// SPFCalculate () has looked up the Ipv4 interface of the node corresponding
+// to the node at the root of the SPF tree.  This is the node for which we
+// are building the routing table.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  if (m_spfrootIpv4 == 0)
     {
-      Ptr<Node> node = *i;
-
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-//
-// If the node doesn't have a GlobalRouter interface it can't be the one
-// we're interested in.
-//
-      if (rtr == 0)
-        {
-          continue;
-        }
-
-      if (rtr->GetRouterId () == routerId)
-        {
-//
-// This is the node we're building the routing table for.  We're going to need
-// the Ipv4 interface to look for the ipv4 interface index.  Since this node
-// is participating in routing IP version 4 packets, it certainly must have 
-// an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
-                         "GetObject for <Ipv4> interface failed");
+      NS_LOG_LOGIC ("FindOutgoingInterfaceId():Can't find root node " << m_spfroot->GetVertexId ());
+      return -1;
+    }
 //
 // Look through the interfaces on this node for one that has the IP address
 // we're looking for.  If we find one, return the corresponding interface
 // index, or -1 if not found.
 //
-          int32_t interface = ipv4->GetInterfaceForPrefix (a, amask);
+  int32_t interface = m_spfrootIpv4->GetInterfaceForPrefix (a, amask);
 
 #if 0
-          if (interface < 0)
-            {
-              NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
-                              "Expected an interface associated with address a:" << a);
-            }
-#endif 
-          return interface;
-        }
+  if (interface < 0)
+    {
+      NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
+                      "Expected an interface associated with address a:" << a);
     }
-//
-// Couldn't find it.
-//
-  NS_LOG_LOGIC ("FindOutgoingInterfaceId():Can't find root node " << routerId);
-  return -1;
+#endif 
+  return interface;
 }
 
 //
@@ -1940,64 +2229,31 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
 // going to use this ID to discover which node it is that we're actually going
 // to update.
 //
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
+  NS_LOG_LOGIC ("Vertex ID = " << m_spfroot->GetVertexId ());
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// The node that has the router ID corresponding to the root vertex, which
+// SPFCalculate () has looked up, is the one we're going to write the routing
+// information to.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  if (m_spfrootNode == 0)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to GetObject for that interface.  If there's no GlobalRouter interface, 
-// the node in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to 
-// GetObject for that interface.  If the node is acting as an IP version 4 
-// router, it should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "GetObject for <Ipv4> interface failed");
+      NS_LOG_LOGIC ("Can't find root node " << m_spfroot->GetVertexId ());
+      return;
+    }
+  Ptr<Node> node = m_spfrootNode;
+  NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
 //
 // Get the Global Router Link State Advertisement from the vertex we're
 // adding the routes to.  The LSA will have a number of attached Global Router
 // Link Records corresponding to links off of that vertex / node.  We're going
 // to be interested in the records corresponding to point-to-point links.
 //
-          GlobalRoutingLSA *lsa = v->GetLSA ();
-          NS_ASSERT_MSG (lsa, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
+  GlobalRoutingLSA *lsa = v->GetLSA ();
+  NS_ASSERT_MSG (lsa, 
+                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                 "Expected valid LSA in SPFVertex* v");
 
-          uint32_t nLinkRecords = lsa->GetNLinkRecords ();
+  uint32_t nLinkRecords = lsa->GetNLinkRecords ();
 //
 // Iterate through the link records on the vertex to which we're going to add
 // routes.  To make sure we're being clear, we're going to add routing table
@@ -2006,18 +2262,19 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
 // the local side of the point-to-point links found on the node described by
 // the vertex <v>.
 //
-          NS_LOG_LOGIC (" Node " << node->GetId () <<
-                        " found " << nLinkRecords << " link records in LSA " << lsa << "with LinkStateId "<< lsa->GetLinkStateId ());
-          for (uint32_t j = 0; j < nLinkRecords; ++j)
-            {
+  NS_LOG_LOGIC (" Node " << node->GetId () <<
+                " found " << nLinkRecords << " link records in LSA " << lsa << "with LinkStateId "<< lsa->GetLinkStateId ());
+  Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+  for (uint32_t j = 0; j < nLinkRecords; ++j)
+    {
 //
 // We are only concerned about point-to-point links
 //
-              GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
-              if (lr->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                  continue;
-                }
+      GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+      if (lr->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
+        {
+          continue;
+        }
 //
 // Here's why we did all of that work.  We're going to add a host route to the
 // host address found in the m_linkData field of the point-to-point link
@@ -2031,44 +2288,31 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
 // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
 // which the packets should be send for forwarding.
 //
-              Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-              if (router == 0)
-                {
-                  continue;
-                }
-              Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-              NS_ASSERT (gr);
-              // walk through all available exit directions due to ECMP,
-              // and add host route for each of the exit direction toward
-              // the vertex 'v'
-              for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-                {
-                  SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-                  Ipv4Address nextHop = exit.first;
-                  int32_t outIf = exit.second;
-                  if (outIf >= 0)
-                    {
-                      gr->AddHostRouteTo (lr->GetLinkData (), nextHop,
-                                          outIf);
-                      NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                    " adding host route to " << lr->GetLinkData () <<
-                                    " using next hop " << nextHop <<
-                                    " and outgoing interface " << outIf);
-                    }
-                  else
-                    {
-                      NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                    " NOT able to add host route to " << lr->GetLinkData () <<
-                                    " using next hop " << nextHop <<
-                                    " since outgoing interface id is negative " << outIf);
-                    }
-                } // for all routes from the root the vertex 'v'
+      // walk through all available exit directions due to ECMP,
+      // and add host route for each of the exit direction toward
+      // the vertex 'v'
+      for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+        {
+          SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+          Ipv4Address nextHop = exit.first;
+          int32_t outIf = exit.second;
+          if (outIf >= 0)
+            {
+              gr->AddHostRouteTo (lr->GetLinkData (), nextHop,
+                                  outIf);
+              NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
+                            " adding host route to " << lr->GetLinkData () <<
+                            " using next hop " << nextHop <<
+                            " and outgoing interface " << outIf);
             }
-//
-// Done adding the routes for the selected node.
-//
-          return;
-        }
+          else
+            {
+              NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
+                            " NOT able to add host route to " << lr->GetLinkData () <<
+                            " using next hop " << nextHop <<
+                            " since outgoing interface id is negative " << outIf);
+            }
+        } // for all routes from the root the vertex 'v'
     }
 }
 void
@@ -2085,99 +2329,58 @@ GlobalRouteManagerImpl::SPFIntraAddTransit (SPFVertex* v)
 // going to use this ID to discover which node it is that we're actually going
 // to update.
 //
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
+  NS_LOG_LOGIC ("Vertex ID = " << m_spfroot->GetVertexId ());
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// The node that has the router ID corresponding to the root vertex, which
+// SPFCalculate () has looked up, is the one we're going to write the routing
+// information to.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  if (m_spfrootNode == 0)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to GetObject for that interface.  If there's no GlobalRouter interface, 
-// the node in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to 
-// GetObject for that interface.  If the node is acting as an IP version 4 
-// router, it should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                         "GetObject for <Ipv4> interface failed");
+      NS_LOG_LOGIC ("Can't find root node " << m_spfroot->GetVertexId ());
+      return;
+    }
+  Ptr<Node> node = m_spfrootNode;
+  NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
 //
 // Get the Global Router Link State Advertisement from the vertex we're
 // adding the routes to.  The LSA will have a number of attached Global Router
 // Link Records corresponding to links off of that vertex / node.  We're going
 // to be interested in the records corresponding to point-to-point links.
 //
-          GlobalRoutingLSA *lsa = v->GetLSA ();
-          NS_ASSERT_MSG (lsa, 
-                         "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask ();
-          Ipv4Address tempip = lsa->GetLinkStateId ();
-          tempip = tempip.CombineMask (tempmask);
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all available exit directions due to ECMP,
-          // and add host route for each of the exit direction toward
-          // the vertex 'v'
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
+  GlobalRoutingLSA *lsa = v->GetLSA ();
+  NS_ASSERT_MSG (lsa, 
+                 "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask ();
+  Ipv4Address tempip = lsa->GetLinkStateId ();
+  tempip = tempip.CombineMask (tempmask);
+  Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+  // walk through all available exit directions due to ECMP,
+  // and add host route for each of the exit direction toward
+  // the vertex 'v'
+  for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+    {
+      SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
 
-              if (outIf >= 0)
-                {
-                  gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative " << outIf);
-                }
-            }
+      if (outIf >= 0)
+        {
+          gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
+                        " add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
         }
-    } 
+      else
+        {
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
+                        " NOT able to add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative " << outIf);
+        }
+    }
 }
 
 // Derived from quagga ospf_vertex_add_parents ()
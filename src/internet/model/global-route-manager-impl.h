@@ -26,6 +26,7 @@
 #include <list>
 #include <queue>
 #include <map>
+#include <set>
 #include <vector>
 #include "ns3/object.h"
 #include "ns3/ptr.h"
@@ -37,6 +38,7 @@ namespace ns3 {
 const uint32_t SPF_INFINITY = 0xffffffff; //!< "infinite" distance between nodes
 
 class CandidateQueue;
+class Ipv4;
 class Ipv4GlobalRouting;
 
 /**
@@ -696,12 +698,43 @@ public:
    */
   uint32_t GetNumExtLSAs () const;
 
+  /**
+   * @brief Make a deep copy of the database.
+   * @internal
+   *
+   * The SPF calculation keeps its state in the LSAs, so that each thread
+   * which runs SPF calculations needs its own copy of the database.
+   *
+   * @returns a new database, to be deleted by the caller.
+   */
+  GlobalRouteManagerLSDB* Copy () const;
+
+  /**
+   * @brief Find the routers whose SPF calculation may not give the same
+   * result with this database as with an older one.
+   * @internal
+   *
+   * The SPF calculation of a router only reads the LSAs which can be
+   * reached from the router LSA of this router.  The routers whose
+   * calculation reads, in the old database, an LSA which has changed, or
+   * which looks up an LSA which has been added, are found by walking the
+   * links of the old database backwards from the changed LSAs.  Routers
+   * which have no LSA in the old database are always returned.
+   *
+   * @param old the database from which the current routes were computed
+   * @param routers filled with the Router IDs of the routers whose routes
+   * must be computed again
+   * @returns true if the routes of all the routers must be computed again,
+   * because the External LSAs have changed.
+   */
+  bool GetChangedRouters (const GlobalRouteManagerLSDB& old, std::set<Ipv4Address>& routers) const;
 
 private:
   typedef std::map<Ipv4Address, GlobalRoutingLSA*> LSDBMap_t; //!< container of IPv4 addresses / Link State Advertisements
   typedef std::pair<Ipv4Address, GlobalRoutingLSA*> LSDBPair_t; //!< pair of IPv4 addresses / Link State Advertisements
 
   LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
+  std::map<Ipv4Address, Ipv4Address> m_linkDataIndex; //!< link data of the TransitNetwork link records / first LSA of m_database with this link data
   std::vector<GlobalRoutingLSA*> m_extdatabase; //!< database of External Link State Advertisements
 
 /**
@@ -758,6 +791,20 @@ public:
  */
   virtual void InitializeRoutes ();
 
+/**
+ * @brief Recompute the routes after a change of the topology or of the
+ * state of the interfaces.
+ * @internal
+ *
+ * This is equivalent to DeleteGlobalRoutes (), BuildGlobalRoutingDatabase ()
+ * and InitializeRoutes ().  When the "GlobalRoutingIncrementalSpf" global
+ * value is true, the new database is compared with the one from which the
+ * current routes were computed, and the routes are only deleted and
+ * computed again on the routers whose SPF calculation may give another
+ * result.
+ */
+  virtual void RecomputeRoutingTables ();
+
 /**
  * @brief Debugging routine; allow client code to supply a pre-built LSDB
  * @internal
@@ -786,8 +833,46 @@ private:
  */
   GlobalRouteManagerImpl& operator= (GlobalRouteManagerImpl& srmi);
 
+  typedef std::pair<Ipv4Address, Ptr<Node> > SPFRoot_t; //!< Router ID and node of a router
+
   SPFVertex* m_spfroot; //!< the root node
+  Ptr<Node> m_spfrootNode; //!< the node of the root router, 0 if not found
+  Ptr<Ipv4> m_spfrootIpv4; //!< the Ipv4 of the root router
+  Ptr<Ipv4GlobalRouting> m_spfrootRouting; //!< the routing protocol to which the routes are added
   GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+  bool m_lsdbInUse; //!< true if the current routes were computed from m_lsdb
+  std::vector<SPFRoot_t> m_spfRoots; //!< the routers whose routes SPFCalculateRoots () computes
+
+  /**
+   * \brief Delete the routes of a node
+   *
+   * \param node the node
+   */
+  void DeleteRoutes (Ptr<Node> node);
+
+  /**
+   * \brief Find the node of a router
+   *
+   * \param routerId the Router ID
+   * \returns the node, or 0 if no node has this Router ID
+   */
+  Ptr<Node> FindRouterNode (Ipv4Address routerId) const;
+
+  /**
+   * \brief Run the SPF calculation of the routers in m_spfRoots
+   *
+   * The calculations are split among "GlobalRoutingSpfThreads" threads,
+   * each one with its own copy of the LSDB.  The routes are the same as
+   * with a single thread, since each calculation only adds routes to the
+   * routing protocol of its root.
+   */
+  void SPFCalculateRoots (void);
+
+  /**
+   * \brief Run the SPF calculation of the routers in m_spfRoots in the
+   * calling thread
+   */
+  void DoSPFCalculateRoots (void);
 
   /**
    * \brief Test if a node is a stub, from an OSPF sense.
@@ -809,6 +894,18 @@ private:
    */
   void SPFCalculate (Ipv4Address root);
 
+  /**
+   * \brief Calculate the shortest path first (SPF) tree
+   *
+   * Equivalent to SPFCalculate (root), for a root whose node is known.
+   * Only the objects aggregated to this node are used, so that the
+   * calculations of different roots can run in parallel.
+   *
+   * \param root the root node
+   * \param node the node of the root, or 0 if there is none
+   */
+  void SPFCalculate (Ipv4Address root, Ptr<Node> node);
+
   /**
    * \brief Process Stub nodes
    *
@@ -67,6 +67,18 @@ public:
  */
   static void InitializeRoutes ();
 
+/**
+ * @brief Recompute the routes after a change of the topology or of the
+ * state of the interfaces, as DeleteGlobalRoutes (),
+ * BuildGlobalRoutingDatabase () and InitializeRoutes () do.
+ * @internal
+ *
+ * When the "GlobalRoutingIncrementalSpf" global value is true, only the
+ * routers whose shortest path tree reads a Link State Advertisement which
+ * has changed get their routes computed again.
+ */
+  static void RecomputeRoutingTables ();
+
 private:
 /**
  * @brief Global Route Manager copy construction is disallowed.  There's no 
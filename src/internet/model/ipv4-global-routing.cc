@@ -17,6 +17,7 @@
 //
 
 #include <vector>
+#include <algorithm>
 #include <iomanip>
 #include "ns3/names.h"
 #include "ns3/log.h"
@@ -58,7 +59,8 @@ Ipv4GlobalRouting::GetTypeId (void)
 
 Ipv4GlobalRouting::Ipv4GlobalRouting () 
   : m_randomEcmpRouting (false),
-    m_respondToInterfaceEvents (false)
+    m_respondToInterfaceEvents (false),
+    m_nextRouteOrder (0)
 {
   NS_LOG_FUNCTION (this);
 
@@ -79,6 +81,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
   m_hostRoutes.push_back (route);
+  m_hostRouteMap[dest].push_back (route);
 }
 
 void 
@@ -89,6 +92,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
   m_hostRoutes.push_back (route);
+  m_hostRouteMap[dest].push_back (route);
 }
 
 void 
@@ -104,6 +108,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (route);
+  IndexRoute (m_networkRouteIndex, route);
 }
 
 void 
@@ -117,6 +122,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (route);
+  IndexRoute (m_networkRouteIndex, route);
 }
 
 void 
@@ -132,8 +138,77 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_ASexternalRoutes.push_back (route);
+  IndexRoute (m_ASexternalRouteIndex, route);
 }
 
+void
+Ipv4GlobalRouting::IndexRoute (RouteIndex &index, Ipv4RoutingTableEntry *route)
+{
+  NS_LOG_FUNCTION (this << route);
+  IndexedRoute indexed;
+  indexed.route = route;
+  indexed.order = m_nextRouteOrder++;
+  Ipv4Mask mask = route->GetDestNetworkMask ();
+  uint16_t length = mask.GetPrefixLength ();
+  if (mask.Get () == (length == 0 ? 0 : 0xffffffff << (32 - length)))
+    {
+      uint8_t prefix[4];
+      route->GetDestNetwork ().Serialize (prefix);
+      index.trie.Insert (prefix, length, indexed);
+    }
+  else
+    {
+      index.nonContiguous.push_back (indexed);
+    }
+}
+
+void
+Ipv4GlobalRouting::UnindexRoute (RouteIndex &index, Ipv4RoutingTableEntry *route)
+{
+  NS_LOG_FUNCTION (this << route);
+  IndexedRoute indexed;
+  indexed.route = route;
+  Ipv4Mask mask = route->GetDestNetworkMask ();
+  uint16_t length = mask.GetPrefixLength ();
+  if (mask.Get () == (length == 0 ? 0 : 0xffffffff << (32 - length)))
+    {
+      uint8_t prefix[4];
+      route->GetDestNetwork ().Serialize (prefix);
+      bool removed = index.trie.Remove (prefix, length, indexed);
+      NS_ASSERT (removed);
+    }
+  else
+    {
+      index.nonContiguous.erase (std::find (index.nonContiguous.begin (),
+                                            index.nonContiguous.end (),
+                                            indexed));
+    }
+}
+
+void
+Ipv4GlobalRouting::MatchRoutes (const RouteIndex &index, Ipv4Address dest,
+                                std::vector<IndexedRoute> &matches) const
+{
+  uint8_t key[4];
+  dest.Serialize (key);
+  const PrefixTrie<4, IndexedRoute>::Values *values[PrefixTrie<4, IndexedRoute>::MAX_MATCHES];
+  uint32_t nValues = index.trie.Match (key, values);
+  for (uint32_t i = 0; i < nValues; i++)
+    {
+      matches.insert (matches.end (), values[i]->begin (), values[i]->end ());
+    }
+  for (std::vector<IndexedRoute>::const_iterator i = index.nonContiguous.begin ();
+       i != index.nonContiguous.end ();
+       i++)
+    {
+      if (i->route->GetDestNetworkMask ().IsMatch (dest, i->route->GetDestNetwork ()))
+        {
+          matches.push_back (*i);
+        }
+    }
+  // the routes are considered in the order of the route lists
+  std::sort (matches.begin (), matches.end ());
+}
 
 Ptr<Ipv4Route>
 Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
@@ -144,76 +219,70 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
   // store all available routes that bring packets to their destination
   typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
   RouteVec_t allRoutes;
+  // the equal cost host routes to dest are used in place when they do
+  // not have to be filtered by interface
+  const RouteVec_t *candidates = &allRoutes;
 
-  NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
-  for (HostRoutesCI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
-       i++) 
+  HostRouteMap::const_iterator h = m_hostRouteMap.find (dest);
+  if (h != m_hostRouteMap.end ())
     {
-      NS_ASSERT ((*i)->IsHost ());
-      if ((*i)->GetDest ().IsEqual (dest)) 
+      NS_LOG_LOGIC ("Found " << h->second.size () << " global host routes");
+      if (oif == 0)
         {
-          if (oif != 0)
+          candidates = &h->second;
+        }
+      else
+        {
+          for (RouteVec_t::const_iterator i = h->second.begin (); i != h->second.end (); i++)
             {
+              NS_ASSERT ((*i)->IsHost ());
               if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
                 {
                   NS_LOG_LOGIC ("Not on requested interface, skipping");
                   continue;
                 }
+              allRoutes.push_back (*i);
             }
-          allRoutes.push_back (*i);
-          NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << *i); 
         }
     }
-  if (allRoutes.size () == 0) // if no host route is found
+  if (candidates->size () == 0) // if no host route is found
     {
-      NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
-      for (NetworkRoutesI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end (); 
-           j++) 
+      std::vector<IndexedRoute> matches;
+      MatchRoutes (m_networkRouteIndex, dest, matches);
+      for (std::vector<IndexedRoute>::const_iterator j = matches.begin (); j != matches.end (); j++)
         {
-          Ipv4Mask mask = (*j)->GetDestNetworkMask ();
-          Ipv4Address entry = (*j)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry)) 
+          if (oif != 0)
             {
-              if (oif != 0)
+              if (oif != m_ipv4->GetNetDevice (j->route->GetInterface ()))
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
-                    {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
-                    }
+                  NS_LOG_LOGIC ("Not on requested interface, skipping");
+                  continue;
                 }
-              allRoutes.push_back (*j);
-              NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << *j);
             }
+          allRoutes.push_back (j->route);
+          NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << j->route);
         }
     }
-  if (allRoutes.size () == 0)  // consider external if no host/network found
+  if (candidates->size () == 0)  // consider external if no host/network found
     {
-      for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
-           k != m_ASexternalRoutes.end ();
-           k++)
+      std::vector<IndexedRoute> matches;
+      MatchRoutes (m_ASexternalRouteIndex, dest, matches);
+      for (std::vector<IndexedRoute>::const_iterator k = matches.begin (); k != matches.end (); k++)
         {
-          Ipv4Mask mask = (*k)->GetDestNetworkMask ();
-          Ipv4Address entry = (*k)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry))
+          NS_LOG_LOGIC ("Found external route" << k->route);
+          if (oif != 0)
             {
-              NS_LOG_LOGIC ("Found external route" << *k);
-              if (oif != 0)
+              if (oif != m_ipv4->GetNetDevice (k->route->GetInterface ()))
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*k)->GetInterface ()))
-                    {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
-                    }
+                  NS_LOG_LOGIC ("Not on requested interface, skipping");
+                  continue;
                 }
-              allRoutes.push_back (*k);
-              break;
             }
+          allRoutes.push_back (k->route);
+          break;
         }
     }
-  if (allRoutes.size () > 0 ) // if route(s) is found
+  if (candidates->size () > 0 ) // if route(s) is found
     {
       // pick up one of the routes uniformly at random if random
       // ECMP routing is enabled, or always select the first route
@@ -221,13 +290,13 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
       uint32_t selectIndex;
       if (m_randomEcmpRouting)
         {
-          selectIndex = m_rand->GetInteger (0, allRoutes.size ()-1);
+          selectIndex = m_rand->GetInteger (0, candidates->size ()-1);
         }
       else 
         {
           selectIndex = 0;
         }
-      Ipv4RoutingTableEntry* route = allRoutes.at (selectIndex); 
+      Ipv4RoutingTableEntry* route = candidates->at (selectIndex); 
       // create a Ipv4Route object from the selected routing table entry
       rtentry = Create<Ipv4Route> ();
       rtentry->SetDestination (route->GetDest ());
@@ -318,6 +387,12 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           if (tmp  == index)
             {
               NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_hostRoutes.size ());
+              std::vector<Ipv4RoutingTableEntry *> &routes = m_hostRouteMap[(*i)->GetDest ()];
+              routes.erase (std::find (routes.begin (), routes.end (), *i));
+              if (routes.empty ())
+                {
+                  m_hostRouteMap.erase ((*i)->GetDest ());
+                }
               delete *i;
               m_hostRoutes.erase (i);
               NS_LOG_LOGIC ("Done removing host route " << index << "; host route remaining size = " << m_hostRoutes.size ());
@@ -335,6 +410,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_networkRoutes.size ());
+          UnindexRoute (m_networkRouteIndex, *j);
           delete *j;
           m_networkRoutes.erase (j);
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
@@ -351,6 +427,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_ASexternalRoutes.size ());
+          UnindexRoute (m_ASexternalRouteIndex, *k);
           delete *k;
           m_ASexternalRoutes.erase (k);
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
@@ -391,6 +468,11 @@ Ipv4GlobalRouting::DoDispose (void)
     {
       delete (*l);
     }
+  m_hostRouteMap.clear ();
+  m_networkRouteIndex.trie.Clear ();
+  m_networkRouteIndex.nonContiguous.clear ();
+  m_ASexternalRouteIndex.trie.Clear ();
+  m_ASexternalRouteIndex.nonContiguous.clear ();
 
   Ipv4RoutingProtocol::DoDispose ();
 }
@@ -557,9 +639,7 @@ Ipv4GlobalRouting::NotifyInterfaceUp (uint32_t i)
   NS_LOG_FUNCTION (this << i);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::RecomputeRoutingTables ();
     }
 }
 
@@ -569,9 +649,7 @@ Ipv4GlobalRouting::NotifyInterfaceDown (uint32_t i)
   NS_LOG_FUNCTION (this << i);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::RecomputeRoutingTables ();
     }
 }
 
@@ -581,9 +659,7 @@ Ipv4GlobalRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress ad
   NS_LOG_FUNCTION (this << interface << address);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::RecomputeRoutingTables ();
     }
 }
 
@@ -593,9 +669,7 @@ Ipv4GlobalRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
   NS_LOG_FUNCTION (this << interface << address);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::RecomputeRoutingTables ();
     }
 }
 
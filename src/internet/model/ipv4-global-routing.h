@@ -21,6 +21,7 @@
 #define IPV4_GLOBAL_ROUTING_H
 
 #include <list>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
@@ -28,6 +29,8 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/sgi-hashmap.h"
+#include "prefix-trie.h"
 
 namespace ns3 {
 
@@ -258,12 +261,62 @@ private:
   /// iterator of container of Ipv4RoutingTableEntry (routes to external AS)
   typedef std::list<Ipv4RoutingTableEntry *>::iterator ASExternalRoutesI;
 
+  /// the equal cost host routes to each destination, in insertion order
+  typedef sgi::hash_map<Ipv4Address, std::vector<Ipv4RoutingTableEntry *>, Ipv4AddressHash> HostRouteMap;
+
+  /// A network or AS external route, as indexed by its destination prefix
+  struct IndexedRoute
+  {
+    Ipv4RoutingTableEntry *route;
+    uint64_t order; //!< insertion order, which is the order of the route lists
+    bool operator== (const IndexedRoute &o) const
+    {
+      return route == o.route;
+    }
+    bool operator< (const IndexedRoute &o) const
+    {
+      return order < o.order;
+    }
+  };
+
+  /// Prefix index of network or AS external routes
+  struct RouteIndex
+  {
+    PrefixTrie<4, IndexedRoute> trie; //!< routes with a contiguous mask
+    std::vector<IndexedRoute> nonContiguous; //!< routes the trie cannot index
+  };
+
+  /**
+   * \brief Add a route to a prefix index.
+   * \param index the index
+   * \param route the route to add
+   */
+  void IndexRoute (RouteIndex &index, Ipv4RoutingTableEntry *route);
+  /**
+   * \brief Remove a route from a prefix index.
+   * \param index the index
+   * \param route the route to remove
+   */
+  void UnindexRoute (RouteIndex &index, Ipv4RoutingTableEntry *route);
+  /**
+   * \brief Find all the routes of a prefix index which match a destination.
+   * \param index the index
+   * \param dest the destination
+   * \param matches filled with the matching routes, in insertion order
+   */
+  void MatchRoutes (const RouteIndex &index, Ipv4Address dest, std::vector<IndexedRoute> &matches) const;
+
   Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
 
   HostRoutes m_hostRoutes;             //!< Routes to hosts
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  HostRouteMap m_hostRouteMap;       //!< m_hostRoutes by destination
+  RouteIndex m_networkRouteIndex;    //!< m_networkRoutes by prefix
+  RouteIndex m_ASexternalRouteIndex; //!< m_ASexternalRoutes by prefix
+  uint64_t m_nextRouteOrder;         //!< order of the next indexed route
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
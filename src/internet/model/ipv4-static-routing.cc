@@ -24,6 +24,7 @@
                 << " [node " << m_ipv4->GetObject<Node> ()->GetId () << "] "; }
 
 #include <iomanip>
+#include <algorithm>
 #include "ns3/log.h"
 #include "ns3/names.h"
 #include "ns3/packet.h"
@@ -54,11 +55,65 @@ Ipv4StaticRouting::GetTypeId (void)
 }
 
 Ipv4StaticRouting::Ipv4StaticRouting () 
-  : m_ipv4 (0)
+  : m_nextRouteOrder (0),
+    m_ipv4 (0)
 {
   NS_LOG_FUNCTION (this);
 }
 
+static bool
+IsContiguous (Ipv4Mask mask)
+{
+  uint16_t length = mask.GetPrefixLength ();
+  return mask.Get () == (length == 0 ? 0 : 0xffffffff << (32 - length));
+}
+
+void
+Ipv4StaticRouting::InsertNetworkRoute (Ipv4RoutingTableEntry *route, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << route << metric);
+  m_networkRoutes.push_back (std::make_pair (route, metric));
+  IndexedRoute indexed;
+  indexed.route = route;
+  indexed.metric = metric;
+  indexed.order = m_nextRouteOrder++;
+  Ipv4Mask mask = route->GetDestNetworkMask ();
+  if (IsContiguous (mask))
+    {
+      uint8_t prefix[4];
+      route->GetDestNetwork ().Serialize (prefix);
+      m_routeTrie.Insert (prefix, mask.GetPrefixLength (), indexed);
+    }
+  else
+    {
+      m_nonContiguousRoutes.push_back (indexed);
+    }
+}
+
+Ipv4StaticRouting::NetworkRoutesI
+Ipv4StaticRouting::EraseNetworkRoute (NetworkRoutesI i)
+{
+  NS_LOG_FUNCTION (this << i->first);
+  IndexedRoute indexed;
+  indexed.route = i->first;
+  Ipv4Mask mask = i->first->GetDestNetworkMask ();
+  if (IsContiguous (mask))
+    {
+      uint8_t prefix[4];
+      i->first->GetDestNetwork ().Serialize (prefix);
+      bool removed = m_routeTrie.Remove (prefix, mask.GetPrefixLength (), indexed);
+      NS_ASSERT (removed);
+    }
+  else
+    {
+      m_nonContiguousRoutes.erase (std::find (m_nonContiguousRoutes.begin (),
+                                              m_nonContiguousRoutes.end (),
+                                              indexed));
+    }
+  delete i->first;
+  return m_networkRoutes.erase (i);
+}
+
 void 
 Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network, 
                                       Ipv4Mask networkMask, 
@@ -72,7 +127,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         nextHop,
                                                         interface);
-  m_networkRoutes.push_back (make_pair (route,metric));
+  InsertNetworkRoute (route, metric);
 }
 
 void 
@@ -86,7 +141,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
   *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
                                                         networkMask,
                                                         interface);
-  m_networkRoutes.push_back (make_pair (route,metric));
+  InsertNetworkRoute (route, metric);
 }
 
 void 
@@ -143,7 +198,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
   *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
                                                         networkMask,
                                                         outputInterface);
-  m_networkRoutes.push_back (make_pair (route,0));
+  InsertNetworkRoute (route, 0);
 }
 
 uint32_t 
@@ -224,8 +279,6 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
 {
   NS_LOG_FUNCTION (this << dest << " " << oif);
   Ptr<Ipv4Route> rtentry = 0;
-  uint16_t longest_mask = 0;
-  uint32_t shortest_metric = 0xffffffff;
   /* when sending on local multicast, there have to be interface specified */
   if (dest.IsLocalMulticast ())
     {
@@ -239,53 +292,65 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
       return rtentry;
     }
 
-
-  for (NetworkRoutesI i = m_networkRoutes.begin (); 
-       i != m_networkRoutes.end (); 
-       i++) 
+  // Among the routes which match dest and use oif, pick the longest
+  // mask, then the lowest metric, then the latest inserted route.
+  const IndexedRoute *best = 0;
+  uint8_t key[4];
+  dest.Serialize (key);
+  const RouteTrie::Values *matches[RouteTrie::MAX_MATCHES];
+  uint32_t nMatches = m_routeTrie.Match (key, matches);
+  for (uint32_t k = nMatches; k > 0 && best == 0; k--)
     {
-      Ipv4RoutingTableEntry *j=i->first;
-      uint32_t metric =i->second;
-      Ipv4Mask mask = (j)->GetDestNetworkMask ();
-      uint16_t masklen = mask.GetPrefixLength ();
-      Ipv4Address entry = (j)->GetDestNetwork ();
-      NS_LOG_LOGIC ("Searching for route to " << dest << ", checking against route to " << entry << "/" << masklen);
-      if (mask.IsMatch (dest, entry)) 
+      for (RouteTrie::Values::const_iterator i = matches[k - 1]->begin (); i != matches[k - 1]->end (); i++)
         {
-          NS_LOG_LOGIC ("Found global network route " << j << ", mask length " << masklen << ", metric " << metric);
-          if (oif != 0)
-            {
-              if (oif != m_ipv4->GetNetDevice (j->GetInterface ()))
-                {
-                  NS_LOG_LOGIC ("Not on requested interface, skipping");
-                  continue;
-                }
-            }
-          if (masklen < longest_mask) // Not interested if got shorter mask
+          NS_LOG_LOGIC ("Found global network route " << i->route << ", mask length " << 
+                        i->route->GetDestNetworkMask ().GetPrefixLength () << ", metric " << i->metric);
+          if (oif != 0 && oif != m_ipv4->GetNetDevice (i->route->GetInterface ()))
             {
-              NS_LOG_LOGIC ("Previous match longer, skipping");
+              NS_LOG_LOGIC ("Not on requested interface, skipping");
               continue;
             }
-          if (masklen > longest_mask) // Reset metric if longer masklen
+          if (best == 0 || i->metric < best->metric
+              || (i->metric == best->metric && i->order > best->order))
             {
-              shortest_metric = 0xffffffff;
+              best = &(*i);
             }
+        }
+    }
+  uint16_t longest_mask = best == 0 ? 0 : best->route->GetDestNetworkMask ().GetPrefixLength ();
+  for (std::vector<IndexedRoute>::const_iterator i = m_nonContiguousRoutes.begin ();
+       i != m_nonContiguousRoutes.end ();
+       i++)
+    {
+      Ipv4Mask mask = i->route->GetDestNetworkMask ();
+      uint16_t masklen = mask.GetPrefixLength ();
+      if (!mask.IsMatch (dest, i->route->GetDestNetwork ()))
+        {
+          continue;
+        }
+      if (oif != 0 && oif != m_ipv4->GetNetDevice (i->route->GetInterface ()))
+        {
+          continue;
+        }
+      if (best == 0 || masklen > longest_mask
+          || (masklen == longest_mask
+              && (i->metric < best->metric
+                  || (i->metric == best->metric && i->order > best->order))))
+        {
+          best = &(*i);
           longest_mask = masklen;
-          if (metric > shortest_metric)
-            {
-              NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
-              continue;
-            }
-          shortest_metric = metric;
-          Ipv4RoutingTableEntry* route = (j);
-          uint32_t interfaceIdx = route->GetInterface ();
-          rtentry = Create<Ipv4Route> ();
-          rtentry->SetDestination (route->GetDest ());
-          rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetDest ()));
-          rtentry->SetGateway (route->GetGateway ());
-          rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
         }
     }
+  if (best != 0)
+    {
+      Ipv4RoutingTableEntry* route = best->route;
+      uint32_t interfaceIdx = route->GetInterface ();
+      rtentry = Create<Ipv4Route> ();
+      rtentry->SetDestination (route->GetDest ());
+      rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetDest ()));
+      rtentry->SetGateway (route->GetGateway ());
+      rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
+    }
   if (rtentry != 0)
     {
       NS_LOG_LOGIC ("Matching route via " << rtentry->GetGateway () << " at the end");
@@ -443,8 +508,7 @@ Ipv4StaticRouting::RemoveRoute (uint32_t index)
     {
       if (tmp == index)
         {
-          delete j->first;
-          m_networkRoutes.erase (j);
+          EraseNetworkRoute (j);
           return;
         }
       tmp++;
@@ -593,6 +657,8 @@ Ipv4StaticRouting::DoDispose (void)
     {
       delete (j->first);
     }
+  m_routeTrie.Clear ();
+  m_nonContiguousRoutes.clear ();
   for (MulticastRoutesI i = m_multicastRoutes.begin (); 
        i != m_multicastRoutes.end (); 
        i = m_multicastRoutes.erase (i)) 
@@ -23,6 +23,7 @@
 #define IPV4_STATIC_ROUTING_H
 
 #include <list>
+#include <vector>
 #include <utility>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
@@ -31,6 +32,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "prefix-trie.h"
 
 namespace ns3 {
 
@@ -399,6 +401,36 @@ private:
   /// Iterator for container for the multicast routes
   typedef std::list<Ipv4MulticastRoutingTableEntry *>::iterator MulticastRoutesI;
 
+  /// A network route, as indexed by its destination prefix.
+  struct IndexedRoute
+  {
+    Ipv4RoutingTableEntry *route;
+    uint32_t metric;
+    uint64_t order; //!< insertion order, the latest route wins metric ties
+    bool operator== (const IndexedRoute &o) const
+    {
+      return route == o.route;
+    }
+  };
+
+  /// Longest prefix match index of the network routes
+  typedef PrefixTrie<4, IndexedRoute> RouteTrie;
+
+  /**
+   * \brief Append a route to the network routes and index it.
+   * \param route the route, owned by the routing table from now on
+   * \param metric metric of the route
+   */
+  void InsertNetworkRoute (Ipv4RoutingTableEntry *route, uint32_t metric);
+
+  /**
+   * \brief Remove a route from the network routes and from the index,
+   * and delete it.
+   * \param i the route to remove
+   * \return the route which followed the removed one
+   */
+  NetworkRoutesI EraseNetworkRoute (NetworkRoutesI i);
+
   /**
    * \brief Lookup in the forwarding table for destination.
    * \param dest destination address
@@ -430,6 +462,22 @@ private:
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the network routes with a contiguous mask, indexed by prefix.
+   */
+  RouteTrie m_routeTrie;
+
+  /**
+   * \brief the network routes with a non-contiguous mask, which the
+   * trie cannot index.
+   */
+  std::vector<IndexedRoute> m_nonContiguousRoutes;
+
+  /**
+   * \brief the order given to the next inserted network route.
+   */
+  uint64_t m_nextRouteOrder;
+
   /**
    * \brief the forwarding table for multicast.
    */
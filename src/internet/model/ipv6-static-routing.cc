@@ -19,6 +19,7 @@
  */
 
 #include <iomanip>
+#include <algorithm>
 #include "ns3/log.h"
 #include "ns3/node.h"
 #include "ns3/packet.h"
@@ -47,7 +48,8 @@ TypeId Ipv6StaticRouting::GetTypeId ()
 }
 
 Ipv6StaticRouting::Ipv6StaticRouting ()
-  : m_ipv6 (0)
+  : m_nextRouteOrder (0),
+    m_ipv6 (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -149,7 +151,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
   NS_LOG_FUNCTION (this << network << networkPrefix << nextHop << interface << metric);
   Ipv6RoutingTableEntry* route = new Ipv6RoutingTableEntry ();
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, nextHop, interface);
-  m_networkRoutes.push_back (std::make_pair (route, metric));
+  InsertNetworkRoute (route, metric);
 }
 
 void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix networkPrefix, Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse, uint32_t metric)
@@ -162,7 +164,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
 
   Ipv6RoutingTableEntry* route = new Ipv6RoutingTableEntry ();
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, nextHop, interface, prefixToUse);
-  m_networkRoutes.push_back (std::make_pair (route, metric));
+  InsertNetworkRoute (route, metric);
 }
 
 void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix networkPrefix, uint32_t interface, uint32_t metric)
@@ -170,7 +172,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
   NS_LOG_FUNCTION (this << network << networkPrefix << interface);
   Ipv6RoutingTableEntry* route = new Ipv6RoutingTableEntry ();
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, interface);
-  m_networkRoutes.push_back (std::make_pair (route, metric));
+  InsertNetworkRoute (route, metric);
 }
 
 void Ipv6StaticRouting::SetDefaultRoute (Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse, uint32_t metric)
@@ -179,6 +181,55 @@ void Ipv6StaticRouting::SetDefaultRoute (Ipv6Address nextHop, uint32_t interface
   AddNetworkRouteTo (Ipv6Address ("::"), Ipv6Prefix::GetZero (), nextHop, interface, prefixToUse, metric);
 }
 
+static bool IsContiguous (Ipv6Prefix prefix)
+{
+  return prefix == Ipv6Prefix (prefix.GetPrefixLength ());
+}
+
+void Ipv6StaticRouting::InsertNetworkRoute (Ipv6RoutingTableEntry *route, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << route << metric);
+  m_networkRoutes.push_back (std::make_pair (route, metric));
+  IndexedRoute indexed;
+  indexed.route = route;
+  indexed.metric = metric;
+  indexed.order = m_nextRouteOrder++;
+  Ipv6Prefix prefix = route->GetDestNetworkPrefix ();
+  if (IsContiguous (prefix))
+    {
+      uint8_t network[16];
+      route->GetDestNetwork ().Serialize (network);
+      m_routeTrie.Insert (network, prefix.GetPrefixLength (), indexed);
+    }
+  else
+    {
+      m_nonContiguousRoutes.push_back (indexed);
+    }
+}
+
+Ipv6StaticRouting::NetworkRoutesI Ipv6StaticRouting::EraseNetworkRoute (NetworkRoutesI i)
+{
+  NS_LOG_FUNCTION (this << i->first);
+  IndexedRoute indexed;
+  indexed.route = i->first;
+  Ipv6Prefix prefix = i->first->GetDestNetworkPrefix ();
+  if (IsContiguous (prefix))
+    {
+      uint8_t network[16];
+      i->first->GetDestNetwork ().Serialize (network);
+      bool removed = m_routeTrie.Remove (network, prefix.GetPrefixLength (), indexed);
+      NS_ASSERT (removed);
+    }
+  else
+    {
+      m_nonContiguousRoutes.erase (std::find (m_nonContiguousRoutes.begin (),
+                                              m_nonContiguousRoutes.end (),
+                                              indexed));
+    }
+  delete i->first;
+  return m_networkRoutes.erase (i);
+}
+
 void Ipv6StaticRouting::AddMulticastRoute (Ipv6Address origin, Ipv6Address group, uint32_t inputInterface, std::vector<uint32_t> outputInterfaces)
 {
   NS_LOG_FUNCTION (this << origin << group << inputInterface);
@@ -194,7 +245,7 @@ void Ipv6StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
   Ipv6Address network = Ipv6Address ("ff00::"); /* RFC 3513 */
   Ipv6Prefix networkMask = Ipv6Prefix (8);
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkMask, outputInterface);
-  m_networkRoutes.push_back (std::make_pair (route, 0));
+  InsertNetworkRoute (route, 0);
 }
 
 uint32_t Ipv6StaticRouting::GetNMulticastRoutes () const
@@ -263,9 +314,23 @@ bool Ipv6StaticRouting::HasNetworkDest (Ipv6Address network, uint32_t interfaceI
   NS_LOG_FUNCTION (this << network << interfaceIndex);
 
   /* in the network table */
-  for (NetworkRoutesI j = m_networkRoutes.begin (); j != m_networkRoutes.end (); j++)
+  uint8_t key[16];
+  network.Serialize (key);
+  const RouteTrie::Values *matches[RouteTrie::MAX_MATCHES];
+  uint32_t nMatches = m_routeTrie.Match (key, matches);
+  for (uint32_t k = 0; k < nMatches; k++)
+    {
+      for (RouteTrie::Values::const_iterator i = matches[k]->begin (); i != matches[k]->end (); i++)
+        {
+          if (i->route->GetInterface () == interfaceIndex)
+            {
+              return true;
+            }
+        }
+    }
+  for (std::vector<IndexedRoute>::const_iterator i = m_nonContiguousRoutes.begin (); i != m_nonContiguousRoutes.end (); i++)
     {
-      Ipv6RoutingTableEntry* rtentry = j->first;
+      Ipv6RoutingTableEntry* rtentry = i->route;
       Ipv6Prefix prefix = rtentry->GetDestNetworkPrefix ();
       Ipv6Address entry = rtentry->GetDestNetwork ();
 
@@ -283,8 +348,6 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
 {
   NS_LOG_FUNCTION (this << dst << interface);
   Ptr<Ipv6Route> rtentry = 0;
-  uint16_t longestMask = 0;
-  uint32_t shortestMetric = 0xffffffff;
 
   /* when sending on link-local multicast, there have to be interface specified */
   if (dst == Ipv6Address::GetAllNodesMulticast () || dst.IsSolicitedMulticast ()
@@ -299,64 +362,78 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
       return rtentry;
     }
 
-  for (NetworkRoutesI it = m_networkRoutes.begin (); it != m_networkRoutes.end (); it++)
+  /* among the routes which match dst and output on interface, pick the
+   * longest prefix, then the lowest metric, then the latest added route.
+   */
+  const IndexedRoute *best = 0;
+  uint8_t key[16];
+  dst.Serialize (key);
+  const RouteTrie::Values *matches[RouteTrie::MAX_MATCHES];
+  uint32_t nMatches = m_routeTrie.Match (key, matches);
+  for (uint32_t k = nMatches; k > 0 && best == 0; k--)
     {
-      Ipv6RoutingTableEntry* j = it->first;
-      uint32_t metric = it->second;
-      Ipv6Prefix mask = j->GetDestNetworkPrefix ();
-      uint16_t maskLen = mask.GetPrefixLength ();
-      Ipv6Address entry = j->GetDestNetwork ();
-
-      NS_LOG_LOGIC ("Searching for route to " << dst << ", mask length " << maskLen << ", metric " << metric);
-
-      if (mask.IsMatch (dst, entry))
+      for (RouteTrie::Values::const_iterator i = matches[k - 1]->begin (); i != matches[k - 1]->end (); i++)
         {
-          NS_LOG_LOGIC ("Found global network route " << j << ", mask length " << maskLen << ", metric " << metric);
+          NS_LOG_LOGIC ("Found global network route " << i->route << ", mask length " << (uint32_t) i->route->GetDestNetworkPrefix ().GetPrefixLength () << ", metric " << i->metric);
 
           /* if interface is given, check the route will output on this interface */
-          if (!interface || interface == m_ipv6->GetNetDevice (j->GetInterface ()))
+          if (interface && interface != m_ipv6->GetNetDevice (i->route->GetInterface ()))
             {
-              if (maskLen < longestMask)
-                {
-                  NS_LOG_LOGIC ("Previous match longer, skipping");
-                  continue;
-                }
-
-              if (maskLen > longestMask)
-                {
-                  shortestMetric = 0xffffffff;
-                }
-
-              longestMask = maskLen;
-              if (metric > shortestMetric)
-                {
-                  NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
-                  continue;
-                }
+              continue;
+            }
+          if (!best || i->metric < best->metric
+              || (i->metric == best->metric && i->order > best->order))
+            {
+              best = &(*i);
+            }
+        }
+    }
 
-              shortestMetric = metric;
-              Ipv6RoutingTableEntry* route = j;
-              uint32_t interfaceIdx = route->GetInterface ();
-              rtentry = Create<Ipv6Route> ();
+  uint16_t longestMask = best ? best->route->GetDestNetworkPrefix ().GetPrefixLength () : 0;
+  for (std::vector<IndexedRoute>::const_iterator i = m_nonContiguousRoutes.begin (); i != m_nonContiguousRoutes.end (); i++)
+    {
+      Ipv6Prefix mask = i->route->GetDestNetworkPrefix ();
+      uint16_t maskLen = mask.GetPrefixLength ();
+      if (!mask.IsMatch (dst, i->route->GetDestNetwork ()))
+        {
+          continue;
+        }
+      if (interface && interface != m_ipv6->GetNetDevice (i->route->GetInterface ()))
+        {
+          continue;
+        }
+      if (!best || maskLen > longestMask
+          || (maskLen == longestMask
+              && (i->metric < best->metric
+                  || (i->metric == best->metric && i->order > best->order))))
+        {
+          best = &(*i);
+          longestMask = maskLen;
+        }
+    }
 
-              if (route->GetGateway ().IsAny ())
-                {
-                  rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetDest ()));
-                }
-              else if (route->GetDest ().IsAny ()) /* default route */
-                {
-                  rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetPrefixToUse ().IsAny () ? dst : route->GetPrefixToUse ()));
-                }
-              else
-                {
-                  rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetGateway ()));
-                }
+  if (best)
+    {
+      Ipv6RoutingTableEntry* route = best->route;
+      uint32_t interfaceIdx = route->GetInterface ();
+      rtentry = Create<Ipv6Route> ();
 
-              rtentry->SetDestination (route->GetDest ());
-              rtentry->SetGateway (route->GetGateway ());
-              rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
-            }
+      if (route->GetGateway ().IsAny ())
+        {
+          rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetDest ()));
+        }
+      else if (route->GetDest ().IsAny ()) /* default route */
+        {
+          rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetPrefixToUse ().IsAny () ? dst : route->GetPrefixToUse ()));
         }
+      else
+        {
+          rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetGateway ()));
+        }
+
+      rtentry->SetDestination (route->GetDest ());
+      rtentry->SetGateway (route->GetGateway ());
+      rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
     }
 
   if (rtentry)
@@ -375,6 +452,8 @@ void Ipv6StaticRouting::DoDispose ()
       delete j->first;
     }
   m_networkRoutes.clear ();
+  m_routeTrie.Clear ();
+  m_nonContiguousRoutes.clear ();
 
   for (MulticastRoutesI i = m_multicastRoutes.begin (); i != m_multicastRoutes.end (); i = m_multicastRoutes.erase (i))
     {
@@ -523,8 +602,7 @@ void Ipv6StaticRouting::RemoveRoute (uint32_t index)
     {
       if (tmp == index)
         {
-          delete it->first;
-          m_networkRoutes.erase (it);
+          EraseNetworkRoute (it);
           return;
         }
       tmp++;
@@ -542,8 +620,7 @@ void Ipv6StaticRouting::RemoveRoute (Ipv6Address network, Ipv6Prefix prefix, uin
       if (network == rtentry->GetDest () && rtentry->GetInterface () == ifIndex
           && rtentry->GetPrefixToUse () == prefixToUse)
         {
-          delete it->first;
-          m_networkRoutes.erase (it);
+          EraseNetworkRoute (it);
           return;
         }
     }
@@ -779,8 +856,7 @@ void Ipv6StaticRouting::NotifyRemoveRoute (Ipv6Address dst, Ipv6Prefix mask, Ipv
 
           if (dst == entry && prefix == mask && rtentry->GetInterface () == interface)
             {
-              delete j->first;
-              j = m_networkRoutes.erase (j);
+              j = EraseNetworkRoute (j);
             }
           else
             {
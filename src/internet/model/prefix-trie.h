@@ -0,0 +1,249 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PREFIX_TRIE_H
+#define PREFIX_TRIE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief A path-compressed binary trie which maps the prefixes of
+ * BYTES-byte long keys, in network byte order, to lists of values.
+ *
+ * Each node of the trie stores a prefix and the values which were
+ * inserted with exactly this prefix; nodes with a single child and no
+ * value are skipped, so that the depth of the trie is bounded by the
+ * number of distinct prefix lengths rather than by the key length.
+ * Match returns the value lists of all the prefixes of a key, from the
+ * shortest to the longest, which is what the longest prefix match of
+ * the static routing protocols needs to apply their metric and
+ * interface rules.
+ *
+ * The nodes are kept in a vector and refer to their children by
+ * index: removing a value does not free its node, which is reused if
+ * the same prefix is inserted again.
+ */
+template <uint32_t BYTES, typename T>
+class PrefixTrie
+{
+public:
+  /// The values stored with a prefix, in insertion order.
+  typedef std::vector<T> Values;
+  /// The maximum number of value lists returned by Match.
+  static const uint32_t MAX_MATCHES = BYTES * 8 + 1;
+
+  PrefixTrie ()
+  {
+    Clear ();
+  }
+
+  /**
+   * \brief Remove all the prefixes and values.
+   */
+  void Clear (void)
+  {
+    m_nodes.clear ();
+    uint8_t zero[BYTES];
+    memset (zero, 0, BYTES);
+    NewNode (zero, 0);
+  }
+
+  /**
+   * \param prefix the prefix, of which only the first length bits are used
+   * \param length the length of the prefix, in bits
+   * \param value the value to append to the values of this prefix
+   */
+  void Insert (const uint8_t *prefix, uint32_t length, const T &value)
+  {
+    NS_ASSERT (length <= BYTES * 8);
+    uint8_t key[BYTES];
+    CopyPrefix (key, prefix, length);
+    uint32_t current = 0;
+    while (m_nodes[current].length != length)
+      {
+        // the prefix of current is a strict prefix of key
+        uint32_t bit = GetBit (key, m_nodes[current].length);
+        uint32_t child = m_nodes[current].children[bit];
+        if (child == 0)
+          {
+            uint32_t leaf = NewNode (key, length);
+            m_nodes[current].children[bit] = leaf;
+            current = leaf;
+            break;
+          }
+        uint32_t childLength = m_nodes[child].length;
+        uint32_t common = CommonLength (key, m_nodes[child].key, std::min (length, childLength));
+        if (common == childLength)
+          {
+            current = child;
+            continue;
+          }
+        // key and child diverge, or key is a prefix of child: insert a
+        // node at the divergence point.
+        uint32_t split = NewNode (key, common);
+        m_nodes[split].children[GetBit (m_nodes[child].key, common)] = child;
+        m_nodes[current].children[bit] = split;
+        current = split;
+        if (common != length)
+          {
+            uint32_t leaf = NewNode (key, length);
+            m_nodes[split].children[GetBit (key, common)] = leaf;
+            current = leaf;
+          }
+        break;
+      }
+    m_nodes[current].values.push_back (value);
+  }
+
+  /**
+   * \param prefix the prefix, of which only the first length bits are used
+   * \param length the length of the prefix, in bits
+   * \param value the value to remove from the values of this prefix
+   * \returns true if the value was found and removed.
+   */
+  bool Remove (const uint8_t *prefix, uint32_t length, const T &value)
+  {
+    NS_ASSERT (length <= BYTES * 8);
+    uint8_t key[BYTES];
+    CopyPrefix (key, prefix, length);
+    uint32_t current = 0;
+    while (m_nodes[current].length != length)
+      {
+        uint32_t child = m_nodes[current].children[GetBit (key, m_nodes[current].length)];
+        if (child == 0
+            || m_nodes[child].length > length
+            || CommonLength (key, m_nodes[child].key, m_nodes[child].length) != m_nodes[child].length)
+          {
+            return false;
+          }
+        current = child;
+      }
+    Values &values = m_nodes[current].values;
+    typename Values::iterator i = std::find (values.begin (), values.end (), value);
+    if (i == values.end ())
+      {
+        return false;
+      }
+    values.erase (i);
+    return true;
+  }
+
+  /**
+   * \param key the key to look up
+   * \param matches an array of at least MAX_MATCHES elements, filled with
+   *        the non-empty value lists of the prefixes of key, from the
+   *        shortest prefix to the longest one.
+   * \returns the number of value lists stored in matches.
+   */
+  uint32_t Match (const uint8_t *key, const Values **matches) const
+  {
+    uint32_t n = 0;
+    uint32_t current = 0;
+    while (true)
+      {
+        const Node &node = m_nodes[current];
+        if (!node.values.empty ())
+          {
+            matches[n++] = &node.values;
+          }
+        if (node.length == BYTES * 8)
+          {
+            break;
+          }
+        uint32_t child = node.children[GetBit (key, node.length)];
+        if (child == 0
+            || CommonLength (key, m_nodes[child].key, m_nodes[child].length) != m_nodes[child].length)
+          {
+            break;
+          }
+        current = child;
+      }
+    return n;
+  }
+
+private:
+  struct Node
+  {
+    uint8_t key[BYTES]; //!< the prefix, with all the bits past length cleared
+    uint32_t length;
+    uint32_t children[2]; //!< indexes in m_nodes, 0 if none
+    Values values;
+  };
+
+  static uint32_t GetBit (const uint8_t *key, uint32_t i)
+  {
+    return (key[i / 8] >> (7 - i % 8)) & 1;
+  }
+
+  /// \returns the number of leading bits, up to max, which a and b share.
+  static uint32_t CommonLength (const uint8_t *a, const uint8_t *b, uint32_t max)
+  {
+    uint32_t i = 0;
+    while (i + 8 <= max && a[i / 8] == b[i / 8])
+      {
+        i += 8;
+      }
+    while (i < max && GetBit (a, i) == GetBit (b, i))
+      {
+        i++;
+      }
+    return i;
+  }
+
+  static void CopyPrefix (uint8_t *dst, const uint8_t *src, uint32_t length)
+  {
+    for (uint32_t i = 0; i < BYTES; i++)
+      {
+        if (length >= (i + 1) * 8)
+          {
+            dst[i] = src[i];
+          }
+        else if (length > i * 8)
+          {
+            dst[i] = src[i] & (0xff << (8 - (length - i * 8)));
+          }
+        else
+          {
+            dst[i] = 0;
+          }
+      }
+  }
+
+  uint32_t NewNode (const uint8_t *prefix, uint32_t length)
+  {
+    Node node;
+    CopyPrefix (node.key, prefix, length);
+    node.length = length;
+    node.children[0] = 0;
+    node.children[1] = 0;
+    m_nodes.push_back (node);
+    return m_nodes.size () - 1;
+  }
+
+  std::vector<Node> m_nodes; //!< m_nodes[0] is the root, of length 0
+};
+
+} // namespace ns3
+
+#endif /* PREFIX_TRIE_H */
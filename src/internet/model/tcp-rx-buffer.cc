@@ -152,8 +152,13 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
+  // Remove overlapped bytes from packet, starting from the last packet
+  // which begins at or before headSeq
+  BufIterator i = m_data.upper_bound (headSeq);
+  if (i != m_data.begin ())
+    {
+      --i;
+    }
   while (i != m_data.end () && i->first <= tailSeq)
     {
       SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
@@ -195,16 +200,10 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
   // Update variables
   m_size += p->GetSize ();      // Occupancy
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  // The packets before m_nextRxSeq are already counted as available
+  for (BufIterator i = m_data.find (m_nextRxSeq);
+       i != m_data.end () && i->first == m_nextRxSeq; ++i)
     {
-      if (i->first < m_nextRxSeq)
-        {
-          continue;
-        }
-      else if (i->first > m_nextRxSeq)
-        {
-          break;
-        };
       m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
       m_availBytes += i->second->GetSize ();
     }
@@ -32,6 +32,13 @@ NS_LOG_COMPONENT_DEFINE ("TcpTxBuffer");
 
 namespace ns3 {
 
+/* Packets are appended to the last chunk of the buffer as long as it
+ * stays below this size. With the 512-byte default SendSize of
+ * BulkSendApplication, most segments would otherwise span two writes
+ * which every CopyFromSequence, and every retransmission, glues again.
+ */
+static const uint32_t COALESCE_SIZE = 4096;
+
 TypeId
 TcpTxBuffer::GetTypeId (void)
 {
@@ -53,7 +60,7 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0)
+  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_headOffset (0)
 {
 }
 
@@ -107,7 +114,25 @@ TcpTxBuffer::Add (Ptr<Packet> p)
     {
       if (p->GetSize () > 0)
         {
-          m_data.push_back (p);
+          if (!m_data.empty ()
+              && m_data.back ().packet->GetSize () + p->GetSize () <= COALESCE_SIZE)
+            { // Coalesce small writes
+              Chunk &last = m_data.back ();
+              if (!last.owned)
+                {
+                  last.packet = last.packet->Copy ();
+                  last.owned = true;
+                }
+              last.packet->AddAtEnd (p);
+            }
+          else
+            {
+              Chunk chunk;
+              chunk.packet = p;
+              chunk.start = m_headOffset + m_size;
+              chunk.owned = false;
+              m_data.push_back (chunk);
+            }
           m_size += p->GetSize ();
           NS_LOG_LOGIC ("Updated size=" << m_size << ", lastSeq=" << m_firstByteSeq + SequenceNumber32 (m_size));
         }
@@ -129,6 +154,31 @@ TcpTxBuffer::SizeFromSequence (const SequenceNumber32& seq) const
   return lastSeq - seq;
 }
 
+TcpTxBuffer::BufIterator
+TcpTxBuffer::FindChunk (uint32_t offset)
+{
+  // The chunks are contiguous in the stream: find the first one which
+  // ends after offset.
+  BufIterator first = m_data.begin ();
+  uint32_t count = m_data.size ();
+  while (count > 0)
+    {
+      uint32_t step = count / 2;
+      BufIterator i = first + step;
+      if (static_cast<int32_t> (i->start + i->packet->GetSize () - offset) > 0)
+        {
+          count = step;
+        }
+      else
+        {
+          first = i + 1;
+          count -= step + 1;
+        }
+    }
+  NS_ASSERT (first != m_data.end ());
+  return first;
+}
+
 Ptr<Packet>
 TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
 {
@@ -144,55 +194,32 @@ TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
     }
 
   // Extract data from the buffer and return
-  uint32_t offset = seq - m_firstByteSeq.Get ();
-  uint32_t count = 0;      // Offset of the first byte of a packet in the buffer
-  uint32_t pktSize = 0;
-  bool beginFound = false;
-  int pktCount = 0;
-  Ptr<Packet> outPacket;
-  NS_LOG_LOGIC ("There are " << m_data.size () << " number of packets in buffer");
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  uint32_t offset = m_headOffset + (seq - m_firstByteSeq.Get ());
+  NS_LOG_LOGIC ("There are " << m_data.size () << " chunks in buffer");
+  BufIterator i = FindChunk (offset);
+  uint32_t packetOffset = offset - i->start;
+  uint32_t fragmentLength = i->packet->GetSize () - packetOffset;
+  NS_LOG_LOGIC ("First byte found in chunk #" << i - m_data.begin () << " at offset " << packetOffset
+                                              << ", packet len=" << i->packet->GetSize ());
+  if (fragmentLength >= s)
+    { // Data to be copied falls entirely in this packet
+      return i->packet->CreateFragment (packetOffset, s);
+    }
+  Ptr<Packet> outPacket = i->packet->CreateFragment (packetOffset, fragmentLength);
+  uint32_t remaining = s - fragmentLength;
+  for (++i; remaining > 0; ++i)
     {
-      pktCount++;
-      pktSize = (*i)->GetSize ();
-      if (!beginFound)
-        { // Look for first fragment
-          if (count + pktSize > offset)
-            {
-              NS_LOG_LOGIC ("First byte found in packet #" << pktCount << " at buffer offset " << count
-                                                           << ", packet len=" << pktSize);
-              beginFound = true;
-              uint32_t packetOffset = offset - count;
-              uint32_t fragmentLength = count + pktSize - offset;
-              if (fragmentLength >= s)
-                { // Data to be copied falls entirely in this packet
-                  return (*i)->CreateFragment (packetOffset, s);
-                }
-              else
-                { // This packet only fulfills part of the request
-                  outPacket = (*i)->CreateFragment (packetOffset, fragmentLength);
-                }
-              NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-            }
-        }
-      else if (count + pktSize >= offset + s)
+      NS_ASSERT (i != m_data.end ());
+      uint32_t pktSize = i->packet->GetSize ();
+      if (pktSize >= remaining)
         { // Last packet fragment found
-          NS_LOG_LOGIC ("Last byte found in packet #" << pktCount << " at buffer offset " << count
-                                                      << ", packet len=" << pktSize);
-          uint32_t fragmentLength = offset + s - count;
-          Ptr<Packet> endFragment = (*i)->CreateFragment (0, fragmentLength);
-          outPacket->AddAtEnd (endFragment);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
+          outPacket->AddAtEnd (i->packet->CreateFragment (0, remaining));
           break;
         }
-      else
-        {
-          NS_LOG_LOGIC ("Appending to output the packet #" << pktCount << " of offset " << count << " len=" << pktSize);
-          outPacket->AddAtEnd (*i);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-        }
-      count += pktSize;
+      outPacket->AddAtEnd (i->packet);
+      remaining -= pktSize;
     }
+  NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
   NS_ASSERT (outPacket->GetSize () == s);
   return outPacket;
 }
@@ -209,35 +236,23 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
 {
   NS_LOG_FUNCTION (this << seq);
   NS_LOG_LOGIC ("current data size=" << m_size << ", headSeq=" << m_firstByteSeq << ", maxBuffer=" << m_maxBuffer
-                                     << ", numPkts=" << m_data.size ());
+                                     << ", numChunks=" << m_data.size ());
   // Cases do not need to scan the buffer
   if (m_firstByteSeq >= seq) return;
 
-  // Scan the buffer and discard packets
-  uint32_t offset = seq - m_firstByteSeq.Get ();  // Number of bytes to remove
-  uint32_t pktSize;
+  // Number of bytes to remove
+  uint32_t offset = std::min (static_cast<uint32_t> (seq - m_firstByteSeq.Get ()), m_size);
   NS_LOG_LOGIC ("Offset=" << offset);
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end ())
+  m_size -= offset;
+  m_headOffset += offset;
+  m_firstByteSeq += offset;
+  // Drop the chunks which are fully behind the seqnum. The bytes of a
+  // partially acknowledged chunk are skipped by CopyFromSequence.
+  while (!m_data.empty ()
+         && static_cast<int32_t> (m_data.front ().start + m_data.front ().packet->GetSize () - m_headOffset) <= 0)
     {
-      if (offset > (*i)->GetSize ())
-        { // This packet is behind the seqnum. Remove this packet from the buffer
-          pktSize = (*i)->GetSize ();
-          m_size -= pktSize;
-          offset -= pktSize;
-          m_firstByteSeq += pktSize;
-          i = m_data.erase (i);
-          NS_LOG_LOGIC ("Removed one packet of size " << pktSize << ", offset=" << offset);
-        }
-      else if (offset > 0)
-        { // Part of the packet is behind the seqnum. Fragment
-          pktSize = (*i)->GetSize () - offset;
-          *i = (*i)->CreateFragment (offset, pktSize);
-          m_size -= offset;
-          m_firstByteSeq += offset;
-          NS_LOG_LOGIC ("Fragmented one packet by size " << offset << ", new size=" << pktSize);
-          break;
-        }
+      NS_LOG_LOGIC ("Removed one chunk of size " << m_data.front ().packet->GetSize ());
+      m_data.pop_front ();
     }
   // Catching the case of ACKing a FIN
   if (m_size == 0)
@@ -245,7 +260,7 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
       m_firstByteSeq = seq;
     }
   NS_LOG_LOGIC ("size=" << m_size << " headSeq=" << m_firstByteSeq << " maxBuffer=" << m_maxBuffer
-                        <<" numPkts="<< m_data.size ());
+                        <<" numChunks="<< m_data.size ());
   NS_ASSERT (m_firstByteSeq == seq);
 }
 
@@ -21,7 +21,7 @@
 #ifndef TCP_TX_BUFFER_H
 #define TCP_TX_BUFFER_H
 
-#include <list>
+#include <deque>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/object.h"
@@ -36,6 +36,15 @@ class Packet;
  *
  * \brief class for keeping the data sent by the application to the TCP socket, i.e.
  *        the sending buffer.
+ *
+ * The data is kept as a sequence of chunks, each of which holds a packet
+ * and the offset of its first byte in the stream of bytes added to the
+ * buffer. CopyFromSequence finds the first chunk of a range by binary
+ * search, and DiscardUpTo only drops the chunks which are fully
+ * acknowledged: a partially acknowledged chunk is kept whole, and the
+ * bytes before the head sequence are skipped when it is copied from.
+ * Small packets appended in a row are coalesced into a single chunk so
+ * that the segments which span them are carved out of one packet.
  */
 class TcpTxBuffer : public Object
 {
@@ -128,13 +137,27 @@ public:
   void DiscardUpTo (const SequenceNumber32& seq);
 
 private:
+  /// A packet of the buffer and its position in the stream
+  struct Chunk
+  {
+    Ptr<Packet> packet; //!< the data, which is not shared with the application if owned
+    uint32_t start;     //!< stream offset of the first byte of the packet
+    bool owned;         //!< true if packet is a private copy which may be appended to
+  };
   /// container for data stored in the buffer
-  typedef std::list<Ptr<Packet> >::iterator BufIterator;
+  typedef std::deque<Chunk>::iterator BufIterator;
+
+  /**
+   * \param offset a stream offset between m_headOffset and m_headOffset + m_size
+   * \returns the chunk which holds the byte at this offset
+   */
+  BufIterator FindChunk (uint32_t offset);
 
   TracedValue<SequenceNumber32> m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
   uint32_t m_size;                              //!< Number of data bytes
   uint32_t m_maxBuffer;                         //!< Max number of data bytes in buffer (SND.WND)
-  std::list<Ptr<Packet> > m_data;               //!< Corresponding data (may be null)
+  uint32_t m_headOffset;                        //!< Stream offset of the first byte in data
+  std::deque<Chunk> m_data;                     //!< Corresponding data, in stream order
 };
 
 } // namepsace ns3
@@ -26,7 +26,22 @@
 #include "ns3/global-route-manager-impl.h"
 #include "ns3/candidate-queue.h"
 #include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/global-router-interface.h"
 #include <cstdlib> // for rand()
+#include <sstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -214,6 +229,162 @@ GlobalRouteManagerImplTestCase::DoRun (void)
 }
 
 
+/**
+ * Check that the incremental recomputation of the routes, and the SPF
+ * calculations split among several threads, give the same routing tables
+ * as the full recomputation, and that the incremental recomputation does
+ * not touch the routes of the routers which an interface change cannot
+ * affect.
+ */
+class GlobalRouteManagerRecomputeTestCase : public TestCase
+{
+public:
+  GlobalRouteManagerRecomputeTestCase ();
+private:
+  virtual void DoRun (void);
+  void Link (Ptr<Node> a, Ptr<Node> b);
+  std::string GetRoutes (Ptr<Node> node) const;
+  std::vector<Ipv4RoutingTableEntry *> GetEntries (Ptr<Node> node) const;
+  void Recompute (bool incremental, uint32_t threads);
+
+  Ipv4AddressHelper m_address;
+};
+
+GlobalRouteManagerRecomputeTestCase::GlobalRouteManagerRecomputeTestCase ()
+  : TestCase ("Check the incremental and the parallel route computations")
+{
+}
+
+void
+GlobalRouteManagerRecomputeTestCase::Link (Ptr<Node> a, Ptr<Node> b)
+{
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  NetDeviceContainer devices;
+  Ptr<Node> nodes[2] = { a, b };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      device->SetChannel (channel);
+      nodes[i]->AddDevice (device);
+      devices.Add (device);
+    }
+  m_address.Assign (devices);
+  m_address.NewNetwork ();
+}
+
+std::string
+GlobalRouteManagerRecomputeTestCase::GetRoutes (Ptr<Node> node) const
+{
+  std::ostringstream oss;
+  Ptr<Ipv4GlobalRouting> routing = node->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+  for (uint32_t i = 0; i < routing->GetNRoutes (); i++)
+    {
+      oss << *routing->GetRoute (i) << std::endl;
+    }
+  return oss.str ();
+}
+
+std::vector<Ipv4RoutingTableEntry *>
+GlobalRouteManagerRecomputeTestCase::GetEntries (Ptr<Node> node) const
+{
+  std::vector<Ipv4RoutingTableEntry *> entries;
+  Ptr<Ipv4GlobalRouting> routing = node->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+  for (uint32_t i = 0; i < routing->GetNRoutes (); i++)
+    {
+      entries.push_back (routing->GetRoute (i));
+    }
+  return entries;
+}
+
+void
+GlobalRouteManagerRecomputeTestCase::Recompute (bool incremental, uint32_t threads)
+{
+  Config::SetGlobal ("GlobalRoutingIncrementalSpf", BooleanValue (incremental));
+  Config::SetGlobal ("GlobalRoutingSpfThreads", UintegerValue (threads));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+}
+
+void
+GlobalRouteManagerRecomputeTestCase::DoRun (void)
+{
+  // a ring of five routers with a chord, and a separate chain of three
+  // (no equal cost paths go on through a transit network, which SPF asserts on)
+  NodeContainer ring;
+  ring.Create (5);
+  NodeContainer chain;
+  chain.Create (3);
+  InternetStackHelper internet;
+  internet.Install (ring);
+  internet.Install (chain);
+  m_address.SetBase ("10.1.0.0", "255.255.255.0");
+  for (uint32_t i = 0; i < ring.GetN (); i++)
+    {
+      Link (ring.Get (i), ring.Get ((i + 1) % ring.GetN ()));
+    }
+  Link (ring.Get (0), ring.Get (2));
+  Link (chain.Get (0), chain.Get (1));
+  Link (chain.Get (1), chain.Get (2));
+  NodeContainer all (ring, chain);
+
+  Config::SetGlobal ("GlobalRoutingIncrementalSpf", BooleanValue (false));
+  Config::SetGlobal ("GlobalRoutingSpfThreads", UintegerValue (1));
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  std::vector<std::string> initial;
+  std::vector<std::vector<Ipv4RoutingTableEntry *> > entries;
+  for (uint32_t i = 0; i < all.GetN (); i++)
+    {
+      initial.push_back (GetRoutes (all.Get (i)));
+      entries.push_back (GetEntries (all.Get (i)));
+      NS_TEST_ASSERT_MSG_NE (initial[i], "", "No route on node " << i);
+    }
+
+  // nothing has changed: no route is recomputed
+  Recompute (true, 1);
+  for (uint32_t i = 0; i < all.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((GetEntries (all.Get (i)) == entries[i]), true, "Recomputed route on node " << i);
+    }
+
+  // take the chord down: the routers of the chain keep their routes
+  Ptr<Ipv4> ipv4 = ring.Get (2)->GetObject<Ipv4> ();
+  uint32_t chord = ipv4->GetNInterfaces () - 1;
+  ipv4->SetDown (chord);
+  Recompute (true, 1);
+  std::vector<std::string> incremental;
+  for (uint32_t i = 0; i < all.GetN (); i++)
+    {
+      incremental.push_back (GetRoutes (all.Get (i)));
+    }
+  for (uint32_t i = ring.GetN (); i < all.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((GetEntries (all.Get (i)) == entries[i]), true, "Recomputed route on node " << i);
+    }
+  Recompute (false, 1);
+  for (uint32_t i = 0; i < all.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (incremental[i], GetRoutes (all.Get (i)), "Wrong incremental routes on node " << i);
+    }
+  NS_TEST_EXPECT_MSG_NE (incremental[0], initial[0], "Routes of node 0 did not change");
+  Recompute (false, 4);
+  for (uint32_t i = 0; i < all.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (incremental[i], GetRoutes (all.Get (i)), "Wrong parallel routes on node " << i);
+    }
+
+  // and up again
+  ipv4->SetUp (chord);
+  Recompute (true, 2);
+  for (uint32_t i = 0; i < all.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (initial[i], GetRoutes (all.Get (i)), "Wrong routes on node " << i << " after recovery");
+    }
+
+  Config::SetGlobal ("GlobalRoutingIncrementalSpf", BooleanValue (false));
+  Config::SetGlobal ("GlobalRoutingSpfThreads", UintegerValue (1));
+  Simulator::Destroy ();
+}
+
 static class GlobalRouteManagerImplTestSuite : public TestSuite
 {
 public:
@@ -221,5 +392,6 @@ public:
     : TestSuite ("global-route-manager-impl", UNIT)
   {
     AddTestCase (new GlobalRouteManagerImplTestCase (), TestCase::QUICK);
+    AddTestCase (new GlobalRouteManagerRecomputeTestCase (), TestCase::QUICK);
   }
 } g_globalRoutingManagerImplTestSuite;
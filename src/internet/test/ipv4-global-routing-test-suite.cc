@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-table-entry.h"
+
+using namespace ns3;
+
+/**
+ * Check the route selection of Ipv4GlobalRouting: host routes first,
+ * with the equal cost routes in insertion order, then all the network
+ * routes which match, in insertion order, then the first matching AS
+ * external route, and the bookkeeping of RemoveRoute.
+ */
+class Ipv4GlobalRoutingLookupTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingLookupTestCase ();
+private:
+  virtual void DoRun (void);
+  Ptr<Ipv4Route> Lookup (const char *dest, uint32_t oif = 0);
+
+  Ptr<Ipv4> m_ipv4;
+  Ptr<Ipv4GlobalRouting> m_routing;
+};
+
+Ipv4GlobalRoutingLookupTestCase::Ipv4GlobalRoutingLookupTestCase ()
+  : TestCase ("Check the Ipv4GlobalRouting host, network and external route lookups")
+{
+}
+
+Ptr<Ipv4Route>
+Ipv4GlobalRoutingLookupTestCase::Lookup (const char *dest, uint32_t oif)
+{
+  Ipv4Header header;
+  header.SetDestination (Ipv4Address (dest));
+  Socket::SocketErrno error;
+  return m_routing->RouteOutput (Create<Packet> (), header,
+                                 oif == 0 ? 0 : m_ipv4->GetNetDevice (oif), error);
+}
+
+void
+Ipv4GlobalRoutingLookupTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol> ();
+  m_routing = CreateObject<Ipv4GlobalRouting> ();
+  ipv4->SetRoutingProtocol (m_routing);
+  node->AggregateObject (ipv4);
+  m_ipv4 = ipv4;
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      uint32_t interface = m_ipv4->AddInterface (device);
+      m_ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address (0xc0a80001 + (i << 8)),
+                                                           Ipv4Mask ("255.255.255.0")));
+      m_ipv4->SetUp (interface);
+    }
+
+  m_routing->AddASExternalRouteTo (Ipv4Address ("0.0.0.0"), Ipv4Mask ("0.0.0.0"), Ipv4Address ("192.168.0.9"), 1);
+  m_routing->AddASExternalRouteTo (Ipv4Address ("0.0.0.0"), Ipv4Mask ("0.0.0.0"), Ipv4Address ("192.168.1.9"), 2);
+  m_routing->AddNetworkRouteTo (Ipv4Address ("10.0.0.0"), Ipv4Mask ("255.0.0.0"), Ipv4Address ("192.168.0.1"), 1);
+  m_routing->AddNetworkRouteTo (Ipv4Address ("10.1.0.0"), Ipv4Mask ("255.255.0.0"), Ipv4Address ("192.168.1.1"), 2);
+  m_routing->AddHostRouteTo (Ipv4Address ("10.1.2.3"), Ipv4Address ("192.168.2.2"), 3);
+  m_routing->AddHostRouteTo (Ipv4Address ("10.1.2.3"), Ipv4Address ("192.168.1.2"), 2);
+  NS_TEST_ASSERT_MSG_EQ (m_routing->GetNRoutes (), 6U, "Wrong route count");
+
+  // the first equal cost host route, unless the interface is given
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.1.2.3")->GetGateway (), Ipv4Address ("192.168.2.2"), "Wrong host route");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.1.2.3", 2)->GetGateway (), Ipv4Address ("192.168.1.2"), "Wrong host route on interface 2");
+  // network routes are not ordered by prefix length
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.1.2.4")->GetGateway (), Ipv4Address ("192.168.0.1"), "Wrong network route");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.1.2.3", 1)->GetGateway (), Ipv4Address ("192.168.0.1"), "Wrong network route on interface 1");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.1.2.4", 2)->GetGateway (), Ipv4Address ("192.168.1.1"), "Wrong network route on interface 2");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.2.0.1", 2)->GetGateway (), Ipv4Address ("192.168.1.9"), "Wrong external route on interface 2");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("11.0.0.1")->GetGateway (), Ipv4Address ("192.168.0.9"), "Wrong external route");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("11.0.0.1", 3), 0, "Unexpected route on interface 3");
+
+  // host routes come first, then network routes, then external routes
+  m_routing->RemoveRoute (0);
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.1.2.3")->GetGateway (), Ipv4Address ("192.168.1.2"), "Wrong host route after removal");
+  m_routing->RemoveRoute (0);
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.1.2.3")->GetGateway (), Ipv4Address ("192.168.0.1"), "Wrong network route after removal");
+  m_routing->RemoveRoute (0);
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.1.2.3")->GetGateway (), Ipv4Address ("192.168.1.1"), "Wrong network route after removal");
+  m_routing->RemoveRoute (1);
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("11.0.0.1")->GetGateway (), Ipv4Address ("192.168.1.9"), "Wrong external route after removal");
+  NS_TEST_EXPECT_MSG_EQ (m_routing->GetNRoutes (), 2U, "Wrong route count after removal");
+
+  m_routing = 0;
+  m_ipv4 = 0;
+  node->Dispose ();
+}
+
+class Ipv4GlobalRoutingTestSuite : public TestSuite
+{
+public:
+  Ipv4GlobalRoutingTestSuite ()
+    : TestSuite ("ipv4-global-routing", UNIT)
+  {
+    AddTestCase (new Ipv4GlobalRoutingLookupTestCase, TestCase::QUICK);
+  }
+} g_ipv4GlobalRoutingTestSuite;
@@ -0,0 +1,342 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv6-static-routing.h"
+#include "ns3/ipv6-route.h"
+#include "ns3/ipv6-routing-table-entry.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Fill the routing tables with overlapping routes of random prefix
+ * lengths, metrics and interfaces, and check that the indexed lookup
+ * selects the same route as a linear scan of the table which applies
+ * the longest prefix, then lowest metric, then latest route rules,
+ * before and after routes are removed. Every route has its own
+ * gateway, which identifies it in the result.
+ */
+class Ipv4StaticRoutingLpmTestCase : public TestCase
+{
+public:
+  Ipv4StaticRoutingLpmTestCase ();
+private:
+  virtual void DoRun (void);
+  void AddRoutes (uint32_t n);
+  void CheckLookups (uint32_t n);
+
+  Ptr<Ipv4> m_ipv4;
+  Ptr<Ipv4StaticRouting> m_routing;
+  Ptr<UniformRandomVariable> m_random;
+  uint32_t m_nextGateway;
+};
+
+Ipv4StaticRoutingLpmTestCase::Ipv4StaticRoutingLpmTestCase ()
+  : TestCase ("Check the Ipv4StaticRouting longest prefix match against a linear scan"),
+    m_nextGateway (0)
+{
+}
+
+void
+Ipv4StaticRoutingLpmTestCase::AddRoutes (uint32_t n)
+{
+  static const uint32_t lengths[] = { 8, 12, 16, 20, 24, 28, 32 };
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ipv4Address network (0x0a000000 | m_random->GetInteger (0, 0x3ff));
+      Ipv4Mask mask;
+      if (m_random->GetInteger (0, 19) == 0)
+        {
+          mask = Ipv4Mask (0xff00ff00);
+        }
+      else
+        {
+          uint32_t length = lengths[m_random->GetInteger (0, 6)];
+          mask = Ipv4Mask (0xffffffff << (32 - length));
+        }
+      Ipv4Address gateway (0xac100000 + m_nextGateway++);
+      m_routing->AddNetworkRouteTo (network, mask, gateway,
+                                    m_random->GetInteger (1, 3),
+                                    m_random->GetInteger (0, 2));
+    }
+}
+
+void
+Ipv4StaticRoutingLpmTestCase::CheckLookups (uint32_t n)
+{
+  std::vector<Ipv4RoutingTableEntry> routes;
+  std::vector<uint32_t> metrics;
+  for (uint32_t i = 0; i < m_routing->GetNRoutes (); i++)
+    {
+      routes.push_back (m_routing->GetRoute (i));
+      metrics.push_back (m_routing->GetMetric (i));
+    }
+
+  for (uint32_t k = 0; k < n; k++)
+    {
+      Ipv4Address dest (0x0a000000 | m_random->GetInteger (0, 0x3ff));
+      uint32_t oifIndex = m_random->GetInteger (0, 3);
+      Ptr<NetDevice> oif = oifIndex == 0 ? 0 : m_ipv4->GetNetDevice (oifIndex);
+
+      int32_t expected = -1;
+      uint16_t longest = 0;
+      for (uint32_t i = 0; i < routes.size (); i++)
+        {
+          Ipv4Mask mask = routes[i].GetDestNetworkMask ();
+          uint16_t length = mask.GetPrefixLength ();
+          if (!mask.IsMatch (dest, routes[i].GetDestNetwork ())
+              || (oif != 0 && oif != m_ipv4->GetNetDevice (routes[i].GetInterface ())))
+            {
+              continue;
+            }
+          if (expected < 0 || length > longest
+              || (length == longest && metrics[i] <= metrics[expected]))
+            {
+              expected = i;
+              longest = length;
+            }
+        }
+
+      Ipv4Header header;
+      header.SetDestination (dest);
+      Socket::SocketErrno error;
+      Ptr<Ipv4Route> route = m_routing->RouteOutput (Create<Packet> (), header, oif, error);
+      if (expected < 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ (route, 0, "Unexpected route to " << dest);
+          continue;
+        }
+      NS_TEST_ASSERT_MSG_NE (route, 0, "No route to " << dest);
+      NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), routes[expected].GetGateway (),
+                             "Wrong route to " << dest << " through " << oifIndex);
+      NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), m_ipv4->GetNetDevice (routes[expected].GetInterface ()),
+                             "Wrong device to " << dest);
+    }
+}
+
+void
+Ipv4StaticRoutingLpmTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol> ();
+  m_routing = CreateObject<Ipv4StaticRouting> ();
+  ipv4->SetRoutingProtocol (m_routing);
+  node->AggregateObject (ipv4);
+  m_ipv4 = ipv4;
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      uint32_t interface = m_ipv4->AddInterface (device);
+      m_ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address (0xc0a80001 + (i << 8)),
+                                                           Ipv4Mask ("255.255.255.0")));
+      m_ipv4->SetUp (interface);
+    }
+  m_random = CreateObject<UniformRandomVariable> ();
+
+  m_routing->SetDefaultRoute (Ipv4Address ("172.31.0.1"), 1, 3);
+  AddRoutes (300);
+  CheckLookups (2000);
+
+  for (uint32_t i = 0; i < 150; i++)
+    {
+      m_routing->RemoveRoute (m_random->GetInteger (0, m_routing->GetNRoutes () - 1));
+    }
+  CheckLookups (2000);
+
+  AddRoutes (100);
+  CheckLookups (2000);
+
+  m_routing = 0;
+  m_ipv4 = 0;
+  node->Dispose ();
+}
+
+/**
+ * The Ipv6StaticRouting counterpart of Ipv4StaticRoutingLpmTestCase.
+ */
+class Ipv6StaticRoutingLpmTestCase : public TestCase
+{
+public:
+  Ipv6StaticRoutingLpmTestCase ();
+private:
+  virtual void DoRun (void);
+  Ipv6Address RandomAddress (void);
+  void AddRoutes (uint32_t n);
+  void CheckLookups (uint32_t n);
+
+  Ptr<Ipv6> m_ipv6;
+  Ptr<Ipv6StaticRouting> m_routing;
+  Ptr<UniformRandomVariable> m_random;
+  uint32_t m_nextGateway;
+};
+
+Ipv6StaticRoutingLpmTestCase::Ipv6StaticRoutingLpmTestCase ()
+  : TestCase ("Check the Ipv6StaticRouting longest prefix match against a linear scan"),
+    m_nextGateway (0)
+{
+}
+
+Ipv6Address
+Ipv6StaticRoutingLpmTestCase::RandomAddress (void)
+{
+  // a few random bits around each prefix length used by the routes,
+  // so that the routes overlap and long prefixes are matched too.
+  uint8_t bytes[16] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+  bytes[5] = m_random->GetInteger (0, 1);
+  bytes[7] = m_random->GetInteger (0, 3);
+  bytes[8] = m_random->GetInteger (0, 1) << 7;
+  bytes[15] = m_random->GetInteger (0, 3);
+  return Ipv6Address (bytes);
+}
+
+void
+Ipv6StaticRoutingLpmTestCase::AddRoutes (uint32_t n)
+{
+  static const uint8_t lengths[] = { 32, 46, 48, 56, 64, 65, 96, 127, 128 };
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ipv6Prefix prefix;
+      if (m_random->GetInteger (0, 19) == 0)
+        {
+          uint8_t bytes[16] = { 0xff, 0xff, 0xff, 0xff, 0, 0xff, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+          prefix = Ipv6Prefix (bytes);
+        }
+      else
+        {
+          prefix = Ipv6Prefix (lengths[m_random->GetInteger (0, 8)]);
+        }
+      uint8_t gateway[16] = { 0x20, 0x01, 0x0d, 0xb8, 0xff, 0xff, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+      gateway[14] = m_nextGateway >> 8;
+      gateway[15] = m_nextGateway & 0xff;
+      m_nextGateway++;
+      m_routing->AddNetworkRouteTo (RandomAddress (), prefix, Ipv6Address (gateway),
+                                    m_random->GetInteger (1, 3),
+                                    m_random->GetInteger (0, 2));
+    }
+}
+
+void
+Ipv6StaticRoutingLpmTestCase::CheckLookups (uint32_t n)
+{
+  std::vector<Ipv6RoutingTableEntry> routes;
+  std::vector<uint32_t> metrics;
+  for (uint32_t i = 0; i < m_routing->GetNRoutes (); i++)
+    {
+      routes.push_back (m_routing->GetRoute (i));
+      metrics.push_back (m_routing->GetMetric (i));
+    }
+
+  for (uint32_t k = 0; k < n; k++)
+    {
+      Ipv6Address dst = RandomAddress ();
+      uint32_t oifIndex = m_random->GetInteger (0, 3);
+      Ptr<NetDevice> oif = oifIndex == 0 ? 0 : m_ipv6->GetNetDevice (oifIndex);
+
+      int32_t expected = -1;
+      uint16_t longest = 0;
+      for (uint32_t i = 0; i < routes.size (); i++)
+        {
+          Ipv6Prefix prefix = routes[i].GetDestNetworkPrefix ();
+          uint16_t length = prefix.GetPrefixLength ();
+          if (!prefix.IsMatch (dst, routes[i].GetDestNetwork ())
+              || (oif != 0 && oif != m_ipv6->GetNetDevice (routes[i].GetInterface ())))
+            {
+              continue;
+            }
+          if (expected < 0 || length > longest
+              || (length == longest && metrics[i] <= metrics[expected]))
+            {
+              expected = i;
+              longest = length;
+            }
+        }
+
+      Ipv6Header header;
+      header.SetDestinationAddress (dst);
+      Socket::SocketErrno error;
+      Ptr<Ipv6Route> route = m_routing->RouteOutput (Create<Packet> (), header, oif, error);
+      if (expected < 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ (route, 0, "Unexpected route to " << dst);
+          continue;
+        }
+      NS_TEST_ASSERT_MSG_NE (route, 0, "No route to " << dst);
+      NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), routes[expected].GetGateway (),
+                             "Wrong route to " << dst << " through " << oifIndex);
+      NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), m_ipv6->GetNetDevice (routes[expected].GetInterface ()),
+                             "Wrong device to " << dst);
+    }
+}
+
+void
+Ipv6StaticRoutingLpmTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<Ipv6L3Protocol> ipv6 = CreateObject<Ipv6L3Protocol> ();
+  m_routing = CreateObject<Ipv6StaticRouting> ();
+  ipv6->SetRoutingProtocol (m_routing);
+  node->AggregateObject (ipv6);
+  m_ipv6 = ipv6;
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      uint32_t interface = m_ipv6->AddInterface (device);
+      m_ipv6->SetUp (interface);
+    }
+  m_random = CreateObject<UniformRandomVariable> ();
+
+  m_routing->SetDefaultRoute (Ipv6Address ("2001:db8:ffff:ffff::1"), 1, Ipv6Address::GetZero (), 3);
+  AddRoutes (300);
+  CheckLookups (2000);
+
+  for (uint32_t i = 0; i < 150; i++)
+    {
+      m_routing->RemoveRoute (m_random->GetInteger (0, m_routing->GetNRoutes () - 1));
+    }
+  CheckLookups (2000);
+
+  AddRoutes (100);
+  CheckLookups (2000);
+
+  m_routing = 0;
+  m_ipv6 = 0;
+  node->Dispose ();
+}
+
+class StaticRoutingTestSuite : public TestSuite
+{
+public:
+  StaticRoutingTestSuite ()
+    : TestSuite ("static-routing", UNIT)
+  {
+    AddTestCase (new Ipv4StaticRoutingLpmTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv6StaticRoutingLpmTestCase, TestCase::QUICK);
+  }
+} g_staticRoutingTestSuite;
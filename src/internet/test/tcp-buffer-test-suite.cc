@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/tcp-rx-buffer.h"
+#include <vector>
+#include <algorithm>
+
+using namespace ns3;
+
+namespace {
+
+// the byte at stream offset i
+uint8_t
+StreamByte (uint32_t i)
+{
+  return (i * 7 + i / 251) & 0xff;
+}
+
+Ptr<Packet>
+CreateStreamPacket (uint32_t start, uint32_t size)
+{
+  std::vector<uint8_t> bytes (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      bytes[i] = StreamByte (start + i);
+    }
+  return Create<Packet> (&bytes[0], size);
+}
+
+// \returns true if p holds the stream bytes from start on
+bool
+CheckStreamPacket (Ptr<Packet> p, uint32_t start)
+{
+  std::vector<uint8_t> bytes (p->GetSize () + 1);
+  p->CopyData (&bytes[0], p->GetSize ());
+  for (uint32_t i = 0; i < p->GetSize (); i++)
+    {
+      if (bytes[i] != StreamByte (start + i))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+} // anonymous namespace
+
+/**
+ * Carve segments out of a TcpTxBuffer filled with writes of various
+ * sizes, some of which are coalesced, and acknowledge them.
+ */
+class TcpTxBufferTestCase : public TestCase
+{
+public:
+  TcpTxBufferTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+TcpTxBufferTestCase::TcpTxBufferTestCase ()
+  : TestCase ("Check the TcpTxBuffer segments and acknowledgements")
+{
+}
+
+void
+TcpTxBufferTestCase::DoRun (void)
+{
+  TcpTxBuffer buffer (1000);
+  buffer.SetMaxBufferSize (100000);
+  uint32_t sizes[] = { 512, 512, 100, 3000, 5000, 1, 536, 20000, 512 };
+  uint32_t total = 0;
+  for (uint32_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); i++)
+    {
+      Ptr<Packet> p = CreateStreamPacket (total, sizes[i]);
+      NS_TEST_ASSERT_MSG_EQ (buffer.Add (p), true, "Packet rejected");
+      NS_TEST_EXPECT_MSG_EQ (p->GetSize (), sizes[i], "The application packet was modified");
+      total += sizes[i];
+    }
+  NS_TEST_ASSERT_MSG_EQ (buffer.Size (), total, "Wrong buffer size");
+  NS_TEST_EXPECT_MSG_EQ (buffer.Add (Create<Packet> (100000)), false, "Oversized packet accepted");
+
+  // the connection is set up after the data was added
+  buffer.SetHeadSequence (SequenceNumber32 (5000));
+  NS_TEST_EXPECT_MSG_EQ (buffer.TailSequence (), SequenceNumber32 (5000 + total), "Wrong tail sequence");
+
+  uint32_t segmentSizes[] = { 536, 1, 1460, 9000 };
+  for (uint32_t s = 0; s < sizeof (segmentSizes) / sizeof (segmentSizes[0]); s++)
+    {
+      for (uint32_t offset = 0; offset < total; offset += segmentSizes[s])
+        {
+          Ptr<Packet> p = buffer.CopyFromSequence (segmentSizes[s], SequenceNumber32 (5000 + offset));
+          NS_TEST_ASSERT_MSG_EQ (p->GetSize (), std::min (segmentSizes[s], total - offset),
+                                 "Wrong segment size at offset " << offset);
+          NS_TEST_ASSERT_MSG_EQ (CheckStreamPacket (p, offset), true,
+                                 "Wrong segment data at offset " << offset);
+        }
+    }
+
+  // acknowledge in the middle of writes, then across several of them
+  uint32_t acked[] = { 300, 1024, 1124, 9000, 9001, 30000 };
+  for (uint32_t a = 0; a < sizeof (acked) / sizeof (acked[0]); a++)
+    {
+      buffer.DiscardUpTo (SequenceNumber32 (5000 + acked[a]));
+      NS_TEST_ASSERT_MSG_EQ (buffer.HeadSequence (), SequenceNumber32 (5000 + acked[a]), "Wrong head sequence");
+      NS_TEST_ASSERT_MSG_EQ (buffer.Size (), total - acked[a], "Wrong size after acknowledgement");
+      Ptr<Packet> p = buffer.CopyFromSequence (1460, SequenceNumber32 (5000 + acked[a]));
+      NS_TEST_ASSERT_MSG_EQ (CheckStreamPacket (p, acked[a]), true, "Wrong data after acknowledgement");
+    }
+
+  // more data, then acknowledge everything and the FIN
+  Ptr<Packet> p = CreateStreamPacket (total, 1000);
+  buffer.Add (p);
+  total += 1000;
+  p = buffer.CopyFromSequence (3000, buffer.HeadSequence ());
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), total - 30000, "Wrong size of the last segment");
+  NS_TEST_EXPECT_MSG_EQ (CheckStreamPacket (p, 30000), true, "Wrong data of the last segment");
+  buffer.DiscardUpTo (SequenceNumber32 (5000 + total + 1));
+  NS_TEST_EXPECT_MSG_EQ (buffer.Size (), 0U, "Data left after the FIN acknowledgement");
+  NS_TEST_EXPECT_MSG_EQ (buffer.HeadSequence (), SequenceNumber32 (5000 + total + 1), "Wrong head sequence after FIN");
+  NS_TEST_EXPECT_MSG_EQ (buffer.CopyFromSequence (100, buffer.HeadSequence ())->GetSize (), 0U, "Data in empty buffer");
+}
+
+/**
+ * Add out of order and overlapping segments to a TcpRxBuffer and
+ * extract the data.
+ */
+class TcpRxBufferTestCase : public TestCase
+{
+public:
+  TcpRxBufferTestCase ();
+private:
+  virtual void DoRun (void);
+  bool Add (uint32_t start, uint32_t size);
+
+  TcpRxBuffer m_buffer;
+};
+
+TcpRxBufferTestCase::TcpRxBufferTestCase ()
+  : TestCase ("Check the TcpRxBuffer reordering")
+{
+}
+
+bool
+TcpRxBufferTestCase::Add (uint32_t start, uint32_t size)
+{
+  TcpHeader header;
+  header.SetSequenceNumber (SequenceNumber32 (1000 + start));
+  return m_buffer.Add (CreateStreamPacket (start, size), header);
+}
+
+void
+TcpRxBufferTestCase::DoRun (void)
+{
+  m_buffer.SetNextRxSequence (SequenceNumber32 (1000));
+  m_buffer.SetMaxBufferSize (10000);
+
+  NS_TEST_EXPECT_MSG_EQ (Add (1000, 500), true, "Out of order segment rejected");
+  NS_TEST_EXPECT_MSG_EQ (Add (3000, 500), true, "Out of order segment rejected");
+  NS_TEST_EXPECT_MSG_EQ (Add (1200, 100), false, "Duplicate segment accepted");
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.Available (), 0U, "Data available with a hole at the head");
+  // overlaps the tail of the first segment and the head of the second one
+  NS_TEST_EXPECT_MSG_EQ (Add (1400, 2000), true, "Overlapping segment rejected");
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.Size (), 2500U, "Wrong buffer size");
+  NS_TEST_EXPECT_MSG_EQ (Add (0, 1000), true, "Head segment rejected");
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.Available (), 3500U, "Wrong available data");
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.NextRxSequence (), SequenceNumber32 (4500), "Wrong next sequence");
+
+  Ptr<Packet> p = m_buffer.Extract (700);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 700U, "Wrong size of the partial extraction");
+  NS_TEST_EXPECT_MSG_EQ (CheckStreamPacket (p, 0), true, "Wrong data of the partial extraction");
+  // embeds a buffered segment and fills the window
+  NS_TEST_EXPECT_MSG_EQ (Add (4000, 1000), true, "Segment rejected");
+  NS_TEST_EXPECT_MSG_EQ (Add (3400, 20000), true, "Embedding segment rejected");
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.MaxRxSequence (), SequenceNumber32 (1000 + 700 + 10000), "Wrong window");
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.Available (), 10000U, "Wrong available data after the window was filled");
+  p = m_buffer.Extract (20000);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 10000U, "Wrong size of the extraction");
+  NS_TEST_EXPECT_MSG_EQ (CheckStreamPacket (p, 700), true, "Wrong data of the extraction");
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.Size (), 0U, "Data left in the buffer");
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.Extract (100), 0, "Data extracted from an empty buffer");
+}
+
+class TcpBufferTestSuite : public TestSuite
+{
+public:
+  TcpBufferTestSuite ()
+    : TestSuite ("tcp-buffer", UNIT)
+  {
+    AddTestCase (new TcpTxBufferTestCase, TestCase::QUICK);
+    AddTestCase (new TcpRxBufferTestCase, TestCase::QUICK);
+  }
+} g_tcpBufferTestSuite;
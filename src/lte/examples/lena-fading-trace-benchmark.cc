@@ -0,0 +1,183 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Loads a fading trace in the TraceFadingLossModel, from its text file
+// and from the binary file written by TraceFadingLossModel::ConvertTrace,
+// and then evaluates the fading of the links between nEnbs eNBs and nUes
+// UEs at each TTI with either model. A random text trace is written
+// first if no traceFile is given. Prints the wall clock time of each
+// step; the fading computed with the two models is checked to be the
+// same.
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/lte-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LenaFadingTraceBenchmark");
+
+namespace {
+
+std::vector<Ptr<MobilityModel> > g_enbs;
+std::vector<Ptr<MobilityModel> > g_ues;
+double g_checksum = 0.0;
+
+void
+EvaluateTti (Ptr<SpectrumPropagationLossModel> model, Ptr<const SpectrumValue> txPsd)
+{
+  for (uint32_t i = 0; i < g_enbs.size (); i++)
+    {
+      for (uint32_t j = 0; j < g_ues.size (); j++)
+        {
+          Ptr<SpectrumValue> rxPsd = model->CalcRxPowerSpectralDensity (txPsd, g_enbs[i], g_ues[j]);
+          g_checksum += Sum (*rxPsd);
+        }
+    }
+}
+
+Ptr<TraceFadingLossModel>
+CreateModel (std::string traceFile, double traceLength, uint32_t samplesNum, uint32_t rbNum)
+{
+  Ptr<TraceFadingLossModel> model = CreateObject<TraceFadingLossModel> ();
+  model->SetAttribute ("TraceFilename", StringValue (traceFile));
+  model->SetAttribute ("TraceLength", TimeValue (Seconds (traceLength)));
+  model->SetAttribute ("SamplesNum", UintegerValue (samplesNum));
+  model->SetAttribute ("RbNum", UintegerValue (rbNum));
+  model->Initialize ();
+  return model;
+}
+
+/**
+ * Evaluates the fading of all the links for nTtis TTIs, and returns the
+ * checksum of the received PSDs.
+ */
+double
+RunTtis (Ptr<TraceFadingLossModel> model, uint32_t rbNum, uint32_t nTtis, int64_t *ms)
+{
+  model->AssignStreams (1000);
+  std::vector<int> activeRbs;
+  for (uint32_t i = 0; i < rbNum; i++)
+    {
+      activeRbs.push_back (i);
+    }
+  Ptr<SpectrumValue> txPsd = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (100, rbNum, 43.0, activeRbs);
+  for (uint32_t tti = 0; tti < nTtis; tti++)
+    {
+      Simulator::Schedule (MilliSeconds (tti), &EvaluateTti, model, txPsd);
+    }
+  g_checksum = 0.0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  *ms = clock.End ();
+  Simulator::Destroy ();
+  return g_checksum;
+}
+
+} // anonymous namespace
+
+int
+main (int argc, char *argv[])
+{
+  std::string traceFile = "";
+  double traceLength = 10.0;
+  uint32_t samplesNum = 10000;
+  uint32_t rbNum = 100;
+  uint32_t nModels = 100;
+  uint32_t nEnbs = 21;
+  uint32_t nUes = 100;
+  uint32_t nTtis = 1000;
+
+  CommandLine cmd;
+  cmd.AddValue ("traceFile", "Text fading trace, a random one is written if empty", traceFile);
+  cmd.AddValue ("traceLength", "Length of the trace, in seconds", traceLength);
+  cmd.AddValue ("samplesNum", "Number of samples per RB of the trace", samplesNum);
+  cmd.AddValue ("rbNum", "Number of RBs of the trace", rbNum);
+  cmd.AddValue ("nModels", "Number of models loading the binary trace", nModels);
+  cmd.AddValue ("nEnbs", "Number of eNBs", nEnbs);
+  cmd.AddValue ("nUes", "Number of UEs", nUes);
+  cmd.AddValue ("nTtis", "Number of TTIs to evaluate", nTtis);
+  cmd.Parse (argc, argv);
+
+  if (traceFile.empty ())
+    {
+      traceFile = "lena-fading-trace-benchmark.fad";
+      std::ofstream ofTraceFile (traceFile.c_str ());
+      Ptr<NormalRandomVariable> sample = CreateObject<NormalRandomVariable> ();
+      sample->SetAttribute ("Variance", DoubleValue (25.0));
+      for (uint32_t i = 0; i < rbNum; i++)
+        {
+          for (uint32_t j = 0; j < samplesNum; j++)
+            {
+              ofTraceFile << sample->GetValue () << " ";
+            }
+          ofTraceFile << std::endl;
+        }
+    }
+  std::string binaryTraceFile = traceFile + ".bin";
+  TraceFadingLossModel::ConvertTrace (traceFile, binaryTraceFile, rbNum, samplesNum);
+
+  for (uint32_t i = 0; i < nEnbs; i++)
+    {
+      Ptr<MobilityModel> enb = CreateObject<ConstantPositionMobilityModel> ();
+      enb->SetPosition (Vector (i * 500.0, 0.0, 30.0));
+      g_enbs.push_back (enb);
+    }
+  for (uint32_t j = 0; j < nUes; j++)
+    {
+      Ptr<MobilityModel> ue = CreateObject<ConstantPositionMobilityModel> ();
+      ue->SetPosition (Vector (j * 10.0, 100.0, 1.5));
+      g_ues.push_back (ue);
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Ptr<TraceFadingLossModel> textModel = CreateModel (traceFile, traceLength, samplesNum, rbNum);
+  int64_t textLoadMs = clock.End ();
+
+  clock.Start ();
+  Ptr<TraceFadingLossModel> binaryModel = CreateModel (binaryTraceFile, traceLength, samplesNum, rbNum);
+  int64_t binaryLoadMs = clock.End ();
+
+  clock.Start ();
+  std::vector<Ptr<TraceFadingLossModel> > models;
+  for (uint32_t i = 0; i < nModels; i++)
+    {
+      models.push_back (CreateModel (binaryTraceFile, traceLength, samplesNum, rbNum));
+    }
+  int64_t sharedLoadMs = clock.End ();
+
+  int64_t textMs;
+  int64_t binaryMs;
+  double textChecksum = RunTtis (textModel, rbNum, nTtis, &textMs);
+  double binaryChecksum = RunTtis (binaryModel, rbNum, nTtis, &binaryMs);
+  NS_ABORT_MSG_IF (textChecksum != binaryChecksum, "the fading of the binary trace differs: "
+                   << binaryChecksum << " instead of " << textChecksum);
+
+  std::cout << rbNum << " RBs x " << samplesNum << " samples" << std::endl
+            << "  text trace load:   " << textLoadMs << " ms" << std::endl
+            << "  binary trace load: " << binaryLoadMs << " ms" << std::endl
+            << "  " << nModels << " more models:    " << sharedLoadMs << " ms" << std::endl
+            << "  " << nEnbs * nUes << " links, " << nTtis << " TTIs: " << textMs
+            << " ms (text), " << binaryMs << " ms (binary), checksum "
+            << std::setprecision (17) << textChecksum << std::endl;
+  return 0;
+}
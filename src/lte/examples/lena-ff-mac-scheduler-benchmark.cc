@@ -0,0 +1,220 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Drives the FfMacSchedSapProvider of an FF MAC scheduler directly,
+// without the PHY and the MAC: nUes UEs with full buffers report random
+// subband CQIs every cqiPeriod TTIs, and the scheduler allocates the
+// RBGs of the bandwidth at each TTI. Prints the wall clock time per TTI
+// and a digest of the allocations, which should not change when the
+// scheduler is only made faster.
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/lte-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LenaFfMacSchedulerBenchmark");
+
+namespace {
+
+/**
+ * The MAC side of the scheduler SAPs, which records the allocations.
+ */
+class BenchmarkSchedSapUser : public FfMacSchedSapUser,
+                              public FfMacCschedSapUser
+{
+public:
+  BenchmarkSchedSapUser ()
+    : m_nDci (0),
+      m_nRbg (0),
+      m_digest (0)
+  {
+  }
+  virtual void SchedDlConfigInd (const struct SchedDlConfigIndParameters& params)
+  {
+    for (std::vector<BuildDataListElement_s>::const_iterator it = params.m_buildDataList.begin ();
+         it != params.m_buildDataList.end (); ++it)
+      {
+        uint32_t rbBitmap = (*it).m_dci.m_rbBitmap;
+        m_nDci++;
+        for (uint32_t mask = rbBitmap; mask != 0; mask &= mask - 1)
+          {
+            m_nRbg++;
+          }
+        m_digest = m_digest * 31 + (*it).m_rnti;
+        m_digest = m_digest * 31 + rbBitmap;
+      }
+  }
+  virtual void SchedUlConfigInd (const struct SchedUlConfigIndParameters& params)
+  {
+  }
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params)
+  {
+  }
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params)
+  {
+  }
+
+  uint64_t m_nDci;   //!< number of DL DCIs
+  uint64_t m_nRbg;   //!< number of RBGs allocated
+  uint32_t m_digest; //!< hash of the RNTIs and RBG bitmaps of the DCIs
+};
+
+} // anonymous namespace
+
+int
+main (int argc, char *argv[])
+{
+  std::string scheduler = "ns3::PfFfMacScheduler";
+  uint32_t nUes = 200;
+  uint32_t bandwidth = 100;
+  uint32_t nTtis = 2000;
+  uint32_t cqiPeriod = 10;
+
+  CommandLine cmd;
+  cmd.AddValue ("scheduler", "TypeId of the FF MAC scheduler", scheduler);
+  cmd.AddValue ("nUes", "Number of UEs", nUes);
+  cmd.AddValue ("bandwidth", "DL and UL bandwidth, in RBs", bandwidth);
+  cmd.AddValue ("nTtis", "Number of TTIs to schedule", nTtis);
+  cmd.AddValue ("cqiPeriod", "TTIs between the CQI reports of a UE", cqiPeriod);
+  cmd.Parse (argc, argv);
+
+  ObjectFactory factory;
+  factory.SetTypeId (scheduler);
+  // the DL HARQ feedback comes from the PHY, which is not simulated
+  factory.Set ("HarqEnabled", BooleanValue (false));
+  Ptr<FfMacScheduler> sched = factory.Create<FfMacScheduler> ();
+  BenchmarkSchedSapUser user;
+  sched->SetFfMacSchedSapUser (&user);
+  sched->SetFfMacCschedSapUser (&user);
+  FfMacSchedSapProvider *schedSap = sched->GetFfMacSchedSapProvider ();
+  FfMacCschedSapProvider *cschedSap = sched->GetFfMacCschedSapProvider ();
+
+  FfMacCschedSapProvider::CschedCellConfigReqParameters cellConfig;
+  cellConfig.m_dlBandwidth = bandwidth;
+  cellConfig.m_ulBandwidth = bandwidth;
+  cschedSap->CschedCellConfigReq (cellConfig);
+  // allocation type 0 (see table 7.1.6.1-1 of 36.213)
+  int rbgSize = bandwidth < 10 ? 1 : bandwidth < 26 ? 2 : bandwidth < 63 ? 3 : 4;
+  int rbgNum = bandwidth / rbgSize;
+
+  for (uint16_t rnti = 1; rnti <= nUes; rnti++)
+    {
+      FfMacCschedSapProvider::CschedUeConfigReqParameters ueConfig;
+      ueConfig.m_rnti = rnti;
+      ueConfig.m_transmissionMode = 0;  // SISO
+      cschedSap->CschedUeConfigReq (ueConfig);
+
+      FfMacCschedSapProvider::CschedLcConfigReqParameters lcConfig;
+      lcConfig.m_rnti = rnti;
+      lcConfig.m_reconfigureFlag = false;
+      LogicalChannelConfigListElement_s lc;
+      lc.m_logicalChannelIdentity = 3;
+      lc.m_logicalChannelGroup = 0;
+      lc.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+      lc.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lc.m_qci = 9;
+      lc.m_eRabMaximulBitrateUl = 0;
+      lc.m_eRabMaximulBitrateDl = 0;
+      lc.m_eRabGuaranteedBitrateUl = 0;
+      lc.m_eRabGuaranteedBitrateDl = 0;
+      lcConfig.m_logicalChannelConfigList.push_back (lc);
+      cschedSap->CschedLcConfigReq (lcConfig);
+
+      // full buffer
+      FfMacSchedSapProvider::SchedDlRlcBufferReqParameters buffer;
+      buffer.m_rnti = rnti;
+      buffer.m_logicalChannelIdentity = 3;
+      buffer.m_rlcTransmissionQueueSize = 1000000000;
+      buffer.m_rlcTransmissionQueueHolDelay = 0;
+      buffer.m_rlcRetransmissionQueueSize = 0;
+      buffer.m_rlcRetransmissionHolDelay = 0;
+      buffer.m_rlcStatusPduSize = 0;
+      schedSap->SchedDlRlcBufferReq (buffer);
+    }
+
+  Ptr<UniformRandomVariable> cqi = CreateObject<UniformRandomVariable> ();
+  cqi->SetAttribute ("Min", DoubleValue (1));
+  cqi->SetAttribute ("Max", DoubleValue (15));
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t tti = 0; tti < nTtis; tti++)
+    {
+      uint16_t sfnSf = (((tti / 10) & 0x3ff) << 4) | (tti % 10);
+
+      // the UEs report their CQIs in turn
+      FfMacSchedSapProvider::SchedDlCqiInfoReqParameters cqiInfo;
+      cqiInfo.m_sfnSf = sfnSf;
+      for (uint16_t rnti = 1 + tti % cqiPeriod; rnti <= nUes; rnti += cqiPeriod)
+        {
+          CqiListElement_s wb;
+          wb.m_rnti = rnti;
+          wb.m_ri = 1;
+          wb.m_cqiType = CqiListElement_s::P10;
+          wb.m_wbCqi.push_back (cqi->GetInteger ());
+          wb.m_wbPmi = 0;
+          cqiInfo.m_cqiList.push_back (wb);
+
+          CqiListElement_s sb;
+          sb.m_rnti = rnti;
+          sb.m_ri = 1;
+          sb.m_cqiType = CqiListElement_s::A30;
+          sb.m_wbPmi = 0;
+          sb.m_sbMeasResult.m_higherLayerSelected.resize (rbgNum);
+          for (int i = 0; i < rbgNum; i++)
+            {
+              sb.m_sbMeasResult.m_higherLayerSelected[i].m_sbPmi = 0;
+              sb.m_sbMeasResult.m_higherLayerSelected[i].m_sbCqi.push_back (cqi->GetInteger ());
+            }
+          cqiInfo.m_cqiList.push_back (sb);
+        }
+      schedSap->SchedDlCqiInfoReq (cqiInfo);
+
+      FfMacSchedSapProvider::SchedDlTriggerReqParameters trigger;
+      trigger.m_sfnSf = sfnSf;
+      schedSap->SchedDlTriggerReq (trigger);
+    }
+  int64_t ms = clock.End ();
+
+  std::cout << scheduler << ": " << nUes << " UEs, " << bandwidth << " RBs, "
+            << nTtis << " TTIs in " << ms << " ms ("
+            << std::fixed << std::setprecision (3) << double (ms) * 1000 / nTtis
+            << " us per TTI), " << user.m_nDci << " DCIs, " << user.m_nRbg
+            << " RBGs, digest " << std::hex << user.m_digest << std::endl;
+
+  sched->Dispose ();
+  return 0;
+}
@@ -0,0 +1,141 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Simulates the downlink and uplink of a full-buffer hexagonal layout of
+// nSites three-sector sites (57 cells by default), with nUesPerCell UEs
+// dropped at random in the area, so that every PHY receives the signals
+// of all the cells and UEs at each TTI. Prints the wall clock time of
+// the simulation and checksums of the TBs received and of the RSRP and
+// SINR reported by the UEs, which should not change when the
+// interference computation is only made faster.
+
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/lte-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LenaInterferenceBenchmark");
+
+namespace {
+
+uint64_t g_nTbs = 0;
+uint64_t g_nCorrectTbs = 0;
+uint64_t g_correctBytes = 0;
+double g_rsrpSinrSum = 0.0;
+
+void
+PhyReception (PhyReceptionStatParameters params)
+{
+  g_nTbs++;
+  if (params.m_correctness)
+    {
+      g_nCorrectTbs++;
+      g_correctBytes += params.m_size;
+    }
+}
+
+void
+ReportCurrentCellRsrpSinr (uint16_t cellId, uint16_t rnti, double rsrp, double sinr)
+{
+  g_rsrpSinrSum += rsrp + sinr;
+}
+
+} // anonymous namespace
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nSites = 19;
+  uint32_t gridWidth = 5;
+  uint32_t nUesPerCell = 2;
+  double interSiteDistance = 500;
+  uint32_t bandwidth = 25;
+  double simTime = 0.5;
+
+  CommandLine cmd;
+  cmd.AddValue ("nSites", "Number of three-sector sites", nSites);
+  cmd.AddValue ("gridWidth", "Number of sites per row of the grid", gridWidth);
+  cmd.AddValue ("nUesPerCell", "Number of UEs per cell", nUesPerCell);
+  cmd.AddValue ("interSiteDistance", "Distance between the sites, in meters", interSiteDistance);
+  cmd.AddValue ("bandwidth", "DL and UL bandwidth, in RBs", bandwidth);
+  cmd.AddValue ("simTime", "Simulated time, in seconds", simTime);
+  cmd.Parse (argc, argv);
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::FriisSpectrumPropagationLossModel"));
+  lteHelper->SetEnbAntennaModelType ("ns3::ParabolicAntennaModel");
+  lteHelper->SetEnbAntennaModelAttribute ("Beamwidth", DoubleValue (70));
+  lteHelper->SetEnbAntennaModelAttribute ("MaxAttenuation", DoubleValue (20.0));
+  lteHelper->SetEnbDeviceAttribute ("DlBandwidth", UintegerValue (bandwidth));
+  lteHelper->SetEnbDeviceAttribute ("UlBandwidth", UintegerValue (bandwidth));
+
+  NodeContainer enbNodes;
+  enbNodes.Create (nSites * 3);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (enbNodes);
+  Ptr<LteHexGridEnbTopologyHelper> hexGridHelper = CreateObject<LteHexGridEnbTopologyHelper> ();
+  hexGridHelper->SetLteHelper (lteHelper);
+  hexGridHelper->SetAttribute ("InterSiteDistance", DoubleValue (interSiteDistance));
+  hexGridHelper->SetAttribute ("MinX", DoubleValue (interSiteDistance / 2));
+  hexGridHelper->SetAttribute ("GridWidth", UintegerValue (gridWidth));
+  NetDeviceContainer enbDevs = hexGridHelper->SetPositionAndInstallEnbDevice (enbNodes);
+
+  NodeContainer ueNodes;
+  ueNodes.Create (enbNodes.GetN () * nUesPerCell);
+  uint32_t nRows = (nSites + gridWidth - 1) / gridWidth;
+  Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable> ();
+  x->SetAttribute ("Max", DoubleValue ((gridWidth + 0.5) * interSiteDistance));
+  Ptr<UniformRandomVariable> y = CreateObject<UniformRandomVariable> ();
+  y->SetAttribute ("Max", DoubleValue (nRows * interSiteDistance * std::sqrt (0.75)));
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < ueNodes.GetN (); i++)
+    {
+      positions->Add (Vector (x->GetValue (), y->GetValue (), 1.5));
+    }
+  mobility.SetPositionAllocator (positions);
+  mobility.Install (ueNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+
+  // full buffer traffic, through the RLC saturation mode
+  lteHelper->AttachToClosestEnb (ueDevs, enbDevs);
+  lteHelper->ActivateDataRadioBearer (ueDevs, EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::LteUeNetDevice/LteUePhy/DlSpectrumPhy/DlPhyReception",
+                                 MakeCallback (&PhyReception));
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::LteEnbNetDevice/LteEnbPhy/UlSpectrumPhy/UlPhyReception",
+                                 MakeCallback (&PhyReception));
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::LteUeNetDevice/LteUePhy/ReportCurrentCellRsrpSinr",
+                                 MakeCallback (&ReportCurrentCellRsrpSinr));
+
+  Simulator::Stop (Seconds (simTime));
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t ms = clock.End ();
+  Simulator::Destroy ();
+
+  std::cout << enbDevs.GetN () << " cells, " << ueDevs.GetN () << " UEs, "
+            << simTime << " s simulated in " << ms << " ms" << std::endl
+            << "  " << g_nTbs << " TBs received, " << g_nCorrectTbs << " correctly ("
+            << g_correctBytes << " bytes), RSRP+SINR checksum "
+            << std::setprecision (17) << g_rsrpSinrSum << std::endl;
+  return 0;
+}
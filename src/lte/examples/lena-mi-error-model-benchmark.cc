@@ -0,0 +1,132 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Evaluates the LteMiErrorModel as the PHY and the AMC of a cell do at
+// each TTI, without simulating them: the TBs of nUes UEs sharing the
+// bandwidth, a quarter of which are HARQ retransmissions, the PCFICH and
+// PDCCH, and the CQIs of the MiErrorModel AMC, over random SINRs. Prints
+// the wall clock time of each and a checksum of the results, which
+// should not change when the error model is only made faster.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/lte-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LenaMiErrorModelBenchmark");
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t bandwidth = 100;
+  uint32_t nUes = 10;
+  uint32_t nTtis = 1000;
+  double minSinrDb = -5.0;
+  double maxSinrDb = 25.0;
+
+  CommandLine cmd;
+  cmd.AddValue ("bandwidth", "Bandwidth, in RBs", bandwidth);
+  cmd.AddValue ("nUes", "Number of UEs scheduled at each TTI", nUes);
+  cmd.AddValue ("nTtis", "Number of TTIs", nTtis);
+  cmd.AddValue ("minSinrDb", "Lowest SINR of an RB, in dB", minSinrDb);
+  cmd.AddValue ("maxSinrDb", "Highest SINR of an RB, in dB", maxSinrDb);
+  cmd.Parse (argc, argv);
+
+  Ptr<SpectrumModel> model = LteSpectrumValueHelper::GetSpectrumModel (100, bandwidth);
+  Ptr<LteAmc> amc = CreateObject<LteAmc> ();
+  amc->SetAttribute ("AmcModel", EnumValue (LteAmc::MiErrorModel));
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+
+  // draw the SINRs and the TBs first, so that only the error model is timed
+  std::vector<SpectrumValue> sinrs;
+  std::vector<uint8_t> mcss;
+  for (uint32_t tti = 0; tti < nTtis; tti++)
+    {
+      SpectrumValue sinr (model);
+      for (Values::iterator it = sinr.ValuesBegin (); it != sinr.ValuesEnd (); ++it)
+        {
+          *it = std::pow (10.0, random->GetValue (minSinrDb, maxSinrDb) / 10.0);
+        }
+      sinrs.push_back (sinr);
+      for (uint32_t ue = 0; ue < nUes; ue++)
+        {
+          mcss.push_back (random->GetInteger (0, 28));
+        }
+    }
+  uint32_t rbsPerUe = bandwidth / nUes;
+  NS_ABORT_MSG_IF (rbsPerUe == 0, "More UEs than RBs");
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  double tblerSum = 0.0;
+  for (uint32_t tti = 0; tti < nTtis; tti++)
+    {
+      for (uint32_t ue = 0; ue < nUes; ue++)
+        {
+          std::vector<int> map;
+          for (uint32_t rb = ue * rbsPerUe; rb < (ue + 1) * rbsPerUe; rb++)
+            {
+              map.push_back (rb);
+            }
+          uint8_t mcs = mcss[tti * nUes + ue];
+          uint16_t size = amc->GetTbSizeFromMcs (mcs, rbsPerUe) / 8;
+          HarqProcessInfoList_t harqInfoList;
+          if ((tti + ue) % 4 == 0)
+            {
+              HarqProcessInfoElement_t el;
+              el.m_mi = 0.5;
+              el.m_rv = 0;
+              el.m_infoBits = size * 8;
+              el.m_codeBits = size * 16;
+              harqInfoList.push_back (el);
+            }
+          TbStats_t tbStats = LteMiErrorModel::GetTbDecodificationStats (sinrs[tti], map, size, mcs, harqInfoList);
+          tblerSum += tbStats.tbler + tbStats.mi;
+        }
+    }
+  int64_t tbMs = clock.End ();
+
+  clock.Start ();
+  double pdcchSum = 0.0;
+  for (uint32_t tti = 0; tti < nTtis; tti++)
+    {
+      pdcchSum += LteMiErrorModel::GetPcfichPdcchError (sinrs[tti]);
+    }
+  int64_t pdcchMs = clock.End ();
+
+  clock.Start ();
+  uint64_t cqiSum = 0;
+  int rbgSize = bandwidth < 10 ? 1 : bandwidth < 26 ? 2 : bandwidth < 63 ? 3 : 4;
+  for (uint32_t tti = 0; tti < nTtis; tti++)
+    {
+      std::vector<int> cqi = amc->CreateCqiFeedbacks (sinrs[tti], rbgSize);
+      for (uint32_t i = 0; i < cqi.size (); i++)
+        {
+          cqiSum = cqiSum * 3 + cqi[i];
+        }
+    }
+  int64_t cqiMs = clock.End ();
+
+  std::cout << std::setprecision (12)
+            << bandwidth << " RBs, " << nTtis << " TTIs" << std::endl
+            << "  PDSCH TBs:   " << tbMs << " ms, checksum " << tblerSum << std::endl
+            << "  PCFICH-PDCCH: " << pdcchMs << " ms, checksum " << pdcchSum << std::endl
+            << "  AMC CQIs:    " << cqiMs << " ms, checksum " << cqiSum << std::endl;
+  return 0;
+}
@@ -33,6 +33,24 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("EpcSgwPgwApplication")
   ;
 
+namespace {
+
+/**
+ * Fibonacci hashing: the top bits of the product depend on all the bits
+ * of the address, and consecutive addresses are spread out
+ *
+ * \param ueAddr the address of a UE
+ * \param shift 32 minus the log2 of the number of slots
+ * \return the slot index of ueAddr
+ */
+inline uint32_t
+HashUeAddr (uint32_t ueAddr, uint32_t shift)
+{
+  return (ueAddr * 0x9e3779b9U) >> shift;
+}
+
+} // anonymous namespace
+
 
 /////////////////////////
 // UeInfo
@@ -113,6 +131,8 @@ EpcSgwPgwApplication::DoDispose ()
 EpcSgwPgwApplication::EpcSgwPgwApplication (const Ptr<VirtualNetDevice> tunDevice, const Ptr<Socket> s1uSocket)
   : m_s1uSocket (s1uSocket),
     m_tunDevice (tunDevice),
+    m_nUeAddrs (0),
+    m_ueAddrShift (32),
     m_gtpuUdpPort (2152), // fixed by the standard
     m_teidCount (0),
     m_s11SapMme (0)
@@ -135,22 +155,21 @@ EpcSgwPgwApplication::RecvFromTunDevice (Ptr<Packet> packet, const Address& sour
   NS_LOG_FUNCTION (this << source << dest << packet << packet->GetSize ());
 
   // get IP address of UE
-  Ptr<Packet> pCopy = packet->Copy ();
   Ipv4Header ipv4Header;
-  pCopy->RemoveHeader (ipv4Header);
+  packet->PeekHeader (ipv4Header);
   Ipv4Address ueAddr =  ipv4Header.GetDestination ();
   NS_LOG_LOGIC ("packet addressed to UE " << ueAddr);
 
   // find corresponding UeInfo address
-  std::map<Ipv4Address, Ptr<UeInfo> >::iterator it = m_ueInfoByAddrMap.find (ueAddr);
-  if (it == m_ueInfoByAddrMap.end ())
+  UeAddrSlot *slot = m_ueAddrSlots.empty () ? 0 : FindUeAddrSlot (ueAddr.Get ());
+  if (slot == 0 || slot->ueInfo == 0)
     {        
       NS_LOG_WARN ("unknown UE address " << ueAddr) ;
     }
   else
     {
-      Ipv4Address enbAddr = it->second->GetEnbAddr ();      
-      uint32_t teid = it->second->Classify (packet);   
+      Ipv4Address enbAddr = slot->ueInfo->GetEnbAddr ();      
+      uint32_t teid = slot->ueInfo->Classify (packet);   
       if (teid == 0)
         {
           NS_LOG_WARN ("no matching bearer for this packet");                   
@@ -245,10 +264,55 @@ EpcSgwPgwApplication::SetUeAddress (uint64_t imsi, Ipv4Address ueAddr)
   NS_LOG_FUNCTION (this << imsi << ueAddr);
   std::map<uint64_t, Ptr<UeInfo> >::iterator ueit = m_ueInfoByImsiMap.find (imsi);
   NS_ASSERT_MSG (ueit != m_ueInfoByImsiMap.end (), "unknown IMSI " << imsi); 
-  m_ueInfoByAddrMap[ueAddr] = ueit->second;
+  if ((m_nUeAddrs + 1) * 2 > m_ueAddrSlots.size ())
+    {
+      GrowUeAddrSlots ();
+    }
+  UeAddrSlot *slot = FindUeAddrSlot (ueAddr.Get ());
+  if (slot->ueInfo == 0)
+    {
+      ++m_nUeAddrs;
+    }
+  slot->ueAddr = ueAddr.Get ();
+  slot->ueInfo = ueit->second;
   ueit->second->SetUeAddr (ueAddr);
 }
 
+EpcSgwPgwApplication::UeAddrSlot *
+EpcSgwPgwApplication::FindUeAddrSlot (uint32_t ueAddr)
+{
+  uint32_t mask = m_ueAddrSlots.size () - 1;
+  uint32_t i = HashUeAddr (ueAddr, m_ueAddrShift);
+  while (m_ueAddrSlots[i].ueInfo != 0 && m_ueAddrSlots[i].ueAddr != ueAddr)
+    {
+      i = (i + 1) & mask;
+    }
+  return &m_ueAddrSlots[i];
+}
+
+void
+EpcSgwPgwApplication::GrowUeAddrSlots ()
+{
+  NS_LOG_FUNCTION (this << m_ueAddrSlots.size ());
+  std::vector<UeAddrSlot> old;
+  old.swap (m_ueAddrSlots);
+  UeAddrSlot empty;
+  empty.ueAddr = 0;
+  m_ueAddrSlots.assign (old.empty () ? 64 : old.size () * 2, empty);
+  m_ueAddrShift = 32;
+  for (uint32_t size = m_ueAddrSlots.size (); size > 1; size >>= 1)
+    {
+      --m_ueAddrShift;
+    }
+  for (std::vector<UeAddrSlot>::const_iterator it = old.begin (); it != old.end (); ++it)
+    {
+      if (it->ueInfo != 0)
+        {
+          *FindUeAddrSlot (it->ueAddr) = *it;
+        }
+    }
+}
+
 void 
 EpcSgwPgwApplication::DoCreateSessionRequest (EpcS11SapSgw::CreateSessionRequestMessage req)
 {
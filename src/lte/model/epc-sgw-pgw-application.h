@@ -37,6 +37,7 @@
 #include <ns3/epc-s1ap-sap.h>
 #include <ns3/epc-s11-sap.h>
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -228,9 +229,45 @@ private:
   Ptr<VirtualNetDevice> m_tunDevice;
 
   /**
-   * Map telling for each UE address the corresponding UE info 
+   * A slot of the hash table telling for each UE address the
+   * corresponding UE info
    */
-  std::map<Ipv4Address, Ptr<UeInfo> > m_ueInfoByAddrMap;
+  struct UeAddrSlot
+  {
+    uint32_t ueAddr;
+    Ptr<UeInfo> ueInfo; ///< 0 if the slot is empty
+  };
+
+  /** 
+   * \param ueAddr the address of a UE
+   * 
+   * \return the slot of the UE address, or the empty slot where it
+   * would be inserted
+   */
+  UeAddrSlot * FindUeAddrSlot (uint32_t ueAddr);
+
+  /** 
+   * Double the number of slots of the hash table of UE addresses
+   */
+  void GrowUeAddrSlots ();
+
+  /**
+   * Hash table telling for each UE address the corresponding UE info,
+   * with open addressing, since it is looked up for every downlink
+   * packet: power of two sized, and at most half full
+   */
+  std::vector<UeAddrSlot> m_ueAddrSlots;
+
+  /**
+   * number of UE addresses in m_ueAddrSlots
+   */
+  uint32_t m_nUeAddrs;
+
+  /**
+   * 32 minus the log2 of the number of slots of m_ueAddrSlots, to keep
+   * the top bits of the hash of a UE address
+   */
+  uint32_t m_ueAddrShift;
 
   /**
    * Map telling for each IMSI the corresponding UE info 
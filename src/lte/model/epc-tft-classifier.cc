@@ -36,11 +36,60 @@
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/tcp-l4-protocol.h"
 
+#include <algorithm>
+
 NS_LOG_COMPONENT_DEFINE ("EpcTftClassifier");
 
 namespace ns3 {
 
+namespace {
+
+/**
+ * \param address an address of a PacketFilter
+ * \param mask the mask of the address
+ * \param exact set to false if the mask is not a prefix, in which case
+ * the addresses matching the PacketFilter are not a range
+ *
+ * \return the range of addresses matching the PacketFilter, or all the
+ * addresses if the mask is not a prefix
+ */
+std::pair<uint32_t, uint32_t>
+GetAddressRange (Ipv4Address address, Ipv4Mask mask, bool &exact)
+{
+  uint32_t inverse = mask.GetInverse ();
+  if ((inverse & (inverse + 1)) != 0)
+    {
+      exact = false;
+      return std::make_pair (0, 0xffffffff);
+    }
+  uint32_t low = address.Get () & mask.Get ();
+  return std::make_pair (low, low | inverse);
+}
+
+/**
+ * \param word a non-zero word
+ *
+ * \return the index of the lowest bit set in the word
+ */
+uint32_t
+GetLowestBitIndex (uint64_t word)
+{
+  // multiply the lowest bit by a de Bruijn sequence, whose 64 windows of
+  // 6 bits are distinct
+  static const uint8_t index[64] = {
+    0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+    62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+    63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+    46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+  };
+  return index[((word & (~word + 1)) * 0x03f79d71b4cb0a89ULL) >> 58];
+}
+
+} // anonymous namespace
+
 EpcTftClassifier::EpcTftClassifier ()
+  : m_compiled (false),
+    m_nWords (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -51,6 +100,7 @@ EpcTftClassifier::Add (Ptr<EpcTft> tft, uint32_t id)
   NS_LOG_FUNCTION (this << tft);
   
   m_tftMap[id] = tft;  
+  m_compiled = false;
   
   // simple sanity check: there shouldn't be more than 16 bearers (hence TFTs) per UE
   NS_ASSERT (m_tftMap.size () <= 16);
@@ -61,8 +111,118 @@ EpcTftClassifier::Delete (uint32_t id)
 {
   NS_LOG_FUNCTION (this << id);
   m_tftMap.erase (id);
+  m_compiled = false;
 }
 
+void
+EpcTftClassifier::Compile ()
+{
+  NS_LOG_FUNCTION (this);
+
+  // we use a reverse iterator since filter priority is not implemented properly.
+  // This way, since the default bearer is expected to be added first, it will be evaluated last.
+  m_filters.clear ();
+  m_filterTftIds.clear ();
+  for (std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it = m_tftMap.rbegin ();
+       it != m_tftMap.rend ();
+       ++it)
+    {
+      std::list<EpcTft::PacketFilter> filters = it->second->GetPacketFilters ();
+      for (std::list<EpcTft::PacketFilter>::const_iterator fit = filters.begin ();
+           fit != filters.end ();
+           ++fit)
+        {
+          m_filters.push_back (*fit);
+          m_filterTftIds.push_back (it->first);
+        }
+    }
+  m_nWords = (m_filters.size () + 63) / 64;
+  NS_LOG_LOGIC ("compiling " << m_filters.size () << " packet filters of " << m_tftMap.size () << " TFTs");
+
+  std::vector<std::pair<uint32_t, uint32_t> > remoteAddresses;
+  std::vector<std::pair<uint32_t, uint32_t> > localAddresses;
+  std::vector<std::pair<uint32_t, uint32_t> > remotePorts;
+  std::vector<std::pair<uint32_t, uint32_t> > localPorts;
+  m_typeOfService.assign (256 * m_nWords, 0);
+  m_direction.assign (2 * m_nWords, 0);
+  m_inexact.assign (m_nWords, 0);
+  for (uint32_t i = 0; i < m_filters.size (); ++i)
+    {
+      const EpcTft::PacketFilter &f = m_filters[i];
+      uint32_t word = i / 64;
+      uint64_t bit = ((uint64_t) 1) << (i % 64);
+      bool exact = true;
+      remoteAddresses.push_back (GetAddressRange (f.remoteAddress, f.remoteMask, exact));
+      localAddresses.push_back (GetAddressRange (f.localAddress, f.localMask, exact));
+      remotePorts.push_back (std::make_pair (f.remotePortStart, f.remotePortEnd));
+      localPorts.push_back (std::make_pair (f.localPortStart, f.localPortEnd));
+      for (uint32_t tos = 0; tos < 256; ++tos)
+        {
+          if ((tos & f.typeOfServiceMask) == (f.typeOfService & f.typeOfServiceMask))
+            {
+              m_typeOfService[tos * m_nWords + word] |= bit;
+            }
+        }
+      if (f.direction & EpcTft::DOWNLINK)
+        {
+          m_direction[word] |= bit;
+        }
+      if (f.direction & EpcTft::UPLINK)
+        {
+          m_direction[m_nWords + word] |= bit;
+        }
+      if (!exact)
+        {
+          m_inexact[word] |= bit;
+        }
+    }
+  CompileField (m_remoteAddress, remoteAddresses);
+  CompileField (m_localAddress, localAddresses);
+  CompileField (m_remotePort, remotePorts);
+  CompileField (m_localPort, localPorts);
+  m_compiled = true;
+}
+
+void
+EpcTftClassifier::CompileField (Field &field, const std::vector<std::pair<uint32_t, uint32_t> > &ranges) const
+{
+  field.starts.clear ();
+  field.starts.push_back (0);
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator it = ranges.begin ();
+       it != ranges.end ();
+       ++it)
+    {
+      if (it->first <= it->second)
+        {
+          field.starts.push_back (it->first);
+          if (it->second < 0xffffffff)
+            {
+              field.starts.push_back (it->second + 1);
+            }
+        }
+    }
+  std::sort (field.starts.begin (), field.starts.end ());
+  field.starts.erase (std::unique (field.starts.begin (), field.starts.end ()), field.starts.end ());
+
+  field.bits.assign (field.starts.size () * m_nWords, 0);
+  for (uint32_t i = 0; i < ranges.size (); ++i)
+    {
+      uint64_t bit = ((uint64_t) 1) << (i % 64);
+      for (uint32_t k = std::lower_bound (field.starts.begin (), field.starts.end (), ranges[i].first) - field.starts.begin ();
+           k < field.starts.size () && field.starts[k] <= ranges[i].second;
+           ++k)
+        {
+          field.bits[k * m_nWords + i / 64] |= bit;
+        }
+    }
+}
+
+const uint64_t *
+EpcTftClassifier::Lookup (const Field &field, uint32_t value) const
+{
+  uint32_t k = std::upper_bound (field.starts.begin (), field.starts.end (), value) - field.starts.begin () - 1;
+  return &field.bits[k * m_nWords];
+}
  
 uint32_t 
 EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
@@ -142,20 +302,34 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
 	       << " tos=0x" << (uint16_t) tos );
 
   // now it is possible to classify the packet!
-  // we use a reverse iterator since filter priority is not implemented properly.
-  // This way, since the default bearer is expected to be added first, it will be evaluated last.
-  std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
-  NS_LOG_LOGIC ("TFT MAP size: " << m_tftMap.size ());
-
-  for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
+  if (!m_compiled)
+    {
+      Compile ();
+    }
+  if (m_filters.empty ())
+    {
+      NS_LOG_LOGIC ("no match");
+      return 0;  // no match
+    }
+  const uint64_t *d = &m_direction[direction == EpcTft::UPLINK ? m_nWords : 0];
+  const uint64_t *ra = Lookup (m_remoteAddress, remoteAddress.Get ());
+  const uint64_t *la = Lookup (m_localAddress, localAddress.Get ());
+  const uint64_t *rp = Lookup (m_remotePort, remotePort);
+  const uint64_t *lp = Lookup (m_localPort, localPort);
+  const uint64_t *t = &m_typeOfService[tos * m_nWords];
+  for (uint32_t word = 0; word < m_nWords; ++word)
     {
-      NS_LOG_LOGIC ("TFT id: " << it->first );
-      NS_LOG_LOGIC (" Ptr<EpcTft>: " << it->second);
-      Ptr<EpcTft> tft = it->second;         
-      if (tft->Matches (direction, remoteAddress, localAddress, remotePort, localPort, tos))
+      uint64_t matches = d[word] & ra[word] & la[word] & rp[word] & lp[word] & t[word];
+      while (matches != 0)
         {
-	  NS_LOG_LOGIC ("matches with TFT ID = " << it->first);
-	  return it->first; // the id of the matching TFT
+          uint32_t i = word * 64 + GetLowestBitIndex (matches);
+          if ((m_inexact[word] & matches & (~matches + 1)) == 0
+              || m_filters[i].Matches (direction, remoteAddress, localAddress, remotePort, localPort, tos))
+            {
+              NS_LOG_LOGIC ("matches with TFT ID = " << m_filterTftIds[i]);
+              return m_filterTftIds[i]; // the id of the matching TFT
+            }
+          matches &= matches - 1;
         }
     }
   NS_LOG_LOGIC ("no match");
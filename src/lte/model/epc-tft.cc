@@ -192,5 +192,12 @@ EpcTft::Matches (Direction direction,
   return false;
 }
 
+std::list<EpcTft::PacketFilter>
+EpcTft::GetPacketFilters () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_filters;
+}
+
 
 } // namespace ns3
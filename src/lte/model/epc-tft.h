@@ -150,6 +150,12 @@ public:
 		  uint16_t localPort,
 		  uint8_t typeOfService);
 
+  /** 
+   * 
+   * \return the PacketFilters of the TFT, in order of precedence
+   */
+  std::list<PacketFilter> GetPacketFilters () const;
+
 
 private:
 
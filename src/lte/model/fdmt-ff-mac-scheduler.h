@@ -31,6 +31,7 @@
 #include <set>
 #include <ns3/nstime.h>
 #include <ns3/lte-amc.h>
+#include <ns3/ff-mac-scheduler-kernel.h>
 
 
 // value for SINR outside the range defined by FF-API, used to indicate that there
@@ -171,6 +172,8 @@ private:
 
   Ptr<LteAmc> m_amc;
 
+  FfMacSchedulerKernel m_kernel;
+
   /*
    * Vectors of UE's LC info
   */
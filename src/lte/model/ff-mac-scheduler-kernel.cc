@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/ff-mac-scheduler-kernel.h>
+#include <ns3/lte-amc.h>
+#include <ns3/log.h>
+#include <ns3/assert.h>
+
+NS_LOG_COMPONENT_DEFINE ("FfMacSchedulerKernel");
+
+namespace ns3 {
+
+FfMacSchedulerKernel::FfMacSchedulerKernel ()
+  : m_rbgNum (0),
+    m_nUes (0),
+    m_mcs0Rate (0)
+{
+  for (int cqi = 0; cqi < 16; cqi++)
+    {
+      m_cqiRates[cqi] = 0;
+    }
+}
+
+void
+FfMacSchedulerKernel::Start (int rbgNum, int rbgSize, Ptr<LteAmc> amc)
+{
+  NS_LOG_FUNCTION (this << rbgNum << rbgSize);
+  m_rbgNum = rbgNum;
+  m_nUes = 0;
+  for (int cqi = 0; cqi < 16; cqi++)
+    {
+      m_cqiRates[cqi] = (amc->GetTbSizeFromMcs (amc->GetMcsFromCqi (cqi), rbgSize) / 8) / 0.001;   // = TB size / TTI
+    }
+  m_mcs0Rate = (amc->GetTbSizeFromMcs (0, rbgSize) / 8) / 0.001;
+}
+
+uint32_t
+FfMacSchedulerKernel::AddUe (uint16_t rnti, double normalization)
+{
+  uint32_t slot = m_nUes++;
+  if (m_nUes > m_rntis.size ())
+    {
+      m_rntis.resize (m_nUes);
+      m_normalizations.resize (m_nUes);
+    }
+  if (m_nUes * m_rbgNum > m_rates.size ())
+    {
+      m_rates.resize (m_nUes * m_rbgNum);
+    }
+  m_rntis[slot] = rnti;
+  m_normalizations[slot] = normalization;
+  return slot;
+}
+
+void
+FfMacSchedulerKernel::SetSbCqi (uint32_t slot, const SbMeasResult_s *sbMeasResult, int nLayer)
+{
+  NS_ASSERT (slot < m_nUes);
+  double *rates = &m_rates[slot * m_rbgNum];
+  if (sbMeasResult == 0)
+    {
+      // start with the lowest CQI on every layer
+      double rate = 0.0;
+      for (int k = 0; k < nLayer; k++)
+        {
+          rate += m_cqiRates[1];
+        }
+      for (int i = 0; i < m_rbgNum; i++)
+        {
+          rates[i] = rate;
+        }
+      return;
+    }
+  for (int i = 0; i < m_rbgNum; i++)
+    {
+      const std::vector<uint8_t> &sbCqi = sbMeasResult->m_higherLayerSelected.at (i).m_sbCqi;
+      uint8_t cqi2 = sbCqi.size () > 1 ? sbCqi[1] : 1;
+      if (sbCqi.at (0) == 0 && cqi2 == 0)
+        {
+          // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
+          rates[i] = 0.0;
+          continue;
+        }
+      double rate = 0.0;
+      for (int k = 0; k < nLayer; k++)
+        {
+          // no info on this subband -> worst MCS
+          rate += k < static_cast<int> (sbCqi.size ()) ? m_cqiRates[sbCqi[k]] : m_mcs0Rate;
+        }
+      rates[i] = rate;
+    }
+}
+
+double
+FfMacSchedulerKernel::GetRate (uint8_t cqi) const
+{
+  NS_ASSERT (cqi < 16);
+  return m_cqiRates[cqi];
+}
+
+void
+FfMacSchedulerKernel::Select (void)
+{
+  NS_LOG_FUNCTION (this << m_nUes);
+  m_bestMetrics.assign (m_rbgNum, 0.0);
+  m_bestSlots.assign (m_rbgNum, -1);
+  if (m_rbgNum == 0)
+    {
+      return;
+    }
+  double *bestMetrics = &m_bestMetrics[0];
+  int32_t *bestSlots = &m_bestSlots[0];
+  for (uint32_t slot = 0; slot < m_nUes; slot++)
+    {
+      // branch free, so that the compiler can vectorize the RBG loop
+      const double *rates = &m_rates[slot * m_rbgNum];
+      double normalization = m_normalizations[slot];
+      for (int i = 0; i < m_rbgNum; i++)
+        {
+          double metric = rates[i] / normalization;
+          bool better = metric > bestMetrics[i];
+          bestMetrics[i] = better ? metric : bestMetrics[i];
+          bestSlots[i] = better ? static_cast<int32_t> (slot) : bestSlots[i];
+        }
+    }
+}
+
+int32_t
+FfMacSchedulerKernel::GetSelectedSlot (int rbg) const
+{
+  NS_ASSERT (rbg < static_cast<int> (m_bestSlots.size ()));
+  return m_bestSlots[rbg];
+}
+
+uint16_t
+FfMacSchedulerKernel::GetRnti (uint32_t slot) const
+{
+  NS_ASSERT (slot < m_nUes);
+  return m_rntis[slot];
+}
+
+} // namespace ns3
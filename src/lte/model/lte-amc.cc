@@ -343,10 +343,19 @@ LteAmc::CreateCqiFeedbacks (const SpectrumValue& sinr, uint8_t rbgSize)
          {
             uint8_t mcs = 0;
             TbStats_t tbStats;
+            HarqProcessInfoList_t harqInfoList;
+            // the MI of the RBG only depends on the modulation of the MCS
+            double mib = 0.0;
+            int mibModulation = -1;
             while (mcs <= 28)
               {
-                HarqProcessInfoList_t harqInfoList;
-                tbStats = LteMiErrorModel::GetTbDecodificationStats (sinr, rbgMap, (uint16_t)GetTbSizeFromMcs (mcs, rbgSize) / 8, mcs, harqInfoList);
+                int modulation = (mcs <= MI_QPSK_MAX_ID) ? 2 : (mcs <= MI_16QAM_MAX_ID) ? 4 : 6;
+                if (modulation != mibModulation)
+                  {
+                    mib = LteMiErrorModel::Mib (sinr, rbgMap, mcs);
+                    mibModulation = modulation;
+                  }
+                tbStats = LteMiErrorModel::GetTbDecodificationStatsFromMib (mib, (uint16_t)GetTbSizeFromMcs (mcs, rbgSize) / 8, mcs, harqInfoList);
                 if (tbStats.tbler > 0.1)
                   {
                     break;
@@ -54,6 +54,7 @@ LteInterference::DoDispose ()
   m_rxSignal = 0;
   m_allSignals = 0;
   m_noise = 0;
+  m_lastBatch = 0;
   Object::DoDispose ();
 } 
 
@@ -78,15 +79,15 @@ LteInterference::StartRx (Ptr<const SpectrumValue> rxPsd)
       m_rxSignal = rxPsd->Copy ();
       m_lastChangeTime = Now ();
       m_receiving = true;
-      for (std::list<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
         {
           (*it)->Start ();
         }
-      for (std::list<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
         {
           (*it)->Start ();
         }
-      for (std::list<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
           (*it)->Start (); 
         }
@@ -115,15 +116,15 @@ LteInterference::EndRx ()
     {
       ConditionallyEvaluateChunk ();
       m_receiving = false;
-      for (std::list<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
         {
           (*it)->End ();
         }
-      for (std::list<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
         {
           (*it)->End ();
         }
-      for (std::list<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
           (*it)->End (); 
         }
@@ -136,6 +137,13 @@ LteInterference::AddSignal (Ptr<const SpectrumValue> spd, const Time duration)
 {
   NS_LOG_FUNCTION (this << *spd << duration);
   DoAddSignal (spd);
+  if (m_lastBatch != 0 && m_lastBatchStart == Now () && m_lastBatchDuration == duration)
+    {
+      // the signal is subtracted with the others of the same TTI, in
+      // the same order as if each had its own event
+      m_lastBatch->signals.push_back (spd);
+      return;
+    }
   uint32_t signalId = ++m_lastSignalId;
   if (signalId == m_lastSignalIdBeforeReset)
     {
@@ -146,7 +154,12 @@ LteInterference::AddSignal (Ptr<const SpectrumValue> spd, const Time duration)
       // boundary further.
       m_lastSignalIdBeforeReset += 0x10000000;
     }
-  Simulator::Schedule (duration, &LteInterference::DoSubtractSignal, this, spd, signalId);
+  m_lastBatch = Create<SignalBatch> ();
+  m_lastBatch->signals.push_back (spd);
+  m_lastBatch->signalId = signalId;
+  m_lastBatchStart = Now ();
+  m_lastBatchDuration = duration;
+  Simulator::Schedule (duration, &LteInterference::DoSubtractSignals, this, m_lastBatch);
 }
 
 
@@ -159,18 +172,27 @@ LteInterference::DoAddSignal  (Ptr<const SpectrumValue> spd)
 }
 
 void
-LteInterference::DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signalId)
+LteInterference::DoSubtractSignals  (Ptr<SignalBatch> batch)
 { 
-  NS_LOG_FUNCTION (this << *spd);
+  NS_LOG_FUNCTION (this << batch->signals.size ());
   ConditionallyEvaluateChunk ();   
-  int32_t deltaSignalId = signalId - m_lastSignalIdBeforeReset;
+  if (batch == m_lastBatch)
+    {
+      m_lastBatch = 0;
+    }
+  int32_t deltaSignalId = batch->signalId - m_lastSignalIdBeforeReset;
   if (deltaSignalId > 0)
     {   
-      (*m_allSignals) -= (*spd);
+      for (std::vector<Ptr<const SpectrumValue> >::const_iterator it = batch->signals.begin ();
+           it != batch->signals.end ();
+           ++it)
+        {
+          (*m_allSignals) -= (**it);
+        }
     }
   else
     {
-      NS_LOG_INFO ("ignoring signal scheduled for subtraction before last reset");
+      NS_LOG_INFO ("ignoring signals scheduled for subtraction before last reset");
     }
 }
 
@@ -188,19 +210,24 @@ LteInterference::ConditionallyEvaluateChunk ()
     {
       NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
+      // interf = allSignals - rxSignal + noise and sinr = rxSignal / interf,
+      // in place, without allocating new values
+      m_interf = *m_allSignals;
+      m_interf -= *m_rxSignal;
+      m_interf += *m_noise;
 
-      SpectrumValue sinr = (*m_rxSignal) / interf;
+      m_sinr = *m_rxSignal;
+      m_sinr /= m_interf;
       Time duration = Now () - m_lastChangeTime;
-      for (std::list<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
-          (*it)->EvaluateSinrChunk (sinr, duration);
+          (*it)->EvaluateSinrChunk (m_sinr, duration);
         }
-      for (std::list<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
         {
-          (*it)->EvaluateSinrChunk (interf, duration);
+          (*it)->EvaluateSinrChunk (m_interf, duration);
         }
-      for (std::list<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
         {
           (*it)->EvaluateSinrChunk (*m_rxSignal, duration);
         }
@@ -225,6 +252,7 @@ LteInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd
   // record the last SignalId so that we can ignore all signals that
   // were scheduled for subtraction before m_allSignal 
   m_lastSignalIdBeforeReset = m_lastSignalId;
+  m_lastBatch = 0;
 }
 
 void
@@ -26,8 +26,9 @@
 #include <ns3/packet.h>
 #include <ns3/nstime.h>
 #include <ns3/spectrum-value.h>
+#include <ns3/simple-ref-count.h>
 
-#include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -42,6 +43,12 @@ class LteSinrChunkProcessor;
  * This class implements a gaussian interference model, i.e., all
  * incoming signals are added to the total interference.
  *
+ * Since all the cells transmit in sync, the signals perceived by a
+ * PHY usually start at the same time and have the same duration. Such
+ * signals are subtracted from the total interference by a single
+ * event, rather than one event each; the SINR and interference of a
+ * chunk are computed in buffers which are kept from one chunk to the
+ * next.
  */
 class LteInterference : public Object
 {
@@ -115,9 +122,19 @@ public:
   void SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd);
 
 private:
+  /**
+   * The signals which started at the same time and have the same
+   * duration, in order of arrival, which are subtracted together
+   */
+  struct SignalBatch : public SimpleRefCount<SignalBatch>
+  {
+    std::vector<Ptr<const SpectrumValue> > signals;
+    uint32_t signalId;
+  };
+
   void ConditionallyEvaluateChunk ();
   void DoAddSignal  (Ptr<const SpectrumValue> spd);
-  void DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signalId);
+  void DoSubtractSignals  (Ptr<SignalBatch> batch);
 
 
 
@@ -141,17 +158,24 @@ private:
   uint32_t m_lastSignalId;
   uint32_t m_lastSignalIdBeforeReset;
 
+  Ptr<SignalBatch> m_lastBatch; ///< the last batch of signals, which is pending subtraction
+  Time m_lastBatchStart; ///< the time at which the signals of m_lastBatch started
+  Time m_lastBatchDuration; ///< the duration of the signals of m_lastBatch
+
+  SpectrumValue m_sinr; ///< the SINR of the last chunk
+  SpectrumValue m_interf; ///< the interference and noise of the last chunk
+
   /** all the processor instances that need to be notified whenever
   a new interference chunk is calculated */
-  std::list<Ptr<LteSinrChunkProcessor> > m_rsPowerChunkProcessorList;
+  std::vector<Ptr<LteSinrChunkProcessor> > m_rsPowerChunkProcessorList;
 
   /** all the processor instances that need to be notified whenever
       a new SINR chunk is calculated */
-  std::list<Ptr<LteSinrChunkProcessor> > m_sinrChunkProcessorList;
+  std::vector<Ptr<LteSinrChunkProcessor> > m_sinrChunkProcessorList;
 
   /** all the processor instances that need to be notified whenever
       a new interference chunk is calculated */
-  std::list<Ptr<LteSinrChunkProcessor> > m_interfChunkProcessorList; 
+  std::vector<Ptr<LteSinrChunkProcessor> > m_interfChunkProcessorList; 
 
 
 };
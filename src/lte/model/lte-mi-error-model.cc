@@ -32,6 +32,7 @@
 
 #include <list>
 #include <vector>
+#include <algorithm>
 #include <ns3/log.h>
 #include <ns3/pointer.h>
 #include <stdint.h>
@@ -326,76 +327,52 @@ LteMiErrorModel::Mib (const SpectrumValue& sinr, const std::vector<int>& map, ui
 {
   NS_LOG_FUNCTION (sinr << &map << (uint32_t) mcs);
   
+  // the MI map of the modulation of the MCS
+  const double *miMap;
+  const double *miMapAxis;
+  uint16_t miMapSize;
+  if (mcs <= MI_QPSK_MAX_ID) // QPSK
+    {
+      miMap = MI_map_qpsk;
+      miMapAxis = MI_map_qpsk_axis;
+      miMapSize = MI_MAP_QPSK_SIZE;
+    }
+  else if (mcs <= MI_16QAM_MAX_ID) // 16-QAM
+    {
+      miMap = MI_map_16qam;
+      miMapAxis = MI_map_16qam_axis;
+      miMapSize = MI_MAP_16QAM_SIZE;
+    }
+  else // 64-QAM
+    {
+      miMap = MI_map_64qam;
+      miMapAxis = MI_map_64qam_axis;
+      miMapSize = MI_MAP_64QAM_SIZE;
+    }
+  // since the values in the MI map axis are uniformly spaced, we have
+  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
+  const double scalingCoeff = (miMapSize - 1) / (miMapAxis[miMapSize - 1] - miMapAxis[0]);
+  const double maxSinr = miMapAxis[miMapSize - 1];
+
   double MI;
   double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
-  
+  Values::const_iterator sinrBegin = sinr.ConstValuesBegin ();
+  NS_ASSERT (sinr.ConstValuesEnd () - sinrBegin >= 0);
+  size_t nRbs = sinr.ConstValuesEnd () - sinrBegin;
   for (uint32_t i = 0; i < map.size (); i++)
     {
-      double sinrLin = sinrCopy[map.at (i)];
-      if (mcs <= MI_QPSK_MAX_ID) // QPSK
+      NS_ASSERT_MSG (map[i] >= 0 && static_cast<size_t> (map[i]) < nRbs, "RB " << map[i] << " out of the SINR");
+      double sinrLin = sinrBegin[map[i]];
+      if (sinrLin > maxSinr)
         {
-
-          if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1])
-            {
-              MI = 1;
-            }
-          else 
-            { 
-              // since the values in MI_map_qpsk_axis are uniformly spaced, we have
-              // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-              // the scaling coefficient is always the same, so we use a static const
-              // to speed up the calculation
-              static const double scalingCoeffQpsk = 
-                (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0]);
-              double sinrIndexDouble = (sinrLin -  MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
-              uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-              NS_ASSERT_MSG (sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-              MI = MI_map_qpsk[sinrIndex];
-            }
+          MI = 1;
         }
-      else
-        {
-          if (mcs > MI_QPSK_MAX_ID && mcs <= MI_16QAM_MAX_ID )	// 16-QAM
-            {
-              if (sinrLin > MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else 
-                {
-                  // since the values in MI_map_16QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff16qam = 
-                    (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1] - MI_map_16qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_16qam_axis[0]) * scalingCoeff16qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_16QAM_SIZE, "MI map out of data");
-                  MI = MI_map_16qam[sinrIndex];
-                }
-            }
-          else // 64-QAM
-            {
-              if (sinrLin > MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else
-                {
-                  // since the values in MI_map_64QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff64qam = 
-                    (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1] - MI_map_64qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_64qam_axis[0]) * scalingCoeff64qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_64QAM_SIZE, "MI map out of data");
-                  MI = MI_map_64qam[sinrIndex];
-                }
-            }
+      else 
+        { 
+          double sinrIndexDouble = (sinrLin - miMapAxis[0]) * scalingCoeff + 1;
+          uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
+          NS_ASSERT_MSG (sinrIndex < miMapSize, "MI map out of data");
+          MI = miMap[sinrIndex];
         }
       NS_LOG_LOGIC (" RB " << map.at (i) << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
       MIsum += MI;
@@ -406,44 +383,59 @@ LteMiErrorModel::Mib (const SpectrumValue& sinr, const std::vector<int>& map, ui
 }
 
 
+namespace {
+
+/**
+ * The parameters b and c of the BLER curves of each CB size and ECR,
+ * where the missing curves are replaced by those of the lowest larger
+ * CB size which has one, computed once.
+ */
+struct MiBlerCurves
+{
+  MiBlerCurves ()
+  {
+    for (int cbIndex = 0; cbIndex < 9; cbIndex++)
+      {
+        for (int ecrId = 0; ecrId <= MI_64QAM_BLER_MAX_ID; ecrId++)
+          {
+            //take the lowest CB size including this CB for removing CB size
+            //quatization errors
+            int i = cbIndex;
+            double bi = bEcrTable[i][ecrId];
+            while ((i<9)&&(bi<0))
+              {
+                bi = bEcrTable[i++][ecrId];
+              }
+            b[cbIndex][ecrId] = bi;
+            i = cbIndex;
+            double ci = cEcrTable[i][ecrId];
+            while ((i<9)&&(ci<0))
+              {
+                ci = cEcrTable[i++][ecrId];
+              }
+            c[cbIndex][ecrId] = ci;
+          }
+      }
+  }
+  double b[9][MI_64QAM_BLER_MAX_ID + 1];
+  double c[9][MI_64QAM_BLER_MAX_ID + 1];
+};
+
+} // anonymous namespace
+
 double 
 LteMiErrorModel::MappingMiBler (double mib, uint8_t ecrId, uint16_t cbSize)
 {
   NS_LOG_FUNCTION (mib << (uint32_t) ecrId << (uint32_t) cbSize);
-  double b = 0;
-  double c = 0;
+  static const MiBlerCurves curves;
 
   NS_ASSERT_MSG (ecrId <= MI_64QAM_BLER_MAX_ID, "ECR out of range [0..37]: " << (uint16_t) ecrId);
-  int cbIndex = 1;
-  while ((cbIndex < 9)&&(cbMiSizeTable[cbIndex]<= cbSize))
-    {
-      cbIndex++;
-    }
-  cbIndex--;
+  // the largest curve CB size not above cbSize, or the smallest one
+  int cbIndex = std::upper_bound (cbMiSizeTable + 1, cbMiSizeTable + 9, cbSize) - cbMiSizeTable - 1;
   NS_LOG_LOGIC (" ECRid " << (uint16_t)ecrId << " ECR " << BlerCurvesEcrMap[ecrId] << " CB size " << cbSize << " CB size curve " << cbMiSizeTable[cbIndex]);
 
-  b = bEcrTable[cbIndex][ecrId];
-  if (b<0.0)
-    {
-      //take the lowest CB size including this CB for removing CB size
-      //quatization errors
-      int i = cbIndex;
-      while ((i<9)&&(b<0))
-        {
-          b = bEcrTable[i++][ecrId];
-        }
-    }
-  c = cEcrTable[cbIndex][ecrId];
-  if (c<0.0)
-    {
-      //take the lowest CB size including this CB for removing CB size
-      //quatization errors
-      int i = cbIndex;
-      while ((i<9)&&(c<0))
-        {
-          c = cEcrTable[i++][ecrId];
-        }
-    }
+  double b = curves.b[cbIndex][ecrId];
+  double c = curves.c[cbIndex][ecrId];
   // see IEEE802.16m EMD formula 55 of section 4.3.2.1
   double bler = 0.5*( 1 - erf((mib-b)/(sqrt(2)*c)) );
   NS_LOG_LOGIC ("MIB: " << mib << " BLER:" << bler << " b:" << b << " c:" << c);
@@ -458,24 +450,21 @@ LteMiErrorModel::GetPcfichPdcchError (const SpectrumValue& sinr)
   NS_LOG_FUNCTION (sinr);
   double MI;
   double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
-  Values::iterator sinrIt = sinrCopy.ValuesBegin ();
+  Values::const_iterator sinrIt = sinr.ConstValuesBegin ();
   uint16_t rb = 0;
-  NS_ASSERT (sinrIt!=sinrCopy.ValuesEnd ());
-  while (sinrIt!=sinrCopy.ValuesEnd ())
+  NS_ASSERT (sinrIt!=sinr.ConstValuesEnd ());
+  // the MI maps and the BLER curve are sorted: search them by bisection
+  double *axisEnd = MI_map_qpsk_axis + MI_MAP_QPSK_SIZE;
+  while (sinrIt!=sinr.ConstValuesEnd ())
     {
       double sinrLin = *sinrIt;
-      int tr = 0;
-      while ((tr<MI_MAP_QPSK_SIZE)&&(MI_map_qpsk_axis[tr] < sinrLin))
-        {
-          tr++;
-        }
       if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1])
         {
           MI = 1;
         }
       else 
         {
+          int tr = std::lower_bound (MI_map_qpsk_axis, axisEnd, sinrLin) - MI_map_qpsk_axis;
           NS_ASSERT_MSG (tr<MI_MAP_QPSK_SIZE, "MI map out of data");
           MI = MI_map_qpsk[tr];
         }
@@ -486,18 +475,14 @@ LteMiErrorModel::GetPcfichPdcchError (const SpectrumValue& sinr)
     }
   MI = MIsum / rb;
   // return to the effective SINR value
-  int j = 0;
   double esinr = 0.0;
-  while ((j<MI_MAP_QPSK_SIZE)&&(MI_map_qpsk[j] < MI))
-    {
-      j++;
-    }
   if (MI > MI_map_qpsk[MI_MAP_QPSK_SIZE-1])
     {
       esinr = MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1];
     }
   else 
     {
+      int j = std::lower_bound (MI_map_qpsk, MI_map_qpsk + MI_MAP_QPSK_SIZE, MI) - MI_map_qpsk;
       NS_ASSERT_MSG (j<MI_MAP_QPSK_SIZE, "MI map out of data");
       // take the closest value (when possible)  
       if (j>0)
@@ -519,18 +504,14 @@ LteMiErrorModel::GetPcfichPdcchError (const SpectrumValue& sinr)
 
   double esirnDb = 10*log10 (esinr); 
 //   NS_LOG_DEBUG ("Effective SINR " << esirnDb << " max " << 10*log10 (MI_map_qpsk [MI_MAP_QPSK_SIZE-1]));
-  uint16_t i = 0;
   double errorRate = 0.0;
-  while ((i<PDCCH_PCFICH_CURVE_SIZE)&&(PdcchPcfichBlerCurveXaxis[i] < esirnDb))
-    {
-      i++;
-    }
   if (esirnDb > PdcchPcfichBlerCurveXaxis[PDCCH_PCFICH_CURVE_SIZE-1])
     {
       errorRate = 0.0;
     }
   else 
     {
+      int i = std::lower_bound (PdcchPcfichBlerCurveXaxis, PdcchPcfichBlerCurveXaxis + PDCCH_PCFICH_CURVE_SIZE, esirnDb) - PdcchPcfichBlerCurveXaxis;
       NS_ASSERT_MSG (i<PDCCH_PCFICH_CURVE_SIZE, "PDCCH-PCFICH map out of data");
       errorRate = PdcchPcfichBlerCurveYaxis[i];
     }  
@@ -542,11 +523,19 @@ LteMiErrorModel::GetPcfichPdcchError (const SpectrumValue& sinr)
 
 
 TbStats_t
-LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, HarqProcessInfoList_t miHistory)
+LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory)
 {
   NS_LOG_FUNCTION (sinr << &map << (uint32_t) size << (uint32_t) mcs);
 
-  double tbMi = Mib(sinr, map, mcs);
+  return GetTbDecodificationStatsFromMib (Mib (sinr, map, mcs), size, mcs, miHistory);
+}
+
+
+TbStats_t
+LteMiErrorModel::GetTbDecodificationStatsFromMib (double tbMi, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory)
+{
+  NS_LOG_FUNCTION (tbMi << (uint32_t) size << (uint32_t) mcs);
+
   double MI = 0.0;
   double Reff = 0.0;
   NS_ASSERT (mcs < 29);
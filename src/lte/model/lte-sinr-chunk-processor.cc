@@ -78,7 +78,7 @@ LteCtrlSinrChunkProcessor::EvaluateSinrChunk (const SpectrumValue& sinr, Time du
     {
       m_sumSinr = Create<SpectrumValue> (sinr.GetSpectrumModel ());
     }
-  (*m_sumSinr) += sinr * duration.GetSeconds ();
+  m_sumSinr->AddScaled (sinr, duration.GetSeconds ());
   m_totDuration += duration;
 }
  
@@ -146,7 +146,7 @@ LteDataSinrChunkProcessor::EvaluateSinrChunk (const SpectrumValue& sinr, Time du
   {
     m_sumSinr = Create<SpectrumValue> (sinr.GetSpectrumModel ());
   }
-  (*m_sumSinr) += sinr * duration.GetSeconds ();
+  m_sumSinr->AddScaled (sinr, duration.GetSeconds ());
   m_totDuration += duration;
 }
 
@@ -203,7 +203,7 @@ LteRsReceivedPowerChunkProcessor::EvaluateSinrChunk (const SpectrumValue& sinr,
     {
       m_sumSinr = Create<SpectrumValue> (sinr.GetSpectrumModel ());
     }
-  (*m_sumSinr) += sinr * duration.GetSeconds ();
+  m_sumSinr->AddScaled (sinr, duration.GetSeconds ());
   m_totDuration += duration;
 }
 
@@ -257,7 +257,7 @@ LteInterferencePowerChunkProcessor::EvaluateSinrChunk (const SpectrumValue& sinr
     {
       m_sumSinr = Create<SpectrumValue> (sinr.GetSpectrumModel ());
     }
-  (*m_sumSinr) += sinr * duration.GetSeconds ();
+  m_sumSinr->AddScaled (sinr, duration.GetSeconds ());
   m_totDuration += duration;
 }
 
@@ -946,7 +946,8 @@ LteSpectrumPhy::EndRxData ()
                 
                     if (!m_ltePhyRxDataEndOkCallback.IsNull ())
                       {
-                        m_ltePhyRxDataEndOkCallback (*j);
+                        // the packet burst is shared by all the receivers
+                        m_ltePhyRxDataEndOkCallback ((*j)->Copy ());
                       }
                   }
                 else
@@ -1075,7 +1076,6 @@ LteSpectrumPhy::EndRxDlCtrl ()
   if (m_ctrlErrorModelEnabled)
     {
       double  errorRate = LteMiErrorModel::GetPcfichPdcchError (m_sinrPerceived);
-      errorRate = LteMiErrorModel::GetPcfichPdcchError (m_sinrPerceived);
       error = m_random->GetValue () > errorRate ? false : true;
       NS_LOG_DEBUG (this << " PCFICH-PDCCH Decodification, errorRate " << errorRate << " error " << error);
     }
@@ -39,7 +39,7 @@ LteSpectrumSignalParameters::LteSpectrumSignalParameters (const LteSpectrumSigna
   : SpectrumSignalParameters (p)
 {
   NS_LOG_FUNCTION (this << &p);
-  packetBurst = p.packetBurst->Copy ();
+  packetBurst = p.packetBurst;
 }
 
 Ptr<SpectrumSignalParameters>
@@ -68,10 +68,7 @@ LteSpectrumSignalParametersDataFrame::LteSpectrumSignalParametersDataFrame (cons
 {
   NS_LOG_FUNCTION (this << &p);
   cellId = p.cellId;
-  if (p.packetBurst)
-    {
-      packetBurst = p.packetBurst->Copy ();
-    }
+  packetBurst = p.packetBurst;
   ctrlMsgList = p.ctrlMsgList;
 }
 
@@ -53,7 +53,9 @@ struct LteSpectrumSignalParameters : public SpectrumSignalParameters
   LteSpectrumSignalParameters (const LteSpectrumSignalParameters& p);
 
   /**
-   * The packet burst being transmitted with this signal
+   * The packet burst being transmitted with this signal. It is shared by
+   * all the copies of these parameters, that is, by all the receivers,
+   * which must copy its packets before modifying them.
    */
   Ptr<PacketBurst> packetBurst;
 };
@@ -83,7 +85,9 @@ struct LteSpectrumSignalParametersDataFrame : public SpectrumSignalParameters
   LteSpectrumSignalParametersDataFrame (const LteSpectrumSignalParametersDataFrame& p);
   
   /**
-  * The packet burst being transmitted with this signal
+  * The packet burst being transmitted with this signal. It is shared by
+  * all the copies of these parameters, that is, by all the receivers,
+  * which must copy its packets before modifying them.
   */
   Ptr<PacketBurst> packetBurst;
   
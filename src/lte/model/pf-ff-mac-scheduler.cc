@@ -1010,113 +1010,73 @@ PfFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
 
 
 
+  // evaluate the metric of each UE on each RBG
+  m_kernel.Start (rbgNum, rbgSize, m_amc);
+  std::map <uint16_t, pfsFlowPerf_t>::iterator it;
+  for (it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
+    {
+      std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
+      if ((itRnti != rntiAllocated.end ())||(!HarqProcessAvailability ((*it).first)))
+        {
+          // UE already allocated for HARQ or without HARQ process available -> drop it
+          if (itRnti != rntiAllocated.end ())
+          {
+            NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)(*it).first);
+          }
+          if (!HarqProcessAvailability ((*it).first))
+          {
+            NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)(*it).first);
+          }
+          continue;
+        }
+      std::map <uint16_t,uint8_t>::iterator itTxMode;
+      itTxMode = m_uesTxMode.find ((*it).first);
+      if (itTxMode == m_uesTxMode.end ())
+        {
+          NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
+        }
+      if (LcActivePerFlow ((*it).first) == 0)
+        {
+          // this UE has no data to transmit
+          continue;
+        }
+      int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
+      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
+      itCqi = m_a30CqiRxed.find ((*it).first);
+      uint32_t slot = m_kernel.AddUe ((*it).first, (*it).second.lastAveragedThroughput);
+      m_kernel.SetSbCqi (slot, itCqi == m_a30CqiRxed.end () ? 0 : &(*itCqi).second, nLayer);
+    }
+  m_kernel.Select ();
+
   for (int i = 0; i < rbgNum; i++)
     {
       NS_LOG_INFO (this << " ALLOCATION for RBG " << i << " of " << rbgNum);
       if (rbgMap.at (i) == false)
         {
-          std::map <uint16_t, pfsFlowPerf_t>::iterator it;
-          std::map <uint16_t, pfsFlowPerf_t>::iterator itMax = m_flowStatsDl.end ();
-          double rcqiMax = 0.0;
-          for (it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
-            {
-              std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
-              if ((itRnti != rntiAllocated.end ())||(!HarqProcessAvailability ((*it).first)))
-                {
-                  // UE already allocated for HARQ or without HARQ process available -> drop it
-                  if (itRnti != rntiAllocated.end ())
-                  {
-                    NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)(*it).first);
-                  }
-                  if (!HarqProcessAvailability ((*it).first))
-                  {
-                    NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)(*it).first);
-                  }
-                  continue;
-                }
-              std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-              itCqi = m_a30CqiRxed.find ((*it).first);
-              std::map <uint16_t,uint8_t>::iterator itTxMode;
-              itTxMode = m_uesTxMode.find ((*it).first);
-              if (itTxMode == m_uesTxMode.end ())
-                {
-                  NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
-                }
-              int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-              std::vector <uint8_t> sbCqi;
-              if (itCqi == m_a30CqiRxed.end ())
-                {
-                  for (uint8_t k = 0; k < nLayer; k++)
-                    {
-                      sbCqi.push_back (1);  // start with lowest value
-                    }
-                }
-              else
-                {
-                  sbCqi = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
-                }
-              uint8_t cqi1 = sbCqi.at (0);
-              uint8_t cqi2 = 1;
-              if (sbCqi.size () > 1)
-                {
-                  cqi2 = sbCqi.at (1);
-                }
-
-              if ((cqi1 > 0)||(cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
-                {
-                  if (LcActivePerFlow ((*it).first) > 0)
-                    {
-                      // this UE has data to transmit
-                      double achievableRate = 0.0;
-                      uint8_t mcs = 0;
-                      for (uint8_t k = 0; k < nLayer; k++)
-                        {
-                          if (sbCqi.size () > k)
-                            {
-                              mcs = m_amc->GetMcsFromCqi (sbCqi.at (k));
-                            }
-                          else
-                            {
-                              // no info on this subband -> worst MCS
-                              mcs = 0;
-                            }
-                          achievableRate += ((m_amc->GetTbSizeFromMcs (mcs, rbgSize) / 8) / 0.001);   // = TB size / TTI
-                        }
-
-                      double rcqi = achievableRate / (*it).second.lastAveragedThroughput;
-                      NS_LOG_INFO (this << " RNTI " << (*it).first << " MCS " << (uint32_t)mcs << " achievableRate " << achievableRate << " avgThr " << (*it).second.lastAveragedThroughput << " RCQI " << rcqi);
-
-                      if (rcqi > rcqiMax)
-                        {
-                          rcqiMax = rcqi;
-                          itMax = it;
-                        }
-                    }
-                }   // end if cqi
-            } // end for m_rlcBufferReq
-
-          if (itMax == m_flowStatsDl.end ())
+          int32_t slot = m_kernel.GetSelectedSlot (i);
+          if (slot < 0)
             {
               // no UE available for this RB
               NS_LOG_INFO (this << " any UE found");
             }
           else
             {
+              uint16_t rnti = m_kernel.GetRnti (slot);
               rbgMap.at (i) = true;
               std::map <uint16_t, std::vector <uint16_t> >::iterator itMap;
-              itMap = allocationMap.find ((*itMax).first);
+              itMap = allocationMap.find (rnti);
               if (itMap == allocationMap.end ())
                 {
                   // insert new element
                   std::vector <uint16_t> tempMap;
                   tempMap.push_back (i);
-                  allocationMap.insert (std::pair <uint16_t, std::vector <uint16_t> > ((*itMax).first, tempMap));
+                  allocationMap.insert (std::pair <uint16_t, std::vector <uint16_t> > (rnti, tempMap));
                 }
               else
                 {
                   (*itMap).second.push_back (i);
                 }
-              NS_LOG_INFO (this << " UE assigned " << (*itMax).first);
+              NS_LOG_INFO (this << " UE assigned " << rnti);
             }
         } // end for RBG free
     } // end for RBGs
@@ -29,6 +29,7 @@
 #include <map>
 #include <ns3/nstime.h>
 #include <ns3/lte-amc.h>
+#include <ns3/ff-mac-scheduler-kernel.h>
 
 
 // value for SINR outside the range defined by FF-API, used to indicate that there
@@ -178,6 +179,8 @@ private:
 
   Ptr<LteAmc> m_amc;
 
+  FfMacSchedulerKernel m_kernel;
+
   /*
    * Vectors of UE's LC info
   */
@@ -27,20 +27,240 @@
 #include <ns3/string.h>
 #include <ns3/double.h>
 #include "ns3/uinteger.h"
+#include <ns3/abort.h>
+#include <ns3/system-mutex.h>
 #include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
 #include <ns3/simulator.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 NS_LOG_COMPONENT_DEFINE ("TraceFadingLossModel");
 
 namespace ns3 {
 
+namespace {
+
+const char TRACE_MAGIC[8] = { 'N', 'S', '3', 'F', 'A', 'D', 'E', '1' };
+/// the magic, the number of RBs and the number of samples per RB
+const size_t TRACE_HEADER_SIZE = 16;
+
+const uint64_t EMPTY_KEY = ~(uint64_t)0;
+const uint64_t HASH_MULTIPLIER = 0x9e3779b97f4a7c15ULL;
+
+inline uint32_t
+HashKey (uint64_t key)
+{
+  return (key * HASH_MULTIPLIER) >> 32;
+}
+
+/**
+ * Read rbNum * samplesNum samples of a text trace, one RB after the other.
+ */
+void
+ReadTextTrace (std::string fileName, uint32_t rbNum, uint32_t samplesNum,
+               std::vector<double> &samples)
+{
+  std::ifstream ifTraceFile;
+  ifTraceFile.open (fileName.c_str (), std::ifstream::in);
+  if (!ifTraceFile.good ())
+    {
+      NS_LOG_INFO (" File: " << fileName);
+      NS_ASSERT_MSG (ifTraceFile.good (), " Fading trace file not found");
+    }
+  samples.resize (rbNum * samplesNum);
+  for (uint32_t i = 0; i < samples.size (); i++)
+    {
+      double sample = 0.0;
+      ifTraceFile >> sample;
+      samples[i] = sample;
+    }
+}
+
+} // anonymous namespace
+
+/**
+ * The samples of a trace, read from a text file or mapped from a binary
+ * one. The traces loaded by all the models are kept in a table, so that
+ * each file is loaded only once. The reference count is guarded by the
+ * mutex of the table, so that the last Unref and the removal from the
+ * table are done at once.
+ */
+class TraceFadingLossModel::Samples
+{
+public:
+  /**
+   * \returns the samples of this trace, which are loaded if no model
+   *          holds them yet.
+   */
+  static Ptr<Samples> Get (std::string fileName, uint32_t rbNum, uint32_t samplesNum);
+  ~Samples ();
+
+  /// \returns the samples of RB i, which start at i * samplesNum
+  const double *GetSamples (void) const;
+
+  /// Increment the reference count, for Ptr.
+  void Ref (void) const;
+  /// Decrement the reference count, and delete the samples at 0, for Ptr.
+  void Unref (void) const;
+
+private:
+  typedef std::map<std::string, Samples *> Table;
+
+  Samples (std::string key);
+  void Load (std::string fileName, uint32_t rbNum, uint32_t samplesNum);
+  static Table &GetTable (void);
+  static SystemMutex &GetTableMutex (void);
+
+  std::string m_key;
+  mutable uint32_t m_count; //!< guarded by GetTableMutex ()
+  std::vector<double> m_values; //!< the samples of a text trace
+  void *m_map; //!< the mapping of a binary trace, or MAP_FAILED
+  size_t m_mapSize;
+  const double *m_samples;
+};
+
+TraceFadingLossModel::Samples::Table &
+TraceFadingLossModel::Samples::GetTable (void)
+{
+  static Table table;
+  return table;
+}
+
+SystemMutex &
+TraceFadingLossModel::Samples::GetTableMutex (void)
+{
+  static SystemMutex mutex;
+  return mutex;
+}
+
+Ptr<TraceFadingLossModel::Samples>
+TraceFadingLossModel::Samples::Get (std::string fileName, uint32_t rbNum, uint32_t samplesNum)
+{
+  NS_ABORT_MSG_IF (rbNum == 0 || samplesNum == 0,
+                   "Fading trace " << fileName << " needs RBs and samples");
+  std::ostringstream key;
+  key << fileName << ' ' << rbNum << ' ' << samplesNum;
+  CriticalSection cs (GetTableMutex ());
+  Table::iterator it = GetTable ().find (key.str ());
+  if (it != GetTable ().end ())
+    {
+      // Ref would take the mutex again
+      it->second->m_count++;
+      return Ptr<Samples> (it->second, false);
+    }
+  // not a Ptr yet: copying it out would Ref with the mutex held
+  Samples *samples = new Samples (key.str ());
+  samples->Load (fileName, rbNum, samplesNum);
+  GetTable ()[key.str ()] = samples;
+  return Ptr<Samples> (samples, false);
+}
+
+TraceFadingLossModel::Samples::Samples (std::string key)
+  : m_key (key),
+    m_count (1),
+    m_map (MAP_FAILED),
+    m_mapSize (0),
+    m_samples (0)
+{
+}
+
+TraceFadingLossModel::Samples::~Samples ()
+{
+  if (m_map != MAP_FAILED)
+    {
+      munmap (m_map, m_mapSize);
+    }
+}
+
+void
+TraceFadingLossModel::Samples::Ref (void) const
+{
+  CriticalSection cs (GetTableMutex ());
+  m_count++;
+}
+
+void
+TraceFadingLossModel::Samples::Unref (void) const
+{
+  bool last;
+  {
+    CriticalSection cs (GetTableMutex ());
+    last = --m_count == 0;
+    if (last)
+      {
+        // no Get can find these samples any more
+        GetTable ().erase (m_key);
+      }
+  }
+  if (last)
+    {
+      delete this;
+    }
+}
+
+const double *
+TraceFadingLossModel::Samples::GetSamples (void) const
+{
+  return m_samples;
+}
+
+void
+TraceFadingLossModel::Samples::Load (std::string fileName, uint32_t rbNum, uint32_t samplesNum)
+{
+  NS_LOG_FUNCTION (this << fileName << rbNum << samplesNum);
+  int fd = open (fileName.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_LOG_INFO (this << " File: " << fileName);
+      NS_ASSERT_MSG (fd >= 0, " Fading trace file not found");
+    }
+  char header[TRACE_HEADER_SIZE];
+  if (fd < 0
+      || read (fd, header, TRACE_HEADER_SIZE) != (ssize_t) TRACE_HEADER_SIZE
+      || std::memcmp (header, TRACE_MAGIC, sizeof (TRACE_MAGIC)) != 0)
+    {
+      if (fd >= 0)
+        {
+          close (fd);
+        }
+      ReadTextTrace (fileName, rbNum, samplesNum, m_values);
+      m_samples = &m_values[0];
+      return;
+    }
+
+  uint32_t fileRbNum;
+  uint32_t fileSamplesNum;
+  std::memcpy (&fileRbNum, header + 8, 4);
+  std::memcpy (&fileSamplesNum, header + 12, 4);
+  NS_ABORT_MSG_IF (fileRbNum < rbNum || fileSamplesNum != samplesNum,
+                   "Fading trace " << fileName << " has " << fileRbNum << " RBs of "
+                   << fileSamplesNum << " samples, instead of " << rbNum << " RBs of "
+                   << samplesNum << " samples");
+  struct stat st;
+  m_mapSize = TRACE_HEADER_SIZE + (size_t) fileRbNum * fileSamplesNum * sizeof (double);
+  NS_ABORT_MSG_IF (fstat (fd, &st) != 0 || (size_t) st.st_size < m_mapSize,
+                   "Fading trace " << fileName << " is truncated");
+  m_map = mmap (0, m_mapSize, PROT_READ, MAP_SHARED, fd, 0);
+  NS_ABORT_MSG_IF (m_map == MAP_FAILED, "Could not map fading trace " << fileName
+                   << ": " << std::strerror (errno));
+  close (fd);
+  m_samples = reinterpret_cast<const double *> (static_cast<const char *> (m_map) + TRACE_HEADER_SIZE);
+}
+
 NS_OBJECT_ENSURE_REGISTERED (TraceFadingLossModel)
   ;
   
 
 
 TraceFadingLossModel::TraceFadingLossModel ()
-  : m_streamsAssigned (false)
+  : m_fadingTrace (0),
+    m_streamsAssigned (false)
 {
   NS_LOG_FUNCTION (this);
   SetNext (NULL);
@@ -49,9 +269,6 @@ TraceFadingLossModel::TraceFadingLossModel ()
 
 TraceFadingLossModel::~TraceFadingLossModel ()
 {
-  m_fadingTrace.clear ();
-  m_windowOffsetsMap.clear ();
-  m_startVariableMap.clear ();
 }
 
 
@@ -120,32 +337,140 @@ void
 TraceFadingLossModel::LoadTrace ()
 {
   NS_LOG_FUNCTION (this << "Loading Fading Trace " << m_traceFile);
-  std::ifstream ifTraceFile;
-  ifTraceFile.open (m_traceFile.c_str (), std::ifstream::in);
-  m_fadingTrace.clear ();
-  if (!ifTraceFile.good ())
+  // release the trace first, since this might unload it
+  m_fadingTrace = 0;
+  m_samples = 0;
+  m_samples = Samples::Get (m_traceFile, m_rbNum, m_samplesNum);
+  m_fadingTrace = m_samples->GetSamples ();
+  m_timeGranularity = m_traceLength.GetMilliSeconds () / m_samplesNum;
+  m_lastWindowUpdate = Simulator::Now ();
+}
+
+void
+TraceFadingLossModel::ConvertTrace (std::string textFileName, std::string binaryFileName,
+                                    uint32_t rbNum, uint32_t samplesNum)
+{
+  NS_LOG_FUNCTION (textFileName << binaryFileName << rbNum << samplesNum);
+  NS_ABORT_MSG_IF (rbNum == 0 || samplesNum == 0,
+                   "Fading trace " << textFileName << " needs RBs and samples");
+  std::vector<double> samples;
+  ReadTextTrace (textFileName, rbNum, samplesNum, samples);
+  std::ofstream ofTraceFile (binaryFileName.c_str (), std::ofstream::out | std::ofstream::binary);
+  NS_ABORT_MSG_IF (!ofTraceFile.good (), "Could not open " << binaryFileName);
+  ofTraceFile.write (TRACE_MAGIC, sizeof (TRACE_MAGIC));
+  ofTraceFile.write (reinterpret_cast<const char *> (&rbNum), sizeof (rbNum));
+  ofTraceFile.write (reinterpret_cast<const char *> (&samplesNum), sizeof (samplesNum));
+  ofTraceFile.write (reinterpret_cast<const char *> (&samples[0]), samples.size () * sizeof (double));
+  NS_ABORT_MSG_IF (!ofTraceFile.good (), "Could not write " << binaryFileName);
+}
+
+uint32_t
+TraceFadingLossModel::GetNodeIndex (Ptr<const MobilityModel> mobility) const
+{
+  if (m_nodes.size () * 2 >= m_nodeSlots.size ())
     {
-      NS_LOG_INFO (this << " File: " << m_traceFile);
-      NS_ASSERT_MSG(ifTraceFile.good (), " Fading trace file not found");
+      GrowNodeSlots ();
+    }
+  uint32_t mask = m_nodeSlots.size () - 1;
+  uint32_t i = HashKey (reinterpret_cast<uintptr_t> (PeekPointer (mobility))) & mask;
+  while (m_nodeSlots[i].mobility != 0)
+    {
+      if (m_nodeSlots[i].mobility == PeekPointer (mobility))
+        {
+          return m_nodeSlots[i].index;
+        }
+      i = (i + 1) & mask;
     }
+  uint32_t index = m_nodes.size ();
+  m_nodes.push_back (mobility);
+  m_nodeSlots[i].mobility = PeekPointer (mobility);
+  m_nodeSlots[i].index = index;
+  return index;
+}
 
-//   NS_LOG_INFO (this << " length " << m_traceLength.GetSeconds ());
-//   NS_LOG_INFO (this << " RB " << (uint32_t)m_rbNum << " samples " << m_samplesNum);
-  for (uint32_t i = 0; i < m_rbNum; i++)
+void
+TraceFadingLossModel::GrowNodeSlots (void) const
+{
+  NodeSlot empty;
+  empty.mobility = 0;
+  empty.index = 0;
+  m_nodeSlots.assign (m_nodeSlots.empty () ? 64 : m_nodeSlots.size () * 2, empty);
+  uint32_t mask = m_nodeSlots.size () - 1;
+  for (uint32_t index = 0; index < m_nodes.size (); index++)
     {
-      FadingTraceSample rbTimeFadingTrace;
-      for (uint32_t j = 0; j < m_samplesNum; j++)
+      const MobilityModel *mobility = PeekPointer (m_nodes[index]);
+      uint32_t i = HashKey (reinterpret_cast<uintptr_t> (mobility)) & mask;
+      while (m_nodeSlots[i].mobility != 0)
         {
-          double sample;
-          ifTraceFile >> sample;
-          rbTimeFadingTrace.push_back (sample);
+          i = (i + 1) & mask;
+        }
+      m_nodeSlots[i].mobility = mobility;
+      m_nodeSlots[i].index = index;
+    }
+}
+
+void
+TraceFadingLossModel::GrowLinkSlots (void) const
+{
+  std::vector<LinkSlot> old;
+  old.swap (m_linkSlots);
+  LinkSlot empty;
+  empty.key = EMPTY_KEY;
+  empty.index = 0;
+  m_linkSlots.assign (old.empty () ? 1024 : old.size () * 2, empty);
+  uint32_t mask = m_linkSlots.size () - 1;
+  for (std::vector<LinkSlot>::const_iterator it = old.begin (); it != old.end (); ++it)
+    {
+      if (it->key != EMPTY_KEY)
+        {
+          uint32_t i = HashKey (it->key) & mask;
+          while (m_linkSlots[i].key != EMPTY_KEY)
+            {
+              i = (i + 1) & mask;
+            }
+          m_linkSlots[i] = *it;
         }
-      m_fadingTrace.push_back (rbTimeFadingTrace);
     }
-  m_timeGranularity = m_traceLength.GetMilliSeconds () / m_samplesNum;
-  m_lastWindowUpdate = Simulator::Now ();
 }
 
+uint32_t
+TraceFadingLossModel::GetLinkIndex (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) const
+{
+  uint64_t key = ((uint64_t)GetNodeIndex (a) << 32) | GetNodeIndex (b);
+  if ((m_links.size () + 1) * 2 > m_linkSlots.size ())
+    {
+      GrowLinkSlots ();
+    }
+  uint32_t mask = m_linkSlots.size () - 1;
+  uint32_t i = HashKey (key) & mask;
+  while (m_linkSlots[i].key != EMPTY_KEY)
+    {
+      if (m_linkSlots[i].key == key)
+        {
+          return m_linkSlots[i].index;
+        }
+      i = (i + 1) & mask;
+    }
+
+  NS_LOG_LOGIC (this << "insert new channel realization, m_links.size () = " << m_links.size ());
+  Ptr<UniformRandomVariable> startV = CreateObject<UniformRandomVariable> ();
+  startV->SetAttribute ("Min", DoubleValue (1.0));
+  startV->SetAttribute ("Max", DoubleValue ((m_traceLength.GetSeconds () - m_windowSize.GetSeconds ()) * 1000.0));
+  if (m_streamsAssigned)
+    {
+      NS_ASSERT_MSG (m_currentStream <= m_lastStream, "not enough streams, consider increasing the StreamSetSize attribute");
+      startV->SetStream (m_currentStream);
+      m_currentStream += 1;
+    }
+  Link link;
+  link.startVariable = startV;
+  link.windowOffset = startV->GetValue ();
+  uint32_t index = m_links.size ();
+  m_links.push_back (link);
+  m_linkSlots[i].key = key;
+  m_linkSlots[i].index = index;
+  return index;
+}
 
 Ptr<SpectrumValue>
 TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
@@ -154,44 +479,24 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
   Ptr<const MobilityModel> b) const
 {
   NS_LOG_FUNCTION (this << *txPsd << a << b);
-  
-  std::map <ChannelRealizationId_t, int >::iterator itOff;
-  ChannelRealizationId_t mobilityPair = std::make_pair (a,b);
-  itOff = m_windowOffsetsMap.find (mobilityPair);
-  if (itOff!=m_windowOffsetsMap.end ())
+
+  uint32_t nLinks = m_links.size ();
+  uint32_t linkIndex = GetLinkIndex (a, b);
+  if (linkIndex < nLinks)
     {
       if (Simulator::Now ().GetSeconds () >= m_lastWindowUpdate.GetSeconds () + m_windowSize.GetSeconds ())
         {
           // update all the offsets
           NS_LOG_INFO ("Fading Windows Updated");
-          std::map <ChannelRealizationId_t, int >::iterator itOff2;
-          for (itOff2 = m_windowOffsetsMap.begin (); itOff2 != m_windowOffsetsMap.end (); itOff2++)
+          for (std::vector<Link>::iterator it = m_links.begin (); it != m_links.end (); ++it)
             {
-              std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> >::iterator itVar;
-              itVar = m_startVariableMap.find ((*itOff2).first);
-              (*itOff2).second = (*itVar).second->GetValue ();
+              it->windowOffset = it->startVariable->GetValue ();
             }
           m_lastWindowUpdate = Simulator::Now ();
         }
     }
-  else
-    {
-      NS_LOG_LOGIC (this << "insert new channel realization, m_windowOffsetMap.size () = " << m_windowOffsetsMap.size ());
-      Ptr<UniformRandomVariable> startV = CreateObject<UniformRandomVariable> ();
-      startV->SetAttribute ("Min", DoubleValue (1.0));
-      startV->SetAttribute ("Max", DoubleValue ((m_traceLength.GetSeconds () - m_windowSize.GetSeconds ()) * 1000.0));
-      if (m_streamsAssigned)
-        {
-          NS_ASSERT_MSG (m_currentStream <= m_lastStream, "not enough streams, consider increasing the StreamSetSize attribute");
-          startV->SetStream (m_currentStream);
-          m_currentStream += 1;
-        }
-      ChannelRealizationId_t mobilityPair = std::make_pair (a,b);
-      m_startVariableMap.insert (std::pair<ChannelRealizationId_t,Ptr<UniformRandomVariable> > (mobilityPair, startV));
-      m_windowOffsetsMap.insert (std::pair<ChannelRealizationId_t,int> (mobilityPair, startV->GetValue ()));
-    }
+  int windowOffset = m_links[linkIndex].windowOffset;
 
-  
   Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (txPsd);
   Values::iterator vit = rxPsd->ValuesBegin ();
   
@@ -201,18 +506,19 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
   //double speed = std::sqrt (std::pow (aSpeedVector.x-bSpeedVector.x,2) + std::pow (aSpeedVector.y-bSpeedVector.y,2));
 
   NS_LOG_LOGIC (this << *rxPsd);
-  NS_ASSERT (!m_fadingTrace.empty ());
+  NS_ASSERT (m_fadingTrace != 0);
   int now_ms = static_cast<int> (Simulator::Now ().GetMilliSeconds () * m_timeGranularity);
   int lastUpdate_ms = static_cast<int> (m_lastWindowUpdate.GetMilliSeconds () * m_timeGranularity);
-  int index = ((*itOff).second + now_ms - lastUpdate_ms) % m_samplesNum;
+  int index = (windowOffset + now_ms - lastUpdate_ms) % m_samplesNum;
   int subChannel = 0;
   while (vit != rxPsd->ValuesEnd ())
     {
       NS_ASSERT (subChannel < 100);
       if (*vit != 0.)
         {
-          double fading = m_fadingTrace.at (subChannel).at (index);
-          NS_LOG_INFO (this << " FADING now " << now_ms << " offset " << (*itOff).second << " id " << index << " fading " << fading);
+          NS_ASSERT_MSG (subChannel < m_rbNum, "no fading trace for RB " << subChannel);
+          double fading = m_fadingTrace[subChannel * m_samplesNum + index];
+          NS_LOG_INFO (this << " FADING now " << now_ms << " offset " << windowOffset << " id " << index << " fading " << fading);
           double power = *vit; // in Watt/Hz
           power = 10 * std::log10 (180000 * power); // in dB
 
@@ -241,14 +547,12 @@ TraceFadingLossModel::AssignStreams (int64_t stream)
   m_streamsAssigned = true;
   m_currentStream = stream;
   m_lastStream = stream + m_streamSetSize - 1;
-  std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> >::iterator itVar;
-  itVar = m_startVariableMap.begin ();
   // the following loop is for eventually pre-existing ChannelRealization instances
   // note that more instances are expected to be created at run time
-  while (itVar!=m_startVariableMap.end ())
+  for (std::vector<Link>::iterator it = m_links.begin (); it != m_links.end (); ++it)
     {
       NS_ASSERT_MSG (m_currentStream <= m_lastStream, "not enough streams, consider increasing the StreamSetSize attribute");
-      (*itVar).second->SetStream (m_currentStream);
+      it->startVariable->SetStream (m_currentStream);
       m_currentStream += 1;
     }
   return m_streamSetSize;
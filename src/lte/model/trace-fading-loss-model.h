@@ -27,6 +27,7 @@
 #include <ns3/object.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <map>
+#include <vector>
 #include "ns3/random-variable-stream.h"
 #include <ns3/nstime.h>
 
@@ -40,6 +41,12 @@ class MobilityModel;
  * \ingroup lte
  *
  * \brief fading loss model based on precalculated fading traces
+ *
+ * The trace is read either from a text file, as generated by
+ * fading_trace_generator.m, or from a binary file written by
+ * ConvertTrace (). A binary trace is mapped in memory rather than read,
+ * so that its pages are shared by all the processes which use it, and
+ * the samples of a trace are shared by all the models which load it.
  */
 class TraceFadingLossModel : public SpectrumPropagationLossModel
 {
@@ -66,8 +73,46 @@ public:
   */
   int64_t AssignStreams (int64_t stream);
 
-  
+  /**
+   * \brief Write a text fading trace in the binary format
+   *
+   * The binary format is an 8 byte "NS3FADE1" magic, followed by the
+   * number of RBs and the number of samples per RB as 32 bit integers,
+   * and by the samples of each RB in turn as doubles, all in the byte
+   * order of the host.
+   *
+   * \param textFileName the name of the text trace to read
+   * \param binaryFileName the name of the binary trace to write
+   * \param rbNum the number of RBs of the trace
+   * \param samplesNum the number of samples per RB of the trace
+   */
+  static void ConvertTrace (std::string textFileName, std::string binaryFileName,
+                            uint32_t rbNum, uint32_t samplesNum);
+
 private:
+  /// The samples of a trace, shared by the models which load it.
+  class Samples;
+
+  /// The state of the fading channel realization of a (tx, rx) pair.
+  struct Link
+  {
+    Ptr<UniformRandomVariable> startVariable;
+    int windowOffset;
+  };
+  /// A slot of the mobility model to node index table.
+  struct NodeSlot
+  {
+    const MobilityModel *mobility;
+    uint32_t index;
+  };
+  /// A slot of the (tx, rx) node index pair to link index table.
+  struct LinkSlot
+  {
+    // (index of a << 32) | index of b, or EMPTY_KEY
+    uint64_t key;
+    uint32_t index;
+  };
+
   /**
    * \param txPsd set of values vs frequency representing the
    *              transmission power. See SpectrumChannel for details.
@@ -93,26 +138,30 @@ private:
   
   void LoadTrace ();
 
-
-   
-  mutable std::map <ChannelRealizationId_t, int > m_windowOffsetsMap;
-  
-  mutable std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> > m_startVariableMap;
-  
   /**
-   * Vector with fading samples in time domain (for a fixed RB)
+   * \returns the index in m_links of the channel realization from a to
+   *          b, which is created if it was never seen before.
    */
-  typedef std::vector<double> FadingTraceSample;
+  uint32_t GetLinkIndex (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) const;
   /**
-   * Vector collecting the time fading traces in the frequency domain (per RB)
+   * \returns the index of this mobility model, which is given the next
+   *          index if it was never seen before.
    */
-  typedef std::vector<FadingTraceSample> FadingTrace;
+  uint32_t GetNodeIndex (Ptr<const MobilityModel> mobility) const;
+  void GrowNodeSlots (void) const;
+  void GrowLinkSlots (void) const;
 
+  // The links are created by DoCalcRxPowerSpectralDensity, which is const.
+  mutable std::vector<Ptr<const MobilityModel> > m_nodes;
+  mutable std::vector<NodeSlot> m_nodeSlots; //!< power of two sized
+  mutable std::vector<Link> m_links; //!< in creation order
+  mutable std::vector<LinkSlot> m_linkSlots; //!< power of two sized
 
-  
   std::string m_traceFile;
-  
-  FadingTrace m_fadingTrace;
+
+  Ptr<Samples> m_samples;
+  /// the samples of RB i start at m_fadingTrace + i * m_samplesNum
+  const double *m_fadingTrace;
 
   
   Time m_traceLength;
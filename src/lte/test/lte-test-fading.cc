@@ -25,10 +25,12 @@
 #include "ns3/spectrum-test.h"
 
 #include "ns3/lte-phy-tag.h"
-#include "ns3/lte-test-ue-phy.h"
 #include "ns3/lte-sinr-chunk-processor.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include "ns3/constant-position-mobility-model.h"
 
-#include "ns3/lte-test-fading.h"
+#include "lte-test-fading.h"
 #include <ns3/buildings-propagation-loss-model.h>
 #include <ns3/node-container.h>
 #include <ns3/mobility-helper.h>
@@ -47,6 +49,9 @@
 #include <ns3/lte-ue-phy.h>
 #include "lte-test-sinr-chunk-processor.h"
 
+#include <fstream>
+#include <cstdio>
+
 // #include <ns3/trace-fading-loss-model.h>
 // #include <ns3/spectrum-value.h>
 
@@ -72,71 +77,113 @@ LteFadingTestSuite::LteFadingTestSuite ()
   
   // -------------- COMPOUND TESTS ----------------------------------
   
-  LogComponentEnable ("LteFadingTest", LOG_LEVEL_ALL);
-  
-  // NS_LOG_INFO ("Creating LteDownlinkSinrTestSuite");
-  
-  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
-  
-  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::BuildingsPropagationLossModel"));
-  
-  // Create Nodes: eNodeB, home eNB, UE and home UE (UE attached to HeNB)
-  NodeContainer enbNodes;
-  NodeContainer henbNodes;
-  NodeContainer ueNodes;
-  NodeContainer hueNodes;
-  enbNodes.Create (1);
-  henbNodes.Create (2);
-  ueNodes.Create (5);
-  hueNodes.Create (3);
-  
-  // Install Mobility Model
-  MobilityHelper mobility;
-  mobility.SetMobilityModel ("ns3::BuildingsMobilityModel");
-  mobility.Install (enbNodes);
-  mobility.Install (henbNodes);
-  mobility.Install (ueNodes);
-  mobility.Install (hueNodes);
-  
-  NetDeviceContainer enbDevs;
-  NetDeviceContainer henbDevs;
-  NetDeviceContainer ueDevs;
-  NetDeviceContainer hueDevs;
-  enbDevs = lteHelper->InstallEnbDevice (enbNodes);
-  ueDevs = lteHelper->InstallUeDevice (ueNodes);
-  henbDevs = lteHelper->InstallEnbDevice (henbNodes);
-  hueDevs = lteHelper->InstallUeDevice (hueNodes);
-  
-  
-  
-  lteHelper->Attach (ueDevs, enbDevs.Get (0));
-  lteHelper->Attach (hueDevs, henbDevs.Get (0));
-  
   // Test #1 Okumura Hata Model (150 < freq < 1500 MHz) (Macro<->UE)
   
   double distance = 2000;
   double hm = 1;
   double hb = 30;
 //   double freq = 869e6; // E_UTRA BAND #5 see table 5.5-1 of 36.101
-  Ptr<BuildingsMobilityModel> mm1 = enbNodes.Get (0)->GetObject<BuildingsMobilityModel> ();
+  Ptr<MobilityModel> mm1 = CreateObject<ConstantPositionMobilityModel> ();
   mm1->SetPosition (Vector (0.0, 0.0, hb));
   
-  Ptr<BuildingsMobilityModel> mm2 = ueNodes.Get (0)->GetObject<BuildingsMobilityModel> ();
+  Ptr<MobilityModel> mm2 = CreateObject<ConstantPositionMobilityModel> ();
   mm2->SetPosition (Vector (distance, 0.0, hm));
   
   AddTestCase (new LteFadingTestCase (mm1, mm2, 137.93, "OH Urban Large city"), TestCase::QUICK);
-    
-  
+  AddTestCase (new LteFadingTraceFormatTestCase, TestCase::QUICK);
+  AddTestCase (new LteFadingSharedTraceTestCase, TestCase::QUICK);
+  AddTestCase (new LteFadingAssignStreamsTestCase, TestCase::QUICK);
 }
 
 static LteFadingTestSuite lteFadingTestSuite;
 
 
+namespace {
+
+const uint32_t RB_NUM = 2;
+const uint32_t SAMPLES_NUM = 1000;
+
+/**
+* Write a text trace of RB_NUM RBs of SAMPLES_NUM samples, in dB.
+*/
+void
+WriteTextTrace (std::string fileName)
+{
+  std::ofstream ofTraceFile (fileName.c_str ());
+  for (uint32_t rb = 0; rb < RB_NUM; rb++)
+    {
+      for (uint32_t i = 0; i < SAMPLES_NUM; i++)
+        {
+          ofTraceFile << -0.01 * ((rb * SAMPLES_NUM + i) * 7 % 1999) << " ";
+        }
+      ofTraceFile << std::endl;
+    }
+}
+
+/**
+* \returns a model of the trace, of 1 s with windows of 100 ms, ready
+* to be used.
+*/
+Ptr<TraceFadingLossModel>
+CreateFadingModel (std::string fileName)
+{
+  Ptr<TraceFadingLossModel> model = CreateObject<TraceFadingLossModel> ();
+  model->SetAttribute ("TraceFilename", StringValue (fileName));
+  model->SetAttribute ("TraceLength", TimeValue (Seconds (1.0)));
+  model->SetAttribute ("SamplesNum", UintegerValue (SAMPLES_NUM));
+  model->SetAttribute ("WindowSize", TimeValue (Seconds (0.1)));
+  model->SetAttribute ("RbNum", UintegerValue (RB_NUM));
+  model->Initialize ();
+  return model;
+}
+
+/**
+* Append to samples the received power of a unit PSD on each RB.
+*/
+void
+SampleFading (Ptr<TraceFadingLossModel> model, Ptr<MobilityModel> a, Ptr<MobilityModel> b,
+              std::vector<double> *samples)
+{
+  Bands bands;
+  for (uint32_t rb = 0; rb < RB_NUM; rb++)
+    {
+      BandInfo bi;
+      bi.fl = 2.400e9 + rb * 180e3;
+      bi.fc = bi.fl + 90e3;
+      bi.fh = bi.fl + 180e3;
+      bands.push_back (bi);
+    }
+  Ptr<SpectrumValue> txPsd = Create<SpectrumValue> (Create<SpectrumModel> (bands));
+  *txPsd = 1.;
+  Ptr<SpectrumValue> rxPsd = model->CalcRxPowerSpectralDensity (txPsd, a, b);
+  for (uint32_t rb = 0; rb < RB_NUM; rb++)
+    {
+      samples->push_back ((*rxPsd)[rb]);
+    }
+}
+
+/**
+* Sample the fading of the links a to b and b to a of a model every 50
+* ms from start to 500 ms, across several windows.
+*/
+void
+ScheduleSamples (Ptr<TraceFadingLossModel> model, Ptr<MobilityModel> a, Ptr<MobilityModel> b,
+                 Time start, std::vector<double> *samples)
+{
+  for (Time t = start; t < MilliSeconds (500); t += MilliSeconds (50))
+    {
+      Simulator::Schedule (t, &SampleFading, model, a, b, samples);
+      Simulator::Schedule (t, &SampleFading, model, b, a, samples);
+    }
+}
+
+} // anonymous namespace
+
 /**
 * TestCase
 */
 
-LteFadingTestCase::LteFadingTestCase (Ptr<BuildingsMobilityModel> m1, Ptr<BuildingsMobilityModel> m2, double refValue, std::string name)
+LteFadingTestCase::LteFadingTestCase (Ptr<MobilityModel> m1, Ptr<MobilityModel> m2, double refValue, std::string name)
 : TestCase ("FADING calculation: " + name),
 m_node1 (m1),
 m_node2 (m2),
@@ -179,18 +226,17 @@ LteFadingTestCase::DoRun (void)
   //   LogComponentEnable ("LteUeNetDevice", logLevel);
   //   LogComponentEnable ("LteEnbNetDevice", logLevel);
   
-  LogComponentEnable ("TraceFadingLossModel", LOG_LEVEL_ALL);
 //   LogComponentEnable ("TraceFadingLossModel", LOG_LEVEL_ALL);
 //   LogComponentEnable ("BuildingsPropagationLossModel", LOG_LEVEL_ALL);
   NS_LOG_INFO ("Testing " << GetName());
   
-  
-  m_fadingModule = CreateObject<TraceFadingLossModel> ();
-  
-  m_fadingModule->SetAttribute("TraceFilename", StringValue("../../../src/lte/model/fading-traces/fading_trace_EPA_3kmph.fad"));
+  // no trace ships with the tree: the test writes its own.
+  std::string traceFile = CreateTempDirFilename ("fading-trace.fad");
+  WriteTextTrace (traceFile);
+  m_fadingModule = CreateFadingModel (traceFile);
   //m_fadingModule->SetAttribute("WindowSize", TimeValue(Seconds (0.003)));
   
-  m_fadingModule->CreateFadingChannelRealization (m_node1, m_node2);
+  // the channel realization is created by the first sample
   
 //   Ptr<SpectrumModel> sm;
 //   
@@ -230,6 +276,8 @@ LteFadingTestCase::DoRun (void)
   Simulator::Stop (Seconds (10.1));
   Simulator::Run ();
   Simulator::Destroy ();
+  m_fadingModule = 0;
+  remove (traceFile.c_str ());
 //   double loss = m_downlinkPropagationLossModel->GetLoss (m_node1, m_node2);
   time = 0.0;
   int rbNum = 2;
@@ -296,5 +344,124 @@ LteFadingTestCase::GetFadingSample ()
   m_fadingSamples.push_back ((*outPsd1));
 }
 
-} // namespace ns3
 
+LteFadingTraceFormatTestCase::LteFadingTraceFormatTestCase ()
+  : TestCase ("FADING trace: text and binary traces give the same fading")
+{
+}
+
+void
+LteFadingTraceFormatTestCase::DoRun (void)
+{
+  std::string textFile = CreateTempDirFilename ("fading-trace.fad");
+  std::string binaryFile = CreateTempDirFilename ("fading-trace.bin");
+  WriteTextTrace (textFile);
+  TraceFadingLossModel::ConvertTrace (textFile, binaryFile, RB_NUM, SAMPLES_NUM);
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<TraceFadingLossModel> text = CreateFadingModel (textFile);
+  Ptr<TraceFadingLossModel> binary = CreateFadingModel (binaryFile);
+  text->AssignStreams (1);
+  binary->AssignStreams (1);
+  std::vector<double> textSamples;
+  std::vector<double> binarySamples;
+  ScheduleSamples (text, a, b, Seconds (0), &textSamples);
+  ScheduleSamples (binary, a, b, Seconds (0), &binarySamples);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (textSamples.size (), 40U, "Wrong number of samples");
+  NS_TEST_ASSERT_MSG_EQ (binarySamples.size (), textSamples.size (), "Wrong number of samples");
+  for (uint32_t i = 0; i < textSamples.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (binarySamples[i], textSamples[i], "Binary trace differs at sample " << i);
+    }
+  // the fading of the trace is applied: 0 dB is sample 0 of RB 0 only
+  NS_TEST_EXPECT_MSG_LT (textSamples[1], 1., "No fading applied");
+  remove (textFile.c_str ());
+  remove (binaryFile.c_str ());
+}
+
+LteFadingSharedTraceTestCase::LteFadingSharedTraceTestCase ()
+  : TestCase ("FADING trace: models share the samples of a trace")
+{
+}
+
+void
+LteFadingSharedTraceTestCase::DoRun (void)
+{
+  std::string traceFile = CreateTempDirFilename ("fading-trace.fad");
+  WriteTextTrace (traceFile);
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<TraceFadingLossModel> first = CreateFadingModel (traceFile);
+  Ptr<TraceFadingLossModel> second = CreateFadingModel (traceFile);
+  // the trace is not read again: a model which loads it after the file
+  // has changed still gets the shared samples.
+  std::ofstream (traceFile.c_str ()) << "bad trace" << std::endl;
+  first = 0;
+  Ptr<TraceFadingLossModel> third = CreateFadingModel (traceFile);
+  second->AssignStreams (1);
+  third->AssignStreams (1);
+  std::vector<double> secondSamples;
+  std::vector<double> thirdSamples;
+  ScheduleSamples (second, a, b, Seconds (0), &secondSamples);
+  ScheduleSamples (third, a, b, Seconds (0), &thirdSamples);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (secondSamples.size (), 40U, "Wrong number of samples");
+  NS_TEST_ASSERT_MSG_EQ (thirdSamples.size (), secondSamples.size (), "Wrong number of samples");
+  for (uint32_t i = 0; i < secondSamples.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (thirdSamples[i], secondSamples[i], "Shared trace differs at sample " << i);
+    }
+  NS_TEST_EXPECT_MSG_LT (secondSamples[1], 1., "No fading applied");
+  remove (traceFile.c_str ());
+}
+
+LteFadingAssignStreamsTestCase::LteFadingAssignStreamsTestCase ()
+  : TestCase ("FADING trace: AssignStreams after the links are created")
+{
+}
+
+void
+LteFadingAssignStreamsTestCase::DoRun (void)
+{
+  std::string traceFile = CreateTempDirFilename ("fading-trace.fad");
+  WriteTextTrace (traceFile);
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<TraceFadingLossModel> first = CreateFadingModel (traceFile);
+  Ptr<TraceFadingLossModel> second = CreateFadingModel (traceFile);
+  // create the links with the streams allocated automatically
+  std::vector<double> ignored;
+  SampleFading (first, a, b, &ignored);
+  SampleFading (first, b, a, &ignored);
+  SampleFading (second, a, b, &ignored);
+  SampleFading (second, b, a, &ignored);
+
+  NS_TEST_EXPECT_MSG_EQ (first->AssignStreams (1), 200000, "Wrong number of streams");
+  NS_TEST_EXPECT_MSG_EQ (second->AssignStreams (1), 200000, "Wrong number of streams");
+  // the offsets are drawn again from the assigned streams at the
+  // first window update
+  std::vector<double> firstSamples;
+  std::vector<double> secondSamples;
+  ScheduleSamples (first, a, b, MilliSeconds (100), &firstSamples);
+  ScheduleSamples (second, a, b, MilliSeconds (100), &secondSamples);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (firstSamples.size (), 32U, "Wrong number of samples");
+  NS_TEST_ASSERT_MSG_EQ (secondSamples.size (), firstSamples.size (), "Wrong number of samples");
+  for (uint32_t i = 0; i < firstSamples.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (secondSamples[i], firstSamples[i], "Assigned streams differ at sample " << i);
+    }
+  remove (traceFile.c_str ());
+}
+
+} // namespace ns3
@@ -25,7 +25,7 @@
 
 #include "ns3/test.h"
 
-#include <ns3/buildings-mobility-model.h>
+#include <ns3/mobility-model.h>
 #include <ns3/buildings-propagation-loss-model.h>
 #include <ns3/spectrum-value.h>
 
@@ -48,7 +48,7 @@ class LteFadingTestSuite : public TestSuite
 class LteFadingTestCase : public TestCase
 {
   public:
-    LteFadingTestCase (Ptr<BuildingsMobilityModel> m1, Ptr<BuildingsMobilityModel> m2, double refValue, std::string name);
+    LteFadingTestCase (Ptr<MobilityModel> m1, Ptr<MobilityModel> m2, double refValue, std::string name);
     virtual ~LteFadingTestCase ();
     
   private:
@@ -56,8 +56,8 @@ class LteFadingTestCase : public TestCase
     
     void GetFadingSample ();
     
-    Ptr<BuildingsMobilityModel> m_node1;
-    Ptr<BuildingsMobilityModel> m_node2;
+    Ptr<MobilityModel> m_node1;
+    Ptr<MobilityModel> m_node2;
     Ptr<TraceFadingLossModel> m_fadingModule;
     double m_lossRef;
     std::vector<SpectrumValue> m_fadingSamples;
@@ -65,6 +65,44 @@ class LteFadingTestCase : public TestCase
     
 };
 
+/**
+* A text trace and the binary trace written from it by ConvertTrace give
+* the same fading.
+*/
+class LteFadingTraceFormatTestCase : public TestCase
+{
+  public:
+    LteFadingTraceFormatTestCase ();
+
+  private:
+    virtual void DoRun (void);
+};
+
+/**
+* Models which load the same trace share its samples, which stay loaded
+* as long as one of the models holds them.
+*/
+class LteFadingSharedTraceTestCase : public TestCase
+{
+  public:
+    LteFadingSharedTraceTestCase ();
+
+  private:
+    virtual void DoRun (void);
+};
+
+/**
+* AssignStreams called once links exist sets the streams of these links.
+*/
+class LteFadingAssignStreamsTestCase : public TestCase
+{
+  public:
+    LteFadingAssignStreamsTestCase ();
+
+  private:
+    virtual void DoRun (void);
+};
+
 class LteFadingSystemTestCase : public TestCase
 {
   public:
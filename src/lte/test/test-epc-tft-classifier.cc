@@ -30,6 +30,7 @@
 #include "ns3/tcp-l4-protocol.h"
 
 #include "ns3/epc-tft-classifier.h"
+#include "ns3/random-variable-stream.h"
 
 #include <iomanip>
 
@@ -136,6 +137,175 @@ EpcTftClassifierTestCase::DoRun (void)
 
 
 
+/**
+ * Checks the classification of random packets by random TFTs against
+ * the evaluation of the TFTs one by one, in decreasing order of
+ * identifier, also after some TFTs are deleted.
+ */
+class EpcTftClassifierRandomTestCase : public TestCase
+{
+public:
+  EpcTftClassifierRandomTestCase ();
+  virtual ~EpcTftClassifierRandomTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  EpcTft::PacketFilter CreatePacketFilter ();
+  Ipv4Address CreateAddress ();
+  uint16_t CreatePort ();
+  void CheckClassification (uint32_t nPackets);
+
+  Ptr<UniformRandomVariable> m_random;
+  Ptr<EpcTftClassifier> m_c;
+  std::map<uint32_t, Ptr<EpcTft> > m_tftMap;
+};
+
+EpcTftClassifierRandomTestCase::EpcTftClassifierRandomTestCase ()
+  : TestCase ("random TFTs and packets")
+{
+  NS_LOG_FUNCTION (this);
+}
+
+EpcTftClassifierRandomTestCase::~EpcTftClassifierRandomTestCase ()
+{
+}
+
+Ipv4Address
+EpcTftClassifierRandomTestCase::CreateAddress ()
+{
+  // few distinct addresses, so that the filters overlap
+  return Ipv4Address ((10 << 24) | (m_random->GetInteger (0, 3) << 16) | (m_random->GetInteger (0, 3) << 8) | m_random->GetInteger (0, 3));
+}
+
+uint16_t
+EpcTftClassifierRandomTestCase::CreatePort ()
+{
+  return m_random->GetInteger (1000, 1020);
+}
+
+EpcTft::PacketFilter
+EpcTftClassifierRandomTestCase::CreatePacketFilter ()
+{
+  // the last two masks are not prefixes
+  static const uint32_t masks[] = { 0x00000000, 0xff000000, 0xffff0000, 0xffffff00, 0xffffffff, 0xff00ff00, 0x00ff00ff };
+  EpcTft::PacketFilter f;
+  f.direction = (EpcTft::Direction) m_random->GetInteger (1, 3);
+  f.remoteAddress = CreateAddress ();
+  f.remoteMask.Set (masks[m_random->GetInteger (0, 6)]);
+  f.localAddress = CreateAddress ();
+  f.localMask.Set (masks[m_random->GetInteger (0, 6)]);
+  if (m_random->GetInteger (0, 1))
+    {
+      f.remotePortStart = CreatePort ();
+      f.remotePortEnd = f.remotePortStart + m_random->GetInteger (0, 5);
+    }
+  if (m_random->GetInteger (0, 1))
+    {
+      f.localPortStart = CreatePort ();
+      f.localPortEnd = f.localPortStart + m_random->GetInteger (0, 5);
+    }
+  if (m_random->GetInteger (0, 3) == 0)
+    {
+      f.typeOfService = m_random->GetInteger (0, 255);
+      f.typeOfServiceMask = m_random->GetInteger (0, 255);
+    }
+  return f;
+}
+
+void
+EpcTftClassifierRandomTestCase::CheckClassification (uint32_t nPackets)
+{
+  for (uint32_t n = 0; n < nPackets; ++n)
+    {
+      EpcTft::Direction d = m_random->GetInteger (0, 1) ? EpcTft::UPLINK : EpcTft::DOWNLINK;
+      Ipv4Address ra = CreateAddress ();
+      Ipv4Address la = CreateAddress ();
+      uint16_t rp = CreatePort ();
+      uint16_t lp = CreatePort ();
+      uint8_t tos = m_random->GetInteger (0, 255);
+
+      uint32_t expectedTftId = 0;
+      for (std::map<uint32_t, Ptr<EpcTft> >::reverse_iterator it = m_tftMap.rbegin ();
+           it != m_tftMap.rend ();
+           ++it)
+        {
+          if (it->second->Matches (d, ra, la, rp, lp, tos))
+            {
+              expectedTftId = it->first;
+              break;
+            }
+        }
+
+      Ipv4Header ipHeader;
+      ipHeader.SetSource (d == EpcTft::UPLINK ? la : ra);
+      ipHeader.SetDestination (d == EpcTft::UPLINK ? ra : la);
+      ipHeader.SetTos (tos);
+      uint16_t sp = d == EpcTft::UPLINK ? lp : rp;
+      uint16_t dp = d == EpcTft::UPLINK ? rp : lp;
+      Ptr<Packet> packet = Create<Packet> ();
+      if (n % 2)
+        {
+          UdpHeader udpHeader;
+          udpHeader.SetSourcePort (sp);
+          udpHeader.SetDestinationPort (dp);
+          packet->AddHeader (udpHeader);
+          ipHeader.SetProtocol (UdpL4Protocol::PROT_NUMBER);
+        }
+      else
+        {
+          TcpHeader tcpHeader;
+          tcpHeader.SetSourcePort (sp);
+          tcpHeader.SetDestinationPort (dp);
+          packet->AddHeader (tcpHeader);
+          ipHeader.SetProtocol (TcpL4Protocol::PROT_NUMBER);
+        }
+      packet->AddHeader (ipHeader);
+      NS_TEST_ASSERT_MSG_EQ (m_c->Classify (packet, d), expectedTftId,
+                             "bad classification, d = " << d << ", ra = " << ra << ", la = " << la
+                             << ", rp = " << rp << ", lp = " << lp << ", tos = " << (uint16_t) tos);
+    }
+}
+
+void 
+EpcTftClassifierRandomTestCase::DoRun (void)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_c = Create<EpcTftClassifier> ();
+
+  // 16 TFTs of 15 filters, the filters of a TFT being ordered by precedence
+  for (uint32_t id = 1; id <= 16; ++id)
+    {
+      Ptr<EpcTft> tft = Create<EpcTft> ();
+      for (uint32_t i = 0; i < 15; ++i)
+        {
+          EpcTft::PacketFilter f = CreatePacketFilter ();
+          f.precedence = m_random->GetInteger (0, 255);
+          tft->Add (f);
+        }
+      // the identifiers are not added in order
+      uint32_t tftId = (id * 7) % 17;
+      m_c->Add (tft, tftId);
+      m_tftMap[tftId] = tft;
+    }
+  CheckClassification (2000);
+
+  for (uint32_t tftId = 1; tftId <= 16; tftId += 3)
+    {
+      m_c->Delete (tftId);
+      m_tftMap.erase (tftId);
+    }
+  CheckClassification (2000);
+
+  Ptr<EpcTft> tft = EpcTft::Default ();
+  m_c->Add (tft, 1);
+  m_tftMap[1] = tft;
+  CheckClassification (2000);
+}
+
+
+
+
 class EpcTftClassifierTestSuite : public TestSuite
 {
 public:
@@ -328,6 +498,14 @@ EpcTftClassifierTestSuite::EpcTftClassifierTestSuite ()
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::UPLINK,   Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     9,     5897,     0,    2), TestCase::QUICK);
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),  5897,       10,     0,    2), TestCase::QUICK);
 
+
+
+  ///////////////////////////////////////////
+  // check random TFTs against their evaluation one by one
+  ///////////////////////////////////////////
+
+  AddTestCase (new EpcTftClassifierRandomTestCase (), TestCase::QUICK);
+
 }
 
 
@@ -0,0 +1,845 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/simulator.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/system-thread.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/net-device.h"
+#include "ns3/channel.h"
+#include "ns3/packet.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <utility>
+#include <pthread.h>
+
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+namespace ns3 {
+
+/**
+ * \brief A reusable barrier for a fixed number of threads.
+ *
+ * The mutex acquired by Wait also orders the memory accesses made
+ * by the threads before the barrier with the accesses made after it.
+ */
+class MultithreadedBarrier
+{
+public:
+  MultithreadedBarrier (uint32_t count)
+    : m_count (count),
+      m_waiting (0),
+      m_generation (0)
+  {
+    pthread_mutex_init (&m_mutex, NULL);
+    pthread_cond_init (&m_cond, NULL);
+  }
+  ~MultithreadedBarrier ()
+  {
+    pthread_cond_destroy (&m_cond);
+    pthread_mutex_destroy (&m_mutex);
+  }
+  void Wait (void)
+  {
+    pthread_mutex_lock (&m_mutex);
+    uint32_t generation = m_generation;
+    m_waiting++;
+    if (m_waiting == m_count)
+      {
+        m_waiting = 0;
+        m_generation++;
+        pthread_cond_broadcast (&m_cond);
+      }
+    else
+      {
+        while (generation == m_generation)
+          {
+            pthread_cond_wait (&m_cond, &m_mutex);
+          }
+      }
+    pthread_mutex_unlock (&m_mutex);
+  }
+private:
+  pthread_mutex_t m_mutex;
+  pthread_cond_t m_cond;
+  uint32_t m_count;
+  uint32_t m_waiting;
+  uint32_t m_generation;
+};
+
+namespace {
+/**
+ * The partition run by the calling thread, or -1 for threads which
+ * do not run a partition. The main thread is reported as partition 0
+ * outside of Run.
+ */
+__thread int32_t g_partitionId = -1;
+/**
+ * The simulator which is in Run, for ScheduleSerial.
+ */
+MultithreadedSimulatorImpl *g_running = 0;
+} // anonymous namespace
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl)
+  ;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("LookAhead",
+                   "The length of the synchronization windows. If zero, the smallest delay "
+                   "of the point-to-point channels between partitions is used.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&MultithreadedSimulatorImpl::m_lookAheadAttribute),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_barrier (0),
+    m_lookAhead (0),
+    m_stopTs (GetMaximumSimulationTime ().GetTimeStep ()),
+    m_running (false),
+    m_runningSerial (false),
+    m_stopSnapshot (false)
+{
+  NS_LOG_FUNCTION (this);
+  AddPartitions (1);
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      Partition *partition = m_partitions[i];
+      if (partition->events != 0)
+        {
+          while (!partition->events->IsEmpty ())
+            {
+              Scheduler::Event next = partition->events->RemoveNext ();
+              next.impl->Unref ();
+            }
+        }
+      for (uint32_t j = 0; j < partition->inbox.size (); ++j)
+        {
+          for (Mailbox::iterator k = partition->inbox[j].begin (); k != partition->inbox[j].end (); ++k)
+            {
+              k->impl->Unref ();
+            }
+        }
+      delete partition;
+    }
+  m_partitions.clear ();
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  // the destroy events dispose of the NodeList.
+  CalculatePartitions ();
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::AddPartitions (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  NS_ASSERT (!m_running);
+  while (m_partitions.size () < n)
+    {
+      Partition *partition = new Partition ();
+      if (m_schedulerFactory.GetTypeId () != TypeId ())
+        {
+          partition->events = m_schedulerFactory.Create<Scheduler> ();
+        }
+      // all partitions share the same time outside of Run.
+      partition->currentTs = m_partitions.empty () ? 0 : m_partitions[0]->currentTs;
+      // uids are allocated from 4.
+      // uid 0 is "invalid" events
+      // uid 1 is "now" events
+      // uid 2 is "destroy" events
+      partition->uid = 4;
+      // before ::Run is entered, the m_currentUid will be zero
+      partition->currentUid = 0;
+      partition->currentContext = 0xffffffff;
+      partition->unscheduledEvents = 0;
+      partition->nextTs = 0;
+      partition->windowEnd = 0;
+      partition->stopRequest = GetMaximumSimulationTime ().GetTimeStep ();
+      partition->stopTs = partition->stopRequest;
+      partition->packetUid = 0;
+      m_partitions.push_back (partition);
+    }
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionCount (void) const
+{
+  return m_partitions.size ();
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookAhead (void) const
+{
+  return TimeStep (m_lookAhead);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetCurrentPartitionId (void) const
+{
+  return g_partitionId < 0 ? 0 : g_partitionId;
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetCurrentPartition (void) const
+{
+  return m_partitions[GetCurrentPartitionId ()];
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionId (uint32_t context) const
+{
+  // NodeList cannot be used from the partition threads since
+  // Ptr<Node> reference counts are not atomic, nor while it is
+  // disposed of by Simulator::Destroy.
+  if (context < m_nodePartitions.size ())
+    {
+      return m_nodePartitions[context];
+    }
+  if (m_running)
+    {
+      return 0;
+    }
+  if (context < NodeList::GetNNodes ())
+    {
+      uint32_t id = NodeList::GetNode (context)->GetSystemId ();
+      const_cast<MultithreadedSimulatorImpl *> (this)->AddPartitions (id + 1);
+      return id;
+    }
+  return 0;
+}
+
+void
+MultithreadedSimulatorImpl::CalculatePartitions (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_nodePartitions.resize (NodeList::GetNNodes ());
+  uint32_t n = 1;
+  for (uint32_t i = 0; i < NodeList::GetNNodes (); ++i)
+    {
+      uint32_t id = NodeList::GetNode (i)->GetSystemId ();
+      m_nodePartitions[i] = id;
+      n = std::max (n, id + 1);
+    }
+  AddPartitions (n);
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      m_partitions[i]->inbox.resize (m_partitions.size ());
+    }
+}
+
+void
+MultithreadedSimulatorImpl::CalculateLookAhead (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_lookAheadAttribute.IsZero ())
+    {
+      m_lookAhead = m_lookAheadAttribute.GetTimeStep ();
+      return;
+    }
+  m_lookAhead = GetMaximumSimulationTime ().GetTimeStep ();
+  for (NodeList::Iterator iter = NodeList::Begin (); iter != NodeList::End (); ++iter)
+    {
+      for (uint32_t i = 0; i < (*iter)->GetNDevices (); ++i)
+        {
+          Ptr<NetDevice> localNetDevice = (*iter)->GetDevice (i);
+          // only works for p2p links currently
+          if (!localNetDevice->IsPointToPoint ())
+            {
+              continue;
+            }
+          Ptr<Channel> channel = localNetDevice->GetChannel ();
+          if (channel == 0)
+            {
+              continue;
+            }
+
+          // grab the adjacent node
+          Ptr<Node> remoteNode;
+          if (channel->GetDevice (0) == localNetDevice)
+            {
+              remoteNode = (channel->GetDevice (1))->GetNode ();
+            }
+          else
+            {
+              remoteNode = (channel->GetDevice (0))->GetNode ();
+            }
+
+          // if it's in the same partition, don't consider it
+          if (remoteNode->GetSystemId () == (*iter)->GetSystemId ())
+            {
+              continue;
+            }
+
+          TimeValue delay;
+          if (!channel->GetAttributeFailSafe ("Delay", delay))
+            {
+              continue;
+            }
+          if (static_cast<uint64_t> (delay.Get ().GetTimeStep ()) < m_lookAhead)
+            {
+              m_lookAhead = delay.Get ().GetTimeStep ();
+            }
+        }
+    }
+  if (m_lookAhead == 0)
+    {
+      NS_FATAL_ERROR ("Zero-delay channel between two partitions: cannot run in parallel");
+    }
+  NS_LOG_DEBUG ("lookahead=" << m_lookAhead);
+}
+
+void
+MultithreadedSimulatorImpl::CheckOwner (const EventId &id, const char *method) const
+{
+  // destroy events are only run by the main thread, after Run.
+  if (m_running && id.GetUid () != 2 && GetPartitionId (id.GetContext ()) != GetCurrentPartitionId ())
+    {
+      NS_FATAL_ERROR ("Simulator::" << method << " invoked by partition " << GetCurrentPartitionId () <<
+                      " for an event of partition " << GetPartitionId (id.GetContext ()));
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  NS_ASSERT (!m_running);
+  m_schedulerFactory = schedulerFactory;
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      Partition *partition = m_partitions[i];
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      if (partition->events != 0)
+        {
+          while (!partition->events->IsEmpty ())
+            {
+              Scheduler::Event next = partition->events->RemoveNext ();
+              scheduler->Insert (next);
+            }
+        }
+      partition->events = scheduler;
+    }
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return GetCurrentPartitionId ();
+}
+
+EventId
+MultithreadedSimulatorImpl::Insert (Partition *partition, uint64_t ts, uint32_t context, EventImpl *event)
+{
+  NS_ASSERT_MSG (!m_runningSerial, "Events run by ScheduleSerial cannot schedule events");
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  ev.key.m_uid = partition->uid;
+  partition->uid++;
+  partition->unscheduledEvents++;
+  partition->events->Insert (ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent (Partition *partition)
+{
+  Scheduler::Event next = partition->events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= partition->currentTs);
+  partition->unscheduledEvents--;
+
+  NS_LOG_LOGIC ("handle " << next.key.m_ts);
+  partition->currentTs = next.key.m_ts;
+  partition->currentContext = next.key.m_context;
+  partition->currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stopSnapshot)
+    {
+      return true;
+    }
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      if (!m_partitions[i]->events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorImpl::RunThread (MultithreadedSimulatorImpl *impl, uint32_t id)
+{
+  impl->RunPartition (id);
+}
+
+void
+MultithreadedSimulatorImpl::RunPartition (uint32_t id)
+{
+  NS_LOG_FUNCTION (this << id);
+  g_partitionId = id;
+  Partition *partition = m_partitions[id];
+  uint64_t maxTs = GetMaximumSimulationTime ().GetTimeStep ();
+  // Partition 0 runs in the main thread, which keeps its own packet
+  // uid counter. The other ones run in a new thread at each Run.
+  if (id != 0)
+    {
+      Packet::SetNextUid (partition->packetUid);
+    }
+
+  while (true)
+    {
+      // Receive the events posted during the previous window. Mailboxes
+      // are visited in a fixed order to make uids deterministic.
+      for (uint32_t src = 0; src < partition->inbox.size (); ++src)
+        {
+          Mailbox &mailbox = partition->inbox[src];
+          for (Mailbox::const_iterator i = mailbox.begin (); i != mailbox.end (); ++i)
+            {
+              Insert (partition, i->ts, i->context, i->impl);
+            }
+          mailbox.clear ();
+        }
+      partition->nextTs = partition->events->IsEmpty () ? maxTs : partition->events->PeekNext ().key.m_ts;
+      partition->stopTs = partition->stopRequest;
+      m_barrier->Wait ();
+
+      // Every thread makes the same decision from the values
+      // published before the barrier.
+      uint64_t smallest = maxTs;
+      uint64_t stopTs = m_stopTs;
+      for (uint32_t i = 0; i < m_partitions.size (); ++i)
+        {
+          smallest = std::min (smallest, m_partitions[i]->nextTs);
+          stopTs = std::min (stopTs, m_partitions[i]->stopTs);
+        }
+      if (smallest == maxTs || smallest > stopTs)
+        {
+          break;
+        }
+      // process all events strictly before the end of the window
+      // and up to the stop time.
+      uint64_t last = stopTs;
+      if (m_lookAhead < maxTs - smallest)
+        {
+          last = std::min (last, smallest + m_lookAhead - 1);
+        }
+      partition->windowEnd = last;
+      while (!partition->events->IsEmpty ()
+             && partition->events->PeekNext ().key.m_ts <= last)
+        {
+          ProcessOneEvent (partition);
+        }
+      m_barrier->Wait ();
+
+      // Every thread sees the same serial events until the next barrier.
+      bool serial = false;
+      for (uint32_t i = 0; i < m_partitions.size (); ++i)
+        {
+          serial |= !m_partitions[i]->serial.empty ();
+        }
+      if (serial)
+        {
+          if (id == 0)
+            {
+              RunSerialEvents ();
+            }
+          m_barrier->Wait ();
+          partition->serial.clear ();
+        }
+    }
+  if (id != 0)
+    {
+      partition->packetUid = Packet::GetNextUid ();
+    }
+  g_partitionId = -1;
+}
+
+namespace {
+struct SerialEventLess
+{
+  template <typename T>
+  bool operator () (const std::pair<uint32_t, T> &a, const std::pair<uint32_t, T> &b) const
+  {
+    return a.second.ts < b.second.ts;
+  }
+};
+} // anonymous namespace
+
+void
+MultithreadedSimulatorImpl::RunSerialEvents (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Sort by timestamp, and by partition and order of posting for
+  // equal timestamps.
+  std::vector<std::pair<uint32_t, Message> > events;
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      const std::vector<Message> &serial = m_partitions[i]->serial;
+      for (std::vector<Message>::const_iterator j = serial.begin (); j != serial.end (); ++j)
+        {
+          events.push_back (std::make_pair (i, *j));
+        }
+    }
+  std::stable_sort (events.begin (), events.end (), SerialEventLess ());
+
+  m_runningSerial = true;
+  for (uint32_t i = 0; i < events.size (); ++i)
+    {
+      // run as the partition which posted the event.
+      Partition *partition = m_partitions[events[i].first];
+      uint64_t currentTs = partition->currentTs;
+      uint32_t currentContext = partition->currentContext;
+      g_partitionId = events[i].first;
+      partition->currentTs = events[i].second.ts;
+      partition->currentContext = events[i].second.context;
+      events[i].second.impl->Invoke ();
+      events[i].second.impl->Unref ();
+      partition->currentTs = currentTs;
+      partition->currentContext = currentContext;
+    }
+  g_partitionId = 0;
+  m_runningSerial = false;
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleSerial (EventImpl *event)
+{
+  NS_LOG_FUNCTION (event);
+  if (g_running == 0 || g_partitionId < 0)
+    {
+      event->Invoke ();
+      event->Unref ();
+      return;
+    }
+  Partition *partition = g_running->GetCurrentPartition ();
+  Message message;
+  message.ts = partition->currentTs;
+  message.context = partition->currentContext;
+  message.impl = event;
+  partition->serial.push_back (message);
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  CalculatePartitions ();
+  CalculateLookAhead ();
+  uint64_t maxTs = GetMaximumSimulationTime ().GetTimeStep ();
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      m_partitions[i]->stopRequest = maxTs;
+    }
+  m_stopSnapshot = false;
+  m_barrier = new MultithreadedBarrier (m_partitions.size ());
+  m_running = true;
+  g_running = this;
+
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 1; i < m_partitions.size (); ++i)
+    {
+      Ptr<SystemThread> thread =
+        Create<SystemThread> (MakeBoundCallback (&MultithreadedSimulatorImpl::RunThread, this, i));
+      thread->Start ();
+      threads.push_back (thread);
+    }
+  RunPartition (0);
+  for (uint32_t i = 0; i < threads.size (); ++i)
+    {
+      threads[i]->Join ();
+    }
+
+  m_running = false;
+  g_running = 0;
+  delete m_barrier;
+  m_barrier = 0;
+
+  // Outside of Run, all partitions share the time of the last event.
+  // Every partition stopped at the same timestamp so none of them
+  // still holds an event older than this time.
+  uint64_t currentTs = 0;
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      currentTs = std::max (currentTs, m_partitions[i]->currentTs);
+      m_stopSnapshot |= m_partitions[i]->stopRequest != maxTs;
+    }
+  for (uint32_t i = 0; i < m_partitions.size (); ++i)
+    {
+      m_partitions[i]->currentTs = currentTs;
+      m_partitions[i]->currentContext = 0xffffffff;
+    }
+  m_stopTs = GetMaximumSimulationTime ().GetTimeStep ();
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  Stop (TimeStep (0));
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &time)
+{
+  NS_LOG_FUNCTION (this << time.GetTimeStep ());
+  Partition *partition = GetCurrentPartition ();
+  uint64_t ts = partition->currentTs + time.GetTimeStep ();
+  if (m_running)
+    {
+      // The other partitions may already have run the whole current
+      // window: all of them stop after the later of this window and
+      // of the requested time, when they see the request after the
+      // next barrier.
+      partition->stopRequest = std::min (partition->stopRequest, std::max (ts, partition->windowEnd));
+    }
+  else
+    {
+      m_stopTs = ts;
+    }
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << time.GetTimeStep () << event);
+
+  Partition *partition = GetCurrentPartition ();
+  Time tAbsolute = time + TimeStep (partition->currentTs);
+
+  NS_ASSERT (tAbsolute.IsPositive ());
+  NS_ASSERT (tAbsolute >= TimeStep (partition->currentTs));
+  return Insert (partition, tAbsolute.GetTimeStep (), partition->currentContext, event);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << time.GetTimeStep () << event);
+
+  NS_ASSERT_MSG (!m_runningSerial, "Events run by ScheduleSerial cannot schedule events");
+  uint32_t src = GetCurrentPartitionId ();
+  uint32_t dst = GetPartitionId (context);
+  uint64_t ts = m_partitions[src]->currentTs + time.GetTimeStep ();
+  if (!m_running || src == dst)
+    {
+      Insert (m_partitions[dst], ts, context, event);
+      return;
+    }
+  if (static_cast<uint64_t> (time.GetTimeStep ()) < m_lookAhead)
+    {
+      NS_FATAL_ERROR ("Event scheduled for partition " << dst << " by partition " << src <<
+                      " with a delay smaller than the lookahead (" << time << ")");
+    }
+  Message message;
+  message.ts = ts;
+  message.context = context;
+  message.impl = event;
+  // Only the source partition writes to this mailbox until
+  // the destination reads it after the next barrier.
+  m_partitions[dst]->inbox[src].push_back (message);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << event);
+  Partition *partition = GetCurrentPartition ();
+  return Insert (partition, partition->currentTs, partition->currentContext, event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << event);
+  NS_ASSERT_MSG (!m_running, "Simulator::ScheduleDestroy cannot be invoked from a partition thread");
+
+  EventId id (Ptr<EventImpl> (event, false), GetCurrentPartition ()->currentTs, 0xffffffff, 2);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  return TimeStep (GetCurrentPartition ()->currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  CheckOwner (id, "GetDelayLeft");
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - GetCurrentPartition ()->currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  CheckOwner (id, "Remove");
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Partition *partition = m_partitions[GetPartitionId (id.GetContext ())];
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  partition->events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  partition->unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  CheckOwner (id, "Cancel");
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &ev) const
+{
+  if (ev.GetUid () == 2)
+    {
+      if (ev.PeekEventImpl () == 0
+          || ev.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == ev)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  // uids are allocated per partition so the event must be compared
+  // with the current event of its own partition.
+  CheckOwner (ev, "IsExpired");
+  const Partition *partition = m_partitions[GetPartitionId (ev.GetContext ())];
+  if (ev.PeekEventImpl () == 0
+      || ev.GetTs () < partition->currentTs
+      || (ev.GetTs () == partition->currentTs
+          && ev.GetUid () <= partition->currentUid)
+      || ev.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  /// \todo I am fairly certain other compilers use other non-standard
+  /// post-fixes to indicate 64 bit constants.
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  return GetCurrentPartition ()->currentContext;
+}
+
+} // namespace ns3
@@ -0,0 +1,383 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/packet.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Tokens travel around a ring of nodes which belong to different
+ * partitions while every node also runs local events. Each handler
+ * only writes to the slot of its own node, so the checks themselves
+ * do not race.
+ */
+class MultithreadedSimulatorRingTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorRingTestCase (uint32_t nNodes, uint32_t nPartitions);
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void Token (uint32_t node, uint64_t expectedNs);
+  void Local (uint32_t node, uint64_t expectedNs);
+  void Check (uint32_t node, uint64_t expectedNs);
+
+  struct NodeState
+  {
+    uint32_t tokens;
+    uint32_t locals;
+    uint64_t lastNs;
+    bool ok;
+  };
+  uint32_t m_nNodes;
+  uint32_t m_nPartitions;
+  std::vector<NodeState> m_state;
+};
+
+MultithreadedSimulatorRingTestCase::MultithreadedSimulatorRingTestCase (uint32_t nNodes, uint32_t nPartitions)
+  : TestCase ("Check event ordering and contexts in a ring of nodes"),
+    m_nNodes (nNodes),
+    m_nPartitions (nPartitions)
+{
+}
+
+void
+MultithreadedSimulatorRingTestCase::DoSetup (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::LookAhead", TimeValue (MilliSeconds (1)));
+}
+
+void
+MultithreadedSimulatorRingTestCase::DoTeardown (void)
+{
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::LookAhead", TimeValue (Seconds (0)));
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+void
+MultithreadedSimulatorRingTestCase::Check (uint32_t node, uint64_t expectedNs)
+{
+  NodeState &state = m_state[node];
+  uint64_t now = Simulator::Now ().GetNanoSeconds ();
+  if (now != expectedNs
+      || now < state.lastNs
+      || Simulator::GetContext () != node
+      || Simulator::GetSystemId () != node % m_nPartitions)
+    {
+      state.ok = false;
+    }
+  state.lastNs = now;
+}
+
+void
+MultithreadedSimulatorRingTestCase::Token (uint32_t node, uint64_t expectedNs)
+{
+  Check (node, expectedNs);
+  m_state[node].tokens++;
+  uint32_t next = (node + 1) % m_nNodes;
+  Simulator::ScheduleWithContext (next, MilliSeconds (1), &MultithreadedSimulatorRingTestCase::Token,
+                                  this, next, expectedNs + 1000000);
+}
+
+void
+MultithreadedSimulatorRingTestCase::Local (uint32_t node, uint64_t expectedNs)
+{
+  Check (node, expectedNs);
+  m_state[node].locals++;
+  Simulator::Schedule (MicroSeconds (10), &MultithreadedSimulatorRingTestCase::Local,
+                       this, node, expectedNs + 10000);
+}
+
+void
+MultithreadedSimulatorRingTestCase::DoRun (void)
+{
+  NodeState initial = { 0, 0, 0, true};
+  m_state.assign (m_nNodes, initial);
+  for (uint32_t i = 0; i < m_nNodes; ++i)
+    {
+      CreateObject<Node> (i % m_nPartitions);
+    }
+  for (uint32_t i = 0; i < m_nNodes; ++i)
+    {
+      Simulator::ScheduleWithContext (i, MilliSeconds (1), &MultithreadedSimulatorRingTestCase::Token,
+                                      this, i, 1000000);
+      Simulator::ScheduleWithContext (i, MicroSeconds (5), &MultithreadedSimulatorRingTestCase::Local,
+                                      this, i, 5000);
+    }
+  Simulator::Stop (MilliSeconds (100));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetImplementation ()->GetInstanceTypeId ().GetName (),
+                         "ns3::MultithreadedSimulatorImpl", "Wrong simulator implementation");
+  for (uint32_t i = 0; i < m_nNodes; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_state[i].ok, true, "Bad time or context on node " << i);
+      NS_TEST_EXPECT_MSG_EQ (m_state[i].tokens, 100U, "Bad token count on node " << i);
+      NS_TEST_EXPECT_MSG_EQ (m_state[i].locals, 10000U, "Bad local event count on node " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), MilliSeconds (100), "Bad stop time");
+  Simulator::Destroy ();
+}
+
+/**
+ * A node of the second partition stops the simulation: every partition
+ * must stop at the same time, and the simulation must be able to run
+ * again afterwards.
+ */
+class MultithreadedSimulatorStopTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorStopTestCase ();
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void Local (uint32_t node);
+  void Stop (void);
+
+  std::vector<uint64_t> m_lastNs;
+};
+
+MultithreadedSimulatorStopTestCase::MultithreadedSimulatorStopTestCase ()
+  : TestCase ("Check that Stop during Run stops every partition")
+{
+}
+
+void
+MultithreadedSimulatorStopTestCase::DoSetup (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::LookAhead", TimeValue (MilliSeconds (1)));
+}
+
+void
+MultithreadedSimulatorStopTestCase::DoTeardown (void)
+{
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::LookAhead", TimeValue (Seconds (0)));
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+void
+MultithreadedSimulatorStopTestCase::Local (uint32_t node)
+{
+  m_lastNs[node] = Simulator::Now ().GetNanoSeconds ();
+  Simulator::Schedule (MicroSeconds (10), &MultithreadedSimulatorStopTestCase::Local, this, node);
+}
+
+void
+MultithreadedSimulatorStopTestCase::Stop (void)
+{
+  Simulator::Stop (MilliSeconds (2));
+}
+
+void
+MultithreadedSimulatorStopTestCase::DoRun (void)
+{
+  uint32_t nNodes = 4;
+  m_lastNs.assign (nNodes, 0);
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      CreateObject<Node> (i % 2);
+      Simulator::ScheduleWithContext (i, MicroSeconds (5), &MultithreadedSimulatorStopTestCase::Local, this, i);
+    }
+  Simulator::ScheduleWithContext (1, NanoSeconds (5000500), &MultithreadedSimulatorStopTestCase::Stop, this);
+  Simulator::Run ();
+
+  // the stop time falls after the end of its window: every node
+  // runs its events up to 7.0005ms.
+  NS_TEST_EXPECT_MSG_EQ (Simulator::IsFinished (), true, "Simulation not stopped");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), NanoSeconds (6995000), "Bad stop time");
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_lastNs[i], 6995000U, "Node " << i << " did not stop with the others");
+    }
+
+  Simulator::Stop (MilliSeconds (3));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), NanoSeconds (9995000), "Bad stop time");
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_lastNs[i], 9995000U, "Node " << i << " did not run again");
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * Events scheduled by a node of the second partition are cancelled and
+ * removed by the main thread between two runs.
+ */
+class MultithreadedSimulatorCancelTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorCancelTestCase ();
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void Start (void);
+  void Fire (void);
+
+  EventId m_cancelled;
+  EventId m_removed;
+  EventId m_kept;
+  uint32_t m_fired;
+};
+
+MultithreadedSimulatorCancelTestCase::MultithreadedSimulatorCancelTestCase ()
+  : TestCase ("Check Cancel and Remove of events of another partition")
+{
+}
+
+void
+MultithreadedSimulatorCancelTestCase::DoSetup (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::LookAhead", TimeValue (MilliSeconds (1)));
+}
+
+void
+MultithreadedSimulatorCancelTestCase::DoTeardown (void)
+{
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::LookAhead", TimeValue (Seconds (0)));
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+void
+MultithreadedSimulatorCancelTestCase::Start (void)
+{
+  m_cancelled = Simulator::Schedule (MilliSeconds (5), &MultithreadedSimulatorCancelTestCase::Fire, this);
+  m_removed = Simulator::Schedule (MilliSeconds (5), &MultithreadedSimulatorCancelTestCase::Fire, this);
+  m_kept = Simulator::Schedule (MilliSeconds (6), &MultithreadedSimulatorCancelTestCase::Fire, this);
+}
+
+void
+MultithreadedSimulatorCancelTestCase::Fire (void)
+{
+  m_fired++;
+}
+
+void
+MultithreadedSimulatorCancelTestCase::DoRun (void)
+{
+  m_fired = 0;
+  CreateObject<Node> (0);
+  CreateObject<Node> (1);
+  Simulator::ScheduleWithContext (1, MilliSeconds (1), &MultithreadedSimulatorCancelTestCase::Start, this);
+  Simulator::Stop (MilliSeconds (2));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_cancelled.GetContext (), 1U, "Event not scheduled by node 1");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::IsExpired (m_cancelled), false, "Event expired too early");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetDelayLeft (m_kept), MilliSeconds (6), "Bad delay left");
+  Simulator::Cancel (m_cancelled);
+  Simulator::Remove (m_removed);
+  NS_TEST_EXPECT_MSG_EQ (Simulator::IsExpired (m_cancelled), true, "Cancelled event not expired");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::IsExpired (m_removed), true, "Removed event not expired");
+
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_fired, 1U, "Cancelled or removed events fired");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), MilliSeconds (7), "Bad end time");
+  Simulator::Destroy ();
+}
+
+/**
+ * Every Run creates a new thread for partition 1: the packets it
+ * creates must still get new uids.
+ */
+class MultithreadedSimulatorPacketUidTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorPacketUidTestCase ();
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void CreatePacket (void);
+
+  std::vector<uint64_t> m_uids;
+};
+
+MultithreadedSimulatorPacketUidTestCase::MultithreadedSimulatorPacketUidTestCase ()
+  : TestCase ("Check packet uids of a partition across calls to Run")
+{
+}
+
+void
+MultithreadedSimulatorPacketUidTestCase::DoSetup (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::LookAhead", TimeValue (MilliSeconds (1)));
+}
+
+void
+MultithreadedSimulatorPacketUidTestCase::DoTeardown (void)
+{
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::LookAhead", TimeValue (Seconds (0)));
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+void
+MultithreadedSimulatorPacketUidTestCase::CreatePacket (void)
+{
+  m_uids.push_back (Create<Packet> ()->GetUid ());
+}
+
+void
+MultithreadedSimulatorPacketUidTestCase::DoRun (void)
+{
+  CreateObject<Node> (0);
+  CreateObject<Node> (1);
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      Simulator::ScheduleWithContext (1, MilliSeconds (1), &MultithreadedSimulatorPacketUidTestCase::CreatePacket, this);
+      Simulator::Run ();
+    }
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_uids.size (), 3U, "Packets not created");
+  for (uint32_t i = 0; i < m_uids.size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((m_uids[i] >> 32), 1U, "Packet " << i << " not created by partition 1");
+      NS_TEST_EXPECT_MSG_EQ ((m_uids[i] & 0xffffffff), i, "Packet uid " << i << " reused");
+    }
+}
+
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+public:
+  MultithreadedSimulatorTestSuite ()
+    : TestSuite ("multithreaded-simulator")
+  {
+    AddTestCase (new MultithreadedSimulatorRingTestCase (1, 1), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorRingTestCase (4, 4), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorRingTestCase (16, 4), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorStopTestCase (), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorCancelTestCase (), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorPacketUidTestCase (), TestCase::QUICK);
+  }
+} g_multithreadedSimulatorTestSuite;
@@ -26,6 +26,9 @@
 #include "ns3/ptr.h"
 #include "ns3/node.h"
 #include "ns3/names.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
 #include "ns3/net-device.h"
 #include "ns3/pcap-file-wrapper.h"
 
@@ -35,6 +38,25 @@ NS_LOG_COMPONENT_DEFINE ("TraceHelper");
 
 namespace ns3 {
 
+static GlobalValue g_pcapSingleFile ("PcapSingleFile",
+                                     "If not empty, the name of a pcapng file in which the pcap "
+                                     "files created by the helpers are written, each one as an "
+                                     "interface of the pcapng file.",
+                                     StringValue (""),
+                                     MakeStringChecker ());
+
+/// The pcapng file named by PcapSingleFile, released when the simulator is destroyed.
+static Ptr<PcapFileWrapper> g_singleFile;
+static std::string g_singleFileName;
+
+static void
+ReleaseSingleFile (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_singleFile = 0;
+  g_singleFileName = "";
+}
+
 PcapHelper::PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -55,6 +77,22 @@ PcapHelper::CreateFile (
 {
   NS_LOG_FUNCTION (filename << filemode << dataLinkType << snapLen << tzCorrection);
 
+  StringValue singleFile;
+  g_pcapSingleFile.GetValue (singleFile);
+  if (singleFile.Get () != "" && (filemode & std::ios::in) == 0)
+    {
+      if (g_singleFile == 0 || g_singleFileName != singleFile.Get ())
+        {
+          g_singleFile = CreateObject<PcapFileWrapper> ();
+          g_singleFileName = singleFile.Get ();
+          g_singleFile->Open (g_singleFileName, std::ios::out);
+          NS_ABORT_MSG_IF (g_singleFile->Fail (), "Unable to Open " << g_singleFileName);
+          g_singleFile->InitNg ();
+          Simulator::ScheduleDestroy (&ReleaseSingleFile);
+        }
+      return g_singleFile->AddInterface (filename, dataLinkType, snapLen);
+    }
+
   Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
   file->Open (filename, filemode);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename << " for mode " << filemode);
@@ -88,6 +88,10 @@ public:
 
   /**
    * @brief Create and initialize a pcap file.
+   *
+   * If the "PcapSingleFile" GlobalValue names a file, no file is created
+   * for writing: the packets are recorded in that pcapng file instead, as
+   * the packets of an interface named filename.
    * 
    * @param filename file name
    * @param filemode file mode
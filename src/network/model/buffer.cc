@@ -20,6 +20,11 @@
 #include "buffer.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
+#include <vector>
 
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
@@ -46,7 +51,7 @@ static struct Zeroes
 namespace ns3 {
 
 
-uint32_t Buffer::g_recommendedStart = 0;
+__thread uint32_t Buffer::g_recommendedStart = 0;
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -71,13 +76,32 @@ uint32_t Buffer::g_recommendedStart = 0;
 #define IS_INITIALIZED(x) (!IS_UNINITIALIZED (x) && !IS_DESTROYED (x))
 #define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
 #define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList *Buffer::g_freeList = 0;
+__thread uint32_t Buffer::g_maxSize = 0;
+__thread Buffer::FreeList *Buffer::g_freeList = 0;
 struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
 
 Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
 {
   NS_LOG_FUNCTION (this);
+  Buffer::DestroyFreeList ();
+}
+
+void
+Buffer::CreateFreeList (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_freeList = new Buffer::FreeList ();
+#ifdef HAVE_PTHREAD_H
+  // the free lists of the other threads than the main one are
+  // destroyed when they exit.
+  SystemThread::AtExit (&Buffer::DestroyFreeList);
+#endif
+}
+
+void
+Buffer::DestroyFreeList (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
   if (IS_INITIALIZED (g_freeList))
     {
       for (Buffer::FreeList::iterator i = g_freeList->begin ();
@@ -95,7 +119,11 @@ Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
+  if (IS_UNINITIALIZED (g_freeList))
+    {
+      // the buffer was created by another thread
+      CreateFreeList ();
+    }
   g_maxSize = std::max (g_maxSize, data->m_size);
   /* feed into free list */
   if (data->m_size < g_maxSize ||
@@ -118,7 +146,7 @@ Buffer::Create (uint32_t dataSize)
   /* try to find a buffer correctly sized. */
   if (IS_UNINITIALIZED (g_freeList))
     {
-      g_freeList = new Buffer::FreeList ();
+      CreateFreeList ();
     }
   else if (IS_INITIALIZED (g_freeList))
     {
@@ -181,6 +209,190 @@ Buffer::Deallocate (struct Buffer::Data *data)
   delete [] buf;
 }
 
+struct Buffer::Payload *
+Buffer::CreatePayload (uint8_t const *buffer, uint32_t size)
+{
+  NS_LOG_FUNCTION (&buffer << size);
+  uint8_t *b = new uint8_t [sizeof (struct Buffer::Payload) + size];
+  struct Buffer::Payload *payload = reinterpret_cast<struct Buffer::Payload *> (b);
+  payload->m_count = 1;
+  payload->m_size = size;
+  payload->m_nSegments = 1;
+  uint8_t *bytes = b + sizeof (struct Buffer::Payload);
+  memcpy (bytes, buffer, size);
+  payload->m_segments[0].owner = 0;
+  payload->m_segments[0].bytes = bytes;
+  payload->m_segments[0].start = 0;
+  return payload;
+}
+
+void
+Buffer::AppendSegments (std::vector<struct Buffer::Payload::Segment> &segments,
+                        struct Buffer::Payload *payload, uint32_t start, uint32_t size)
+{
+  uint32_t i = payload == 0 || size == 0 ? 0 : FindSegment (payload, start, 0);
+  while (size > 0)
+    {
+      struct Buffer::Payload::Segment range;
+      if (payload == 0)
+        {
+          range.owner = 0;
+          range.bytes = 0;
+          range.start = size;
+        }
+      else
+        {
+          struct Buffer::Payload::Segment const &segment = payload->m_segments[i];
+          uint32_t end = i + 1 < payload->m_nSegments ? payload->m_segments[i + 1].start : payload->m_size;
+          range.start = std::min (size, end - start);
+          if (segment.bytes == 0)
+            {
+              range.owner = 0;
+              range.bytes = 0;
+            }
+          else
+            {
+              range.owner = segment.owner != 0 ? segment.owner : payload;
+              range.bytes = segment.bytes + (start - segment.start);
+            }
+          i++;
+        }
+      start += range.start;
+      size -= range.start;
+      if (!segments.empty ())
+        {
+          struct Buffer::Payload::Segment &last = segments.back ();
+          if (last.owner == range.owner
+              && (last.bytes == 0 ? range.bytes == 0 : last.bytes + last.start == range.bytes))
+            {
+              last.start += range.start;
+              continue;
+            }
+        }
+      segments.push_back (range);
+    }
+}
+
+struct Buffer::Payload *
+Buffer::ConcatPayloads (struct Buffer::Payload *a, uint32_t aStart, uint32_t aSize,
+                        struct Buffer::Payload *b, uint32_t bStart, uint32_t bSize,
+                        uint32_t *start)
+{
+  NS_LOG_FUNCTION (a << aStart << aSize << b << bStart << bSize);
+  if (a != 0 && a == b && aStart + aSize == bStart)
+    {
+      // two adjacent windows of the same payload.
+      a->m_count++;
+      *start = aStart;
+      return a;
+    }
+  // the start field of these segments holds their size.
+  std::vector<struct Buffer::Payload::Segment> segments;
+  AppendSegments (segments, a, aStart, aSize);
+  AppendSegments (segments, b, bStart, bSize);
+  uint8_t *buffer = new uint8_t [sizeof (struct Buffer::Payload)
+                                 + (segments.size () - 1) * sizeof (struct Buffer::Payload::Segment)];
+  struct Buffer::Payload *payload = reinterpret_cast<struct Buffer::Payload *> (buffer);
+  payload->m_count = 1;
+  payload->m_size = 0;
+  payload->m_nSegments = segments.size ();
+  for (uint32_t i = 0; i < segments.size (); i++)
+    {
+      payload->m_segments[i] = segments[i];
+      payload->m_segments[i].start = payload->m_size;
+      payload->m_size += segments[i].start;
+      if (segments[i].owner != 0)
+        {
+          segments[i].owner->m_count++;
+        }
+    }
+  *start = 0;
+  return payload;
+}
+
+void
+Buffer::ReleasePayload (struct Buffer::Payload *payload)
+{
+  NS_LOG_FUNCTION (payload);
+  if (payload == 0)
+    {
+      return;
+    }
+  payload->m_count--;
+  if (payload->m_count == 0)
+    {
+      for (uint32_t i = 0; i < payload->m_nSegments; i++)
+        {
+          ReleasePayload (payload->m_segments[i].owner);
+        }
+      uint8_t *buf = reinterpret_cast<uint8_t *> (payload);
+      delete [] buf;
+    }
+}
+
+uint32_t
+Buffer::FindSegment (struct Buffer::Payload const *payload, uint32_t offset, uint32_t hint)
+{
+  NS_ASSERT (offset < payload->m_size);
+  uint32_t n = payload->m_nSegments;
+  if (hint < n && payload->m_segments[hint].start <= offset
+      && (hint + 1 == n || offset < payload->m_segments[hint + 1].start))
+    {
+      return hint;
+    }
+  // the last segment whose start is not past offset
+  uint32_t low = 0;
+  uint32_t high = n;
+  while (high - low > 1)
+    {
+      uint32_t middle = (low + high) / 2;
+      if (payload->m_segments[middle].start <= offset)
+        {
+          low = middle;
+        }
+      else
+        {
+          high = middle;
+        }
+    }
+  return low;
+}
+
+void
+Buffer::ReadPayload (struct Buffer::Payload const *payload, uint32_t offset,
+                     uint8_t *buffer, uint32_t size)
+{
+  if (size == 0)
+    {
+      return;
+    }
+  if (payload == 0)
+    {
+      memset (buffer, 0, size);
+      return;
+    }
+  NS_ASSERT (offset + size <= payload->m_size);
+  uint32_t i = FindSegment (payload, offset, 0);
+  while (size > 0)
+    {
+      struct Buffer::Payload::Segment const &segment = payload->m_segments[i];
+      uint32_t end = i + 1 < payload->m_nSegments ? payload->m_segments[i + 1].start : payload->m_size;
+      uint32_t toCopy = std::min (size, end - offset);
+      if (segment.bytes == 0)
+        {
+          memset (buffer, 0, toCopy);
+        }
+      else
+        {
+          memcpy (buffer, segment.bytes + (offset - segment.start), toCopy);
+        }
+      buffer += toCopy;
+      offset += toCopy;
+      size -= toCopy;
+      i++;
+    }
+}
+
 Buffer::Buffer ()
 {
   NS_LOG_FUNCTION (this);
@@ -194,6 +406,8 @@ Buffer::Buffer (uint32_t dataSize)
 }
 
 Buffer::Buffer (uint32_t dataSize, bool initialize)
+  : m_payload (0),
+    m_payloadStart (0)
 {
   NS_LOG_FUNCTION (this << dataSize << initialize);
   if (initialize == true)
@@ -202,6 +416,16 @@ Buffer::Buffer (uint32_t dataSize, bool initialize)
     }
 }
 
+Buffer::Buffer (uint8_t const *buffer, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << &buffer << size);
+  Initialize (size);
+  if (size > 0)
+    {
+      m_payload = CreatePayload (buffer, size);
+    }
+}
+
 bool
 Buffer::CheckInternalState (void) const
 {
@@ -221,8 +445,12 @@ Buffer::CheckInternalState (void) const
   bool internalSizeOk = m_end - (m_zeroAreaEnd - m_zeroAreaStart) <= m_data->m_size &&
     m_start <= m_data->m_size &&
     m_zeroAreaStart <= m_data->m_size;
+  bool payloadOk = m_payload == 0 ||
+    (m_payload->m_count > 0 &&
+     m_zeroAreaEnd > m_zeroAreaStart &&
+     m_payloadStart + (m_zeroAreaEnd - m_zeroAreaStart) <= m_payload->m_size);
 
-  bool ok = m_data->m_count > 0 && offsetsOk && dirtyOk && internalSizeOk;
+  bool ok = m_data->m_count > 0 && offsetsOk && dirtyOk && internalSizeOk && payloadOk;
   if (!ok)
     {
       LOG_INTERNAL_STATE ("check " << this << 
@@ -241,6 +469,8 @@ Buffer::Initialize (uint32_t zeroSize)
 {
   NS_LOG_FUNCTION (this << zeroSize);
   m_data = Buffer::Create (0);
+  m_payload = 0;
+  m_payloadStart = 0;
   m_start = std::min (m_data->m_size, g_recommendedStart);
   m_maxZeroAreaStart = m_start;
   m_zeroAreaStart = m_start;
@@ -266,6 +496,16 @@ Buffer::operator = (Buffer const&o)
       m_data = o.m_data;
       m_data->m_count++;
     }
+  if (m_payload != o.m_payload)
+    {
+      ReleasePayload (m_payload);
+      m_payload = o.m_payload;
+      if (m_payload != 0)
+        {
+          m_payload->m_count++;
+        }
+    }
+  m_payloadStart = o.m_payloadStart;
   g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
   m_maxZeroAreaStart = o.m_maxZeroAreaStart;
   m_zeroAreaStart = o.m_zeroAreaStart;
@@ -286,6 +526,46 @@ Buffer::~Buffer ()
     {
       Recycle (m_data);
     }
+  ReleasePayload (m_payload);
+}
+
+void
+Buffer::DropEmptyPayload (void)
+{
+  if (m_zeroAreaStart == m_zeroAreaEnd)
+    {
+      ReleasePayload (m_payload);
+      m_payload = 0;
+      m_payloadStart = 0;
+    }
+}
+
+void
+Buffer::Unshare (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_end == m_zeroAreaEnd);
+  /* Give this buffer its own copy of its bytes, which are all before
+   * the zero area, keeping the usual room for headers in front of them.
+   */
+  uint32_t size = GetInternalSize ();
+  struct Buffer::Data *newData = Buffer::Create (g_recommendedStart + size);
+  uint32_t start = newData->m_size - size;
+  start = std::min (start, g_recommendedStart);
+  memcpy (newData->m_data + start, m_data->m_data + m_start, size);
+  m_data->m_count--;
+  if (m_data->m_count == 0)
+    {
+      Buffer::Recycle (m_data);
+    }
+  m_data = newData;
+  int32_t delta = start - m_start;
+  m_start += delta;
+  m_zeroAreaStart += delta;
+  m_zeroAreaEnd += delta;
+  m_end += delta;
+  m_data->m_dirtyStart = m_start;
+  m_data->m_dirtyEnd = m_end;
 }
 
 uint32_t
@@ -411,18 +691,31 @@ void
 Buffer::AddAtEnd (const Buffer &o)
 {
   NS_LOG_FUNCTION (this << &o);
-  if (m_data->m_count == 1 &&
-      m_end == m_zeroAreaEnd &&
-      m_end == m_data->m_dirtyEnd &&
+  if (m_end == m_zeroAreaEnd &&
       o.m_start == o.m_zeroAreaStart &&
       o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
     {
       /**
        * This is an optimization which kicks in when
        * we attempt to aggregate two buffers which contain
-       * adjacent zero areas.
+       * adjacent zero areas: the payload of the result
+       * references the payloads of both buffers.
        */
       uint32_t zeroSize = o.m_zeroAreaEnd - o.m_zeroAreaStart;
+      if (m_data->m_count != 1 || m_end != m_data->m_dirtyEnd)
+        {
+          Unshare ();
+        }
+      if (m_payload != 0 || o.m_payload != 0)
+        {
+          uint32_t payloadStart;
+          struct Buffer::Payload *payload = ConcatPayloads (m_payload, m_payloadStart, m_zeroAreaEnd - m_zeroAreaStart,
+                                                            o.m_payload, o.m_payloadStart, zeroSize,
+                                                            &payloadStart);
+          ReleasePayload (m_payload);
+          m_payload = payload;
+          m_payloadStart = payloadStart;
+        }
       m_zeroAreaEnd += zeroSize;
       m_end = m_zeroAreaEnd;
       m_data->m_dirtyEnd = m_zeroAreaEnd;
@@ -468,6 +761,7 @@ Buffer::RemoveAtStart (uint32_t start)
       m_start = m_zeroAreaStart;
       m_zeroAreaEnd -= delta;
       m_end -= delta;
+      m_payloadStart += delta;
     } 
   else if (newStart <= m_end)
     {
@@ -489,6 +783,7 @@ Buffer::RemoveAtStart (uint32_t start)
       m_zeroAreaEnd = m_end;
       m_zeroAreaStart = m_end;
     }
+  DropEmptyPayload ();
   m_maxZeroAreaStart = std::max (m_maxZeroAreaStart, m_zeroAreaStart);
   LOG_INTERNAL_STATE ("rem start=" << start << ", ");
   NS_ASSERT (CheckInternalState ());
@@ -524,6 +819,7 @@ Buffer::RemoveAtEnd (uint32_t end)
       m_zeroAreaEnd = m_start;
       m_zeroAreaStart = m_start;
     }
+  DropEmptyPayload ();
   m_maxZeroAreaStart = std::max (m_maxZeroAreaStart, m_zeroAreaStart);
   LOG_INTERNAL_STATE ("rem end=" << end << ", ");
   NS_ASSERT (CheckInternalState ());
@@ -550,7 +846,8 @@ Buffer::CreateFullCopy (void) const
     {
       Buffer tmp;
       tmp.AddAtStart (m_zeroAreaEnd - m_zeroAreaStart);
-      tmp.Begin ().WriteU8 (0, m_zeroAreaEnd - m_zeroAreaStart);
+      ReadPayload (m_payload, m_payloadStart, tmp.m_data->m_data + tmp.m_start,
+                   m_zeroAreaEnd - m_zeroAreaStart);
       uint32_t dataStart = m_zeroAreaStart - m_start;
       tmp.AddAtStart (dataStart);
       tmp.Begin ().Write (m_data->m_data+m_start, dataStart);
@@ -570,6 +867,11 @@ uint32_t
 Buffer::GetSerializedSize (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_payload != 0)
+    {
+      // the payload bytes are serialized as real data.
+      return CreateFullCopy ().GetSerializedSize ();
+    }
   uint32_t dataStart = (m_zeroAreaStart - m_start + 3) & (~0x3);
   uint32_t dataEnd = (m_end - m_zeroAreaEnd + 3) & (~0x3);
 
@@ -590,6 +892,10 @@ uint32_t
 Buffer::Serialize (uint8_t* buffer, uint32_t maxSize) const
 {
   NS_LOG_FUNCTION (this << &buffer << maxSize);
+  if (m_payload != 0)
+    {
+      return CreateFullCopy ().Serialize (buffer, maxSize);
+    }
   uint32_t* p = reinterpret_cast<uint32_t *> (buffer);
   uint32_t size = 0;
 
@@ -748,11 +1054,22 @@ Buffer::CopyData (std::ostream *os, uint32_t size) const
           size -= m_zeroAreaStart-m_start;
           tmpsize = std::min (m_zeroAreaEnd - m_zeroAreaStart, size);
           uint32_t left = tmpsize;
+          uint32_t offset = m_payloadStart;
           while (left > 0)
             {
               uint32_t toWrite = std::min (left, g_zeroes.size);
-              os->write (g_zeroes.buffer, toWrite);
+              if (m_payload == 0)
+                {
+                  os->write (g_zeroes.buffer, toWrite);
+                }
+              else
+                {
+                  char bytes[sizeof (g_zeroes.buffer)];
+                  ReadPayload (m_payload, offset, reinterpret_cast<uint8_t *> (bytes), toWrite);
+                  os->write (bytes, toWrite);
+                }
               left -= toWrite;
+              offset += toWrite;
             }
           if (size > tmpsize)
             {
@@ -778,14 +1095,8 @@ Buffer::CopyData (uint8_t *buffer, uint32_t size) const
       if (size > 0) 
         { 
           tmpsize = std::min (m_zeroAreaEnd - m_zeroAreaStart, size);
-          uint32_t left = tmpsize;
-          while (left > 0)
-            {
-              uint32_t toWrite = std::min (left, g_zeroes.size);
-              memcpy (buffer, g_zeroes.buffer, toWrite);
-              left -= toWrite;
-              buffer += toWrite;
-            }
+          ReadPayload (m_payload, m_payloadStart, buffer, tmpsize);
+          buffer += tmpsize;
           size -= tmpsize;
           if (size > 0)
             {
@@ -868,27 +1179,36 @@ Buffer::Iterator::Write (Iterator start, Iterator end)
   uint32_t size = end.m_current - start.m_current;
   NS_ASSERT_MSG (CheckNoZero (m_current, m_current + size),
                  GetWriteErrorMessage ());
+  // the bytes written are either all before or all after our zero area.
+  uint8_t *to;
+  if (m_current < m_zeroEnd)
+    {
+      to = &m_data[m_current];
+    }
+  else
+    {
+      to = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
+    }
+  m_current += size;
   if (start.m_current <= start.m_zeroStart)
     {
       uint32_t toCopy = std::min (size, start.m_zeroStart - start.m_current);
-      memcpy (&m_data[m_current], &start.m_data[start.m_current], toCopy);
+      memcpy (to, &start.m_data[start.m_current], toCopy);
       start.m_current += toCopy;
-      m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   if (start.m_current <= start.m_zeroEnd)
     {
       uint32_t toCopy = std::min (size, start.m_zeroEnd - start.m_current);
-      memset (&m_data[m_current], 0, toCopy);
+      ReadPayload (start.m_payload, start.m_payloadStart + (start.m_current - start.m_zeroStart),
+                   to, toCopy);
       start.m_current += toCopy;
-      m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
-  uint32_t toCopy = std::min (size, start.m_dataEnd - start.m_current);
   uint8_t *from = &start.m_data[start.m_current - (start.m_zeroEnd-start.m_zeroStart)];
-  uint8_t *to = &m_data[m_current];
-  memcpy (to, from, toCopy);
-  m_current += toCopy;
+  memcpy (to, from, size);
 }
 
 void 
@@ -1148,10 +1468,41 @@ void
 Buffer::Iterator::Read (uint8_t *buffer, uint32_t size)
 {
   NS_LOG_FUNCTION (this << &buffer << size);
-  for (uint32_t i = 0; i < size; i++)
+  NS_ASSERT_MSG (m_current >= m_dataStart &&
+                 m_current + size <= m_dataEnd,
+                 GetReadErrorMessage ());
+  if (m_current < m_zeroStart)
+    {
+      uint32_t toCopy = std::min (size, m_zeroStart - m_current);
+      memcpy (buffer, &m_data[m_current], toCopy);
+      m_current += toCopy;
+      buffer += toCopy;
+      size -= toCopy;
+    }
+  if (m_current < m_zeroEnd)
     {
-      buffer[i] = ReadU8 ();
+      uint32_t toCopy = std::min (size, m_zeroEnd - m_current);
+      Buffer::ReadPayload (m_payload, m_payloadStart + (m_current - m_zeroStart), buffer, toCopy);
+      m_current += toCopy;
+      buffer += toCopy;
+      size -= toCopy;
+    }
+  memcpy (buffer, &m_data[m_current - (m_zeroEnd - m_zeroStart)], size);
+  m_current += size;
+}
+
+uint8_t
+Buffer::Iterator::ReadPayloadU8 (void)
+{
+  uint32_t offset = m_payloadStart + (m_current - m_zeroStart);
+  m_segment = Buffer::FindSegment (m_payload, offset, m_segment);
+  struct Buffer::Payload::Segment const &segment = m_payload->m_segments[m_segment];
+  m_current++;
+  if (segment.bytes == 0)
+    {
+      return 0;
     }
+  return segment.bytes[offset - segment.start];
 }
 
 uint16_t
@@ -88,9 +88,23 @@ namespace ns3 {
  * \endverbatim
  *
  * A simple state invariant is that m_start <= m_zeroStart <= m_zeroEnd <= m_end
+ *
+ * The "virtual zero area" can also hold real payload bytes which are
+ * not stored in the BufferData: Buffer::Payload is a read-only,
+ * reference-counted list of byte ranges, and the zero area is then a
+ * window into this list. A Buffer created with Buffer::Buffer (uint8_t
+ * const *, uint32_t) stores its bytes this way, so that its copies and
+ * fragments share them, and so that the headers added to a fragment
+ * never copy its payload. Appending a buffer whose payload window
+ * starts right at the end of the payload window of this buffer only
+ * builds a new list of ranges which references the bytes of both:
+ * reassembling fragments or building a TCP segment out of several
+ * application writes does not copy the payload either.
  */
 class Buffer 
 {
+private:
+  struct Payload;
 public:
   /**
    * \brief iterator in a Buffer instance
@@ -366,6 +380,7 @@ private:
     inline void Construct (const Buffer *buffer);
     bool CheckNoZero (uint32_t start, uint32_t end) const;
     bool Check (uint32_t i) const;
+    uint8_t ReadPayloadU8 (void);
     uint16_t SlowReadNtohU16 (void);
     uint32_t SlowReadNtohU32 (void);
     std::string GetReadErrorMessage (void) const;
@@ -395,6 +410,17 @@ private:
      * to this pointer.
      */
     uint8_t *m_data;
+    /* the payload read from the "virtual zero area", zero if it holds
+     * zero bytes.
+     */
+    struct Buffer::Payload const *m_payload;
+    /* offset in m_payload of the byte at m_zeroStart.
+     */
+    uint32_t m_payloadStart;
+    /* index of the segment of m_payload last read, a hint for the next
+     * read.
+     */
+    uint32_t m_segment;
   };
 
   /**
@@ -528,6 +554,16 @@ private:
   Buffer ();
   Buffer (uint32_t dataSize);
   Buffer (uint32_t dataSize, bool initialize);
+  /**
+   * \param buffer the bytes to store in the new buffer.
+   * \param size the number of bytes to store.
+   *
+   * Create a buffer which holds a copy of the input bytes. These bytes
+   * are stored out of the byte buffer which holds the headers and the
+   * trailers, and are shared by all the copies and fragments of the
+   * new buffer: they are read-only.
+   */
+  Buffer (uint8_t const *buffer, uint32_t size);
   ~Buffer ();
 private:
   /**
@@ -567,6 +603,42 @@ private:
     uint8_t m_data[1];
   };
 
+  /**
+   * The bytes of the "virtual zero area", as a list of segments. A
+   * payload is never modified once it has been created, and holds a
+   * reference to the payloads whose bytes it uses.
+   */
+  struct Payload
+  {
+    struct Segment
+    {
+      /* the payload which holds the bytes of this segment, zero if
+       * the bytes are stored in this payload or if they are zero.
+       */
+      struct Payload *owner;
+      /* the bytes of this segment, zero if they are zero.
+       */
+      uint8_t const *bytes;
+      /* offset of the first byte of this segment in the payload.
+       */
+      uint32_t start;
+    };
+    /* The reference count of this payload: each Buffer which uses it
+     * and each Segment whose owner it is holds a count.
+     */
+    uint32_t m_count;
+    /* the total number of bytes of this payload.
+     */
+    uint32_t m_size;
+    /* the number of entries of the m_segments array below.
+     */
+    uint32_t m_nSegments;
+    /* the segments, in byte order. A payload created out of a byte
+     * array has one segment, followed by the bytes.
+     */
+    struct Segment m_segments[1];
+  };
+
   void TransformIntoRealBuffer (void) const;
   bool CheckInternalState (void) const;
   void Initialize (uint32_t zeroSize);
@@ -576,8 +648,26 @@ private:
   static struct Buffer::Data *Create (uint32_t size);
   static struct Buffer::Data *Allocate (uint32_t reqSize);
   static void Deallocate (struct Buffer::Data *data);
+  static struct Buffer::Payload *CreatePayload (uint8_t const *buffer, uint32_t size);
+  static struct Buffer::Payload *ConcatPayloads (struct Buffer::Payload *a, uint32_t aStart, uint32_t aSize,
+                                                 struct Buffer::Payload *b, uint32_t bStart, uint32_t bSize,
+                                                 uint32_t *start);
+  static void AppendSegments (std::vector<struct Buffer::Payload::Segment> &segments,
+                              struct Buffer::Payload *payload, uint32_t start, uint32_t size);
+  static void ReleasePayload (struct Buffer::Payload *payload);
+  static uint32_t FindSegment (struct Buffer::Payload const *payload, uint32_t offset, uint32_t hint);
+  static void ReadPayload (struct Buffer::Payload const *payload, uint32_t offset,
+                           uint8_t *buffer, uint32_t size);
+  void DropEmptyPayload (void);
+  void Unshare (void);
 
   struct Data *m_data;
+  /* the bytes of the "virtual zero area", zero if they are all zero.
+   */
+  struct Payload *m_payload;
+  /* offset in m_payload of the first byte of the "virtual zero area".
+   */
+  uint32_t m_payloadStart;
 
   /* keep track of the maximum value of m_zeroAreaStart across
    * the lifetime of a Buffer instance. This variable is used
@@ -594,7 +684,7 @@ private:
    * writing data. i.e., m_start should be initialized to this 
    * value.
    */
-  static uint32_t g_recommendedStart;
+  static __thread uint32_t g_recommendedStart;
 
   /* offset to the start of the virtual zero area from the start 
    * of m_data->m_data
@@ -619,8 +709,21 @@ private:
   {
     ~LocalStaticDestructor ();
   };
-  static uint32_t g_maxSize;
-  static FreeList *g_freeList;
+  /**
+   * Create the free list of the calling thread.
+   */
+  static void CreateFreeList (void);
+  /**
+   * Free the buffers of the free list of the calling thread, which
+   * then stops recycling buffers.
+   */
+  static void DestroyFreeList (void);
+  /* each thread has its own free list and sizes so that buffers
+   * can be created and destroyed concurrently by the partitions of
+   * a multithreaded simulation.
+   */
+  static __thread uint32_t g_maxSize;
+  static __thread FreeList *g_freeList;
   static struct LocalStaticDestructor g_localStaticDestructor;
 #endif
 };
@@ -638,7 +741,10 @@ Buffer::Iterator::Iterator ()
     m_dataStart (0),
     m_dataEnd (0),
     m_current (0),
-    m_data (0)
+    m_data (0),
+    m_payload (0),
+    m_payloadStart (0),
+    m_segment (0)
 {
 }
 Buffer::Iterator::Iterator (Buffer const*buffer)
@@ -660,6 +766,9 @@ Buffer::Iterator::Construct (const Buffer *buffer)
   m_dataStart = buffer->m_start;
   m_dataEnd = buffer->m_end;
   m_data = buffer->m_data->m_data;
+  m_payload = buffer->m_payload;
+  m_payloadStart = buffer->m_payloadStart;
+  m_segment = 0;
 }
 
 void 
@@ -773,7 +882,7 @@ Buffer::Iterator::ReadNtohU16 (void)
     }
   else if (m_current >= m_zeroEnd)
     {
-      buffer = &m_data[m_current];
+      buffer = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
     }
   else
     {
@@ -797,7 +906,7 @@ Buffer::Iterator::ReadNtohU32 (void)
     }
   else if (m_current >= m_zeroEnd)
     {
-      buffer = &m_data[m_current];
+      buffer = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
     }
   else
     {
@@ -830,6 +939,10 @@ Buffer::Iterator::ReadU8 (void)
     }
   else if (m_current < m_zeroEnd)
     {
+      if (m_payload != 0)
+        {
+          return ReadPayloadU8 ();
+        }
       m_current++;
       return 0;
     }
@@ -855,6 +968,8 @@ Buffer::Iterator::ReadU16 (void)
 
 Buffer::Buffer (Buffer const&o)
   : m_data (o.m_data),
+    m_payload (o.m_payload),
+    m_payloadStart (o.m_payloadStart),
     m_maxZeroAreaStart (o.m_zeroAreaStart),
     m_zeroAreaStart (o.m_zeroAreaStart),
     m_zeroAreaEnd (o.m_zeroAreaEnd),
@@ -862,6 +977,10 @@ Buffer::Buffer (Buffer const&o)
     m_end (o.m_end)
 {
   m_data->m_count++;
+  if (m_payload != 0)
+    {
+      m_payload->m_count++;
+    }
   NS_ASSERT (CheckInternalState ());
 }
 
@@ -19,13 +19,16 @@
  */
 #include "byte-tag-list.h"
 #include "ns3/log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
 #include <vector>
 #include <cstring>
 
 NS_LOG_COMPONENT_DEFINE ("ByteTagList");
 
 #define USE_FREE_LIST 1
-#define FREE_LIST_SIZE 1000
 #define OFFSET_MAX (2147483647)
 
 namespace ns3 {
@@ -38,23 +41,72 @@ struct ByteTagListData {
 };
 
 #ifdef USE_FREE_LIST
-static class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
+namespace {
+
+/**
+ * The free lists are indexed by size class: the buffers of class i
+ * can hold (POOL_MIN_SIZE << i) bytes of tags. Bigger buffers are
+ * not recycled.
+ */
+const uint32_t POOL_MIN_SIZE = 64;
+const uint32_t POOL_CLASSES = 6;
+/**
+ * Maximum number of buffers kept in each free list.
+ */
+const uint32_t POOL_MAX_BLOCKS = 1000;
+
+/**
+ * Packets can be created and destroyed from several threads, so each
+ * thread owns its free lists, which avoids any locking. A free buffer
+ * is linked to the next one of its class through its first bytes.
+ */
+__thread struct ByteTagListData *g_freeLists[POOL_CLASSES];
+__thread uint32_t g_freeListSizes[POOL_CLASSES];
+__thread uint64_t g_poolHits;
+__thread uint64_t g_poolMisses;
+
+uint32_t
+GetSizeClass (uint32_t size)
 {
-public:
-  ~ByteTagListDataFreeList ();
-} g_freeList;
-static uint32_t g_maxSize = 0;
+  uint32_t sizeClass = 0;
+  while (sizeClass < POOL_CLASSES && (POOL_MIN_SIZE << sizeClass) < size)
+    {
+      sizeClass++;
+    }
+  return sizeClass;
+}
 
-ByteTagListDataFreeList::~ByteTagListDataFreeList ()
+struct ByteTagListData *&
+NextFree (struct ByteTagListData *data)
 {
-  NS_LOG_FUNCTION (this);
-  for (ByteTagListDataFreeList::iterator i = begin ();
-       i != end (); i++)
+  return *reinterpret_cast<struct ByteTagListData **> (data);
+}
+
+/**
+ * Whether the free lists of the calling thread are freed when it exits.
+ */
+__thread bool g_freeAtExit;
+
+/**
+ * Free the buffers of the free lists of the calling thread, which is
+ * exiting: the buffers it frees from now on are not kept.
+ */
+void
+FreePools (void)
+{
+  for (uint32_t i = 0; i < POOL_CLASSES; i++)
     {
-      uint8_t *buffer = (uint8_t *)(*i);
-      delete [] buffer;
+      while (g_freeLists[i] != 0)
+        {
+          uint8_t *buffer = (uint8_t *)g_freeLists[i];
+          g_freeLists[i] = NextFree (g_freeLists[i]);
+          delete [] buffer;
+        }
+      g_freeListSizes[i] = POOL_MAX_BLOCKS;
     }
 }
+
+} // anonymous namespace
 #endif /* USE_FREE_LIST */
 
 ByteTagList::Iterator::Item::Item (TagBuffer buf_)
@@ -344,24 +396,27 @@ struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
-  while (!g_freeList.empty ())
+  uint32_t sizeClass = GetSizeClass (size);
+  struct ByteTagListData *data;
+  if (sizeClass < POOL_CLASSES && g_freeLists[sizeClass] != 0)
     {
-      struct ByteTagListData *data = g_freeList.back ();
-      g_freeList.pop_back ();
-      NS_ASSERT (data != 0);
-      if (data->size >= size)
-        {
-          data->count = 1;
-          data->dirty = 0;
-          return data;
-        }
-      uint8_t *buffer = (uint8_t *)data;
-      delete [] buffer;
+      data = g_freeLists[sizeClass];
+      g_freeLists[sizeClass] = NextFree (data);
+      g_freeListSizes[sizeClass]--;
+      data->size = POOL_MIN_SIZE << sizeClass;
+      g_poolHits++;
+    }
+  else
+    {
+      // buffers are allocated with the full size of their class, so
+      // that the tags added later can be appended in place.
+      uint32_t capacity = sizeClass < POOL_CLASSES ? POOL_MIN_SIZE << sizeClass : size;
+      uint8_t *buffer = new uint8_t [capacity + sizeof (struct ByteTagListData) - 4];
+      data = (struct ByteTagListData *)buffer;
+      data->size = capacity;
+      g_poolMisses++;
     }
-  uint8_t *buffer = new uint8_t [std::max (size, g_maxSize) + sizeof (struct ByteTagListData) - 4];
-  struct ByteTagListData *data = (struct ByteTagListData *)buffer;
   data->count = 1;
-  data->size = size;
   data->dirty = 0;
   return data;
 }
@@ -374,19 +429,29 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
     {
       return;
     }
-  g_maxSize = std::max (g_maxSize, data->size);
   data->count--;
   if (data->count == 0)
     {
-      if (g_freeList.size () > FREE_LIST_SIZE ||
-          data->size < g_maxSize)
+      uint32_t sizeClass = GetSizeClass (data->size);
+      if (sizeClass < POOL_CLASSES
+          && data->size == POOL_MIN_SIZE << sizeClass
+          && g_freeListSizes[sizeClass] < POOL_MAX_BLOCKS)
         {
-          uint8_t *buffer = (uint8_t *)data;
-          delete [] buffer;
+#ifdef HAVE_PTHREAD_H
+          if (!g_freeAtExit)
+            {
+              g_freeAtExit = true;
+              SystemThread::AtExit (&FreePools);
+            }
+#endif
+          NextFree (data) = g_freeLists[sizeClass];
+          g_freeLists[sizeClass] = data;
+          g_freeListSizes[sizeClass]++;
         }
       else
         {
-          g_freeList.push_back (data);
+          uint8_t *buffer = (uint8_t *)data;
+          delete [] buffer;
         }
     }
 }
@@ -423,5 +488,24 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
 
 #endif /* USE_FREE_LIST */
 
+uint64_t
+ByteTagList::GetPoolHits (void)
+{
+#ifdef USE_FREE_LIST
+  return g_poolHits;
+#else
+  return 0;
+#endif
+}
+
+uint64_t
+ByteTagList::GetPoolMisses (void)
+{
+#ifdef USE_FREE_LIST
+  return g_poolMisses;
+#else
+  return 0;
+#endif
+}
 
 } // namespace ns3
@@ -213,6 +213,17 @@ private:
    */
   void AddAtStart (int32_t adjustment, int32_t prependOffset);
 
+  /**
+   * \returns the number of tag buffer allocations of the calling thread
+   *          which reused a freed buffer.
+   */
+  static uint64_t GetPoolHits (void);
+  /**
+   * \returns the number of tag buffer allocations of the calling thread
+   *          which had to allocate memory.
+   */
+  static uint64_t GetPoolMisses (void);
+
 private:
   bool IsDirtyAtEnd (int32_t appendOffset);
   bool IsDirtyAtStart (int32_t prependOffset);
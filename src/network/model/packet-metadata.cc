@@ -22,6 +22,10 @@
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
 #include "packet-metadata.h"
 #include "buffer.h"
 #include "header.h"
@@ -34,9 +38,22 @@ namespace ns3 {
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
 bool PacketMetadata::m_metadataSkipped = false;
-uint32_t PacketMetadata::m_maxSize = 0;
-uint16_t PacketMetadata::m_chunkUid = 0;
-PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+__thread uint32_t PacketMetadata::m_maxSize = 0;
+__thread uint16_t PacketMetadata::m_chunkUid = 0;
+// a free list which is zero has not been created yet, and the free list
+// of a thread is DESTROYED_FREE_LIST once the thread has exited, or once
+// the static destructors have run for the main thread, so that it is
+// not created again.
+#define DESTROYED_FREE_LIST ((PacketMetadata::DataFreeList *)~(uintptr_t)0)
+__thread PacketMetadata::DataFreeList *PacketMetadata::m_freeList = 0;
+struct PacketMetadata::LocalStaticDestructor PacketMetadata::m_localStaticDestructor;
+
+PacketMetadata::LocalStaticDestructor::~LocalStaticDestructor ()
+{
+  NS_LOG_FUNCTION (this);
+  DestroyFreeList ();
+  PacketMetadata::m_enable = false;
+}
 
 PacketMetadata::DataFreeList::~DataFreeList ()
 {
@@ -45,7 +62,6 @@ PacketMetadata::DataFreeList::~DataFreeList ()
     {
       PacketMetadata::Deallocate (*i);
     }
-  PacketMetadata::m_enable = false;
 }
 
 void 
@@ -133,6 +149,11 @@ bool
 PacketMetadata::IsStateOk (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_data == 0)
+    {
+      return (m_head == 0xffff && m_tail == 0xffff) ||
+             (m_head <= m_tail && m_tail < INLINE_ITEMS);
+    }
   bool ok = m_used <= m_data->m_size;
   ok &= IsPointerOk (m_head);
   ok &= IsPointerOk (m_tail);
@@ -512,6 +533,7 @@ PacketMetadata::ReplaceTail (PacketMetadata::SmallItem *item,
 
   // create a copy of the packet without its tail.
   PacketMetadata h (m_packetUid, 0);
+  h.Expand ();
   uint16_t current = m_head;
   while (current != 0xffff && current != m_tail)
     {
@@ -544,6 +566,20 @@ PacketMetadata::ReadItems (uint16_t current,
   NS_LOG_FUNCTION (this << current << item->chunkUid << item->prev << item->next << item->size <<
                         item->typeUid << extraItem->fragmentEnd << extraItem->fragmentStart <<
                         extraItem->packetUid);
+  if (m_data == 0)
+    {
+      NS_ASSERT (current < INLINE_ITEMS && current >= m_head && current <= m_tail);
+      const struct PacketMetadata::InlineItem *inlineItem = &m_inline[current];
+      item->next = current == m_tail ? 0xffff : current + 1;
+      item->prev = current == m_head ? 0xffff : current - 1;
+      item->typeUid = inlineItem->uid << 1;
+      item->size = inlineItem->size;
+      item->chunkUid = inlineItem->chunkUid;
+      extraItem->fragmentStart = 0;
+      extraItem->fragmentEnd = item->size;
+      extraItem->packetUid = m_packetUid;
+      return 0;
+    }
   NS_ASSERT (current <= m_data->m_size);
   const uint8_t *buffer = &m_data->m_data[current];
   item->next = buffer[0];
@@ -578,6 +614,103 @@ PacketMetadata::ReadItems (uint16_t current,
   return buffer - &m_data->m_data[current];
 }
 
+/**
+ * \param item the item to add, whose next and prev fields are ignored
+ * \param atHead true to add the item before the head, false to add it
+ *        after the tail.
+ * \returns true if the item was stored inline, false if the items are
+ *          not stored inline or if there is no room left for it.
+ */
+bool
+PacketMetadata::AddInline (const struct PacketMetadata::SmallItem *item, bool atHead)
+{
+  NS_LOG_FUNCTION (this << item << atHead);
+  if (m_data != 0)
+    {
+      return false;
+    }
+  NS_ASSERT ((item->typeUid & 0x1) == 0);
+  uint16_t index;
+  if (m_head == 0xffff)
+    {
+      // leave room for a trailer after the first item, usually the payload
+      index = INLINE_ITEMS - 2;
+      m_head = index;
+      m_tail = index;
+    }
+  else
+    {
+      uint16_t n = m_tail - m_head + 1;
+      if (n == INLINE_ITEMS)
+        {
+          return false;
+        }
+      if (atHead)
+        {
+          if (m_head == 0)
+            {
+              memmove (&m_inline[INLINE_ITEMS - n], &m_inline[0],
+                       n * sizeof (struct PacketMetadata::InlineItem));
+              m_head = INLINE_ITEMS - n;
+              m_tail = INLINE_ITEMS - 1;
+            }
+          m_head--;
+          index = m_head;
+        }
+      else
+        {
+          if (m_tail == INLINE_ITEMS - 1)
+            {
+              memmove (&m_inline[0], &m_inline[m_head],
+                       n * sizeof (struct PacketMetadata::InlineItem));
+              m_head = 0;
+              m_tail = n - 1;
+            }
+          m_tail++;
+          index = m_tail;
+        }
+    }
+  m_inline[index].uid = item->typeUid >> 1;
+  m_inline[index].size = item->size;
+  m_inline[index].chunkUid = item->chunkUid;
+  return true;
+}
+
+/**
+ * Move the items stored inline, if any, to a Data buffer.
+ */
+void
+PacketMetadata::Expand (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_data != 0)
+    {
+      return;
+    }
+  uint16_t head = m_head;
+  uint16_t tail = m_tail;
+  m_data = PacketMetadata::Create (10);
+  memset (m_data->m_data, 0xff, 4);
+  m_head = 0xffff;
+  m_tail = 0xffff;
+  m_used = 0;
+  if (head == 0xffff)
+    {
+      return;
+    }
+  for (uint16_t i = head; i <= tail; i++)
+    {
+      struct PacketMetadata::SmallItem item;
+      item.next = 0xffff;
+      item.prev = m_tail;
+      item.typeUid = m_inline[i].uid << 1;
+      item.size = m_inline[i].size;
+      item.chunkUid = m_inline[i].chunkUid;
+      uint16_t written = AddSmall (&item);
+      UpdateTail (written);
+    }
+}
+
 struct PacketMetadata::Data *
 PacketMetadata::Create (uint32_t size)
 {
@@ -587,10 +720,11 @@ PacketMetadata::Create (uint32_t size)
     {
       m_maxSize = size;
     }
-  while (!m_freeList.empty ()) 
+  DataFreeList *freeList = GetFreeList ();
+  while (freeList != 0 && !freeList->empty ()) 
     {
-      struct PacketMetadata::Data *data = m_freeList.back ();
-      m_freeList.pop_back ();
+      struct PacketMetadata::Data *data = freeList->back ();
+      freeList->pop_back ();
       if (data->m_size >= size) 
         {
           NS_LOG_LOGIC ("create found size="<<data->m_size);
@@ -613,19 +747,47 @@ PacketMetadata::Recycle (struct PacketMetadata::Data *data)
       PacketMetadata::Deallocate (data);
       return;
     } 
-  NS_LOG_LOGIC ("recycle size="<<data->m_size<<", list="<<m_freeList.size ());
+  DataFreeList *freeList = GetFreeList ();
   NS_ASSERT (data->m_count == 0);
-  if (m_freeList.size () > 1000 ||
+  if (freeList == 0 ||
+      freeList->size () > 1000 ||
       data->m_size < m_maxSize) 
     {
       PacketMetadata::Deallocate (data);
     } 
   else 
     {
-      m_freeList.push_back (data);
+      NS_LOG_LOGIC ("recycle size="<<data->m_size<<", list="<<freeList->size ());
+      freeList->push_back (data);
     }
 }
 
+PacketMetadata::DataFreeList *
+PacketMetadata::GetFreeList (void)
+{
+  if (m_freeList == 0)
+    {
+      m_freeList = new DataFreeList ();
+#ifdef HAVE_PTHREAD_H
+      // the free lists of the other threads than the main one are
+      // destroyed when they exit.
+      SystemThread::AtExit (&PacketMetadata::DestroyFreeList);
+#endif
+    }
+  return m_freeList == DESTROYED_FREE_LIST ? 0 : m_freeList;
+}
+
+void
+PacketMetadata::DestroyFreeList (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  if (m_freeList != 0 && m_freeList != DESTROYED_FREE_LIST)
+    {
+      delete m_freeList;
+    }
+  m_freeList = DESTROYED_FREE_LIST;
+}
+
 struct PacketMetadata::Data *
 PacketMetadata::Allocate (uint32_t n)
 {
@@ -682,12 +844,17 @@ PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
     }
 
   struct PacketMetadata::SmallItem item;
-  item.next = m_head;
-  item.prev = 0xffff;
   item.typeUid = uid;
   item.size = size;
   item.chunkUid = m_chunkUid;
   m_chunkUid++;
+  if (AddInline (&item, true))
+    {
+      return;
+    }
+  Expand ();
+  item.next = m_head;
+  item.prev = 0xffff;
   uint16_t written = AddSmall (&item);
   UpdateHead (written);
 }
@@ -724,7 +891,7 @@ PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
         }
       return;
     }
-  if (m_head + read == m_used)
+  if (m_data != 0 && m_head + read == m_used)
     {
       m_used = m_head;
     }
@@ -751,12 +918,18 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
       return;
     }
   struct PacketMetadata::SmallItem item;
-  item.next = 0xffff;
-  item.prev = m_tail;
   item.typeUid = uid;
   item.size = size;
   item.chunkUid = m_chunkUid;
   m_chunkUid++;
+  if (AddInline (&item, false))
+    {
+      NS_ASSERT (IsStateOk ());
+      return;
+    }
+  Expand ();
+  item.next = 0xffff;
+  item.prev = m_tail;
   uint16_t written = AddSmall (&item);
   UpdateTail (written);
   NS_ASSERT (IsStateOk ());
@@ -794,7 +967,7 @@ PacketMetadata::RemoveTrailer (const Trailer &trailer, uint32_t size)
         }
       return;
     }
-  if (m_tail + read == m_used)
+  if (m_data != 0 && m_tail + read == m_used)
     {
       m_used = m_tail;
     }
@@ -834,6 +1007,7 @@ PacketMetadata::AddAtEnd (PacketMetadata const&o)
       return;
     }
   NS_ASSERT (m_head != 0xffff && m_tail != 0xffff);
+  Expand ();
 
   // We read the current tail because we are going to append
   // after this item.
@@ -907,7 +1081,6 @@ PacketMetadata::RemoveAtStart (uint32_t start)
       m_metadataSkipped = true;
       return;
     }
-  NS_ASSERT (m_data != 0);
   uint32_t leftToRemove = start;
   uint16_t current = m_head;
   while (current != 0xffff && leftToRemove > 0)
@@ -934,6 +1107,7 @@ PacketMetadata::RemoveAtStart (uint32_t start)
         {
           // fragment the list item.
           PacketMetadata fragment (m_packetUid, 0);
+          fragment.Expand ();
           extraItem.fragmentStart += leftToRemove;
           leftToRemove = 0;
           uint16_t written = fragment.AddBig (0xffff, fragment.m_tail,
@@ -970,8 +1144,6 @@ PacketMetadata::RemoveAtEnd (uint32_t end)
       m_metadataSkipped = true;
       return;
     }
-  NS_ASSERT (m_data != 0);
-
   uint32_t leftToRemove = end;
   uint16_t current = m_tail;
   while (current != 0xffff && leftToRemove > 0)
@@ -998,6 +1170,7 @@ PacketMetadata::RemoveAtEnd (uint32_t end)
         {
           // fragment the list item.
           PacketMetadata fragment (m_packetUid, 0);
+          fragment.Expand ();
           NS_ASSERT (extraItem.fragmentEnd > leftToRemove);
           extraItem.fragmentEnd -= leftToRemove;
           leftToRemove = 0;
@@ -1295,6 +1468,7 @@ uint32_t
 PacketMetadata::Deserialize (const uint8_t* buffer, uint32_t size)
 {
   NS_LOG_FUNCTION (this << &buffer << size);
+  Expand ();
   const uint8_t* start = buffer;
   uint32_t desSize = size - 4;
 
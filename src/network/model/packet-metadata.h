@@ -75,6 +75,14 @@ class Trailer;
  * integers, and some others as variable-size 32-bit integers.
  * The variable-size 32 bit integers are stored using the uleb128
  * encoding.
+ *
+ * Most packets never hold more than a few whole headers and trailers
+ * added on top of their payload. As long as a packet holds at most
+ * INLINE_ITEMS such items, they are stored in a fixed array inside the
+ * PacketMetadata object rather than in a Data buffer:
+ * m_head and m_tail are then the indexes of the first and last items
+ * of the array, and m_data is zero. No Data buffer is allocated until
+ * a packet is fragmented, concatenated, or gets more items.
  */
 class PacketMetadata 
 {
@@ -292,6 +300,21 @@ private:
     uint64_t packetUid;
   };
 
+  /* the number of whole items stored inline */
+  static const uint32_t INLINE_ITEMS = 8;
+
+  /* A whole header, trailer or payload of the current packet, stored
+     inline.
+   */
+  struct InlineItem {
+    /* the TypeId uid of the header or trailer, zero for payload: the
+       typeUid of the item, without its low bit which is always zero.
+     */
+    uint16_t uid;
+    uint16_t chunkUid;
+    uint32_t size;
+  };
+
   class DataFreeList : public std::vector<struct Data *>
   {
 public:
@@ -303,6 +326,9 @@ public:
 
   PacketMetadata ();
 
+  inline bool AddInline (const PacketMetadata::SmallItem *item, bool atHead);
+  void Expand (void);
+  inline void CopyInline (PacketMetadata const &o);
   inline uint16_t AddSmall (const PacketMetadata::SmallItem *item);
   uint16_t AddBig (uint32_t head, uint32_t tail,
                    const PacketMetadata::SmallItem *item, 
@@ -335,7 +361,19 @@ public:
   static struct PacketMetadata::Data *Allocate (uint32_t n);
   static void Deallocate (struct PacketMetadata::Data *data);
 
-  static DataFreeList m_freeList;
+  static DataFreeList *GetFreeList (void);
+  static void DestroyFreeList (void);
+
+  struct LocalStaticDestructor
+  {
+    ~LocalStaticDestructor ();
+  };
+  /* each thread has its own free list, created on demand, and its own
+   * chunk uids, so that packets can be created and destroyed
+   * concurrently by the partitions of a multithreaded simulation.
+   */
+  static __thread DataFreeList *m_freeList;
+  static struct LocalStaticDestructor m_localStaticDestructor;
   static bool m_enable;
   static bool m_enableChecking;
 
@@ -344,10 +382,10 @@ public:
   // middle of a simulation, which isn't allowed.
   static bool m_metadataSkipped;
 
-  static uint32_t m_maxSize;
-  static uint16_t m_chunkUid;
+  static __thread uint32_t m_maxSize;
+  static __thread uint16_t m_chunkUid;
 
-  struct Data *m_data;
+  struct Data *m_data; // zero if the items are stored in m_inline
   /**
      head -(next)-> tail
        ^             |
@@ -357,6 +395,7 @@ public:
   uint16_t m_tail;
   uint16_t m_used;
   uint64_t m_packetUid;
+  struct InlineItem m_inline[INLINE_ITEMS];
 };
 
 } // namespace ns3
@@ -364,18 +403,26 @@ public:
 namespace ns3 {
 
 PacketMetadata::PacketMetadata (uint64_t uid, uint32_t size)
-  : m_data (PacketMetadata::Create (10)),
+  : m_data (0),
     m_head (0xffff),
     m_tail (0xffff),
     m_used (0),
     m_packetUid (uid)
 {
-  memset (m_data->m_data, 0xff, 4);
   if (size > 0)
     {
       DoAddHeader (0, size);
     }
 }
+void
+PacketMetadata::CopyInline (PacketMetadata const &o)
+{
+  if (o.m_data == 0 && o.m_head != 0xffff)
+    {
+      memcpy (&m_inline[o.m_head], &o.m_inline[o.m_head],
+              (o.m_tail - o.m_head + 1) * sizeof (struct InlineItem));
+    }
+}
 PacketMetadata::PacketMetadata (PacketMetadata const &o)
   : m_data (o.m_data),
     m_head (o.m_head),
@@ -383,7 +430,11 @@ PacketMetadata::PacketMetadata (PacketMetadata const &o)
     m_used (o.m_used),
     m_packetUid (o.m_packetUid)
 {
-  NS_ASSERT (m_data != 0);
+  if (m_data == 0)
+    {
+      CopyInline (o);
+      return;
+    }
   NS_ASSERT (m_data->m_count < std::numeric_limits<uint32_t>::max());
   m_data->m_count++;
 }
@@ -393,15 +444,23 @@ PacketMetadata::operator = (PacketMetadata const& o)
   if (m_data != o.m_data) 
     {
       // not self assignment
-      NS_ASSERT (m_data != 0);
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (m_data != 0)
         {
-          PacketMetadata::Recycle (m_data);
+          m_data->m_count--;
+          if (m_data->m_count == 0) 
+            {
+              PacketMetadata::Recycle (m_data);
+            }
         }
       m_data = o.m_data;
-      NS_ASSERT (m_data != 0);
-      m_data->m_count++;
+      if (m_data != 0)
+        {
+          m_data->m_count++;
+        }
+    }
+  if (m_data == 0 && this != &o)
+    {
+      CopyInline (o);
     }
   m_head = o.m_head;
   m_tail = o.m_tail;
@@ -411,7 +470,10 @@ PacketMetadata::operator = (PacketMetadata const& o)
 }
 PacketMetadata::~PacketMetadata ()
 {
-  NS_ASSERT (m_data != 0);
+  if (m_data == 0)
+    {
+      return;
+    }
   m_data->m_count--;
   if (m_data->m_count == 0) 
     {
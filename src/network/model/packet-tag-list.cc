@@ -28,6 +28,10 @@
 #include "tag.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
 #include <cstring>
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList")
@@ -35,6 +39,104 @@ NS_LOG_COMPONENT_DEFINE ("PacketTagList")
 
 namespace ns3 {
 
+namespace {
+
+/**
+ * Maximum number of TagData kept in the free list of a thread. This
+ * bounds the memory retained by a thread which frees the tags of
+ * packets created by another one.
+ */
+const uint32_t POOL_MAX_BLOCKS = 4096;
+
+struct FreeBlock
+{
+  FreeBlock *next;
+};
+
+/**
+ * Packets can be created and destroyed from several threads, so each
+ * thread owns its free list, which avoids any locking.
+ */
+__thread FreeBlock *g_freeList;
+__thread uint32_t g_freeListSize;
+__thread uint64_t g_poolHits;
+__thread uint64_t g_poolMisses;
+/**
+ * Whether the free list of the calling thread is freed when it exits.
+ */
+__thread bool g_freeAtExit;
+
+/**
+ * Free the TagData of the free list of the calling thread, which is
+ * exiting, and stop filling it.
+ */
+void
+FreePool (void)
+{
+  while (g_freeList != 0)
+    {
+      FreeBlock *block = g_freeList;
+      g_freeList = block->next;
+      ::operator delete (block);
+    }
+  g_freeListSize = POOL_MAX_BLOCKS;
+}
+
+} // anonymous namespace
+
+void *
+PacketTagList::TagData::operator new (size_t size)
+{
+  NS_ASSERT (size == sizeof (struct TagData));
+  FreeBlock *block = g_freeList;
+  if (block != 0)
+    {
+      g_freeList = block->next;
+      g_freeListSize--;
+      g_poolHits++;
+      return block;
+    }
+  g_poolMisses++;
+  return ::operator new (size);
+}
+
+void
+PacketTagList::TagData::operator delete (void *p, size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  if (g_freeListSize < POOL_MAX_BLOCKS)
+    {
+#ifdef HAVE_PTHREAD_H
+      if (!g_freeAtExit)
+        {
+          g_freeAtExit = true;
+          SystemThread::AtExit (&FreePool);
+        }
+#endif
+      FreeBlock *block = static_cast<FreeBlock *> (p);
+      block->next = g_freeList;
+      g_freeList = block;
+      g_freeListSize++;
+      return;
+    }
+  ::operator delete (p);
+}
+
+uint64_t
+PacketTagList::GetPoolHits (void)
+{
+  return g_poolHits;
+}
+
+uint64_t
+PacketTagList::GetPoolMisses (void)
+{
+  return g_poolMisses;
+}
+
 bool
 PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 {
@@ -279,6 +381,25 @@ PacketTagList::Peek (Tag &tag) const
   return false;
 }
 
+PacketTagList
+PacketTagList::DeepCopy (void) const
+{
+  NS_LOG_FUNCTION (this);
+  PacketTagList copy;
+  struct TagData **prevNext = &copy.m_next;
+  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+    {
+      struct TagData *data = new struct TagData ();
+      std::memcpy (data->data, cur->data, TagData::MAX_SIZE);
+      data->tid = cur->tid;
+      data->count = 1;
+      data->next = 0;
+      *prevNext = data;
+      prevNext = &data->next;
+    }
+  return copy;
+}
+
 const struct PacketTagList::TagData *
 PacketTagList::Head (void) const
 {
@@ -124,6 +124,10 @@ class Tag;
  * \n
  * Packet tags must serialize to a finite maximum size, see TagData
  *
+ * TagData are all the same size, and are recycled through a free list
+ * owned by each thread, so that adding and removing tags along the path
+ * of a packet does not normally allocate memory.
+ *
  * This documentation entitles the original author to a free beer.
  */
 class PacketTagList 
@@ -165,6 +169,21 @@ public:
     struct TagData * next;   /**< Pointer to next in list */
     TypeId tid;               /**< Type of the tag serialized into #data */
     uint32_t count;           /**< Number of incoming links */
+
+    /**
+     * Allocate a TagData from the free list of the calling thread.
+     *
+     * \param [in] size The size of the TagData.
+     * \returns The memory of the new TagData.
+     */
+    static void *operator new (size_t size);
+    /**
+     * Return a TagData to the free list of the calling thread.
+     *
+     * \param [in] p The TagData memory.
+     * \param [in] size The size of the TagData.
+     */
+    static void operator delete (void *p, size_t size);
   };  /* struct TagData */
 
   /**
@@ -236,6 +255,21 @@ public:
    * \returns pointer to head of tag list
    */
   const struct PacketTagList::TagData *Head (void) const;
+  /**
+   * \returns A copy of this list which shares no TagData with it.
+   */
+  PacketTagList DeepCopy (void) const;
+
+  /**
+   * \returns The number of TagData allocations of the calling thread
+   *          which reused a freed TagData.
+   */
+  static uint64_t GetPoolHits (void);
+  /**
+   * \returns The number of TagData allocations of the calling thread
+   *          which had to allocate memory.
+   */
+  static uint64_t GetPoolMisses (void);
 
 private:
   /**
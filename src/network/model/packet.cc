@@ -22,13 +22,14 @@
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include <string>
+#include <vector>
 #include <cstdarg>
 
 NS_LOG_COMPONENT_DEFINE ("Packet");
 
 namespace ns3 {
 
-uint32_t Packet::m_globalUid = 0;
+__thread uint32_t Packet::m_globalUid = 0;
 
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
@@ -127,6 +128,25 @@ Packet::Copy (void) const
   return Ptr<Packet> (new Packet (*this), false);
 }
 
+Ptr<Packet>
+Packet::DeepCopy (void) const
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t size = GetSerializedSize ();
+  std::vector<uint8_t> buffer (size);
+  Serialize (&buffer[0], size);
+  Ptr<Packet> copy = Create<Packet> (&buffer[0], size, true);
+  // the byte tags are copied at the offsets of the new buffer, and
+  // the lists of the copy are built from scratch so that they do not
+  // share their data with this packet.
+  ByteTagList byteTags = m_byteTagList;
+  byteTags.AddAtStart (copy->m_buffer.GetCurrentStartOffset () - m_buffer.GetCurrentStartOffset (),
+                       copy->m_buffer.GetCurrentStartOffset ());
+  copy->m_byteTagList.Add (byteTags);
+  copy->m_packetTagList = m_packetTagList.DeepCopy ();
+  return copy;
+}
+
 Packet::Packet ()
   : m_buffer (),
     m_byteTagList (),
@@ -196,7 +216,7 @@ Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
 }
 
 Packet::Packet (uint8_t const*buffer, uint32_t size)
-  : m_buffer (),
+  : m_buffer (buffer, size),
     m_byteTagList (),
     m_packetTagList (),
     /* The upper 32 bits of the packet id in 
@@ -209,9 +229,6 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
     m_nixVector (0)
 {
   m_globalUid++;
-  m_buffer.AddAtStart (size);
-  Buffer::Iterator i = m_buffer.Begin ();
-  i.Write (buffer, size);
 }
 
 Packet::Packet (const Buffer &buffer,  const ByteTagList &byteTagList, 
@@ -395,6 +412,18 @@ Packet::GetUid (void) const
   return m_metadata.GetUid ();
 }
 
+uint32_t
+Packet::GetNextUid (void)
+{
+  return m_globalUid;
+}
+
+void
+Packet::SetNextUid (uint32_t uid)
+{
+  m_globalUid = uid;
+}
+
 void 
 Packet::PrintByteTags (std::ostream &os) const
 {
@@ -236,7 +236,8 @@ public:
   /**
    * Create a packet with payload filled with the content
    * of this buffer. The input data is copied: the input
-   * buffer is untouched.
+   * buffer is untouched. The copies and the fragments of
+   * the new packet share this copy of the data.
    *
    * \param buffer the data to store in the packet.
    * \param size the size of the input buffer.
@@ -381,6 +382,15 @@ public:
    */
   Ptr<Packet> Copy (void) const;
 
+  /**
+   * \returns a copy of the packet, with its uid and its tags, which
+   *          shares no dataset with the original packet.
+   *
+   * Unlike Copy, the copy and the original packet can be used by
+   * different threads: the copy is built from the serialized packet.
+   */
+  Ptr<Packet> DeepCopy (void) const;
+
   /**
    * A packet is allocated a new uid when it is created
    * empty or with zero-filled payload.
@@ -400,6 +410,22 @@ public:
    */
   uint64_t GetUid (void) const;
 
+  /**
+   * \returns the low 32 bits of the uid of the next packet created by
+   *          the calling thread.
+   *
+   * Each thread counts the packets it creates: a simulator which runs
+   * a system id in a new thread saves this counter when the thread
+   * ends and restores it with SetNextUid in the next thread, so that
+   * uids do not repeat.
+   */
+  static uint32_t GetNextUid (void);
+  /**
+   * \param uid the low 32 bits of the uid of the next packet created
+   *        by the calling thread.
+   */
+  static void SetNextUid (uint32_t uid);
+
   /**
    * \param os output stream in which the data should be printed.
    *
@@ -592,7 +618,11 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector;
 
-  static uint32_t m_globalUid;
+  /* uids are allocated per thread: the high 32 bits of a packet uid
+   * hold the system id, which is unique per thread in a multithreaded
+   * simulation.
+   */
+  static __thread uint32_t m_globalUid;
 };
 
 std::ostream& operator<< (std::ostream& os, const Packet &packet);
@@ -2,6 +2,7 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/double.h"
 #include "ns3/test.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -323,6 +324,127 @@ BufferTest::DoRun (void)
   free (cBuf);
 }
 //-----------------------------------------------------------------------------
+/**
+ * Check the buffers whose "virtual zero area" holds payload bytes:
+ * reads through iterators, copies, fragments, concatenation and
+ * serialization must all see the payload bytes.
+ */
+class BufferPayloadTest : public TestCase {
+public:
+  BufferPayloadTest ();
+private:
+  virtual void DoRun (void);
+  std::vector<uint8_t> GetBytes (Buffer const &buffer);
+};
+
+BufferPayloadTest::BufferPayloadTest ()
+  : TestCase ("Buffer payload")
+{
+}
+
+std::vector<uint8_t>
+BufferPayloadTest::GetBytes (Buffer const &buffer)
+{
+  std::vector<uint8_t> bytes (buffer.GetSize () + 1);
+  uint32_t copied = buffer.CopyData (&bytes[0], buffer.GetSize ());
+  NS_TEST_EXPECT_MSG_EQ (copied, buffer.GetSize (), "CopyData copied a wrong size");
+  bytes.resize (buffer.GetSize ());
+  return bytes;
+}
+
+void
+BufferPayloadTest::DoRun (void)
+{
+  uint8_t payload[100];
+  std::vector<uint8_t> expected;
+  for (uint32_t j = 0; j < 100; j++)
+    {
+      payload[j] = j;
+    }
+
+  // a header and a trailer around the payload
+  Buffer buffer (payload, 100);
+  buffer.AddAtStart (4);
+  buffer.Begin ().WriteHtonU32 (0xa1a2a3a4);
+  buffer.AddAtEnd (2);
+  Buffer::Iterator i = buffer.End ();
+  i.Prev (2);
+  i.WriteHtonU16 (0xb1b2);
+  expected.push_back (0xa1);
+  expected.push_back (0xa2);
+  expected.push_back (0xa3);
+  expected.push_back (0xa4);
+  expected.insert (expected.end (), payload, payload + 100);
+  expected.push_back (0xb1);
+  expected.push_back (0xb2);
+  NS_TEST_EXPECT_MSG_EQ ((GetBytes (buffer) == expected), true, "Wrong content");
+
+  i = buffer.Begin ();
+  NS_TEST_EXPECT_MSG_EQ (i.ReadNtohU32 (), 0xa1a2a3a4, "Wrong header");
+  NS_TEST_EXPECT_MSG_EQ (i.ReadNtohU16 (), 0x0001, "Wrong payload read");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)i.ReadU8 (), 2, "Wrong payload read");
+  uint8_t read[97];
+  i.Read (read, 97);
+  NS_TEST_EXPECT_MSG_EQ (memcmp (read, payload + 3, 97), 0, "Wrong payload read");
+  NS_TEST_EXPECT_MSG_EQ (i.ReadNtohU16 (), 0xb1b2, "Wrong trailer");
+
+  // fragments share the payload, and can be joined back
+  Buffer frag0 = buffer.CreateFragment (0, 40);
+  Buffer frag1 = buffer.CreateFragment (40, 66);
+  frag1.AddAtStart (1);
+  frag1.Begin ().WriteU8 (0xcc);
+  NS_TEST_EXPECT_MSG_EQ ((GetBytes (buffer) == expected), true, "Fragment modified the original");
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t)GetBytes (frag1)[1], 36, "Wrong fragment content");
+  frag1.RemoveAtStart (1);
+  frag0.AddAtEnd (frag1);
+  NS_TEST_EXPECT_MSG_EQ ((GetBytes (frag0) == expected), true, "Wrong joined fragments");
+
+  // join the payloads of different buffers, and zero bytes
+  Buffer other (payload + 50, 50);
+  Buffer zeroes (10);
+  Buffer joined = buffer.CreateFragment (4, 100);
+  joined.AddAtEnd (zeroes);
+  joined.AddAtEnd (other);
+  std::vector<uint8_t> joinedBytes (payload, payload + 100);
+  joinedBytes.insert (joinedBytes.end (), 10, 0);
+  joinedBytes.insert (joinedBytes.end (), payload + 50, payload + 100);
+  NS_TEST_EXPECT_MSG_EQ ((GetBytes (joined) == joinedBytes), true, "Wrong joined buffers");
+  i = joined.Begin ();
+  i.Next (98);
+  NS_TEST_EXPECT_MSG_EQ (i.ReadNtohU32 (), 0x62630000, "Wrong read across payloads");
+  i.Next (8);
+  NS_TEST_EXPECT_MSG_EQ (i.ReadNtohU16 (), 0x3233, "Wrong read across payloads");
+  Buffer part = joined.CreateFragment (95, 20);
+  NS_TEST_EXPECT_MSG_EQ ((GetBytes (part) == std::vector<uint8_t> (joinedBytes.begin () + 95,
+                                                                   joinedBytes.begin () + 115)),
+                         true, "Wrong fragment of joined buffers");
+
+  // copies to real bytes
+  Buffer copy;
+  copy.AddAtStart (joined.GetSize ());
+  copy.Begin ().Write (joined.Begin (), joined.End ());
+  NS_TEST_EXPECT_MSG_EQ ((GetBytes (copy) == joinedBytes), true, "Wrong iterator copy");
+  NS_TEST_EXPECT_MSG_EQ (memcmp (joined.PeekData (), &joinedBytes[0], joinedBytes.size ()), 0,
+                         "Wrong PeekData");
+
+  std::vector<uint8_t> serialized (buffer.GetSerializedSize ());
+  NS_TEST_EXPECT_MSG_EQ (buffer.Serialize (&serialized[0], serialized.size ()), 1, "Serialization failed");
+  Buffer deserialized (0, false);
+  // the size given to Deserialize includes the 4 bytes of the size field of Packet::Serialize
+  deserialized.Deserialize (&serialized[0], serialized.size () + 4);
+  NS_TEST_EXPECT_MSG_EQ ((GetBytes (deserialized) == expected), true, "Wrong deserialized content");
+
+  // the data after the zero area is read at its right place
+  Buffer trailer (5);
+  trailer.AddAtEnd (2);
+  i = trailer.End ();
+  i.Prev (2);
+  i.WriteHtonU16 (0x1234);
+  i = trailer.End ();
+  i.Prev (2);
+  NS_TEST_EXPECT_MSG_EQ (i.ReadNtohU16 (), 0x1234, "Wrong read after the zero area");
+}
+//-----------------------------------------------------------------------------
 class BufferTestSuite : public TestSuite
 {
 public:
@@ -333,6 +455,7 @@ BufferTestSuite::BufferTestSuite ()
   : TestSuite ("buffer", UNIT)
 {
   AddTestCase (new BufferTest, TestCase::QUICK);
+  AddTestCase (new BufferPayloadTest, TestCase::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite;
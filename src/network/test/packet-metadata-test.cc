@@ -821,6 +821,32 @@ PacketMetadataTest::DoRun (void)
                                  p3->GetSize ());
   delete [] buf;
   NS_TEST_EXPECT_MSG_EQ (msg, std::string ("hello world"), "Could not find original data in received packet");
+
+  // items added on both sides of the payload, past the number of items
+  // stored inline.
+  p = Create<Packet> (10);
+  ADD_TRAILER (p, 3);
+  ADD_TRAILER (p, 4);
+  ADD_HEADER (p, 1);
+  ADD_HEADER (p, 2);
+  ADD_HEADER (p, 5);
+  ADD_HEADER (p, 6);
+  ADD_HEADER (p, 7);
+  CHECK_HISTORY (p, 8, 7, 6, 5, 2, 1, 10, 3, 4);
+  p1 = p->Copy ();
+  ADD_HEADER (p1, 8);
+  ADD_TRAILER (p1, 9);
+  CHECK_HISTORY (p1, 10, 8, 7, 6, 5, 2, 1, 10, 3, 4, 9);
+  REM_HEADER (p1, 8);
+  REM_HEADER (p1, 7);
+  REM_TRAILER (p1, 9);
+  CHECK_HISTORY (p1, 7, 6, 5, 2, 1, 10, 3, 4);
+  CHECK_HISTORY (p, 8, 7, 6, 5, 2, 1, 10, 3, 4);
+  REM_HEADER (p, 7);
+  REM_TRAILER (p, 4);
+  p2 = p->CreateFragment (3, p->GetSize () - 6);
+  CHECK_HISTORY (p2, 5, 3, 5, 2, 1, 10);
+  CHECK_HISTORY (p, 7, 6, 5, 2, 1, 10, 3);
 }
 //-----------------------------------------------------------------------------
 class PacketMetadataTestSuite : public TestSuite
@@ -21,10 +21,20 @@
 #include <cstdlib>
 #include <sstream>
 #include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <algorithm>
 
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/pcap-file-wrapper.h"
+#include "ns3/packet.h"
+#include "ns3/object-factory.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
 
 using namespace ns3;
 
@@ -1120,6 +1130,197 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+// ===========================================================================
+// Test case to make sure that an asynchronous PcapFileWrapper writes the
+// same file as a synchronous one, whatever the size of its buffers.
+// ===========================================================================
+static std::vector<uint8_t>
+ReadFileBytes (std::string filename)
+{
+  std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary);
+  return std::vector<uint8_t> ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char> ());
+}
+
+static void
+WritePackets (Ptr<PcapFileWrapper> file, uint32_t n, uint32_t offset)
+{
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      uint8_t data[300];
+      uint32_t size = (i * 37 + offset) % sizeof (data);
+      for (uint32_t j = 0; j < size; ++j)
+        {
+          data[j] = i + j;
+        }
+      Time t = MicroSeconds (1000 * i + offset);
+      if (i % 2)
+        {
+          file->Write (t, Create<Packet> (data, size));
+        }
+      else
+        {
+          file->Write (t, data, size);
+        }
+    }
+}
+
+class AsyncWriteTestCase : public TestCase
+{
+public:
+  AsyncWriteTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+AsyncWriteTestCase::AsyncWriteTestCase ()
+  : TestCase ("Check that asynchronous pcap files hold the same records as synchronous ones")
+{
+}
+
+void
+AsyncWriteTestCase::DoRun (void)
+{
+  std::string expected = CreateTempDirFilename ("pcap-sync.pcap");
+  Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  file->Open (expected, std::ios::out);
+  file->Init (1, 200);
+  WritePackets (file, 100, 0);
+  file->Close ();
+
+  uint32_t sizes[] = { 1, 1000, 1 << 20 };
+  for (uint32_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); ++i)
+    {
+      std::string filename = CreateTempDirFilename ("pcap-async.pcap");
+      file = CreateObjectWithAttributes<PcapFileWrapper> ("Asynchronous", BooleanValue (true),
+                                                          "BufferSize", UintegerValue (sizes[i]));
+      file->Open (filename, std::ios::out);
+      file->Init (1, 200);
+      WritePackets (file, 100, 0);
+      file->Close ();
+      NS_TEST_EXPECT_MSG_EQ ((ReadFileBytes (filename) == ReadFileBytes (expected)), true,
+                             "Asynchronous file differs with buffers of " << sizes[i] << " bytes");
+      remove (filename.c_str ());
+    }
+
+  // a file dropped without Close is written by its destructor, and the
+  // simulator does not keep it until it is destroyed
+  std::string filename = CreateTempDirFilename ("pcap-async.pcap");
+  file = CreateObjectWithAttributes<PcapFileWrapper> ("Asynchronous", BooleanValue (true),
+                                                      "BufferSize", UintegerValue (1000));
+  file->Open (filename, std::ios::out);
+  file->Init (1, 200);
+  WritePackets (file, 100, 0);
+  NS_TEST_EXPECT_MSG_EQ (file->Fail (), false, "Asynchronous file failed");
+  file = 0;
+  NS_TEST_EXPECT_MSG_EQ ((ReadFileBytes (filename) == ReadFileBytes (expected)), true,
+                         "Asynchronous file not written when dropped");
+  Simulator::Destroy ();
+  remove (filename.c_str ());
+  remove (expected.c_str ());
+}
+
+// ===========================================================================
+// Test case to make sure that the interfaces of a pcapng file are described
+// and that their packets are recorded in order.
+// ===========================================================================
+class PcapNgTestCase : public TestCase
+{
+public:
+  PcapNgTestCase ();
+private:
+  virtual void DoRun (void);
+  uint32_t GetU32 (uint32_t offset) const;
+  std::vector<uint8_t> m_bytes;
+};
+
+PcapNgTestCase::PcapNgTestCase ()
+  : TestCase ("Check the blocks of a pcapng file with two interfaces")
+{
+}
+
+uint32_t
+PcapNgTestCase::GetU32 (uint32_t offset) const
+{
+  uint32_t value;
+  std::memcpy (&value, &m_bytes[offset], sizeof (value));
+  return value;
+}
+
+void
+PcapNgTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("pcap-ng.pcapng");
+  Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  file->Open (filename, std::ios::out);
+  file->InitNg ();
+  Ptr<PcapFileWrapper> a = file->AddInterface ("a", 1, 100);
+  Ptr<PcapFileWrapper> b = file->AddInterface ("interface-b", 105);
+  NS_TEST_EXPECT_MSG_EQ (a->GetDataLinkType (), 1, "Wrong data link type of interface a");
+  NS_TEST_EXPECT_MSG_EQ (b->GetDataLinkType (), 105, "Wrong data link type of interface b");
+  NS_TEST_EXPECT_MSG_EQ (b->GetSnapLen (), PcapFile::SNAPLEN_DEFAULT, "Wrong snap length of interface b");
+  WritePackets (a, 10, 0);
+  WritePackets (b, 10, 500);
+  file->Close ();
+  a = 0;
+  b = 0;
+  m_bytes = ReadFileBytes (filename);
+
+  NS_TEST_ASSERT_MSG_EQ ((m_bytes.size () >= 28), true, "File too short");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (0), 0x0a0d0d0a, "No section header block");
+  NS_TEST_EXPECT_MSG_EQ (GetU32 (8), 0x1a2b3c4d, "Wrong byte order magic");
+  uint32_t offset = 0;
+  uint32_t nInterfaces = 0;
+  uint32_t nPackets[2] = { 0, 0 };
+  while (offset + 12 <= m_bytes.size ())
+    {
+      uint32_t type = GetU32 (offset);
+      uint32_t length = GetU32 (offset + 4);
+      NS_TEST_ASSERT_MSG_EQ ((length % 4 == 0 && offset + length <= m_bytes.size ()), true,
+                             "Wrong block length at " << offset);
+      NS_TEST_ASSERT_MSG_EQ (GetU32 (offset + length - 4), length, "Wrong trailing block length at " << offset);
+      if (type == 1)
+        {
+          // the fixed fields, the padded if_name option and opt_endofopt
+          uint32_t nameLen = nInterfaces == 0 ? 4 : 12;
+          NS_TEST_EXPECT_MSG_EQ (length, 16 + 4 + nameLen + 4 + 4, "Wrong interface block length at " << offset);
+          nInterfaces++;
+        }
+      else if (type == 6)
+        {
+          uint32_t interfaceId = GetU32 (offset + 8);
+          NS_TEST_ASSERT_MSG_LT (interfaceId, 2, "Wrong interface id at " << offset);
+          uint32_t i = nPackets[interfaceId]++;
+          uint32_t origLen = (i * 37 + interfaceId * 500) % 300;
+          uint64_t ts = ((uint64_t)GetU32 (offset + 12) << 32) | GetU32 (offset + 16);
+          NS_TEST_EXPECT_MSG_EQ (ts, 1000 * i + interfaceId * 500, "Wrong timestamp at " << offset);
+          NS_TEST_EXPECT_MSG_EQ (GetU32 (offset + 24), origLen, "Wrong original length at " << offset);
+          NS_TEST_EXPECT_MSG_EQ (GetU32 (offset + 20), std::min (origLen, interfaceId == 0 ? 100U : 65535U),
+                                 "Wrong captured length at " << offset);
+          NS_TEST_EXPECT_MSG_EQ ((GetU32 (offset + 20) == 0 || m_bytes[offset + 28] == (uint8_t)i), true,
+                                 "Wrong packet data at " << offset);
+        }
+      offset += length;
+    }
+  NS_TEST_EXPECT_MSG_EQ (offset, m_bytes.size (), "Trailing bytes in the file");
+  NS_TEST_EXPECT_MSG_EQ (nInterfaces, 2, "Wrong number of interfaces");
+  NS_TEST_EXPECT_MSG_EQ (nPackets[0], 10, "Wrong number of packets of interface a");
+  NS_TEST_EXPECT_MSG_EQ (nPackets[1], 10, "Wrong number of packets of interface b");
+
+  std::string async = CreateTempDirFilename ("pcap-ng-async.pcapng");
+  file = CreateObjectWithAttributes<PcapFileWrapper> ("Asynchronous", BooleanValue (true),
+                                                      "BufferSize", UintegerValue (1000));
+  file->Open (async, std::ios::out);
+  file->InitNg ();
+  a = file->AddInterface ("a", 1, 100);
+  b = file->AddInterface ("interface-b", 105);
+  WritePackets (a, 10, 0);
+  WritePackets (b, 10, 500);
+  file->Close ();
+  NS_TEST_EXPECT_MSG_EQ ((ReadFileBytes (async) == m_bytes), true, "Asynchronous pcapng file differs");
+  remove (filename.c_str ());
+  remove (async.c_str ());
+}
+
 class PcapFileTestSuite : public TestSuite
 {
 public:
@@ -1140,3 +1341,19 @@ PcapFileTestSuite::PcapFileTestSuite ()
 }
 
 static PcapFileTestSuite pcapFileTestSuite;
+
+// The PcapFileWrapper cases do not need the known.pcap data file.
+class PcapFileWrapperTestSuite : public TestSuite
+{
+public:
+  PcapFileWrapperTestSuite ();
+};
+
+PcapFileWrapperTestSuite::PcapFileWrapperTestSuite ()
+  : TestSuite ("pcap-file-wrapper", UNIT)
+{
+  AddTestCase (new AsyncWriteTestCase, TestCase::QUICK);
+  AddTestCase (new PcapNgTestCase, TestCase::QUICK);
+}
+
+static PcapFileWrapperTestSuite pcapFileWrapperTestSuite;
@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/packet.h"
+#include "ns3/packet-tag-list.h"
+#include "ns3/byte-tag-list.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/test.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+namespace {
+
+/**
+ * A tag of N bytes, like the bearer, PHY, QoS and SNR tags which the
+ * LTE and wifi devices add to the packets they forward.
+ */
+template <int N>
+class PoolTestTag : public Tag
+{
+public:
+  static TypeId GetTypeId (void) {
+    std::ostringstream oss;
+    oss << "anon::PoolTestTag<" << N << ">";
+    static TypeId tid = TypeId (oss.str ().c_str ())
+      .SetParent<Tag> ()
+      .AddConstructor<PoolTestTag<N> > ()
+      .HideFromDocumentation ()
+    ;
+    return tid;
+  }
+  virtual TypeId GetInstanceTypeId (void) const {
+    return GetTypeId ();
+  }
+  virtual uint32_t GetSerializedSize (void) const {
+    return N;
+  }
+  virtual void Serialize (TagBuffer buf) const {
+    for (uint32_t i = 0; i < N; ++i)
+      {
+        buf.WriteU8 (m_data);
+      }
+  }
+  virtual void Deserialize (TagBuffer buf) {
+    for (uint32_t i = 0; i < N; ++i)
+      {
+        m_data = buf.ReadU8 ();
+      }
+  }
+  virtual void Print (std::ostream &os) const {
+    os << N << "(" << (uint32_t)m_data << ")";
+  }
+  PoolTestTag (uint8_t data = 0)
+    : m_data (data) {}
+  uint8_t m_data;
+};
+
+} // anonymous namespace
+
+/**
+ * Forward packets over a few hops, each of which copies the packet,
+ * removes the packet tags of the previous hop and adds its own packet
+ * and byte tags, and count the tag memory allocations per packet.
+ */
+class TagPoolTestCase : public TestCase
+{
+public:
+  TagPoolTestCase ();
+private:
+  virtual void DoRun (void);
+  void Forward (uint32_t nPackets);
+};
+
+TagPoolTestCase::TagPoolTestCase ()
+  : TestCase ("Check that forwarding tagged packets reuses the tag memory")
+{
+}
+
+void
+TagPoolTestCase::Forward (uint32_t nPackets)
+{
+  const uint32_t nHops = 3;
+  // a window of packets in flight, so that the tags are not freed
+  // right after they are allocated.
+  std::vector<Ptr<Packet> > window (64);
+  for (uint32_t i = 0; i < nPackets; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (1000);
+      p->AddPacketTag (PoolTestTag<8> (i));
+      p->AddByteTag (PoolTestTag<4> (i));
+      for (uint32_t hop = 0; hop < nHops; hop++)
+        {
+          Ptr<Packet> copy = p->Copy ();
+          PoolTestTag<2> phyTag (hop);
+          copy->RemovePacketTag (phyTag);
+          copy->AddPacketTag (PoolTestTag<2> (hop));
+          PoolTestTag<8> bearerTag (hop);
+          copy->ReplacePacketTag (bearerTag);
+          copy->AddPacketTag (PoolTestTag<16> (hop));
+          PoolTestTag<16> macTag;
+          copy->RemovePacketTag (macTag);
+          copy->AddByteTag (PoolTestTag<12> (hop));
+          p = copy;
+        }
+      window[i % window.size ()] = p;
+    }
+}
+
+void
+TagPoolTestCase::DoRun (void)
+{
+  // fill the free lists
+  Forward (1000);
+
+  const uint32_t nPackets = 100000;
+  uint64_t packetHits = PacketTagList::GetPoolHits ();
+  uint64_t packetMisses = PacketTagList::GetPoolMisses ();
+  uint64_t byteHits = ByteTagList::GetPoolHits ();
+  uint64_t byteMisses = ByteTagList::GetPoolMisses ();
+  SystemWallClockMs clock;
+  clock.Start ();
+  Forward (nPackets);
+  int64_t ms = clock.End ();
+  packetHits = PacketTagList::GetPoolHits () - packetHits;
+  packetMisses = PacketTagList::GetPoolMisses () - packetMisses;
+  byteHits = ByteTagList::GetPoolHits () - byteHits;
+  byteMisses = ByteTagList::GetPoolMisses () - byteMisses;
+
+  std::cout << GetName () << ": " << nPackets << " packets in " << ms << " ms" << std::endl
+            << std::fixed << std::setprecision (3)
+            << "  packet tags: " << double (packetHits + packetMisses) / nPackets
+            << " allocations per packet, " << double (packetMisses) / nPackets
+            << " not from the pool" << std::endl
+            << "  byte tags:   " << double (byteHits + byteMisses) / nPackets
+            << " allocations per packet, " << double (byteMisses) / nPackets
+            << " not from the pool" << std::endl;
+
+  NS_TEST_EXPECT_MSG_GT (packetHits, 0U, "No packet tag was recycled");
+  NS_TEST_EXPECT_MSG_GT (byteHits, 0U, "No byte tag buffer was recycled");
+  NS_TEST_EXPECT_MSG_EQ (packetMisses, 0U, "Packet tags were allocated in the steady state");
+  NS_TEST_EXPECT_MSG_EQ (byteMisses, 0U, "Byte tag buffers were allocated in the steady state");
+}
+
+class TagPoolTestSuite : public TestSuite
+{
+public:
+  TagPoolTestSuite ();
+};
+
+TagPoolTestSuite::TagPoolTestSuite ()
+  : TestSuite ("tag-pool", PERFORMANCE)
+{
+  AddTestCase (new TagPoolTestCase, TestCase::QUICK);
+}
+
+static TagPoolTestSuite g_tagPoolTestSuite;
@@ -16,16 +16,228 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
 #include "ns3/log.h"
+#include "ns3/abort.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
 #include "ns3/buffer.h"
 #include "ns3/header.h"
+#include "ns3/core-config.h"
 #include "pcap-file-wrapper.h"
 
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
 NS_LOG_COMPONENT_DEFINE ("PcapFileWrapper");
 
 namespace ns3 {
 
+namespace {
+
+const uint32_t NG_SECTION_HEADER_BLOCK = 0x0a0d0d0a;   /**< pcapng Section Header Block type */
+const uint32_t NG_BYTE_ORDER_MAGIC = 0x1a2b3c4d;       /**< pcapng byte order magic, in native order */
+const uint32_t NG_INTERFACE_BLOCK = 0x00000001;        /**< pcapng Interface Description Block type */
+const uint32_t NG_PACKET_BLOCK = 0x00000006;           /**< pcapng Enhanced Packet Block type */
+const uint16_t NG_OPTION_END = 0;                      /**< pcapng opt_endofopt option code */
+const uint16_t NG_OPTION_IF_NAME = 2;                  /**< pcapng if_name option code */
+const uint32_t NG_PACKET_BLOCK_SIZE = 32;              /**< size of an Enhanced Packet Block without data */
+
+/**
+ * The pcapng blocks are written in the native byte order, which the
+ * readers detect from the byte order magic of the section header.
+ */
+inline void
+PutU16 (uint8_t *buffer, uint16_t value)
+{
+  std::memcpy (buffer, &value, sizeof (value));
+}
+
+inline void
+PutU32 (uint8_t *buffer, uint32_t value)
+{
+  std::memcpy (buffer, &value, sizeof (value));
+}
+
+/**
+ * Copy the first inclLen octets of the data of a record into buffer: the
+ * data buffer if any, else the header, if any, followed by the packet.
+ */
+void
+CopyRecordData (uint8_t *buffer, uint32_t inclLen, Header *header,
+                Ptr<const Packet> p, uint8_t const *data)
+{
+  if (data != 0)
+    {
+      std::memcpy (buffer, data, inclLen);
+      return;
+    }
+  if (header != 0)
+    {
+      uint32_t headerSize = header->GetSerializedSize ();
+      Buffer headerBuffer;
+      headerBuffer.AddAtStart (headerSize);
+      header->Serialize (headerBuffer.Begin ());
+      uint32_t toCopy = std::min (headerSize, inclLen);
+      headerBuffer.CopyData (buffer, toCopy);
+      buffer += toCopy;
+      inclLen -= toCopy;
+    }
+  p->CopyData (buffer, inclLen);
+}
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * The thread which writes the records of the asynchronous files, in the
+ * order in which they were submitted.  It runs while at least one
+ * asynchronous file is open, and at most MAX_JOBS buffers wait to be
+ * written: Submit blocks when the disk cannot keep up.
+ */
+class PcapWriterThread
+{
+public:
+  static PcapWriterThread *Get (void)
+  {
+    // never deleted, so that files closed during the static destruction
+    // can still use it.
+    static PcapWriterThread *writer = new PcapWriterThread ();
+    return writer;
+  }
+  void Acquire (void)
+  {
+    pthread_mutex_lock (&m_mutex);
+    if (m_users++ == 0)
+      {
+        m_stop = false;
+        int error = pthread_create (&m_thread, 0, &PcapWriterThread::Run, this);
+        NS_ABORT_MSG_IF (error != 0, "Unable to start the pcap writer thread: " << std::strerror (error));
+      }
+    pthread_mutex_unlock (&m_mutex);
+  }
+  void Release (void)
+  {
+    pthread_mutex_lock (&m_mutex);
+    NS_ASSERT (m_users > 0);
+    bool stop = --m_users == 0;
+    if (stop)
+      {
+        m_stop = true;
+        pthread_cond_broadcast (&m_cond);
+      }
+    pthread_mutex_unlock (&m_mutex);
+    if (stop)
+      {
+        pthread_join (m_thread, 0);
+      }
+  }
+  /**
+   * Queue the records to be written to file, leaving records empty.
+   */
+  void Submit (PcapFile *file, std::vector<uint8_t> &records)
+  {
+    Job job;
+    job.file = file;
+    job.records = new std::vector<uint8_t> ();
+    job.records->swap (records);
+    pthread_mutex_lock (&m_mutex);
+    while (m_jobs.size () >= MAX_JOBS)
+      {
+        pthread_cond_wait (&m_cond, &m_mutex);
+      }
+    m_jobs.push_back (job);
+    pthread_cond_broadcast (&m_cond);
+    pthread_mutex_unlock (&m_mutex);
+  }
+  /**
+   * Take the queue lock, once file is not being written: its stream
+   * can then be used until Unlock.
+   */
+  void Lock (const PcapFile *file)
+  {
+    pthread_mutex_lock (&m_mutex);
+    while (m_busy == file)
+      {
+        pthread_cond_wait (&m_cond, &m_mutex);
+      }
+  }
+  void Unlock (void)
+  {
+    pthread_mutex_unlock (&m_mutex);
+  }
+  /**
+   * Wait until all the submitted records are written.
+   */
+  void Drain (void)
+  {
+    pthread_mutex_lock (&m_mutex);
+    while (!m_jobs.empty () || m_busy != 0)
+      {
+        pthread_cond_wait (&m_cond, &m_mutex);
+      }
+    pthread_mutex_unlock (&m_mutex);
+  }
+private:
+  static const uint32_t MAX_JOBS = 16;
+  struct Job
+  {
+    PcapFile *file;
+    std::vector<uint8_t> *records;
+  };
+  PcapWriterThread ()
+    : m_busy (0),
+      m_stop (false),
+      m_users (0)
+  {
+    pthread_mutex_init (&m_mutex, 0);
+    pthread_cond_init (&m_cond, 0);
+  }
+  static void *Run (void *arg)
+  {
+    static_cast<PcapWriterThread *> (arg)->DoRun ();
+    return 0;
+  }
+  void DoRun (void)
+  {
+    pthread_mutex_lock (&m_mutex);
+    while (true)
+      {
+        while (m_jobs.empty () && !m_stop)
+          {
+            pthread_cond_wait (&m_cond, &m_mutex);
+          }
+        if (m_jobs.empty ())
+          {
+            break;
+          }
+        Job job = m_jobs.front ();
+        m_jobs.pop_front ();
+        m_busy = job.file;
+        pthread_cond_broadcast (&m_cond);
+        pthread_mutex_unlock (&m_mutex);
+        job.file->WriteRecords (&(*job.records)[0], job.records->size ());
+        delete job.records;
+        pthread_mutex_lock (&m_mutex);
+        m_busy = 0;
+        pthread_cond_broadcast (&m_cond);
+      }
+    pthread_mutex_unlock (&m_mutex);
+  }
+  pthread_mutex_t m_mutex;
+  pthread_cond_t m_cond; //!< broadcast on every change of the state below
+  std::deque<Job> m_jobs;
+  const PcapFile *m_busy; //!< the file of the job being written, if any
+  bool m_stop;
+  uint32_t m_users;
+  pthread_t m_thread;
+};
+#endif /* HAVE_PTHREAD_H */
+
+} // anonymous namespace
+
 NS_OBJECT_ENSURE_REGISTERED (PcapFileWrapper)
   ;
 
@@ -40,12 +252,29 @@ PcapFileWrapper::GetTypeId (void)
                    UintegerValue (PcapFile::SNAPLEN_DEFAULT),
                    MakeUintegerAccessor (&PcapFileWrapper::m_snapLen),
                    MakeUintegerChecker<uint32_t> (0, PcapFile::SNAPLEN_DEFAULT))
+    .AddAttribute ("Asynchronous",
+                   "Buffer the records in memory and write them to the file from a background thread. "
+                   "Without thread support, the records are written as they come.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_async),
+                   MakeBooleanChecker ())
+    .AddAttribute ("BufferSize",
+                   "The size, in bytes, of the buffers of an asynchronous file",
+                   UintegerValue (1 << 20),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
   return tid;
 }
 
 
 PcapFileWrapper::PcapFileWrapper ()
+  : m_writing (false),
+    m_ng (false),
+    m_nInterfaces (0),
+    m_interfaceId (0),
+    m_interfaceSnapLen (0),
+    m_interfaceDataLinkType (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -61,18 +290,45 @@ bool
 PcapFileWrapper::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  if (m_writing)
+    {
+      PcapWriterThread::Get ()->Lock (&m_file);
+      bool fail = m_file.Fail ();
+      PcapWriterThread::Get ()->Unlock ();
+      return fail;
+    }
+#endif
   return m_file.Fail ();
 }
 bool 
 PcapFileWrapper::Eof (void) const
 {
   NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  if (m_writing)
+    {
+      PcapWriterThread::Get ()->Lock (&m_file);
+      bool eof = m_file.Eof ();
+      PcapWriterThread::Get ()->Unlock ();
+      return eof;
+    }
+#endif
   return m_file.Eof ();
 }
 void 
 PcapFileWrapper::Clear (void)
 {
   NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  if (m_writing)
+    {
+      PcapWriterThread::Get ()->Lock (&m_file);
+      m_file.Clear ();
+      PcapWriterThread::Get ()->Unlock ();
+      return;
+    }
+#endif
   m_file.Clear ();
 }
 
@@ -80,6 +336,19 @@ void
 PcapFileWrapper::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  Flush ();
+#ifdef HAVE_PTHREAD_H
+  if (m_writing)
+    {
+      PcapWriterThread::Get ()->Release ();
+      m_writing = false;
+      // the event does not hold a reference to this wrapper; it is
+      // cancelled directly, since the simulator may be destroyed already
+      m_destroyFlush.PeekEventImpl ()->Cancel ();
+      m_destroyFlush = EventId ();
+    }
+#endif
+  m_ngFile = 0;
   m_file.Close ();
 }
 
@@ -88,6 +357,94 @@ PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
   m_file.Open (filename, mode);
+#ifdef HAVE_PTHREAD_H
+  if (m_async && !m_writing && (mode & std::ios::out))
+    {
+      PcapWriterThread::Get ()->Acquire ();
+      m_writing = true;
+      m_destroyFlush = Simulator::ScheduleDestroy (&PcapFileWrapper::Flush, this);
+    }
+#endif
+}
+
+void
+PcapFileWrapper::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Flush ();
+      return;
+    }
+  Submit ();
+#ifdef HAVE_PTHREAD_H
+  if (m_writing)
+    {
+      PcapWriterThread::Get ()->Drain ();
+    }
+#endif
+}
+
+void
+PcapFileWrapper::Submit (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_buffer.empty ())
+    {
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  if (m_writing)
+    {
+      PcapWriterThread::Get ()->Submit (&m_file, m_buffer);
+      return;
+    }
+#endif
+  m_file.WriteRecords (&m_buffer[0], m_buffer.size ());
+  m_buffer.clear ();
+}
+
+void
+PcapFileWrapper::BufferRecord (uint32_t interfaceId, uint32_t snapLen, Time t,
+                               Header *header, Ptr<const Packet> p,
+                               uint8_t const *data, uint32_t totalLen)
+{
+  NS_LOG_FUNCTION (this << interfaceId << snapLen << t << header << p << &data << totalLen);
+  if (m_buffer.capacity () == 0 && m_writing)
+    {
+      m_buffer.reserve (m_bufferSize + NG_PACKET_BLOCK_SIZE + m_snapLen + 3);
+    }
+  uint32_t offset = m_buffer.size ();
+  uint64_t current = t.GetMicroSeconds ();
+  if (m_ng)
+    {
+      uint32_t inclLen = std::min (totalLen, snapLen);
+      uint32_t padded = (inclLen + 3) & ~3;
+      uint32_t blockLen = NG_PACKET_BLOCK_SIZE + padded;
+      m_buffer.resize (offset + blockLen);
+      uint8_t *block = &m_buffer[offset];
+      PutU32 (block, NG_PACKET_BLOCK);
+      PutU32 (block + 4, blockLen);
+      PutU32 (block + 8, interfaceId);
+      PutU32 (block + 12, current >> 32);
+      PutU32 (block + 16, current & 0xffffffff);
+      PutU32 (block + 20, inclLen);
+      PutU32 (block + 24, totalLen);
+      CopyRecordData (block + 28, inclLen, header, p, data);
+      std::memset (block + 28 + inclLen, 0, padded - inclLen);
+      PutU32 (block + 28 + padded, blockLen);
+    }
+  else
+    {
+      m_buffer.resize (offset + 16);
+      uint32_t inclLen = m_file.SerializePacketHeader (&m_buffer[offset], current / 1000000, current % 1000000, totalLen);
+      m_buffer.resize (offset + 16 + inclLen);
+      CopyRecordData (&m_buffer[offset + 16], inclLen, header, p, data);
+    }
+  if (!m_writing || m_buffer.size () >= m_bufferSize)
+    {
+      Submit ();
+    }
 }
 
 void
@@ -109,10 +466,74 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
     } 
 }
 
+void
+PcapFileWrapper::InitNg (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_ng = true;
+  m_nInterfaces = 0;
+  uint8_t block[28];
+  PutU32 (block, NG_SECTION_HEADER_BLOCK);
+  PutU32 (block + 4, sizeof (block));
+  PutU32 (block + 8, NG_BYTE_ORDER_MAGIC);
+  PutU16 (block + 12, 1);
+  PutU16 (block + 14, 0);
+  // the section length is not specified
+  PutU32 (block + 16, 0xffffffff);
+  PutU32 (block + 20, 0xffffffff);
+  PutU32 (block + 24, sizeof (block));
+  m_file.WriteRecords (block, sizeof (block));
+}
+
+Ptr<PcapFileWrapper>
+PcapFileWrapper::AddInterface (std::string name, uint32_t dataLinkType, uint32_t snapLen)
+{
+  NS_LOG_FUNCTION (this << name << dataLinkType << snapLen);
+  NS_ASSERT_MSG (m_ng, "PcapFileWrapper::AddInterface(): not a pcapng file");
+  Ptr<PcapFileWrapper> interface = CreateObject<PcapFileWrapper> ();
+  interface->m_ngFile = this;
+  interface->m_interfaceId = m_nInterfaces++;
+  interface->m_interfaceSnapLen = snapLen != std::numeric_limits<uint32_t>::max () ? snapLen : m_snapLen;
+  interface->m_interfaceDataLinkType = dataLinkType;
+
+  // an Interface Description Block, with the name of the interface
+  uint32_t nameLen = (name.size () + 3) & ~3;
+  uint32_t blockLen = 16 + 4 + nameLen + 4 + 4;
+  uint32_t offset = m_buffer.size ();
+  m_buffer.resize (offset + blockLen, 0);
+  uint8_t *block = &m_buffer[offset];
+  PutU32 (block, NG_INTERFACE_BLOCK);
+  PutU32 (block + 4, blockLen);
+  PutU16 (block + 8, dataLinkType);
+  PutU16 (block + 10, 0);
+  PutU32 (block + 12, interface->m_interfaceSnapLen);
+  PutU16 (block + 16, NG_OPTION_IF_NAME);
+  PutU16 (block + 18, name.size ());
+  std::memcpy (block + 20, name.data (), name.size ());
+  PutU16 (block + 20 + nameLen, NG_OPTION_END);
+  PutU16 (block + 22 + nameLen, 0);
+  PutU32 (block + blockLen - 4, blockLen);
+  if (!m_writing)
+    {
+      Submit ();
+    }
+  return interface;
+}
+
 void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->BufferRecord (m_interfaceId, m_interfaceSnapLen, t, 0, p, 0, p->GetSize ());
+      return;
+    }
+  if (m_writing)
+    {
+      BufferRecord (0, 0, t, 0, p, 0, p->GetSize ());
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -124,6 +545,17 @@ void
 PcapFileWrapper::Write (Time t, Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->BufferRecord (m_interfaceId, m_interfaceSnapLen, t, &header, p, 0,
+                              header.GetSerializedSize () + p->GetSize ());
+      return;
+    }
+  if (m_writing)
+    {
+      BufferRecord (0, 0, t, &header, p, 0, header.GetSerializedSize () + p->GetSize ());
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -135,6 +567,16 @@ void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->BufferRecord (m_interfaceId, m_interfaceSnapLen, t, 0, 0, buffer, length);
+      return;
+    }
+  if (m_writing)
+    {
+      BufferRecord (0, 0, t, 0, 0, buffer, length);
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -181,6 +623,10 @@ uint32_t
 PcapFileWrapper::GetSnapLen (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile != 0)
+    {
+      return m_interfaceSnapLen;
+    }
   return m_file.GetSnapLen ();
 }
 
@@ -188,6 +634,10 @@ uint32_t
 PcapFileWrapper::GetDataLinkType (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile != 0)
+    {
+      return m_interfaceDataLinkType;
+    }
   return m_file.GetDataLinkType ();
 }
 
@@ -22,10 +22,12 @@
 #include <cstring>
 #include <limits>
 #include <fstream>
+#include <vector>
 #include "ns3/ptr.h"
 #include "ns3/packet.h"
 #include "ns3/object.h"
 #include "ns3/nstime.h"
+#include "ns3/event-id.h"
 #include "pcap-file.h"
 
 namespace ns3 {
@@ -35,6 +37,16 @@ namespace ns3 {
  * ns-3 interface to the low-level public methods of PcapFile.  Users are
  * encouraged to use this object instead of class ns3::PcapFile in ns-3
  * public APIs.
+ *
+ * If the "Asynchronous" attribute is set, the records are serialized into
+ * memory buffers of "BufferSize" bytes which a background thread writes to
+ * the file, in order.  The buffers are written when the file is closed and
+ * when the simulator is destroyed, and Fail, Eof and Clear then apply to
+ * the records written so far.
+ *
+ * A wrapper can also hold a pcapng file, initialized by InitNg, in which
+ * the packets of several devices are recorded: each device is an
+ * interface of the file, added by AddInterface.
  */
 class PcapFileWrapper : public Object
 {
@@ -105,6 +117,37 @@ public:
              uint32_t snapLen = std::numeric_limits<uint32_t>::max (), 
              int32_t tzCorrection = PcapFile::ZONE_DEFAULT);
 
+  /**
+   * Initialize the pcapng file associated with this wrapper.  This file must
+   * have been previously opened with write permissions.  The packets of a
+   * pcapng file are written through the wrappers returned by AddInterface.
+   *
+   * \warning Calling this method on an existing file will result in the loss
+   * any existing data.
+   */
+  void InitNg (void);
+
+  /**
+   * \brief Add an interface to the pcapng file of this wrapper.
+   *
+   * \param name The name of the interface.
+   *
+   * \param dataLinkType The data link type of the packets of the interface.
+   *
+   * \param snapLen An optional maximum size for the packets of the interface.
+   * Defaults to the "CaptureSize" Attribute of this wrapper.
+   *
+   * \return a wrapper whose Write methods record packets of the new
+   * interface in this file.
+   */
+  Ptr<PcapFileWrapper> AddInterface (std::string name, uint32_t dataLinkType,
+                                     uint32_t snapLen = std::numeric_limits<uint32_t>::max ());
+
+  /**
+   * \brief Write the buffered records and wait until they are in the file.
+   */
+  void Flush (void);
+
   /**
    * \brief Write the next packet to file
    * 
@@ -195,8 +238,33 @@ public:
   uint32_t GetDataLinkType (void);
 
 private:
+  /**
+   * Serialize a record, in the pcap or the pcapng format, in m_buffer.
+   * The packet data is the data buffer if any, else the header, if any,
+   * followed by the packet.
+   */
+  void BufferRecord (uint32_t interfaceId, uint32_t snapLen, Time t,
+                     Header *header, Ptr<const Packet> p,
+                     uint8_t const *data, uint32_t totalLen);
+  /**
+   * Hand the buffered records to the background writer, or write them
+   * to the file if the file is not asynchronous.
+   */
+  void Submit (void);
+
   PcapFile m_file;
   uint32_t m_snapLen;
+  bool m_async;
+  uint32_t m_bufferSize;
+  bool m_writing;                //!< the background writer is in use by this file
+  EventId m_destroyFlush;        //!< flushes the buffers when the simulator is destroyed
+  std::vector<uint8_t> m_buffer; //!< the records not handed to the file yet
+  bool m_ng;                     //!< the file is a pcapng file
+  uint32_t m_nInterfaces;        //!< the number of interfaces of a pcapng file
+  Ptr<PcapFileWrapper> m_ngFile; //!< the pcapng file of an interface
+  uint32_t m_interfaceId;        //!< the interface id in m_ngFile
+  uint32_t m_interfaceSnapLen;
+  uint32_t m_interfaceDataLinkType;
 };
 
 } // namespace ns3
@@ -370,6 +370,41 @@ PcapFile::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t timeZoneCorrect
   WriteFileHeader ();
 }
 
+uint32_t
+PcapFile::SerializePacketHeader (uint8_t *buffer, uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
+{
+  NS_LOG_FUNCTION (this << &buffer << tsSec << tsUsec << totalLen);
+
+  uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
+
+  PcapRecordHeader header;
+  header.m_tsSec = tsSec;
+  header.m_tsUsec = tsUsec;
+  header.m_inclLen = inclLen;
+  header.m_origLen = totalLen;
+
+  if (m_swapMode)
+    {
+      Swap (&header, &header);
+    }
+
+  //
+  // Same layout as the header written by WritePacketHeader.
+  //
+  std::memcpy (buffer, &header.m_tsSec, sizeof(header.m_tsSec));
+  std::memcpy (buffer + 4, &header.m_tsUsec, sizeof(header.m_tsUsec));
+  std::memcpy (buffer + 8, &header.m_inclLen, sizeof(header.m_inclLen));
+  std::memcpy (buffer + 12, &header.m_origLen, sizeof(header.m_origLen));
+  return inclLen;
+}
+
+void
+PcapFile::WriteRecords (uint8_t const *records, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << &records << size);
+  m_file.write ((const char *)records, size);
+}
+
 uint32_t
 PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 {
@@ -149,6 +149,28 @@ public:
    */
   void Write (uint32_t tsSec, uint32_t tsUsec, Header &header, Ptr<const Packet> p);
 
+  /**
+   * \brief Serialize the header of the next packet in memory
+   *
+   * The header is serialized in the byte order of the file, so that the
+   * records built in memory can be written later by WriteRecords.
+   *
+   * \param buffer      [out] Buffer of at least 16 bytes
+   * \param tsSec       Packet timestamp, seconds 
+   * \param tsUsec      Packet timestamp, microseconds
+   * \param totalLen    Total packet length
+   * \return the number of octets of the packet to store after the header
+   */
+  uint32_t SerializePacketHeader (uint8_t *buffer, uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
+
+  /**
+   * \brief Write records serialized in memory to file
+   *
+   * \param records     Records, headers followed by packet data
+   * \param size        Size of the records, in bytes
+   */
+  void WriteRecords (uint8_t const *records, uint32_t size);
+
 
   /**
    * \brief Read next packet from file
@@ -22,6 +22,11 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/multithreaded-simulator-impl.h"
+#endif
 
 NS_LOG_COMPONENT_DEFINE ("PointToPointChannel");
 
@@ -77,6 +82,20 @@ PointToPointChannel::Attach (Ptr<PointToPointNetDevice> device)
       m_link[1].m_dst = m_link[0].m_src;
       m_link[0].m_state = IDLE;
       m_link[1].m_state = IDLE;
+#ifdef HAVE_PTHREAD_H
+      // only MultithreadedSimulatorImpl runs the two ends concurrently.
+      bool multithreaded = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ()) != 0;
+      for (uint32_t i = 0; i < N_DEVICES; ++i)
+        {
+          Ptr<Node> srcNode = m_link[i].m_src->GetNode ();
+          Ptr<Node> dstNode = m_link[i].m_dst->GetNode ();
+          if (multithreaded && srcNode != 0 && dstNode != 0)
+            {
+              m_link[i].m_dstNodeId = dstNode->GetId ();
+              m_link[i].m_remote = srcNode->GetSystemId () != dstNode->GetSystemId ();
+            }
+        }
+#endif
     }
 }
 
@@ -94,6 +113,21 @@ PointToPointChannel::TransmitStart (
 
   uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
+#ifdef HAVE_PTHREAD_H
+  if (m_link[wire].m_remote)
+    {
+      // The receiver runs concurrently in another partition: hand it a
+      // copy of the packet which shares nothing with p, and do not take
+      // any reference to its objects from this partition.
+      Simulator::ScheduleWithContext (m_link[wire].m_dstNodeId,
+                                      txTime + m_delay, &PointToPointNetDevice::Receive,
+                                      PeekPointer (m_link[wire].m_dst), p->DeepCopy ());
+      MultithreadedSimulatorImpl::ScheduleSerial (MakeEvent (&PointToPointChannel::TxRxPointToPoint,
+                                                             this, wire, Ptr<const Packet> (p), txTime));
+      return true;
+    }
+#endif
+
   Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
                                   txTime + m_delay, &PointToPointNetDevice::Receive,
                                   m_link[wire].m_dst, p);
@@ -103,6 +137,13 @@ PointToPointChannel::TransmitStart (
   return true;
 }
 
+void
+PointToPointChannel::TxRxPointToPoint (uint32_t wire, Ptr<const Packet> p, Time txTime)
+{
+  NS_LOG_FUNCTION (this << wire << p << txTime);
+  m_txrxPointToPoint (p, m_link[wire].m_src, m_link[wire].m_dst, txTime, txTime + m_delay);
+}
+
 uint32_t 
 PointToPointChannel::GetNDevices (void) const
 {
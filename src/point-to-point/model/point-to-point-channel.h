@@ -43,6 +43,14 @@ class Packet;
  * There are two "wires" in the channel.  The first device connected gets the
  * [0] wire to transmit on.  The second device gets the [1] wire.  There is a
  * state (IDLE, TRANSMITTING) associated with each wire.
+ *
+ * When MultithreadedSimulatorImpl runs the nodes of the two devices in
+ * different partitions, the receiver runs in another thread: the
+ * channel then delivers a deep copy of the packet (see
+ * Packet::DeepCopy) and fires the TxRxPointToPoint trace at the end of
+ * the synchronization window, when both partitions are stopped. Both
+ * devices must then be added to their node before they are attached to
+ * the channel.
  */
 class PointToPointChannel : public Channel 
 {
@@ -125,6 +133,14 @@ private:
   // Each point to point link has exactly two net devices
   static const int N_DEVICES = 2;
 
+  /*
+   * \brief Fire the TxRxPointToPoint trace for a packet sent on a wire
+   * \param wire the wire of the transmission
+   * \param p the packet sent
+   * \param txTime the transmission time of the packet
+   */
+  void TxRxPointToPoint (uint32_t wire, Ptr<const Packet> p, Time txTime);
+
   Time          m_delay;
   int32_t       m_nDevices;
 
@@ -155,10 +171,14 @@ private:
   class Link
   {
 public:
-    Link() : m_state (INITIALIZING), m_src (0), m_dst (0) {}
+    Link() : m_state (INITIALIZING), m_src (0), m_dst (0), m_dstNodeId (0), m_remote (false) {}
     WireState                  m_state;
     Ptr<PointToPointNetDevice> m_src;
     Ptr<PointToPointNetDevice> m_dst;
+    // the id of the node of m_dst, and whether it runs in another
+    // partition of MultithreadedSimulatorImpl than the node of m_src.
+    uint32_t                   m_dstNodeId;
+    bool                       m_remote;
   };
 
   Link    m_link[N_DEVICES];
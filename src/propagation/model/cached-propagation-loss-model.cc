@@ -0,0 +1,271 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "cached-propagation-loss-model.h"
+#include "ns3/mobility-model.h"
+#include "ns3/pointer.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+
+NS_LOG_COMPONENT_DEFINE ("CachedPropagationLossModel");
+
+namespace ns3 {
+
+namespace {
+
+const uint64_t EMPTY_KEY = ~(uint64_t)0;
+const uint64_t HASH_MULTIPLIER = 0x9e3779b97f4a7c15ULL;
+
+inline uint32_t
+HashKey (uint64_t key)
+{
+  return (key * HASH_MULTIPLIER) >> 32;
+}
+
+} // anonymous namespace
+
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel)
+  ;
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .AddConstructor<CachedPropagationLossModel> ()
+    .AddAttribute ("Model", "The deterministic loss model whose results are cached.",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedPropagationLossModel::SetModel,
+                                        &CachedPropagationLossModel::GetModel),
+                   MakePointerChecker<PropagationLossModel> ())
+  ;
+  return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+  : m_nPaths (0),
+    m_hits (0),
+    m_misses (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CachedPropagationLossModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+  m_model = 0;
+  PropagationLossModel::DoDispose ();
+}
+
+void
+CachedPropagationLossModel::SetModel (Ptr<PropagationLossModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  Flush ();
+  m_model = model;
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetModel (void) const
+{
+  return m_model;
+}
+
+uint64_t
+CachedPropagationLossModel::GetHits (void) const
+{
+  return m_hits;
+}
+
+uint64_t
+CachedPropagationLossModel::GetMisses (void) const
+{
+  return m_misses;
+}
+
+void
+CachedPropagationLossModel::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_nodes.size (); i++)
+    {
+      m_nodes[i].mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                                          MakeBoundCallback (&CachedPropagationLossModel::CourseChanged,
+                                                                             this, i));
+    }
+  m_nodes.clear ();
+  m_nodeSlots.clear ();
+  m_paths.clear ();
+  m_nPaths = 0;
+}
+
+uint32_t
+CachedPropagationLossModel::GetNodeIndex (Ptr<MobilityModel> mobility) const
+{
+  if (m_nodes.size () * 2 >= m_nodeSlots.size ())
+    {
+      GrowNodeSlots ();
+    }
+  uint32_t mask = m_nodeSlots.size () - 1;
+  uint32_t i = HashKey (reinterpret_cast<uintptr_t> (PeekPointer (mobility))) & mask;
+  while (m_nodeSlots[i].mobility != 0)
+    {
+      if (m_nodeSlots[i].mobility == PeekPointer (mobility))
+        {
+          return m_nodeSlots[i].index;
+        }
+      i = (i + 1) & mask;
+    }
+
+  Node node;
+  node.mobility = mobility;
+  node.version = 0;
+  Vector velocity = mobility->GetVelocity ();
+  node.moving = velocity.x != 0.0 || velocity.y != 0.0 || velocity.z != 0.0;
+  uint32_t index = m_nodes.size ();
+  m_nodes.push_back (node);
+  m_nodeSlots[i].mobility = PeekPointer (mobility);
+  m_nodeSlots[i].index = index;
+  mobility->TraceConnectWithoutContext ("CourseChange",
+                                        MakeBoundCallback (&CachedPropagationLossModel::CourseChanged,
+                                                           this, index));
+  return index;
+}
+
+void
+CachedPropagationLossModel::GrowNodeSlots (void) const
+{
+  NodeSlot empty;
+  empty.mobility = 0;
+  empty.index = 0;
+  m_nodeSlots.assign (m_nodeSlots.empty () ? 64 : m_nodeSlots.size () * 2, empty);
+  uint32_t mask = m_nodeSlots.size () - 1;
+  for (uint32_t index = 0; index < m_nodes.size (); index++)
+    {
+      MobilityModel *mobility = PeekPointer (m_nodes[index].mobility);
+      uint32_t i = HashKey (reinterpret_cast<uintptr_t> (mobility)) & mask;
+      while (m_nodeSlots[i].mobility != 0)
+        {
+          i = (i + 1) & mask;
+        }
+      m_nodeSlots[i].mobility = mobility;
+      m_nodeSlots[i].index = index;
+    }
+}
+
+CachedPropagationLossModel::Path *
+CachedPropagationLossModel::FindPath (uint64_t key) const
+{
+  uint32_t mask = m_paths.size () - 1;
+  uint32_t i = HashKey (key) & mask;
+  while (m_paths[i].key != key && m_paths[i].key != EMPTY_KEY)
+    {
+      i = (i + 1) & mask;
+    }
+  return &m_paths[i];
+}
+
+void
+CachedPropagationLossModel::GrowPaths (void) const
+{
+  std::vector<Path> old;
+  old.swap (m_paths);
+  Path empty;
+  empty.key = EMPTY_KEY;
+  m_paths.assign (old.empty () ? 1024 : old.size () * 2, empty);
+  for (std::vector<Path>::const_iterator i = old.begin (); i != old.end (); ++i)
+    {
+      if (i->key != EMPTY_KEY)
+        {
+          *FindPath (i->key) = *i;
+        }
+    }
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+  NS_ASSERT_MSG (m_model != 0, "CachedPropagationLossModel needs a model to cache");
+  uint32_t indexA = GetNodeIndex (a);
+  uint32_t indexB = GetNodeIndex (b);
+  const Node &nodeA = m_nodes[indexA];
+  const Node &nodeB = m_nodes[indexB];
+  if (nodeA.moving || nodeB.moving)
+    {
+      m_misses++;
+      return m_model->CalcRxPower (txPowerDbm, a, b);
+    }
+
+  if ((m_nPaths + 1) * 2 > m_paths.size ())
+    {
+      GrowPaths ();
+    }
+  uint64_t key = ((uint64_t)indexA << 32) | indexB;
+  Path *path = FindPath (key);
+  if (path->key == key
+      && path->versionA == nodeA.version
+      && path->versionB == nodeB.version
+      && path->txPowerDbm == txPowerDbm)
+    {
+      m_hits++;
+      return path->rxPowerDbm;
+    }
+
+  m_misses++;
+  if (path->key == EMPTY_KEY)
+    {
+      m_nPaths++;
+    }
+  path->key = key;
+  path->versionA = nodeA.version;
+  path->versionB = nodeB.version;
+  path->txPowerDbm = txPowerDbm;
+  path->rxPowerDbm = m_model->CalcRxPower (txPowerDbm, a, b);
+  NS_LOG_LOGIC (this << " cached path " << indexA << "->" << indexB << " rxPower=" << path->rxPowerDbm);
+  return path->rxPowerDbm;
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  if (m_model == 0)
+    {
+      return 0;
+    }
+  return m_model->AssignStreams (stream);
+}
+
+void
+CachedPropagationLossModel::CourseChanged (CachedPropagationLossModel const *model, uint32_t index,
+                                           Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (model << index << mobility);
+  Node &node = model->m_nodes[index];
+  node.version++;
+  Vector velocity = mobility->GetVelocity ();
+  node.moving = velocity.x != 0.0 || velocity.y != 0.0 || velocity.z != 0.0;
+}
+
+} // namespace ns3
@@ -23,6 +23,8 @@
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/cached-propagation-loss-model.h"
 #include "ns3/simulator.h"
 
 using namespace ns3;
@@ -436,6 +438,72 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class CachedPropagationLossModelTestCase : public TestCase
+{
+public:
+  CachedPropagationLossModelTestCase ();
+  virtual ~CachedPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase ()
+  : TestCase ("Test CachedPropagationLossModel")
+{
+}
+
+CachedPropagationLossModelTestCase::~CachedPropagationLossModelTestCase ()
+{
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0,0,0));
+  Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (100,0,0));
+  Ptr<ConstantVelocityMobilityModel> c = CreateObject<ConstantVelocityMobilityModel> ();
+  c->SetPosition (Vector (0,50,0));
+  c->SetVelocity (Vector (10,0,0));
+
+  Ptr<LogDistancePropagationLossModel> model = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<CachedPropagationLossModel> cache = CreateObject<CachedPropagationLossModel> ();
+  cache->SetModel (model);
+
+  // the test macros evaluate their arguments more than once, so the
+  // cache is queried outside of them
+  double tolerance = 1e-9;
+  double first = cache->CalcRxPower (10, a, b);
+  double cached = cache->CalcRxPower (10, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (first, model->CalcRxPower (10, a, b), tolerance, "Bad first value");
+  NS_TEST_EXPECT_MSG_EQ_TOL (cached, model->CalcRxPower (10, a, b), tolerance, "Bad cached value");
+  NS_TEST_EXPECT_MSG_EQ (cache->GetHits (), 1U, "The second call was not served from the cache");
+
+  // a different transmit power or the reverse path are different entries
+  double newPower = cache->CalcRxPower (20, a, b);
+  double reverse = cache->CalcRxPower (20, b, a);
+  NS_TEST_EXPECT_MSG_EQ_TOL (newPower, model->CalcRxPower (20, a, b), tolerance, "Bad value for new power");
+  NS_TEST_EXPECT_MSG_EQ_TOL (reverse, model->CalcRxPower (20, b, a), tolerance, "Bad value for reverse path");
+  NS_TEST_EXPECT_MSG_EQ (cache->GetMisses (), 3U, "Unexpected cache hit");
+
+  // a course change invalidates the paths of the node which moved
+  b->SetPosition (Vector (200,0,0));
+  double moved = cache->CalcRxPower (20, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (moved, model->CalcRxPower (20, a, b), tolerance, "Stale value after a move");
+  NS_TEST_EXPECT_MSG_EQ (cache->GetMisses (), 4U, "Stale value served after a move");
+
+  // paths with a moving node are never cached
+  cache->CalcRxPower (10, a, c);
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  double moving = cache->CalcRxPower (10, a, c);
+  NS_TEST_EXPECT_MSG_EQ_TOL (moving, model->CalcRxPower (10, a, c), tolerance, "Stale value for a moving node");
+  NS_TEST_EXPECT_MSG_EQ (cache->GetHits (), 1U, "Cached a path with a moving node");
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +518,7 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new CachedPropagationLossModelTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measure the cost of the SpectrumValue arithmetic done for every
+ * chunk of an LTE reception: the SINR of the received signal is
+ * computed from the sum of all the signals and the noise, and then
+ * accumulated over the duration of the chunk. The computation is done
+ * once with the binary operators, which allocate a temporary for every
+ * operation, and once with the in-place operators and AddScaled.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <ns3/core-module.h>
+#include <ns3/spectrum-value.h>
+
+using namespace ns3;
+
+static Ptr<SpectrumModel>
+CreateRbModel (uint32_t nRbs)
+{
+  // 180 kHz resource blocks, like LteSpectrumValueHelper does.
+  std::vector<double> centerFrequencies;
+  for (uint32_t i = 0; i < nRbs; i++)
+    {
+      centerFrequencies.push_back (2.12e9 + 180e3 * i);
+    }
+  return Create<SpectrumModel> (centerFrequencies);
+}
+
+static void
+Fill (SpectrumValue &v, Ptr<UniformRandomVariable> random, double min, double max)
+{
+  for (Values::iterator i = v.ValuesBegin (); i != v.ValuesEnd (); ++i)
+    {
+      *i = random->GetValue (min, max);
+    }
+}
+
+static double
+RunOperators (const SpectrumValue &all, const SpectrumValue &rx, const SpectrumValue &noise,
+              SpectrumValue &sum, uint32_t iterations)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < iterations; i++)
+    {
+      SpectrumValue interf = all - rx + noise;
+      SpectrumValue sinr = rx / interf;
+      sum += sinr * 1e-3;
+    }
+  return time.End ();
+}
+
+static double
+RunInPlace (const SpectrumValue &all, const SpectrumValue &rx, const SpectrumValue &noise,
+            SpectrumValue &sum, uint32_t iterations)
+{
+  SpectrumValue interf = all;
+  SpectrumValue sinr = rx;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < iterations; i++)
+    {
+      interf = all;
+      interf -= rx;
+      interf += noise;
+      sinr = rx;
+      sinr /= interf;
+      sum.AddScaled (sinr, 1e-3);
+    }
+  return time.End ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t iterations = 200000;
+
+  CommandLine cmd;
+  cmd.AddValue ("iterations", "number of SINR chunks computed for each model", iterations);
+  cmd.Parse (argc, argv);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  uint32_t rbs[] = { 6, 25, 50, 100 };
+
+  std::cout << std::setw (6) << "RBs"
+            << std::setw (16) << "operators (ns)"
+            << std::setw (16) << "in-place (ns)"
+            << std::setw (10) << "speedup" << std::endl;
+  for (uint32_t k = 0; k < sizeof (rbs) / sizeof (rbs[0]); k++)
+    {
+      Ptr<SpectrumModel> model = CreateRbModel (rbs[k]);
+      SpectrumValue all (model), rx (model), noise (model);
+      SpectrumValue sum1 (model), sum2 (model);
+      Fill (rx, random, 1e-13, 1e-12);
+      Fill (noise, random, 1e-15, 1e-14);
+      Fill (all, random, 1e-12, 1e-11);
+      all += rx;
+
+      double operators = RunOperators (all, rx, noise, sum1, iterations);
+      double inPlace = RunInPlace (all, rx, noise, sum2, iterations);
+      NS_ABORT_MSG_IF (Sum (sum1) != Sum (sum2), "results differ");
+
+      std::cout << std::setw (6) << rbs[k]
+                << std::setw (16) << operators * 1e6 / iterations
+                << std::setw (16) << inPlace * 1e6 / iterations
+                << std::setw (10) << (inPlace > 0 ? operators / inPlace : 0)
+                << std::endl;
+    }
+  return 0;
+}
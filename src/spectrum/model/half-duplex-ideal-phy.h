@@ -201,7 +201,7 @@ private:
   Ptr<SpectrumValue> m_txPsd;
   Ptr<const SpectrumValue> m_rxPsd;
   Ptr<Packet> m_txPacket;
-  Ptr<Packet> m_rxPacket;
+  Ptr<const Packet> m_rxPacket;
 
   DataRate m_rate;
 
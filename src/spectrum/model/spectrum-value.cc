@@ -23,11 +23,177 @@
 #include <ns3/math.h>
 #include <ns3/log.h>
 
+#if defined (__AVX__)
+#include <immintrin.h>
+#elif defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
 NS_LOG_COMPONENT_DEFINE ("SpectrumValue");
 
 
 namespace ns3 {
 
+namespace {
+
+/*
+ * Elementwise kernels used by the arithmetic operators. They process
+ * the values with AVX or SSE2 instructions when the compiler targets
+ * them (SSE2 is always available on x86_64) and fall back to a plain
+ * loop otherwise and for the last values. Elementwise IEEE operations
+ * give the same results whatever their width so the vectorized kernels
+ * are bit-exact with respect to the scalar ones.
+ */
+#if defined (__AVX__)
+#define SV_WIDTH 4
+typedef __m256d SvVector;
+#define SV_LOAD(p) _mm256_loadu_pd (p)
+#define SV_STORE(p, v) _mm256_storeu_pd (p, v)
+#define SV_SET1(s) _mm256_set1_pd (s)
+#define SV_ADD(a, b) _mm256_add_pd (a, b)
+#define SV_SUB(a, b) _mm256_sub_pd (a, b)
+#define SV_MUL(a, b) _mm256_mul_pd (a, b)
+#define SV_DIV(a, b) _mm256_div_pd (a, b)
+#elif defined (__SSE2__)
+#define SV_WIDTH 2
+typedef __m128d SvVector;
+#define SV_LOAD(p) _mm_loadu_pd (p)
+#define SV_STORE(p, v) _mm_storeu_pd (p, v)
+#define SV_SET1(s) _mm_set1_pd (s)
+#define SV_ADD(a, b) _mm_add_pd (a, b)
+#define SV_SUB(a, b) _mm_sub_pd (a, b)
+#define SV_MUL(a, b) _mm_mul_pd (a, b)
+#define SV_DIV(a, b) _mm_div_pd (a, b)
+#endif
+
+#ifdef SV_WIDTH
+#define SV_LOOP(i, n, op)                                       \
+  for (; i + SV_WIDTH <= n; i += SV_WIDTH)                      \
+    {                                                           \
+      op;                                                       \
+    }
+#else
+#define SV_LOOP(i, n, op)
+#endif
+
+enum KernelOp
+{
+  KERNEL_ADD,
+  KERNEL_SUB,
+  KERNEL_MUL,
+  KERNEL_DIV
+};
+
+// a[i] = a[i] op b[i]
+template <enum KernelOp OP>
+inline void
+KernelVector (double *a, const double *b, size_t n)
+{
+  size_t i = 0;
+  switch (OP)
+    {
+    case KERNEL_ADD:
+      SV_LOOP (i, n, SV_STORE (a + i, SV_ADD (SV_LOAD (a + i), SV_LOAD (b + i))));
+      for (; i < n; i++)
+        {
+          a[i] += b[i];
+        }
+      break;
+    case KERNEL_SUB:
+      SV_LOOP (i, n, SV_STORE (a + i, SV_SUB (SV_LOAD (a + i), SV_LOAD (b + i))));
+      for (; i < n; i++)
+        {
+          a[i] -= b[i];
+        }
+      break;
+    case KERNEL_MUL:
+      SV_LOOP (i, n, SV_STORE (a + i, SV_MUL (SV_LOAD (a + i), SV_LOAD (b + i))));
+      for (; i < n; i++)
+        {
+          a[i] *= b[i];
+        }
+      break;
+    case KERNEL_DIV:
+      SV_LOOP (i, n, SV_STORE (a + i, SV_DIV (SV_LOAD (a + i), SV_LOAD (b + i))));
+      for (; i < n; i++)
+        {
+          a[i] /= b[i];
+        }
+      break;
+    }
+}
+
+// a[i] = a[i] op s
+template <enum KernelOp OP>
+inline void
+KernelScalar (double *a, double s, size_t n)
+{
+  size_t i = 0;
+#ifdef SV_WIDTH
+  SvVector vs = SV_SET1 (s);
+#endif
+  switch (OP)
+    {
+    case KERNEL_ADD:
+      SV_LOOP (i, n, SV_STORE (a + i, SV_ADD (SV_LOAD (a + i), vs)));
+      for (; i < n; i++)
+        {
+          a[i] += s;
+        }
+      break;
+    case KERNEL_SUB:
+      SV_LOOP (i, n, SV_STORE (a + i, SV_SUB (SV_LOAD (a + i), vs)));
+      for (; i < n; i++)
+        {
+          a[i] -= s;
+        }
+      break;
+    case KERNEL_MUL:
+      SV_LOOP (i, n, SV_STORE (a + i, SV_MUL (SV_LOAD (a + i), vs)));
+      for (; i < n; i++)
+        {
+          a[i] *= s;
+        }
+      break;
+    case KERNEL_DIV:
+      SV_LOOP (i, n, SV_STORE (a + i, SV_DIV (SV_LOAD (a + i), vs)));
+      for (; i < n; i++)
+        {
+          a[i] /= s;
+        }
+      break;
+    }
+}
+
+// a[i] += b[i] * s
+inline void
+KernelAddScaled (double *a, const double *b, double s, size_t n)
+{
+  size_t i = 0;
+#ifdef SV_WIDTH
+  SvVector vs = SV_SET1 (s);
+#endif
+  SV_LOOP (i, n, SV_STORE (a + i, SV_ADD (SV_LOAD (a + i), SV_MUL (SV_LOAD (b + i), vs))));
+  for (; i < n; i++)
+    {
+      a[i] += b[i] * s;
+    }
+}
+
+// a[i] += b[i] * c[i]
+inline void
+KernelMultiplyAccumulate (double *a, const double *b, const double *c, size_t n)
+{
+  size_t i = 0;
+  SV_LOOP (i, n, SV_STORE (a + i, SV_ADD (SV_LOAD (a + i), SV_MUL (SV_LOAD (b + i), SV_LOAD (c + i)))));
+  for (; i < n; i++)
+    {
+      a[i] += b[i] * c[i];
+    }
+}
+
+} // anonymous namespace
+
 
 SpectrumValue::SpectrumValue ()
 {
@@ -102,17 +268,11 @@ SpectrumValue::ConstBandsEnd () const
 void
 SpectrumValue::Add (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  if (!m_values.empty ())
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 += *it2;
-      ++it1;
-      ++it2;
+      KernelVector<KERNEL_ADD> (&m_values[0], &x.m_values[0], m_values.size ());
     }
 }
 
@@ -120,12 +280,9 @@ SpectrumValue::Add (const SpectrumValue& x)
 void
 SpectrumValue::Add (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  if (!m_values.empty ())
     {
-      *it1 += s;
-      ++it1;
+      KernelScalar<KERNEL_ADD> (&m_values[0], s, m_values.size ());
     }
 }
 
@@ -134,17 +291,11 @@ SpectrumValue::Add (double s)
 void
 SpectrumValue::Subtract (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  if (!m_values.empty ())
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 -= *it2;
-      ++it1;
-      ++it2;
+      KernelVector<KERNEL_SUB> (&m_values[0], &x.m_values[0], m_values.size ());
     }
 }
 
@@ -160,17 +311,11 @@ SpectrumValue::Subtract (double s)
 void
 SpectrumValue::Multiply (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  if (!m_values.empty ())
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 *= *it2;
-      ++it1;
-      ++it2;
+      KernelVector<KERNEL_MUL> (&m_values[0], &x.m_values[0], m_values.size ());
     }
 }
 
@@ -178,12 +323,9 @@ SpectrumValue::Multiply (const SpectrumValue& x)
 void
 SpectrumValue::Multiply (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  if (!m_values.empty ())
     {
-      *it1 *= s;
-      ++it1;
+      KernelScalar<KERNEL_MUL> (&m_values[0], s, m_values.size ());
     }
 }
 
@@ -193,17 +335,11 @@ SpectrumValue::Multiply (double s)
 void
 SpectrumValue::Divide (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  if (!m_values.empty ())
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 /= *it2;
-      ++it1;
-      ++it2;
+      KernelVector<KERNEL_DIV> (&m_values[0], &x.m_values[0], m_values.size ());
     }
 }
 
@@ -212,12 +348,9 @@ void
 SpectrumValue::Divide (double s)
 {
   NS_LOG_FUNCTION (this << s);
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  if (!m_values.empty ())
     {
-      *it1 /= s;
-      ++it1;
+      KernelScalar<KERNEL_DIV> (&m_values[0], s, m_values.size ());
     }
 }
 
@@ -457,9 +590,8 @@ operator+ (double lhs, const SpectrumValue& rhs)
 SpectrumValue
 operator- (const SpectrumValue& lhs, const SpectrumValue& rhs)
 {
-  SpectrumValue res = rhs;
-  res.ChangeSign ();
-  res.Add (lhs);
+  SpectrumValue res = lhs;
+  res.Subtract (rhs);
   return res;
 }
 
@@ -651,6 +783,32 @@ SpectrumValue:: operator/= (double rhs)
 }
 
 
+SpectrumValue&
+SpectrumValue::AddScaled (const SpectrumValue& x, double s)
+{
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  if (!m_values.empty ())
+    {
+      KernelAddScaled (&m_values[0], &x.m_values[0], s, m_values.size ());
+    }
+  return *this;
+}
+
+SpectrumValue&
+SpectrumValue::MultiplyAccumulate (const SpectrumValue& x, const SpectrumValue& y)
+{
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_spectrumModel == y.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  NS_ASSERT (m_values.size () == y.m_values.size ());
+  if (!m_values.empty ())
+    {
+      KernelMultiplyAccumulate (&m_values[0], &x.m_values[0], &y.m_values[0], m_values.size ());
+    }
+  return *this;
+}
+
 SpectrumValue&
 SpectrumValue:: operator= (double rhs)
 {
@@ -401,6 +401,32 @@ public:
   SpectrumValue& operator= (double rhs);
 
 
+  /**
+   * Add the Right Hand Side multiplied by a scalar to *this, component
+   * by component. This is equivalent to *this += x * s but does not
+   * allocate a temporary SpectrumValue.
+   *
+   * @param x the values to add
+   * @param s the scalar by which x is multiplied
+   *
+   * @return a reference to *this
+   */
+  SpectrumValue& AddScaled (const SpectrumValue& x, double s);
+
+
+  /**
+   * Add the component by component product of x and y to *this. This is
+   * equivalent to *this += x * y but does not allocate a temporary
+   * SpectrumValue.
+   *
+   * @param x the first factor
+   * @param y the second factor
+   *
+   * @return a reference to *this
+   */
+  SpectrumValue& MultiplyAccumulate (const SpectrumValue& x, const SpectrumValue& y);
+
+
 
   /**
    *
@@ -0,0 +1,376 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// End-to-end tests for MultithreadedSimulatorImpl over point-to-point links
+
+#include "ns3/channel.h"
+#include "ns3/config.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/packet.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/tag.h"
+#include "ns3/test.h"
+#include "ns3/udp-echo-helper.h"
+#include "ns3/uinteger.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * A chain n0 - n1 - n2 - n3 where n0 and n3 belong to partition 0 and
+ * n1 and n2 to partition 1: only the first and the last links, whose
+ * delays are 5ms and 2ms, cross partitions.
+ */
+static NetDeviceContainer
+CreateChain (NodeContainer &nodes)
+{
+  nodes.Add (CreateObject<Node> (0));
+  nodes.Add (CreateObject<Node> (1));
+  nodes.Add (CreateObject<Node> (1));
+  nodes.Add (CreateObject<Node> (0));
+
+  const char *delays[] = { "5ms", "1ms", "2ms" };
+  NetDeviceContainer devices;
+  PointToPointHelper p2p;
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      p2p.SetChannelAttribute ("Delay", StringValue (delays[i]));
+      devices.Add (p2p.Install (nodes.Get (i), nodes.Get (i + 1)));
+    }
+  return devices;
+}
+
+static void
+UseMultithreadedSimulator (bool enable)
+{
+  Config::SetGlobal ("SimulatorImplementationType",
+                     StringValue (enable ? "ns3::MultithreadedSimulatorImpl" : "ns3::DefaultSimulatorImpl"));
+}
+
+class MultithreadedLookAheadTestCase : public TestCase
+{
+public:
+  MultithreadedLookAheadTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+};
+
+MultithreadedLookAheadTestCase::MultithreadedLookAheadTestCase ()
+  : TestCase ("Lookahead computed from the point-to-point links between partitions")
+{
+}
+
+void
+MultithreadedLookAheadTestCase::DoRun (void)
+{
+  UseMultithreadedSimulator (true);
+  NodeContainer nodes;
+  CreateChain (nodes);
+  Simulator::Run ();
+
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  NS_TEST_ASSERT_MSG_NE (impl, 0, "Wrong simulator implementation");
+  NS_TEST_EXPECT_MSG_EQ (impl->GetPartitionCount (), 2U, "Bad number of partitions");
+  // the 1ms link is local to partition 1
+  NS_TEST_EXPECT_MSG_EQ (impl->GetLookAhead (), MilliSeconds (2), "Bad lookahead");
+  Simulator::Destroy ();
+}
+
+void
+MultithreadedLookAheadTestCase::DoTeardown (void)
+{
+  UseMultithreadedSimulator (false);
+}
+
+class MultithreadedUdpEchoTestCase : public TestCase
+{
+public:
+  MultithreadedUdpEchoTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  std::vector<Time> RunEcho (bool multithreaded);
+  void Receive (Ptr<const Packet> p);
+
+  std::vector<Time> m_received;
+};
+
+MultithreadedUdpEchoTestCase::MultithreadedUdpEchoTestCase ()
+  : TestCase ("UDP echo packets which cross partitions twice each way")
+{
+}
+
+void
+MultithreadedUdpEchoTestCase::Receive (Ptr<const Packet> p)
+{
+  m_received.push_back (Simulator::Now ());
+}
+
+std::vector<Time>
+MultithreadedUdpEchoTestCase::RunEcho (bool multithreaded)
+{
+  UseMultithreadedSimulator (multithreaded);
+  NodeContainer nodes;
+  NetDeviceContainer devices = CreateChain (nodes);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces;
+  for (uint32_t i = 0; i < devices.GetN (); i += 2)
+    {
+      NetDeviceContainer link;
+      link.Add (devices.Get (i));
+      link.Add (devices.Get (i + 1));
+      interfaces.Add (ipv4.Assign (link));
+      ipv4.NewNetwork ();
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  UdpEchoServerHelper server (9);
+  server.Install (nodes.Get (3)).Start (Seconds (0.5));
+  UdpEchoClientHelper client (interfaces.GetAddress (5), 9);
+  client.SetAttribute ("MaxPackets", UintegerValue (10));
+  client.SetAttribute ("Interval", TimeValue (MilliSeconds (100)));
+  client.Install (nodes.Get (0)).Start (Seconds (1));
+
+  // the echo replies reach n0, in partition 0 only.
+  m_received.clear ();
+  devices.Get (0)->TraceConnectWithoutContext ("MacRx", MakeCallback (&MultithreadedUdpEchoTestCase::Receive, this));
+  Simulator::Stop (Seconds (5));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_received;
+}
+
+void
+MultithreadedUdpEchoTestCase::DoRun (void)
+{
+  std::vector<Time> expected = RunEcho (false);
+  std::vector<Time> received = RunEcho (true);
+
+  NS_TEST_ASSERT_MSG_EQ (expected.size (), 10U, "Echo replies lost by the default simulator");
+  NS_TEST_ASSERT_MSG_EQ (received.size (), expected.size (), "Echo replies lost across partitions");
+  for (uint32_t i = 0; i < expected.size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (received[i], expected[i], "Bad reception time of echo reply " << i);
+    }
+}
+
+void
+MultithreadedUdpEchoTestCase::DoTeardown (void)
+{
+  UseMultithreadedSimulator (false);
+}
+
+class MultithreadedTestTag : public Tag
+{
+public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer i) const;
+  virtual void Deserialize (TagBuffer i);
+  virtual void Print (std::ostream &os) const;
+
+  MultithreadedTestTag (uint32_t value = 0);
+  uint32_t GetValue (void) const;
+
+private:
+  uint32_t m_value;
+};
+
+TypeId
+MultithreadedTestTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedTestTag")
+    .SetParent<Tag> ()
+    .AddConstructor<MultithreadedTestTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+MultithreadedTestTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+MultithreadedTestTag::GetSerializedSize (void) const
+{
+  return 4;
+}
+
+void
+MultithreadedTestTag::Serialize (TagBuffer i) const
+{
+  i.WriteU32 (m_value);
+}
+
+void
+MultithreadedTestTag::Deserialize (TagBuffer i)
+{
+  m_value = i.ReadU32 ();
+}
+
+void
+MultithreadedTestTag::Print (std::ostream &os) const
+{
+  os << "value=" << m_value;
+}
+
+MultithreadedTestTag::MultithreadedTestTag (uint32_t value)
+  : m_value (value)
+{
+}
+
+uint32_t
+MultithreadedTestTag::GetValue (void) const
+{
+  return m_value;
+}
+
+class MultithreadedTxRxTestCase : public TestCase
+{
+public:
+  MultithreadedTxRxTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void RunLink (bool multithreaded);
+  static void Send (Ptr<NetDevice> device, Address dst);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+  void TxRx (Ptr<const Packet> p, Ptr<NetDevice> tx, Ptr<NetDevice> rx, Time txTime, Time rxTime);
+
+  uint32_t m_received;
+  uint32_t m_packetTag;
+  uint32_t m_byteTag;
+  uint32_t m_txrx;
+  Time m_txrxTime;
+};
+
+MultithreadedTxRxTestCase::MultithreadedTxRxTestCase ()
+  : TestCase ("Tags and TxRxPointToPoint trace of the packets which cross partitions")
+{
+}
+
+void
+MultithreadedTxRxTestCase::Send (Ptr<NetDevice> device, Address dst)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  p->AddPacketTag (MultithreadedTestTag (1));
+  p->AddByteTag (MultithreadedTestTag (2));
+  device->Send (p, dst, 0x800);
+}
+
+bool
+MultithreadedTxRxTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from)
+{
+  MultithreadedTestTag tag;
+  m_received++;
+  if (p->PeekPacketTag (tag))
+    {
+      m_packetTag = tag.GetValue ();
+    }
+  if (p->FindFirstMatchingByteTag (tag))
+    {
+      m_byteTag = tag.GetValue ();
+    }
+  return true;
+}
+
+void
+MultithreadedTxRxTestCase::TxRx (Ptr<const Packet> p, Ptr<NetDevice> tx, Ptr<NetDevice> rx, Time txTime, Time rxTime)
+{
+  m_txrx++;
+  m_txrxTime = Simulator::Now ();
+}
+
+void
+MultithreadedTxRxTestCase::RunLink (bool multithreaded)
+{
+  UseMultithreadedSimulator (multithreaded);
+  m_received = 0;
+  m_packetTag = 0;
+  m_byteTag = 0;
+  m_txrx = 0;
+  m_txrxTime = Seconds (0);
+
+  NodeContainer nodes;
+  nodes.Add (CreateObject<Node> (0));
+  nodes.Add (CreateObject<Node> (1));
+  PointToPointHelper p2p;
+  p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer devices = p2p.Install (nodes);
+  devices.Get (1)->SetReceiveCallback (MakeCallback (&MultithreadedTxRxTestCase::Receive, this));
+  devices.Get (0)->GetChannel ()->TraceConnectWithoutContext ("TxRxPointToPoint",
+                                                              MakeCallback (&MultithreadedTxRxTestCase::TxRx, this));
+  Simulator::ScheduleWithContext (nodes.Get (0)->GetId (), Seconds (1), &MultithreadedTxRxTestCase::Send,
+                                  devices.Get (0), devices.Get (1)->GetAddress ());
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+MultithreadedTxRxTestCase::DoRun (void)
+{
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      bool multithreaded = i == 1;
+      RunLink (multithreaded);
+      NS_TEST_EXPECT_MSG_EQ (m_received, 1U, "Packet lost, multithreaded=" << multithreaded);
+      NS_TEST_EXPECT_MSG_EQ (m_packetTag, 1U, "Packet tag lost, multithreaded=" << multithreaded);
+      NS_TEST_EXPECT_MSG_EQ (m_byteTag, 2U, "Byte tag lost, multithreaded=" << multithreaded);
+      NS_TEST_EXPECT_MSG_EQ (m_txrx, 1U, "TxRxPointToPoint not fired, multithreaded=" << multithreaded);
+      NS_TEST_EXPECT_MSG_EQ (m_txrxTime, Seconds (1), "Bad TxRxPointToPoint time, multithreaded=" << multithreaded);
+    }
+}
+
+void
+MultithreadedTxRxTestCase::DoTeardown (void)
+{
+  UseMultithreadedSimulator (false);
+}
+
+class MultithreadedPointToPointTestSuite : public TestSuite
+{
+public:
+  MultithreadedPointToPointTestSuite ();
+};
+
+MultithreadedPointToPointTestSuite::MultithreadedPointToPointTestSuite ()
+  : TestSuite ("multithreaded-point-to-point", SYSTEM)
+{
+  AddTestCase (new MultithreadedLookAheadTestCase, TestCase::QUICK);
+  AddTestCase (new MultithreadedUdpEchoTestCase, TestCase::QUICK);
+  AddTestCase (new MultithreadedTxRxTestCase, TestCase::QUICK);
+}
+
+static MultithreadedPointToPointTestSuite multithreadedPointToPointTestSuite;
@@ -0,0 +1,133 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Compares the chunk success rates of the Nist and Yans error rate
+// models with and without their "UseTable" attribute: for each mode,
+// prints the largest difference between the two over an SNR sweep and
+// several chunk sizes, and the time it took to compute them both ways.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "ns3/core-module.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
+
+using namespace ns3;
+
+namespace {
+
+// chunk sizes of a few frames, from an ACK to a large A-MSDU
+const uint32_t g_nbits[] = { 14 * 8, 100 * 8, 1500 * 8, 7935 * 8 };
+const uint32_t g_nNbits = sizeof (g_nbits) / sizeof (g_nbits[0]);
+
+double
+SumChunkSuccessRates (Ptr<ErrorRateModel> model, WifiMode mode,
+                      const std::vector<double> &snrs, uint32_t nRuns, int64_t &ms)
+{
+  double sum = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t run = 0; run < nRuns; run++)
+    {
+      for (uint32_t i = 0; i < snrs.size (); i++)
+        {
+          sum += model->GetChunkSuccessRate (mode, snrs[i], g_nbits[i % g_nNbits]);
+        }
+    }
+  ms = clock.End ();
+  return sum;
+}
+
+void
+Compare (std::string name, Ptr<ErrorRateModel> analytic, Ptr<ErrorRateModel> table,
+         const std::vector<WifiMode> &modes, double minSnrDb, double maxSnrDb, uint32_t nRuns)
+{
+  std::cout << name << std::endl;
+  for (std::vector<WifiMode>::const_iterator mode = modes.begin (); mode != modes.end (); ++mode)
+    {
+      // an irregular sweep, so that the SNRs fall between the steps of the tables
+      std::vector<double> snrs;
+      for (double snrDb = minSnrDb; snrDb < maxSnrDb; snrDb += 0.0037)
+        {
+          snrs.push_back (std::pow (10.0, snrDb / 10.0));
+        }
+      double maxError = 0;
+      for (uint32_t i = 0; i < snrs.size (); i++)
+        {
+          for (uint32_t n = 0; n < g_nNbits; n++)
+            {
+              double error = std::fabs (analytic->GetChunkSuccessRate (*mode, snrs[i], g_nbits[n])
+                                        - table->GetChunkSuccessRate (*mode, snrs[i], g_nbits[n]));
+              maxError = std::max (maxError, error);
+            }
+        }
+      int64_t analyticMs;
+      int64_t tableMs;
+      double analyticSum = SumChunkSuccessRates (analytic, *mode, snrs, nRuns, analyticMs);
+      double tableSum = SumChunkSuccessRates (table, *mode, snrs, nRuns, tableMs);
+      NS_ASSERT (std::fabs (analyticSum - tableSum) <= maxError * snrs.size () * nRuns);
+      std::cout << "  " << std::setw (24) << std::left << *mode << std::right
+                << " max error " << std::scientific << std::setprecision (2) << maxError
+                << std::fixed << "  analytic " << std::setw (6) << analyticMs << " ms"
+                << "  table " << std::setw (6) << tableMs << " ms" << std::endl;
+    }
+}
+
+} // anonymous namespace
+
+int
+main (int argc, char *argv[])
+{
+  double minSnrDb = -5.0;
+  double maxSnrDb = 30.0;
+  uint32_t nRuns = 20;
+
+  CommandLine cmd;
+  cmd.AddValue ("minSnrDb", "Lowest SNR of the sweep, in dB", minSnrDb);
+  cmd.AddValue ("maxSnrDb", "Highest SNR of the sweep, in dB", maxSnrDb);
+  cmd.AddValue ("nRuns", "Number of timed sweeps per mode", nRuns);
+  cmd.Parse (argc, argv);
+
+  std::vector<WifiMode> modes;
+  modes.push_back (WifiPhy::GetDsssRate1Mbps ());
+  modes.push_back (WifiPhy::GetDsssRate2Mbps ());
+  modes.push_back (WifiPhy::GetDsssRate5_5Mbps ());
+  modes.push_back (WifiPhy::GetDsssRate11Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate6Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate9Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate12Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate18Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate24Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate36Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate48Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate54Mbps ());
+
+  Ptr<ErrorRateModel> nist = CreateObject<NistErrorRateModel> ();
+  Ptr<ErrorRateModel> nistTable = CreateObject<NistErrorRateModel> ();
+  nistTable->SetAttribute ("UseTable", BooleanValue (true));
+  Compare ("ns3::NistErrorRateModel", nist, nistTable, modes, minSnrDb, maxSnrDb, nRuns);
+
+  Ptr<ErrorRateModel> yans = CreateObject<YansErrorRateModel> ();
+  Ptr<ErrorRateModel> yansTable = CreateObject<YansErrorRateModel> ();
+  yansTable->SetAttribute ("UseTable", BooleanValue (true));
+  Compare ("ns3::YansErrorRateModel", yans, yansTable, modes, minSnrDb, maxSnrDb, nRuns);
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <cmath>
+#include <map>
+#include <limits>
+#include <algorithm>
+#include "error-rate-table.h"
+#include "ns3/system-mutex.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("ErrorRateTable");
+
+namespace ns3 {
+
+const double ErrorRateTable::MIN_SNR_DB = -10.0;
+const double ErrorRateTable::MAX_SNR_DB = 40.0;
+const double ErrorRateTable::STEP_DB = 0.01;
+
+namespace {
+
+typedef std::map<std::pair<std::string, uint32_t>, std::vector<double> > Tables;
+
+// the tables of all the models, which are never removed
+Tables &
+GetTables (void)
+{
+  static Tables tables;
+  return tables;
+}
+
+SystemMutex &
+GetTablesMutex (void)
+{
+  static SystemMutex mutex;
+  return mutex;
+}
+
+} // anonymous namespace
+
+ErrorRateTable::ErrorRateTable ()
+{
+}
+
+void
+ErrorRateTable::SetModel (std::string name, ChunkSuccessRateCallback model)
+{
+  m_name = name;
+  m_model = model;
+  m_tables.clear ();
+}
+
+const ErrorRateTable::Table *
+ErrorRateTable::GetTable (WifiMode mode) const
+{
+  uint32_t uid = mode.GetUid ();
+  if (uid < m_tables.size () && m_tables[uid] != 0)
+    {
+      return m_tables[uid];
+    }
+  Table *table;
+  {
+    CriticalSection cs (GetTablesMutex ());
+    table = &GetTables ()[std::make_pair (m_name, uid)];
+    if (table->empty ())
+      {
+        NS_LOG_DEBUG ("Building the " << m_name << " table of " << mode);
+        uint32_t n = static_cast<uint32_t> ((MAX_SNR_DB - MIN_SNR_DB) / STEP_DB + 0.5) + 1;
+        table->reserve (n);
+        for (uint32_t i = 0; i < n; i++)
+          {
+            double snr = std::pow (10.0, (MIN_SNR_DB + i * STEP_DB) / 10.0);
+            // -inf if the bit success rate rounds to 1, +inf if it is 0
+            table->push_back (std::log (-std::log (m_model (mode, snr, 1))));
+          }
+      }
+  }
+  if (uid >= m_tables.size ())
+    {
+      m_tables.resize (uid + 1, 0);
+    }
+  m_tables[uid] = table;
+  return table;
+}
+
+double
+ErrorRateTable::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  double position = (10.0 * std::log10 (snr) - MIN_SNR_DB) / STEP_DB;
+  if (nbits == 0 || !(position >= 0.0 && position < (MAX_SNR_DB - MIN_SNR_DB) / STEP_DB))
+    {
+      return m_model (mode, snr, nbits);
+    }
+  const Table &table = *GetTable (mode);
+  uint32_t i = static_cast<uint32_t> (position);
+  NS_ASSERT (i + 1 < table.size ());
+  double h0 = table[i];
+  double h1 = table[i + 1];
+  static const double infinity = std::numeric_limits<double>::infinity ();
+  if (h0 == -infinity && h1 == -infinity)
+    {
+      return 1.0;
+    }
+  // the bit error rates of some models are clamped to 1, so that
+  // log (-log (s)) bends sharply where s gets small: use the model there,
+  // unless the chunk is long enough for its success rate to be below
+  // 0.5^64 anyway, and where the bit success rate rounds to 1 at one
+  // end of the step.
+  static const double maxH = std::log (-std::log (0.5));
+  if (h0 > maxH && h1 > maxH && nbits >= 64)
+    {
+      return std::exp (-std::exp (std::min (h0, h1)) * nbits);
+    }
+  if (!(h0 > -infinity && h1 > -infinity && h0 <= maxH && h1 <= maxH))
+    {
+      return m_model (mode, snr, nbits);
+    }
+  double h = h0 + (position - i) * (h1 - h0);
+  return std::exp (-std::exp (h) * nbits);
+}
+
+} // namespace ns3
@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef ERROR_RATE_TABLE_H
+#define ERROR_RATE_TABLE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "wifi-mode.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief tabulated chunk success rates of an error rate model
+ *
+ * The chunk success rate of the Nist, Yans and DSSS error models is
+ * s(snr)^nbits, where s(snr) is the success rate of a single bit. This
+ * class samples log (-log (s)) of a model every STEP_DB dB, from
+ * MIN_SNR_DB to MAX_SNR_DB, the first time a mode is used, and
+ * interpolates it linearly: log (-log (s)) is a smooth function of the
+ * SNR in dB, so that the interpolation error on the chunk success rate
+ * stays below 1e-4 for the OFDM and DSSS modes (see the
+ * error-rate-table-benchmark example). The SNRs out of the table, the
+ * table steps where the bit success rate of the model is below 0.5
+ * (for chunks shorter than 64 bits), and those where it rounds to 1 at
+ * one end only, use the model itself.
+ *
+ * The tables are shared by all the instances of a model and built under
+ * a lock, so that the models of the phys simulated by different threads
+ * can use them.
+ */
+class ErrorRateTable
+{
+public:
+  /// The chunk success rate computed by a model: mode, snr, nbits
+  typedef Callback<double, WifiMode, double, uint32_t> ChunkSuccessRateCallback;
+
+  static const double MIN_SNR_DB; //!< the lowest SNR of the tables
+  static const double MAX_SNR_DB; //!< the highest SNR of the tables
+  static const double STEP_DB;    //!< the SNR step of the tables
+
+  ErrorRateTable ();
+
+  /**
+   * \param name the name of the model, which identifies the tables
+   * \param model the chunk success rate of the model
+   */
+  void SetModel (std::string name, ChunkSuccessRateCallback model);
+  /**
+   * \param mode the Wi-Fi mode the chunk is sent
+   * \param snr the SNR of the chunk
+   * \param nbits the number of bits in this chunk
+   * \return the interpolated probability of successfully receiving the chunk
+   */
+  double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
+
+private:
+  /// log (-log (s)) of the model at each step, indexed from MIN_SNR_DB
+  typedef std::vector<double> Table;
+
+  /**
+   * \param mode a Wi-Fi mode
+   * \return the table of this mode, which is built the first time
+   */
+  const Table * GetTable (WifiMode mode) const;
+
+  std::string m_name;
+  ChunkSuccessRateCallback m_model;
+  /// the tables of the modes which were used, indexed by mode uid
+  mutable std::vector<const Table *> m_tables;
+};
+
+} // namespace ns3
+
+#endif /* ERROR_RATE_TABLE_H */
@@ -98,7 +98,8 @@ InterferenceHelper::Event::GetTxVector (void) const
 
 InterferenceHelper::NiChange::NiChange (Time time, double delta)
   : m_time (time),
-    m_delta (delta)
+    m_delta (delta),
+    m_power (0.0)
 {
 }
 Time
@@ -111,6 +112,16 @@ InterferenceHelper::NiChange::GetDelta (void) const
 {
   return m_delta;
 }
+double
+InterferenceHelper::NiChange::GetPower (void) const
+{
+  return m_power;
+}
+void
+InterferenceHelper::NiChange::AddPower (double delta)
+{
+  m_power += delta;
+}
 bool
 InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o) const
 {
@@ -179,22 +190,16 @@ Time
 InterferenceHelper::GetEnergyDuration (double energyW)
 {
   Time now = Simulator::Now ();
-  double noiseInterferenceW = 0.0;
-  Time end = now;
-  noiseInterferenceW = m_firstPower;
-  for (NiChanges::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
+  NiChanges::const_iterator i = std::lower_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (now, 0));
+  if (i == m_niChanges.end ())
     {
-      noiseInterferenceW += i->GetDelta ();
-      end = i->GetTime ();
-      if (end < now)
-        {
-          continue;
-        }
-      if (noiseInterferenceW < energyW)
-        {
-          break;
-        }
+      return MicroSeconds (0);
+    }
+  while (i->GetPower () >= energyW && i + 1 != m_niChanges.end ())
+    {
+      i++;
     }
+  Time end = i->GetTime ();
   return end > now ? end - now : MicroSeconds (0);
 }
 
@@ -204,20 +209,10 @@ InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
   Time now = Simulator::Now ();
   if (!m_rxing)
     {
-      NiChanges::iterator nowIterator = GetPosition (now);
-      for (NiChanges::iterator i = m_niChanges.begin (); i != nowIterator; i++)
-        {
-          m_firstPower += i->GetDelta ();
-        }
-      m_niChanges.erase (m_niChanges.begin (), nowIterator);
-      m_niChanges.insert (m_niChanges.begin (), NiChange (event->GetStartTime (), event->GetRxPowerW ()));
-    }
-  else
-    {
-      AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW ()));
+      EraseNiChangesUpTo (now);
     }
+  AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW ()));
   AddNiChangeEvent (NiChange (event->GetEndTime (), -event->GetRxPowerW ()));
-
 }
 
 
@@ -238,17 +233,27 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, WifiM
 double
 InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event, NiChanges *ni) const
 {
-  double noiseInterference = m_firstPower;
   NS_ASSERT (m_rxing);
-  for (NiChanges::const_iterator i = m_niChanges.begin () + 1; i != m_niChanges.end (); i++)
+  // the changes of the event are the first changes at its start and end
+  // times with its power, since the changes which happen at the same time
+  // are kept in insertion order.
+  NiChanges::const_iterator start = std::lower_bound (m_niChanges.begin (), m_niChanges.end (),
+                                                      NiChange (event->GetStartTime (), 0));
+  while (start != m_niChanges.end () && start->GetDelta () != event->GetRxPowerW ())
     {
-      if ((event->GetEndTime () == i->GetTime ()) && event->GetRxPowerW () == -i->GetDelta ())
-        {
-          break;
-        }
-      ni->push_back (*i);
+      start++;
+    }
+  NS_ASSERT (start != m_niChanges.end () && start->GetTime () == event->GetStartTime ());
+  NiChanges::const_iterator end = std::lower_bound (start, NiChanges::const_iterator (m_niChanges.end ()),
+                                                    NiChange (event->GetEndTime (), 0));
+  while (end != m_niChanges.end () && end->GetDelta () != -event->GetRxPowerW ())
+    {
+      end++;
     }
-  ni->insert (ni->begin (), NiChange (event->GetStartTime (), noiseInterference));
+  double noiseInterference = GetPowerBefore (start);
+  ni->reserve (end - start + 1);
+  ni->push_back (NiChange (event->GetStartTime (), noiseInterference));
+  ni->insert (ni->end (), start + 1, end);
   ni->push_back (NiChange (event->GetEndTime (), 0));
   return noiseInterference;
 }
@@ -574,7 +579,27 @@ InterferenceHelper::GetPosition (Time moment)
 void
 InterferenceHelper::AddNiChangeEvent (NiChange change)
 {
-  m_niChanges.insert (GetPosition (change.GetTime ()), change);
+  NiChanges::iterator i = m_niChanges.insert (GetPosition (change.GetTime ()), change);
+  i->AddPower (GetPowerBefore (i));
+  for (; i != m_niChanges.end (); i++)
+    {
+      i->AddPower (change.GetDelta ());
+    }
+}
+void
+InterferenceHelper::EraseNiChangesUpTo (Time moment)
+{
+  NiChanges::iterator i = GetPosition (moment);
+  if (i != m_niChanges.begin ())
+    {
+      m_firstPower = (i - 1)->GetPower ();
+      m_niChanges.erase (m_niChanges.begin (), i);
+    }
+}
+double
+InterferenceHelper::GetPowerBefore (NiChanges::const_iterator i) const
+{
+  return i == m_niChanges.begin () ? m_firstPower : (i - 1)->GetPower ();
 }
 void
 InterferenceHelper::NotifyRxStart ()
@@ -37,6 +37,14 @@ class ErrorRateModel;
 /**
  * \ingroup wifi
  * \brief handles interference calculations
+ *
+ * The signals on the medium are tracked as a time-ordered list of the
+ * power changes at their start and end times, each of which also holds
+ * the total noise and interference power after the change. The changes
+ * which are in the past when no packet is being received are folded into
+ * the power before the first change, so that the list only holds the
+ * signals which overlap the current time or the packet being received,
+ * and the searches in the list are binary searches.
  */
 class InterferenceHelper
 {
@@ -227,6 +235,18 @@ public:
      * \return the power
      */
     double GetDelta (void) const;
+    /**
+     * Return the noise and interference power after this change.
+     *
+     * \return the power (w)
+     */
+    double GetPower (void) const;
+    /**
+     * Add the given amount to the power after this change.
+     *
+     * \param delta the power (w)
+     */
+    void AddPower (double delta);
     /**
      * Compare the event time of two NiChange objects (a < o).
      *
@@ -237,15 +257,12 @@ public:
 private:
     Time m_time;
     double m_delta;
+    double m_power;
   };
   /**
    * typedef for a vector of NiChanges
    */
   typedef std::vector <NiChange> NiChanges;
-  /**
-   * typedef for a list of Events
-   */
-  typedef std::list<Ptr<Event> > Events;
 
   //InterferenceHelper (const InterferenceHelper &o);
   //InterferenceHelper &operator = (const InterferenceHelper &o);
@@ -297,16 +314,29 @@ private:
   Ptr<ErrorRateModel> m_errorRateModel;
   /// Experimental: needed for energy duration calculation
   NiChanges m_niChanges;
-  double m_firstPower;
+  double m_firstPower; //!< the power before the first change of m_niChanges
   bool m_rxing;
   /// Returns an iterator to the first nichange, which is later than moment
   NiChanges::iterator GetPosition (Time moment);
   /**
-   * Add NiChange to the list at the appropriate position.
+   * Add NiChange to the list at the appropriate position, and add its
+   * delta to the power after all the later changes.
    *
    * \param change
    */
   void AddNiChangeEvent (NiChange change);
+  /**
+   * Fold the changes up to and including the given time into
+   * m_firstPower and remove them from the list.
+   *
+   * \param moment
+   */
+  void EraseNiChangesUpTo (Time moment);
+  /**
+   * \param i a position in m_niChanges
+   * \return the noise and interference power before the change at i
+   */
+  double GetPowerBefore (NiChanges::const_iterator i) const;
 };
 
 } // namespace ns3
@@ -22,6 +22,7 @@
 #include "nist-error-rate-model.h"
 #include "wifi-phy.h"
 #include "ns3/log.h"
+#include "ns3/boolean.h"
 
 NS_LOG_COMPONENT_DEFINE ("NistErrorRateModel");
 
@@ -36,12 +37,21 @@ NistErrorRateModel::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::NistErrorRateModel")
     .SetParent<ErrorRateModel> ()
     .AddConstructor<NistErrorRateModel> ()
+    .AddAttribute ("UseTable",
+                   "If true, the chunk success rates are interpolated from tables "
+                   "of the model, which are built the first time a mode is used, "
+                   "instead of being computed for each chunk.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NistErrorRateModel::m_useTable),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 NistErrorRateModel::NistErrorRateModel ()
 {
+  m_table.SetModel (GetTypeId ().GetName (),
+                    MakeCallback (&NistErrorRateModel::GetAnalyticChunkSuccessRate, this));
 }
 
 double
@@ -192,6 +202,16 @@ NistErrorRateModel::GetFec64QamBer (double snr, uint32_t nbits,
 }
 double
 NistErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  if (m_useTable)
+    {
+      return m_table.GetChunkSuccessRate (mode, snr, nbits);
+    }
+  return GetAnalyticChunkSuccessRate (mode, snr, nbits);
+}
+
+double
+NistErrorRateModel::GetAnalyticChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
 {
   if (mode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM
       || mode.GetModulationClass () == WIFI_MOD_CLASS_OFDM|| mode.GetModulationClass()==WIFI_MOD_CLASS_HT)
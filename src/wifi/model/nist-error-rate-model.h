@@ -24,6 +24,7 @@
 #include "wifi-mode.h"
 #include "error-rate-model.h"
 #include "dsss-error-rate-model.h"
+#include "error-rate-table.h"
 
 namespace ns3 {
 
@@ -45,6 +46,14 @@ public:
   virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
 
 private:
+  /**
+   * \param mode the Wi-Fi mode the chunk is sent
+   * \param snr the SNR of the chunk
+   * \param nbits the number of bits in this chunk
+   * \return probability of successfully receiving the chunk, computed
+   *         without the table
+   */
+  double GetAnalyticChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
   /**
    * Return the coded BER for the given p and b.
    *
@@ -121,6 +130,9 @@ private:
    */
   double GetFec64QamBer (double snr, uint32_t nbits,
                          uint32_t bValue) const;
+
+  bool m_useTable; //!< true if the chunk success rates are interpolated from a table
+  ErrorRateTable m_table;
 };
 
 
@@ -23,6 +23,7 @@
 #include "yans-error-rate-model.h"
 #include "wifi-phy.h"
 #include "ns3/log.h"
+#include "ns3/boolean.h"
 
 NS_LOG_COMPONENT_DEFINE ("YansErrorRateModel");
 
@@ -37,12 +38,21 @@ YansErrorRateModel::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::YansErrorRateModel")
     .SetParent<ErrorRateModel> ()
     .AddConstructor<YansErrorRateModel> ()
+    .AddAttribute ("UseTable",
+                   "If true, the chunk success rates are interpolated from tables "
+                   "of the model, which are built the first time a mode is used, "
+                   "instead of being computed for each chunk.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansErrorRateModel::m_useTable),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 YansErrorRateModel::YansErrorRateModel ()
 {
+  m_table.SetModel (GetTypeId ().GetName (),
+                    MakeCallback (&YansErrorRateModel::GetAnalyticChunkSuccessRate, this));
 }
 
 double
@@ -175,6 +185,16 @@ YansErrorRateModel::GetFecQamBer (double snr, uint32_t nbits,
 
 double
 YansErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  if (m_useTable)
+    {
+      return m_table.GetChunkSuccessRate (mode, snr, nbits);
+    }
+  return GetAnalyticChunkSuccessRate (mode, snr, nbits);
+}
+
+double
+YansErrorRateModel::GetAnalyticChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
 {
   if (mode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM
       || mode.GetModulationClass () == WIFI_MOD_CLASS_OFDM)
@@ -24,6 +24,7 @@
 #include "wifi-mode.h"
 #include "error-rate-model.h"
 #include "dsss-error-rate-model.h"
+#include "error-rate-table.h"
 
 namespace ns3 {
 
@@ -62,6 +63,14 @@ public:
   virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
 
 private:
+  /**
+   * \param mode the Wi-Fi mode the chunk is sent
+   * \param snr the SNR of the chunk
+   * \param nbits the number of bits in this chunk
+   * \return probability of successfully receiving the chunk, computed
+   *         without the table
+   */
+  double GetAnalyticChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
   /**
    * Return the logarithm of the given value to base 2.
    *
@@ -150,6 +159,9 @@ private:
                        uint32_t phyRate,
                        uint32_t m, uint32_t dfree,
                        uint32_t adFree, uint32_t adFreePlusOne) const;
+
+  bool m_useTable; //!< true if the chunk success rates are interpolated from a table
+  ErrorRateTable m_table;
 };
 
 
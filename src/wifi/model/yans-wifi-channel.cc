@@ -24,11 +24,16 @@
 #include "ns3/node.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/object-factory.h"
 #include "yans-wifi-channel.h"
 #include "yans-wifi-phy.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
+#include <algorithm>
+#include <limits>
+#include <cmath>
 
 NS_LOG_COMPONENT_DEFINE ("YansWifiChannel");
 
@@ -51,11 +56,34 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("MaxRange",
+                   "Phys further than this distance (m) from the sender do not receive "
+                   "its transmissions. Zero disables this cutoff.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("RxSensitivity",
+                   "Phys which would receive a transmission below this power (dBm, "
+                   "including their RxGain) do not receive it at all, and thus do not "
+                   "see it as interference either. By default no cutoff is applied.",
+                   DoubleValue (-std::numeric_limits<double>::max ()),
+                   MakeDoubleAccessor (&YansWifiChannel::m_rxSensitivityDbm),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SpatialIndex",
+                   "If true and MaxRange is set, keep the phys in a grid of MaxRange-wide "
+                   "cells so that Send only visits the phys of the cells around the sender.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_spatialIndex),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_maxRange (0.0),
+    m_rxSensitivityDbm (-std::numeric_limits<double>::max ()),
+    m_spatialIndex (false),
+    m_cellSize (0.0)
 {
 }
 YansWifiChannel::~YansWifiChannel ()
@@ -64,6 +92,13 @@ YansWifiChannel::~YansWifiChannel ()
   m_phyList.clear ();
 }
 
+void
+YansWifiChannel::DoDispose (void)
+{
+  ClearGrid ();
+  WifiChannel::DoDispose ();
+}
+
 void
 YansWifiChannel::SetPropagationLossModel (Ptr<PropagationLossModel> loss)
 {
@@ -81,42 +116,169 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  // A single copy, which protects the receivers from later changes made
+  // by the sender, is shared by all the receivers: YansWifiPhy copies it
+  // again only if it receives the packet successfully.
+  packet = packet->Copy ();
+  if (!m_spatialIndex || m_maxRange <= 0.0)
     {
-      if (sender != (*i))
+      for (uint32_t j = 0; j < m_phyList.size (); j++)
         {
-          // For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
-            {
-              continue;
-            }
+          SendTo (j, sender, senderMobility, packet, txPowerDbm, txVector, preamble);
+        }
+      return;
+    }
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
-            {
-              dstNode = 0xffffffff;
-            }
-          else
+  UpdateGrid ();
+  // Since the cells are as wide as the maximum range, the receivers
+  // are in the 3x3 cells around the sender, or moving.
+  Cell center = GetCell (senderMobility->GetPosition ());
+  std::vector<uint32_t> candidates (m_moving.begin (), m_moving.end ());
+  for (int64_t x = center.first - 1; x <= center.first + 1; x++)
+    {
+      for (int64_t y = center.second - 1; y <= center.second + 1; y++)
+        {
+          std::map<Cell, std::vector<uint32_t> >::const_iterator cell = m_cells.find (Cell (x, y));
+          if (cell != m_cells.end ())
             {
-              dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
+              candidates.insert (candidates.end (), cell->second.begin (), cell->second.end ());
             }
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive, this,
-                                          j, copy, rxPowerDbm, txVector, preamble);
         }
     }
+  // Visit the receivers in the order of the full loop so that the
+  // reception events are scheduled in the same order.
+  std::sort (candidates.begin (), candidates.end ());
+  for (std::vector<uint32_t>::const_iterator j = candidates.begin (); j != candidates.end (); j++)
+    {
+      SendTo (*j, sender, senderMobility, packet, txPowerDbm, txVector, preamble);
+    }
+}
+
+void
+YansWifiChannel::SendTo (uint32_t j, Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility,
+                         Ptr<const Packet> packet, double txPowerDbm,
+                         WifiTxVector txVector, WifiPreamble preamble) const
+{
+  Ptr<YansWifiPhy> receiver = m_phyList[j];
+  if (sender == receiver)
+    {
+      return;
+    }
+  // For now don't account for inter channel interference
+  if (receiver->GetChannelNumber () != sender->GetChannelNumber ())
+    {
+      return;
+    }
+
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+  if (m_maxRange > 0.0
+      && senderMobility->GetDistanceFrom (receiverMobility) > m_maxRange)
+    {
+      return;
+    }
+  Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
+  double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+  NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+  if (rxPowerDbm + receiver->GetRxGain () < m_rxSensitivityDbm)
+    {
+      NS_LOG_DEBUG ("rxPower below sensitivity, dropping");
+      return;
+    }
+  Ptr<Object> dstNetDevice = receiver->GetDevice ();
+  uint32_t dstNode;
+  if (dstNetDevice == 0)
+    {
+      dstNode = 0xffffffff;
+    }
+  else
+    {
+      dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
+    }
+  Simulator::ScheduleWithContext (dstNode,
+                                  delay, &YansWifiChannel::Receive, this,
+                                  j, packet, rxPowerDbm, txVector, preamble);
+}
+
+YansWifiChannel::Cell
+YansWifiChannel::GetCell (const Vector &position) const
+{
+  return Cell (static_cast<int64_t> (std::floor (position.x / m_cellSize)),
+               static_cast<int64_t> (std::floor (position.y / m_cellSize)));
+}
+
+void
+YansWifiChannel::UpdateGrid (void) const
+{
+  if (m_cellSize != m_maxRange)
+    {
+      ClearGrid ();
+      m_cellSize = m_maxRange;
+    }
+  for (uint32_t i = m_gridEntries.size (); i < m_phyList.size (); i++)
+    {
+      GridEntry entry;
+      entry.mobility = m_phyList[i]->GetMobility ()->GetObject<MobilityModel> ();
+      NS_ASSERT (entry.mobility != 0);
+      entry.moving = true;
+      m_moving.insert (i);
+      m_gridEntries.push_back (entry);
+      entry.mobility->TraceConnectWithoutContext ("CourseChange",
+                                                  MakeBoundCallback (&YansWifiChannel::CourseChanged, this, i));
+      PlacePhy (i);
+    }
+}
+
+void
+YansWifiChannel::ClearGrid (void) const
+{
+  for (uint32_t i = 0; i < m_gridEntries.size (); i++)
+    {
+      m_gridEntries[i].mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                                                MakeBoundCallback (&YansWifiChannel::CourseChanged, this, i));
+    }
+  m_gridEntries.clear ();
+  m_cells.clear ();
+  m_moving.clear ();
+}
+
+void
+YansWifiChannel::PlacePhy (uint32_t i) const
+{
+  GridEntry &entry = m_gridEntries[i];
+  if (entry.moving)
+    {
+      m_moving.erase (i);
+    }
+  else
+    {
+      std::vector<uint32_t> &cell = m_cells[entry.cell];
+      cell.erase (std::find (cell.begin (), cell.end (), i));
+    }
+  // A moving phy leaves its cell without notifying its course
+  // so it has to be checked by every transmission.
+  Vector velocity = entry.mobility->GetVelocity ();
+  entry.moving = velocity.x != 0.0 || velocity.y != 0.0;
+  if (entry.moving)
+    {
+      m_moving.insert (i);
+    }
+  else
+    {
+      entry.cell = GetCell (entry.mobility->GetPosition ());
+      m_cells[entry.cell].push_back (i);
+    }
+}
+
+void
+YansWifiChannel::CourseChanged (YansWifiChannel const *channel, uint32_t i,
+                                Ptr<const MobilityModel> mobility)
+{
+  channel->PlacePhy (i);
 }
 
 void
-YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, double rxPowerDbm,
+YansWifiChannel::Receive (uint32_t i, Ptr<const Packet> packet, double rxPowerDbm,
                           WifiTxVector txVector, WifiPreamble preamble) const
 {
   m_phyList[i]->StartReceivePacket (packet, rxPowerDbm, txVector, preamble);
@@ -21,8 +21,11 @@
 #define YANS_WIFI_CHANNEL_H
 
 #include <vector>
+#include <map>
+#include <set>
 #include <stdint.h>
 #include "ns3/packet.h"
+#include "ns3/vector.h"
 #include "wifi-channel.h"
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
@@ -34,6 +37,7 @@ class NetDevice;
 class PropagationLossModel;
 class PropagationDelayModel;
 class YansWifiPhy;
+class MobilityModel;
 
 /**
  * \brief A Yans wifi channel
@@ -46,6 +50,17 @@ class YansWifiPhy;
  * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
  * By default, no propagation models are set so, it is the caller's responsability
  * to set them before using the channel.
+ *
+ * By default, every transmission is delivered to every other phy of the
+ * channel. The MaxRange and RxSensitivity attributes make the channel skip
+ * the phys which are too far from the sender or which would receive the
+ * signal below a given power. When MaxRange is set, the SpatialIndex
+ * attribute additionally keeps the phys in a uniform grid of MaxRange-wide
+ * cells, updated when their mobility model reports a course change, so that
+ * Send only visits the phys of the cells around the sender instead of the
+ * whole phy list. The receptions which are not culled are exactly those
+ * of the full loop, scheduled in the same order, but skipped receivers do
+ * not draw from the random variables of random propagation models.
  */
 class YansWifiChannel : public WifiChannel
 {
@@ -114,18 +129,59 @@ private:
    * bit of the packet has arrived.
    *
    * \param i index of the corresponding YansWifiPhy in the PHY list
-   * \param packet the packet being sent
+   * \param packet the packet being sent, shared by all the receivers
    * \param rxPowerDbm the received power of the packet
    * \param txVector the TXVECTOR of the packet
    * \param preamble the type of preamble being used to send the packet
    */
-  void Receive (uint32_t i, Ptr<Packet> packet, double rxPowerDbm,
+  void Receive (uint32_t i, Ptr<const Packet> packet, double rxPowerDbm,
                 WifiTxVector txVector, WifiPreamble preamble) const;
+  /**
+   * Schedule the reception of a packet by the phy at index j of the PHY list,
+   * unless the phy is culled by the MaxRange or RxSensitivity attributes.
+   */
+  void SendTo (uint32_t j, Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility,
+               Ptr<const Packet> packet, double txPowerDbm,
+               WifiTxVector txVector, WifiPreamble preamble) const;
+
+  /// The coordinates of a cell of the spatial index.
+  typedef std::pair<int64_t, int64_t> Cell;
+  struct GridEntry
+  {
+    Ptr<MobilityModel> mobility;
+    Cell cell;
+    bool moving;
+  };
+  virtual void DoDispose (void);
+  Cell GetCell (const Vector &position) const;
+  /**
+   * Add to the spatial index the phys added to the channel since the last
+   * call, or rebuild it if MaxRange changed.
+   */
+  void UpdateGrid (void) const;
+  void ClearGrid (void) const;
+  /**
+   * Move the phy at index i of the PHY list to the cell of its current
+   * position, or to the list of moving phys if it has a non-zero velocity.
+   */
+  void PlacePhy (uint32_t i) const;
+  static void CourseChanged (YansWifiChannel const *channel, uint32_t i,
+                             Ptr<const MobilityModel> mobility);
 
 
   PhyList m_phyList; //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss; //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay; //!< Propagation delay model
+  double m_maxRange; //!< Receivers further than this are culled, 0 if disabled
+  double m_rxSensitivityDbm; //!< Receivers below this power are culled
+  bool m_spatialIndex; //!< Whether the spatial index is used when m_maxRange is set
+
+  // The spatial index. It is built lazily by Send since phys usually
+  // get their mobility model after they have been added to the channel.
+  mutable std::vector<GridEntry> m_gridEntries; //!< indexed like m_phyList
+  mutable std::map<Cell, std::vector<uint32_t> > m_cells;
+  mutable std::set<uint32_t> m_moving; //!< phys which cannot be kept in a cell
+  mutable double m_cellSize; //!< the value of m_maxRange the grid was built for
 };
 
 } // namespace ns3
@@ -443,7 +443,7 @@ YansWifiPhy::SetReceiveErrorCallback (RxErrorCallback callback)
   m_state->SetReceiveErrorCallback (callback);
 }
 void
-YansWifiPhy::StartReceivePacket (Ptr<Packet> packet,
+YansWifiPhy::StartReceivePacket (Ptr<const Packet> packet,
                                  double rxPowerDbm,
                                  WifiTxVector txVector,
                                  enum WifiPreamble preamble)
@@ -785,7 +785,7 @@ YansWifiPhy::GetPowerDbm (uint8_t power) const
 }
 
 void
-YansWifiPhy::EndReceive (Ptr<Packet> packet, Ptr<InterferenceHelper::Event> event)
+YansWifiPhy::EndReceive (Ptr<const Packet> packet, Ptr<InterferenceHelper::Event> event)
 {
   NS_LOG_FUNCTION (this << packet << event);
   NS_ASSERT (IsStateRx ());
@@ -805,7 +805,9 @@ YansWifiPhy::EndReceive (Ptr<Packet> packet, Ptr<InterferenceHelper::Event> even
       double signalDbm = RatioToDb (event->GetRxPowerW ()) + 30;
       double noiseDbm = RatioToDb (event->GetRxPowerW () / snrPer.snr) - GetRxNoiseFigure () + 30;
       NotifyMonitorSniffRx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, isShortPreamble, signalDbm, noiseDbm);
-      m_state->SwitchFromRxEndOk (packet, snrPer.snr, event->GetPayloadMode (), event->GetPreambleType ());
+      // the packet is shared by all the receivers of the transmission:
+      // give the mac its own copy, which it is free to modify.
+      m_state->SwitchFromRxEndOk (packet->Copy (), snrPer.snr, event->GetPayloadMode (), event->GetPreambleType ());
     }
   else
     {
@@ -98,12 +98,13 @@ public:
   /**
    * Starting receiving the packet (i.e. the first bit of the preamble has arrived).
    *
-   * \param packet the arriving packet
+   * \param packet the arriving packet, shared with the other receivers of
+   *        the transmission: it is copied only if it is received successfully.
    * \param rxPowerDbm the receive power in dBm
    * \param txVector the TXVECTOR of the arriving packet
    * \param preamble the preamble of the arriving packet
    */
-  void StartReceivePacket (Ptr<Packet> packet,
+  void StartReceivePacket (Ptr<const Packet> packet,
                            double rxPowerDbm,
                            WifiTxVector txVector,
                            WifiPreamble preamble);
@@ -450,7 +451,7 @@ private:
    * \param packet the packet that the last bit has arrived
    * \param event the corresponding event of the first time the packet arrives
    */
-  void EndReceive (Ptr<Packet> packet, Ptr<InterferenceHelper::Event> event);
+  void EndReceive (Ptr<const Packet> packet, Ptr<InterferenceHelper::Event> event);
 
 private:
   double   m_edThresholdW;        //!< Energy detection threshold in watts
@@ -24,11 +24,13 @@
 #include "ns3/yans-wifi-channel.h"
 #include "ns3/adhoc-wifi-mac.h"
 #include "ns3/yans-wifi-phy.h"
+#include "ns3/interference-helper.h"
 #include "ns3/arf-wifi-manager.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/error-rate-model.h"
 #include "ns3/yans-error-rate-model.h"
+#include "ns3/nist-error-rate-model.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/node.h"
 #include "ns3/simulator.h"
@@ -41,6 +43,9 @@
 #include "ns3/edca-txop-n.h"
 #include "ns3/config.h"
 #include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include <cmath>
 
 namespace ns3 {
 
@@ -478,6 +483,276 @@ Bug555TestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_secondTransmissionTime, expectedSecondTransmissionTime, "The second transmission time not correct!");
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that culling receivers with the MaxRange attribute and the
+ * spatial index of YansWifiChannel does not change which phys detect
+ * a transmission, including with a moving phy and a phy which is moved
+ * into the middle of the network during the simulation.
+ */
+class YansWifiChannelCullingTest : public TestCase
+{
+public:
+  YansWifiChannelCullingTest ();
+
+  virtual void DoRun (void);
+private:
+  std::vector<uint32_t> RunOne (bool cull);
+  Ptr<YansWifiPhy> CreateOne (Ptr<MobilityModel> mobility, Ptr<YansWifiChannel> channel);
+  static void SendOnePacket (Ptr<YansWifiPhy> phy);
+  static void CountRx (uint32_t *count, Ptr<const Packet> packet);
+};
+
+YansWifiChannelCullingTest::YansWifiChannelCullingTest ()
+  : TestCase ("Check that YansWifiChannel culling only skips phys out of range")
+{
+}
+
+void
+YansWifiChannelCullingTest::SendOnePacket (Ptr<YansWifiPhy> phy)
+{
+  WifiMode mode = WifiPhy::GetOfdmRate6Mbps ();
+  WifiTxVector txVector;
+  txVector.SetMode (mode);
+  txVector.SetTxPowerLevel (0);
+  phy->SendPacket (Create<Packet> (1000), mode, WIFI_PREAMBLE_LONG, txVector);
+}
+
+void
+YansWifiChannelCullingTest::CountRx (uint32_t *count, Ptr<const Packet> packet)
+{
+  (*count)++;
+}
+
+Ptr<YansWifiPhy>
+YansWifiChannelCullingTest::CreateOne (Ptr<MobilityModel> mobility, Ptr<YansWifiChannel> channel)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  node->AggregateObject (mobility);
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+  phy->SetChannel (channel);
+  phy->SetMobility (node);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  return phy;
+}
+
+std::vector<uint32_t>
+YansWifiChannelCullingTest::RunOne (bool cull)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  if (cull)
+    {
+      // phys detect signals up to about 150m with this loss model
+      channel->SetAttribute ("MaxRange", DoubleValue (200.0));
+      channel->SetAttribute ("SpatialIndex", BooleanValue (true));
+    }
+
+  std::vector<Ptr<YansWifiPhy> > phys;
+  for (uint32_t i = 0; i < 30; i++)
+    {
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (60.0 * (i % 6), 60.0 * (i / 6), 0.0));
+      phys.push_back (CreateOne (mobility, channel));
+    }
+  Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+  moving->SetPosition (Vector (-400.0, 100.0, 0.0));
+  moving->SetVelocity (Vector (200.0, 0.0, 0.0));
+  phys.push_back (CreateOne (moving, channel));
+  Ptr<ConstantPositionMobilityModel> jumping = CreateObject<ConstantPositionMobilityModel> ();
+  jumping->SetPosition (Vector (1000.0, 1000.0, 0.0));
+  phys.push_back (CreateOne (jumping, channel));
+  Simulator::Schedule (Seconds (2.0), &ConstantPositionMobilityModel::SetPosition,
+                       jumping, Vector (150.0, 120.0, 0.0));
+
+  std::vector<uint32_t> counts (phys.size (), 0);
+  for (uint32_t i = 0; i < phys.size (); i++)
+    {
+      phys[i]->TraceConnectWithoutContext ("PhyRxBegin",
+                                           MakeBoundCallback (&YansWifiChannelCullingTest::CountRx, &counts[i]));
+    }
+  // every phy sends a packet every 300ms, one at a time.
+  for (uint32_t t = 0; t < 12; t++)
+    {
+      for (uint32_t i = 0; i < phys.size (); i++)
+        {
+          Simulator::Schedule (MilliSeconds (300 * t + 5 * i),
+                               &YansWifiChannelCullingTest::SendOnePacket, phys[i]);
+        }
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return counts;
+}
+
+void
+YansWifiChannelCullingTest::DoRun (void)
+{
+  std::vector<uint32_t> expected = RunOne (false);
+  std::vector<uint32_t> counts = RunOne (true);
+  NS_TEST_ASSERT_MSG_EQ (counts.size (), expected.size (), "Bad number of phys");
+  for (uint32_t i = 0; i < counts.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (counts[i], expected[i], "Culling changed the receptions of phy " << i);
+    }
+  // the phy which jumps detects transmissions only after it has been moved.
+  NS_TEST_EXPECT_MSG_GT (expected[31], 0U, "The phy which jumps never detected anything");
+  NS_TEST_EXPECT_MSG_GT (expected[30], 0U, "The moving phy never detected anything");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Check the noise and interference which InterferenceHelper tracks for
+ * overlapping signals, including signals which arrive while a packet
+ * is being received and signals which arrive after older ones have
+ * ended.
+ *
+ *     A  |-----------------|                       1 nW, 0-100us, received
+ *     B       |---------------------------------|  0.1 nW, 20-220us
+ *     C            |---|                           0.1 nW, 50-70us
+ *     D                            |-----------------|  0.1 nW, 150-250us, received
+ */
+class InterferenceHelperEnergyTest : public TestCase
+{
+public:
+  InterferenceHelperEnergyTest ();
+
+  virtual void DoRun (void);
+private:
+  void Add (double powerW, uint32_t us, bool rx);
+  void CheckEnergyDuration (double energyW, uint32_t us);
+  void EndRx (void);
+
+  InterferenceHelper m_interference;
+  Ptr<InterferenceHelper::Event> m_rxEvent;
+  WifiMode m_mode;
+  std::vector<double> m_snr;
+  std::vector<double> m_per;
+};
+
+InterferenceHelperEnergyTest::InterferenceHelperEnergyTest ()
+  : TestCase ("InterferenceHelper energy durations and SNR of overlapping signals")
+{
+}
+
+void
+InterferenceHelperEnergyTest::Add (double powerW, uint32_t us, bool rx)
+{
+  WifiTxVector txVector;
+  txVector.SetMode (m_mode);
+  Ptr<InterferenceHelper::Event> event = m_interference.Add (100, m_mode, WIFI_PREAMBLE_LONG,
+                                                             MicroSeconds (us), powerW, txVector);
+  if (rx)
+    {
+      m_interference.NotifyRxStart ();
+      m_rxEvent = event;
+    }
+}
+
+void
+InterferenceHelperEnergyTest::CheckEnergyDuration (double energyW, uint32_t us)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_interference.GetEnergyDuration (energyW), MicroSeconds (us),
+                         "Wrong energy duration above " << energyW << " W at " << Simulator::Now ());
+}
+
+void
+InterferenceHelperEnergyTest::EndRx (void)
+{
+  InterferenceHelper::SnrPer snrPer = m_interference.CalculateSnrPer (m_rxEvent);
+  m_interference.NotifyRxEnd ();
+  m_snr.push_back (snrPer.snr);
+  m_per.push_back (snrPer.per);
+}
+
+void
+InterferenceHelperEnergyTest::DoRun (void)
+{
+  m_mode = WifiPhy::GetOfdmRate6Mbps ();
+  m_interference.SetNoiseFigure (1.0);
+  m_interference.SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+
+  Simulator::Schedule (MicroSeconds (0), &InterferenceHelperEnergyTest::Add, this, 1e-9, 100, true);
+  Simulator::Schedule (MicroSeconds (1), &InterferenceHelperEnergyTest::CheckEnergyDuration, this, 5e-10, 99);
+  Simulator::Schedule (MicroSeconds (20), &InterferenceHelperEnergyTest::Add, this, 1e-10, 200, false);
+  Simulator::Schedule (MicroSeconds (20), &InterferenceHelperEnergyTest::CheckEnergyDuration, this, 5e-10, 80);
+  Simulator::Schedule (MicroSeconds (50), &InterferenceHelperEnergyTest::Add, this, 1e-10, 20, false);
+  Simulator::Schedule (MicroSeconds (50), &InterferenceHelperEnergyTest::CheckEnergyDuration, this, 1.5e-10, 50);
+  Simulator::Schedule (MicroSeconds (50), &InterferenceHelperEnergyTest::CheckEnergyDuration, this, 1.15e-9, 20);
+  Simulator::Schedule (MicroSeconds (50), &InterferenceHelperEnergyTest::CheckEnergyDuration, this, 2e-9, 0);
+  Simulator::Schedule (MicroSeconds (100), &InterferenceHelperEnergyTest::EndRx, this);
+  Simulator::Schedule (MicroSeconds (150), &InterferenceHelperEnergyTest::Add, this, 1e-10, 100, true);
+  Simulator::Schedule (MicroSeconds (150), &InterferenceHelperEnergyTest::CheckEnergyDuration, this, 1.5e-10, 70);
+  Simulator::Schedule (MicroSeconds (150), &InterferenceHelperEnergyTest::CheckEnergyDuration, this, 5e-11, 100);
+  Simulator::Schedule (MicroSeconds (250), &InterferenceHelperEnergyTest::EndRx, this);
+  Simulator::Schedule (MicroSeconds (300), &InterferenceHelperEnergyTest::CheckEnergyDuration, this, 1e-12, 0);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_snr.size (), 2U, "Wrong number of receptions");
+  // thermal noise at 290K over 20 MHz, with a noise figure of 1
+  double noiseW = 1.3803e-23 * 290.0 * 20e6;
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_snr[0], 1e-9 / noiseW, 1e-9 / noiseW * 1e-9, "Wrong SNR of A");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_snr[1], 1e-10 / (noiseW + 1e-10), 1e-9, "Wrong SNR of D");
+  // A is received at 10 dB SINR, D at 0 dB
+  NS_TEST_EXPECT_MSG_GT (m_per[1], 0.0, "D was not disturbed by B");
+  NS_TEST_EXPECT_MSG_LT (m_per[0], m_per[1], "A was disturbed more than D");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Check that the chunk success rates which the Nist and Yans error rate
+ * models interpolate from their tables stay close to the computed ones.
+ */
+class ErrorRateTableTest : public TestCase
+{
+public:
+  ErrorRateTableTest ();
+
+  virtual void DoRun (void);
+private:
+  void Check (Ptr<ErrorRateModel> model, WifiMode mode);
+};
+
+ErrorRateTableTest::ErrorRateTableTest ()
+  : TestCase ("Tabulated error rate models")
+{
+}
+
+void
+ErrorRateTableTest::Check (Ptr<ErrorRateModel> model, WifiMode mode)
+{
+  uint32_t nbits[] = { 0, 1, 112, 12000 };
+  for (double snrDb = -20.0; snrDb < 50.0; snrDb += 0.123)
+    {
+      double snr = std::pow (10.0, snrDb / 10.0);
+      for (uint32_t i = 0; i < sizeof (nbits) / sizeof (nbits[0]); i++)
+        {
+          model->SetAttribute ("UseTable", BooleanValue (false));
+          double analytic = model->GetChunkSuccessRate (mode, snr, nbits[i]);
+          model->SetAttribute ("UseTable", BooleanValue (true));
+          double table = model->GetChunkSuccessRate (mode, snr, nbits[i]);
+          NS_TEST_EXPECT_MSG_EQ_TOL (table, analytic, 1e-4, model->GetInstanceTypeId ().GetName ()
+                                     << " " << mode << " " << nbits[i] << " bits at " << snrDb << " dB");
+        }
+    }
+}
+
+void
+ErrorRateTableTest::DoRun (void)
+{
+  Ptr<ErrorRateModel> models[] = { CreateObject<NistErrorRateModel> (), CreateObject<YansErrorRateModel> () };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Check (models[i], WifiPhy::GetDsssRate1Mbps ());
+      Check (models[i], WifiPhy::GetDsssRate11Mbps ());
+      Check (models[i], WifiPhy::GetOfdmRate6Mbps ());
+      Check (models[i], WifiPhy::GetOfdmRate54Mbps ());
+    }
+}
+
 //-----------------------------------------------------------------------------
 class WifiTestSuite : public TestSuite
 {
@@ -492,6 +767,9 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); // Bug 991
   AddTestCase (new Bug555TestCase, TestCase::QUICK); // Bug 555
+  AddTestCase (new YansWifiChannelCullingTest, TestCase::QUICK);
+  AddTestCase (new InterferenceHelperEnergyTest, TestCase::QUICK);
+  AddTestCase (new ErrorRateTableTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite;
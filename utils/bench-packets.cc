@@ -20,6 +20,8 @@
 #include "ns3/system-wall-clock-ms.h"
 #include "ns3/packet.h"
 #include "ns3/packet-metadata.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -241,6 +243,82 @@ benchC (uint32_t n)
   }
 }
 
+static void
+benchE (uint32_t n)
+{
+  BenchHeader<8> udp;
+  BenchHeader<40> ipv6;
+  BenchHeader<8> llc;
+  BenchHeader<26> wifi;
+
+  for (uint32_t i = 0; i < n; i++) {
+    Ptr<Packet> p = Create<Packet> (1000);
+    p->AddHeader (udp);
+    p->AddHeader (ipv6);
+    // forwarded over three wifi hops
+    for (uint32_t hop = 0; hop < 3; hop++) {
+      Ptr<Packet> o = p->Copy ();
+      o->AddHeader (llc);
+      o->AddHeader (wifi);
+      o->RemoveHeader (wifi);
+      o->RemoveHeader (llc);
+      p = o;
+    }
+    p->RemoveHeader (ipv6);
+    p->RemoveHeader (udp);
+  }
+}
+
+static void
+benchF (uint32_t n)
+{
+  BenchHeader<25> ipv4;
+  BenchHeader<8> udp;
+  BenchHeader<12> gtpu;
+  BenchHeader<2> ppp;
+
+  for (uint32_t i = 0; i < n; i++) {
+    Ptr<Packet> p = Create<Packet> (1000);
+    p->AddHeader (udp);
+    p->AddHeader (ipv4);
+    // tunneled from the eNB to the SGW/PGW
+    p->AddHeader (gtpu);
+    p->AddHeader (udp);
+    p->AddHeader (ipv4);
+    p->AddHeader (ppp);
+    Ptr<Packet> o = p->Copy ();
+    o->RemoveHeader (ppp);
+    o->RemoveHeader (ipv4);
+    o->RemoveHeader (udp);
+    o->RemoveHeader (gtpu);
+    o->RemoveHeader (ipv4);
+    o->RemoveHeader (udp);
+  }
+}
+
+static void
+benchG (uint32_t n)
+{
+  BenchHeader<25> ipv4;
+  BenchHeader<8> udp;
+  uint8_t data[4000];
+  memset (data, 0x5a, sizeof (data));
+
+  for (uint32_t i = 0; i < n; i++) {
+    Ptr<Packet> p = Create<Packet> (data, sizeof (data));
+    p->AddHeader (udp);
+    // fragmented over a 1500-byte MTU, then reassembled
+    Ptr<Packet> whole = Create<Packet> ();
+    for (uint32_t offset = 0; offset < p->GetSize (); offset += 1480)
+      {
+        Ptr<Packet> fragment = p->CreateFragment (offset, std::min (1480U, p->GetSize () - offset));
+        fragment->AddHeader (ipv4);
+        fragment->RemoveHeader (ipv4);
+        whole->AddAtEnd (fragment);
+      }
+    whole->RemoveHeader (udp);
+  }
+}
 
 static void
 runBench (void (*bench) (uint32_t), uint32_t n, char const *name)
@@ -289,6 +367,9 @@ int main (int argc, char *argv[])
   runBench (&benchB, n, "Just add headers");
   runBench (&benchC, n, "Remove by func call");
   runBench (&benchD, n, "Intermixed add/remove headers and tags");
+  runBench (&benchE, n, "UDP/IPv6 copied over three wifi hops");
+  runBench (&benchF, n, "UDP/IPv4 in a GTP-U tunnel");
+  runBench (&benchG, n, "4000-byte data payload fragmented and reassembled");
 
   return 0;
 }
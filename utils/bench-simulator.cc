@@ -125,11 +125,50 @@ Bench::Cb (void)
 
 
 Ptr<RandomVariableStream>
-GetRandomStream (std::string filename)
+GetMixedStream (void)
+{
+  // A mix of event intervals typical of packet-level simulations:
+  // back-to-back processing delays, transmission and propagation
+  // delays, and periodic timers such as the LTE 1 ms TTI.
+  Ptr<ExponentialRandomVariable> short_ = CreateObject<ExponentialRandomVariable> ();
+  short_->SetAttribute ("Mean", DoubleValue (100));
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+
+  std::vector<double> nsValues;
+  const uint32_t count = 1000003;
+  nsValues.reserve (count);
+  for (uint32_t i = 0; i < count; ++i)
+    {
+      double u = uniform->GetValue (0, 1);
+      if (u < 0.6)
+        {
+          nsValues.push_back ((uint64_t) short_->GetValue ());
+        }
+      else if (u < 0.9)
+        {
+          nsValues.push_back ((uint64_t) uniform->GetValue (1000, 100000));
+        }
+      else
+        {
+          nsValues.push_back (1000000);
+        }
+    }
+  Ptr<DeterministicRandomVariable> drv = CreateObject<DeterministicRandomVariable> ();
+  drv->SetValueArray (&nsValues[0], nsValues.size ());
+  return drv;
+}
+
+Ptr<RandomVariableStream>
+GetRandomStream (std::string filename, bool mixed)
 {
   Ptr<RandomVariableStream> stream = 0;
   
-  if (filename == "")
+  if (mixed)
+    {
+      LOGME ("using mixed packet/timer event distribution");
+      stream = GetMixedStream ();
+    }
+  else if (filename == "")
     {
       LOGME ("using default exponential distribution");
       Ptr<ExponentialRandomVariable> erv = CreateObject<ExponentialRandomVariable> ();
@@ -186,6 +225,8 @@ int main (int argc, char *argv[])
   bool schedHeap = false;
   bool schedList = false;
   bool schedMap  = true;
+  bool schedBucket = false;
+  bool mixed = false;
 
   uint32_t pop   =  100000;
   uint32_t total = 1000000;
@@ -199,17 +240,20 @@ int main (int argc, char *argv[])
              "  an exponential distribution, with mean 100 ns,\n"
              "  an ascii file, given by the --file=\"<filename>\" argument,\n"
              "  or standard input, by the argument --file=\"-\"\n"
+             "  or a mix of packet delays and 1 ms timers, with --mixed\n"
              "In the case of either --file form, the input is expected\n"
              "to be ascii, giving the relative event times in ns.");
   cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
   cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
+  cmd.AddValue ("bucket", "use BucketScheduler",          schedBucket);
   cmd.AddValue ("debug", "enable debugging output",       g_debug);
   cmd.AddValue ("pop",   "event population size (default 1E5)",         pop);
   cmd.AddValue ("total", "total number of events to run (default 1E6)", total);
   cmd.AddValue ("runs",  "number of runs (default 1)",    runs);
   cmd.AddValue ("file",  "file of relative event times",  filename);
+  cmd.AddValue ("mixed", "use a mixed packet/timer distribution", mixed);
   cmd.AddValue ("prec",  "printed output precision",      g_fwidth);
   cmd.Parse (argc, argv);
   g_me = cmd.GetName () + ": ";
@@ -219,6 +263,7 @@ int main (int argc, char *argv[])
   if (schedCal)  { factory.SetTypeId ("ns3::CalendarScheduler"); }
   if (schedHeap) { factory.SetTypeId ("ns3::HeapScheduler");     }
   if (schedList) { factory.SetTypeId ("ns3::ListScheduler");     }  
+  if (schedBucket) { factory.SetTypeId ("ns3::BucketScheduler"); }
   Simulator::SetScheduler (factory);
 
   LOGME (std::setprecision (g_fwidth - 6));
@@ -230,7 +275,7 @@ int main (int argc, char *argv[])
   LOGME ("runs: " << runs);
   
   Bench *bench = new Bench (pop, total);
-  bench->SetRandomStream (GetRandomStream (filename));
+  bench->SetRandomStream (GetRandomStream (filename, mixed));
 
   // table header
   LOG ("");
@@ -270,5 +315,7 @@ int main (int argc, char *argv[])
     }
 
   LOG ("");
+  LOGME ("event pool hits: " << EventImpl::GetPoolHits () <<
+         ", misses: " << EventImpl::GetPoolMisses ());
   return 0;
 }